@@ -15,6 +15,8 @@ cdef extern from "xmmsc/xmmsc_idnumbers.h":
 		XMMS_PLAYLIST_CHANGED_MOVE
 		XMMS_PLAYLIST_CHANGED_SORT
 		XMMS_PLAYLIST_CHANGED_UPDATE
+		XMMS_PLAYLIST_CHANGED_ADD_MANY
+		XMMS_PLAYLIST_CHANGED_REMOVE_MANY
 
 	ctypedef enum xmms_plugin_type_t:
 		XMMS_PLUGIN_TYPE_ALL
@@ -25,6 +25,8 @@ PLAYLIST_CHANGED_CLEAR   = XMMS_PLAYLIST_CHANGED_CLEAR
 PLAYLIST_CHANGED_MOVE    = XMMS_PLAYLIST_CHANGED_MOVE
 PLAYLIST_CHANGED_SORT    = XMMS_PLAYLIST_CHANGED_SORT
 PLAYLIST_CHANGED_UPDATE  = XMMS_PLAYLIST_CHANGED_UPDATE
+PLAYLIST_CHANGED_ADD_MANY = XMMS_PLAYLIST_CHANGED_ADD_MANY
+PLAYLIST_CHANGED_REMOVE_MANY = XMMS_PLAYLIST_CHANGED_REMOVE_MANY
 
 PLUGIN_TYPE_ALL    = XMMS_PLUGIN_TYPE_ALL
 PLUGIN_TYPE_XFORM  = XMMS_PLUGIN_TYPE_XFORM
@@ -416,6 +416,8 @@ Init_Playlist (VALUE mXmms)
 	DEF_CONST (c, XMMS_PLAYLIST_CHANGED_, MOVE);
 	DEF_CONST (c, XMMS_PLAYLIST_CHANGED_, SORT);
 	DEF_CONST (c, XMMS_PLAYLIST_CHANGED_, UPDATE);
+	DEF_CONST (c, XMMS_PLAYLIST_CHANGED_, ADD_MANY);
+	DEF_CONST (c, XMMS_PLAYLIST_CHANGED_, REMOVE_MANY);
 
 	ePlaylistError = rb_define_class_under (c, "PlaylistError",
 	                                        rb_eStandardError);
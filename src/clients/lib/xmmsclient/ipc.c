@@ -33,11 +33,24 @@
 #include <xmmsc/xmmsc_sockets.h>
 
 
+/* results are hashed on the low bits of their cookie */
+#define XMMSC_IPC_RESULT_BUCKETS 256
+
+/* most messages gathered for a single write */
+#define XMMSC_IPC_WRITE_BATCH 64
+
+/* replies are read in chunks of this size and split up afterwards */
+#define XMMSC_IPC_READ_SIZE 16384
+
 struct xmmsc_ipc_St {
 	xmms_ipc_transport_t *transport;
 	xmms_ipc_msg_t *read_msg;
-	x_list_t *results_list;
+	char read_buf[XMMSC_IPC_READ_SIZE];
+	unsigned int read_pos;
+	unsigned int read_len;
+	x_list_t *results[XMMSC_IPC_RESULT_BUCKETS];
 	x_queue_t *out_msg;
+	int batch;
 	char *error;
 	bool disconnect;
 	void *lockdata;
@@ -66,11 +79,35 @@ xmmsc_ipc_io_in_callback (xmmsc_ipc_t *ipc)
 	x_return_val_if_fail (ipc, false);
 	x_return_val_if_fail (!ipc->disconnect, false);
 
-	while (!disco) {
+	while (!disco && !ipc->disconnect) {
+		bool complete;
+
+		if (ipc->read_pos == ipc->read_len) {
+			int ret;
+
+			ret = xmms_ipc_transport_read (ipc->transport, ipc->read_buf,
+			                               XMMSC_IPC_READ_SIZE);
+			if (ret == SOCKET_ERROR) {
+				disco = !xmms_socket_error_recoverable ();
+				break;
+			} else if (ret == 0) {
+				disco = true;
+				break;
+			}
+
+			ipc->read_pos = 0;
+			ipc->read_len = ret;
+		}
+
 		if (!ipc->read_msg)
 			ipc->read_msg = xmms_ipc_msg_alloc ();
 
-		if (xmms_ipc_msg_read_transport (ipc->read_msg, ipc->transport, &disco)) {
+		ipc->read_pos += xmms_ipc_msg_put_data (ipc->read_msg,
+		                                        ipc->read_buf + ipc->read_pos,
+		                                        ipc->read_len - ipc->read_pos,
+		                                        &complete);
+
+		if (complete) {
 			xmms_ipc_msg_t *msg = ipc->read_msg;
 
 			/* must unset read_msg here,
@@ -78,10 +115,6 @@ xmmsc_ipc_io_in_callback (xmmsc_ipc_t *ipc)
 			ipc->read_msg = NULL;
 
 			xmmsc_ipc_exec_msg (ipc, msg);
-
-		} else {
-
-			break;
 		}
 	}
 
@@ -108,11 +141,24 @@ xmmsc_ipc_io_out_callback (xmmsc_ipc_t *ipc)
 	x_return_val_if_fail (!ipc->disconnect, false);
 
 	while (!x_queue_is_empty (ipc->out_msg)) {
-		xmms_ipc_msg_t *msg = x_queue_peek_head (ipc->out_msg);
-		if (xmms_ipc_msg_write_transport (msg, ipc->transport, &disco)) {
+		xmms_ipc_msg_t *msgs[XMMSC_IPC_WRITE_BATCH];
+		x_list_t *n;
+		int i, count, written;
+
+		count = 0;
+		for (n = ipc->out_msg->head; n && count < XMMSC_IPC_WRITE_BATCH; n = n->next) {
+			msgs[count++] = n->data;
+		}
+
+		written = xmms_ipc_msg_write_transport_many (msgs, count,
+		                                             ipc->transport, &disco);
+
+		for (i = 0; i < written; i++) {
 			x_queue_pop_head (ipc->out_msg);
-			xmms_ipc_msg_destroy (msg);
-		} else {
+			xmms_ipc_msg_destroy (msgs[i]);
+		}
+
+		if (written < count) {
 			break;
 		}
 	}
@@ -151,6 +197,7 @@ xmmsc_ipc_disconnect (xmmsc_ipc_t *ipc)
 		xmms_ipc_msg_destroy (ipc->read_msg);
 		ipc->read_msg = NULL;
 	}
+	ipc->read_pos = ipc->read_len = 0;
 	xmmsc_ipc_error_set (ipc, strdup ("Disconnected"));
 	if (ipc->disconnect_callback) {
 		ipc->disconnect_callback (ipc->disconnect_data);
@@ -170,7 +217,6 @@ xmmsc_ipc_init (void)
 	xmmsc_ipc_t *ipc;
 	ipc = x_new0 (xmmsc_ipc_t, 1);
 	ipc->disconnect = false;
-	ipc->results_list = NULL;
 	ipc->out_msg = x_queue_new ();
 
 	return ipc;
@@ -205,11 +251,15 @@ xmmsc_ipc_lock_set (xmmsc_ipc_t *ipc, void *lock, void (*lockfunc)(void *), void
 void
 xmmsc_ipc_result_register (xmmsc_ipc_t *ipc, xmmsc_result_t *res)
 {
+	int bucket;
+
 	x_return_if_fail (ipc);
 	x_return_if_fail (res);
 
+	bucket = xmmsc_result_cookie_get (res) % XMMSC_IPC_RESULT_BUCKETS;
+
 	xmmsc_ipc_lock (ipc);
-	ipc->results_list = x_list_prepend (ipc->results_list, res);
+	ipc->results[bucket] = x_list_prepend (ipc->results[bucket], res);
 	xmmsc_ipc_unlock (ipc);
 }
 
@@ -223,7 +273,7 @@ xmmsc_ipc_result_lookup (xmmsc_ipc_t *ipc, uint32_t cookie)
 
 	xmmsc_ipc_lock (ipc);
 
-	for (n = ipc->results_list; n; n = x_list_next (n)) {
+	for (n = ipc->results[cookie % XMMSC_IPC_RESULT_BUCKETS]; n; n = x_list_next (n)) {
 		xmmsc_result_t *tmp = n->data;
 
 		if (cookie == xmmsc_result_cookie_get (tmp)) {
@@ -241,17 +291,20 @@ void
 xmmsc_ipc_result_unregister (xmmsc_ipc_t *ipc, xmmsc_result_t *res)
 {
 	x_list_t *n;
+	int bucket;
 
 	x_return_if_fail (ipc);
 	x_return_if_fail (res);
 
+	bucket = xmmsc_result_cookie_get (res) % XMMSC_IPC_RESULT_BUCKETS;
+
 	xmmsc_ipc_lock (ipc);
 
-	for (n = ipc->results_list; n; n = x_list_next (n)) {
+	for (n = ipc->results[bucket]; n; n = x_list_next (n)) {
 		xmmsc_result_t *tmp = n->data;
 
 		if (xmmsc_result_cookie_get (res) == xmmsc_result_cookie_get (tmp)) {
-			ipc->results_list = x_list_delete_link (ipc->results_list, n);
+			ipc->results[bucket] = x_list_delete_link (ipc->results[bucket], n);
 			xmmsc_result_clear_weakrefs (res);
 			break;
 		}
@@ -278,6 +331,13 @@ xmmsc_ipc_wait_for_event (xmmsc_ipc_t *ipc, unsigned int timeout)
 	x_return_if_fail (ipc);
 	x_return_if_fail (!ipc->disconnect);
 
+	/* replies already read, but not dispatched yet (when reentered
+	 * from a result callback) don't wake up select */
+	if (ipc->read_pos < ipc->read_len) {
+		xmmsc_ipc_io_in_callback (ipc);
+		return;
+	}
+
 	tmout.tv_sec = timeout;
 	tmout.tv_usec = 0;
 
@@ -313,28 +373,68 @@ xmmsc_ipc_msg_write (xmmsc_ipc_t *ipc, xmms_ipc_msg_t *msg, uint32_t cookie)
 	xmms_ipc_msg_set_cookie (msg, cookie);
 	x_queue_push_tail (ipc->out_msg, msg);
 
-	if (ipc->need_out_callback) {
+	/* a batch tells the mainloop once it is complete */
+	if (ipc->need_out_callback && !ipc->batch) {
 		ipc->need_out_callback (1, ipc->need_out_data);
 	}
 
 	return true;
 }
 
+void
+xmmsc_ipc_batch_begin (xmmsc_ipc_t *ipc)
+{
+	x_return_if_fail (ipc);
+
+	ipc->batch++;
+}
+
+/**
+ * End a batch. When the outermost batch ends, the queued messages are
+ * handed to the mainloop, or written right away if there is none.
+ *
+ * @returns false if the connection broke while writing.
+ */
+bool
+xmmsc_ipc_batch_end (xmmsc_ipc_t *ipc)
+{
+	x_return_val_if_fail (ipc, false);
+	x_return_val_if_fail (ipc->batch > 0, false);
+
+	if (--ipc->batch > 0 || ipc->disconnect) {
+		return !ipc->disconnect;
+	}
+
+	if (ipc->need_out_callback) {
+		ipc->need_out_callback (xmmsc_ipc_io_out (ipc), ipc->need_out_data);
+		return true;
+	}
+
+	while (xmmsc_ipc_io_out (ipc)) {
+		xmmsc_ipc_wait_for_event (ipc, 1);
+	}
+
+	return !ipc->disconnect;
+}
+
 
 void
 xmmsc_ipc_destroy (xmmsc_ipc_t *ipc)
 {
 	x_list_t *n;
+	int i;
 
 	if (!ipc)
 		return;
 
-	for (n = ipc->results_list; n; n = x_list_next (n)) {
-		xmmsc_result_t *tmp = n->data;
-		xmmsc_result_clear_weakrefs (tmp);
-	}
+	for (i = 0; i < XMMSC_IPC_RESULT_BUCKETS; i++) {
+		for (n = ipc->results[i]; n; n = x_list_next (n)) {
+			xmmsc_result_t *tmp = n->data;
+			xmmsc_result_clear_weakrefs (tmp);
+		}
 
-	x_list_free (ipc->results_list);
+		x_list_free (ipc->results[i]);
+	}
 	if (ipc->transport) {
 		xmms_ipc_transport_destroy (ipc->transport);
 	}
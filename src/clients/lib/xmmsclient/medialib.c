@@ -206,7 +206,8 @@ xmmsc_medialib_add_entry_encoded (xmmsc_connection_t *conn, const char *url)
 
 /**
  * Import a all files recursivly from the directory passed
- * as argument.
+ * as argument. Importing a directory again rescans it, only the
+ * files that changed since they were imported are rehashed.
  * @param conn #xmmsc_connection_t
  * @param path A directory to recursive search for mediafiles, this must
  * 		  include the protocol, i.e file://
@@ -253,6 +254,55 @@ xmmsc_medialib_import_path_encoded (xmmsc_connection_t *conn,
 	return do_methodcall (conn, XMMS_IPC_CMD_PATH_IMPORT, path);
 }
 
+/**
+ * Start importing all files recursively from the directory passed
+ * as argument, without waiting for the import to be done. The result
+ * holds the ID of the import job, and the progress of the job comes
+ * with #xmmsc_broadcast_medialib_import_progress.
+ * @param conn #xmmsc_connection_t
+ * @param path A directory to recursive search for mediafiles, this must
+ * 		  include the protocol, i.e file://
+ */
+xmmsc_result_t *
+xmmsc_medialib_import_path_async (xmmsc_connection_t *conn, const char *path)
+{
+	xmmsc_result_t *res;
+	char *enc_path;
+
+	x_check_conn (conn, NULL);
+
+	enc_path = xmmsc_medialib_encode_url (path);
+	if (!enc_path)
+		return NULL;
+
+	res = xmmsc_medialib_import_path_async_encoded (conn, enc_path);
+
+	free (enc_path);
+
+	return res;
+}
+
+/**
+ * Start importing all files recursively from the directory passed as
+ * argument which must already be url encoded, like
+ * #xmmsc_medialib_import_path_async.
+ *
+ * @param conn #xmmsc_connection_t
+ * @param path A directory to recursive search for mediafiles, this must
+ * 		  include the protocol, i.e file://
+ */
+xmmsc_result_t *
+xmmsc_medialib_import_path_async_encoded (xmmsc_connection_t *conn,
+                                          const char *path)
+{
+	x_check_conn (conn, NULL);
+
+	if (!_xmmsc_medialib_verify_url (path))
+		x_api_error ("with a non encoded url", NULL);
+
+	return do_methodcall (conn, XMMS_IPC_CMD_PATH_IMPORT_ASYNC, path);
+}
+
 /**
  * Import a all files recursivly from the directory passed
  * as argument.
@@ -315,6 +365,37 @@ xmmsc_medialib_get_info (xmmsc_connection_t *c, int id)
 	                       XMMSV_LIST_ENTRY_INT (id), XMMSV_LIST_END);
 }
 
+/**
+ * Retrieve information about several entries from the medialib with a
+ * single request. The result is a list of property dicts in the order of
+ * the ids, entries that don't exist are left out.
+ *
+ * @param c The connection structure.
+ * @param ids A list of ids, or an idlist collection.
+ * @param keys A list of property keys to retrieve, or NULL for all.
+ */
+xmmsc_result_t *
+xmmsc_medialib_get_infos (xmmsc_connection_t *c, xmmsv_t *ids, xmmsv_t *keys)
+{
+	x_check_conn (c, NULL);
+	x_api_error_if (!ids, "with a NULL id list", NULL);
+
+	if (xmmsv_is_type (ids, XMMSV_TYPE_COLL)) {
+		ids = xmmsv_coll_idlist_get (ids);
+	}
+
+	if (!keys) {
+		keys = xmmsv_new_list ();
+	} else {
+		xmmsv_ref (keys);
+	}
+
+	return xmmsc_send_cmd (c, XMMS_IPC_OBJECT_MEDIALIB, XMMS_IPC_CMD_INFOS,
+	                       XMMSV_LIST_ENTRY (xmmsv_ref (ids)),
+	                       XMMSV_LIST_ENTRY (keys),
+	                       XMMSV_LIST_END);
+}
+
 /**
  * Request the medialib_entry_added broadcast. This will be called
  * if a new entry is added to the medialib serverside.
@@ -327,6 +408,20 @@ xmmsc_broadcast_medialib_entry_added (xmmsc_connection_t *c)
 	return xmmsc_send_broadcast_msg (c, XMMS_IPC_SIGNAL_MEDIALIB_ENTRY_ADDED);
 }
 
+/**
+ * Request the medialib_import_progress broadcast. This will be called
+ * as an import job started with #xmmsc_medialib_import_path_async goes,
+ * and once more when it is done. The argument will be a dict with the
+ * job id and its counters.
+ */
+xmmsc_result_t *
+xmmsc_broadcast_medialib_import_progress (xmmsc_connection_t *c)
+{
+	x_check_conn (c, NULL);
+
+	return xmmsc_send_broadcast_msg (c, XMMS_IPC_SIGNAL_MEDIALIB_IMPORT_PROGRESS);
+}
+
 /**
  * Request the medialib_entry_updated broadcast. This will be called
  * if a entry changes on the serverside. The argument will be an medialib
@@ -237,6 +237,80 @@ xmmsc_playlist_list_entries (xmmsc_connection_t *c, const char *playlist)
 	                       XMMSV_LIST_ENTRY_STR (playlist), XMMSV_LIST_END);
 }
 
+/**
+ * Find where a medialib id is in the playlists. The result is a dict
+ * from the name of each playlist containing the id to the list of its
+ * positions there.
+ *
+ * @param c The connection structure.
+ * @param id A medialib id.
+ */
+xmmsc_result_t *
+xmmsc_playlist_entry_positions (xmmsc_connection_t *c, int id)
+{
+	x_check_conn (c, NULL);
+
+	return xmmsc_send_cmd (c, XMMS_IPC_OBJECT_PLAYLIST,
+	                       XMMS_IPC_CMD_ENTRY_POSITIONS,
+	                       XMMSV_LIST_ENTRY_INT (id), XMMSV_LIST_END);
+}
+
+/**
+ * List a range of a playlist. The result is a dict with the "revision"
+ * of the playlist, the "position" of the first entry and the "ids" of
+ * the entries.
+ *
+ * @param c The connection structure.
+ * @param playlist the playlist name, or NULL for the active playlist.
+ * @param start The position of the first entry to list.
+ * @param length The number of entries to list, or -1 for all of them.
+ */
+xmmsc_result_t *
+xmmsc_playlist_list_range (xmmsc_connection_t *c, const char *playlist,
+                           int start, int length)
+{
+	x_check_conn (c, NULL);
+
+	/* default to the active playlist */
+	if (playlist == NULL) {
+		playlist = XMMS_ACTIVE_PLAYLIST;
+	}
+
+	return xmmsc_send_cmd (c, XMMS_IPC_OBJECT_PLAYLIST, XMMS_IPC_CMD_LIST_RANGE,
+	                       XMMSV_LIST_ENTRY_STR (playlist),
+	                       XMMSV_LIST_ENTRY_INT (start),
+	                       XMMSV_LIST_ENTRY_INT (length),
+	                       XMMSV_LIST_END);
+}
+
+/**
+ * List the changes of a playlist since a revision, to bring a copy made
+ * with #xmmsc_playlist_list_range up to date. The result is a dict with
+ * the current "revision" and the list of "changes", in the format of
+ * the playlist changed broadcast. It is an error if the revision is no
+ * longer known, the playlist must then be listed again.
+ *
+ * @param c The connection structure.
+ * @param playlist the playlist name, or NULL for the active playlist.
+ * @param revision The revision of the copy.
+ */
+xmmsc_result_t *
+xmmsc_playlist_list_changes (xmmsc_connection_t *c, const char *playlist,
+                             int revision)
+{
+	x_check_conn (c, NULL);
+
+	/* default to the active playlist */
+	if (playlist == NULL) {
+		playlist = XMMS_ACTIVE_PLAYLIST;
+	}
+
+	return xmmsc_send_cmd (c, XMMS_IPC_OBJECT_PLAYLIST, XMMS_IPC_CMD_LIST_CHANGES,
+	                       XMMSV_LIST_ENTRY_STR (playlist),
+	                       XMMSV_LIST_ENTRY_INT (revision),
+	                       XMMSV_LIST_END);
+}
+
 /**
  * Insert a medialib id at given position in playlist.
  *
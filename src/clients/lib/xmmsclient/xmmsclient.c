@@ -448,6 +448,45 @@ xmmsc_send_cmd (xmmsc_connection_t *c, int obj, int cmd, ...)
 	return xmmsc_send_msg (c, msg);
 }
 
+/**
+ * Start batching commands.
+ *
+ * Commands sent until the matching #xmmsc_batch_flush are queued without
+ * waking up the mainloop, and are written to the server together instead
+ * of one at a time. Their results can be waited for or get callbacks as
+ * usual, replies are matched to them by cookie in any order. Batches may
+ * be nested, only the outermost flush sends.
+ *
+ * Waiting for a result inside a batch writes everything queued so far.
+ *
+ * @param c The connection structure.
+ */
+void
+xmmsc_batch_begin (xmmsc_connection_t *c)
+{
+	x_check_conn (c,);
+
+	xmmsc_ipc_batch_begin (c->ipc);
+}
+
+/**
+ * End a batch started with #xmmsc_batch_begin.
+ *
+ * With a mainloop integration the queued commands are written by the
+ * next #xmmsc_io_out_handle, in as few writes as possible. Without one
+ * they are written before this function returns.
+ *
+ * @param c The connection structure.
+ * @returns 1 if everything is well, 0 if the connection is broken.
+ */
+int
+xmmsc_batch_flush (xmmsc_connection_t *c)
+{
+	x_check_conn (c, 0);
+
+	return xmmsc_ipc_batch_end (c->ipc);
+}
+
 /**
  * @defgroup IOFunctions IOFunctions
  * @ingroup XMMSClient
@@ -613,7 +613,9 @@ on_directory_event (GFileMonitor *monitor, GFile *entity, GFile *other,
 	case G_FILE_MONITOR_EVENT_CREATED:
 		on_entity_created (updater, entity);
 		break;
-	case G_FILE_MONITOR_EVENT_CHANGED:
+	case G_FILE_MONITOR_EVENT_CHANGES_DONE_HINT:
+		/* a file being written sends a CHANGED event for every write,
+		 * wait for it to be done to rehash it once */
 		on_entity_changed (updater, entity);
 		break;
 	case G_FILE_MONITOR_EVENT_DELETED:
@@ -139,8 +139,9 @@ update_active_playlist (xmmsv_t *val, void *udata)
 {
 	cli_cache_t *cache = (cli_cache_t *) udata;
 	xmmsc_result_t *refres;
+	xmmsv_t *ids = NULL;
 	gint pos, newpos, type;
-	gint id;
+	gint id, i, count;
 	const gchar *name;
 
 	xmmsv_dict_entry_get_int (val, "type", &type);
@@ -163,6 +164,13 @@ update_active_playlist (xmmsv_t *val, void *udata)
 		xmmsv_list_insert_int (cache->active_playlist, pos, id);
 		break;
 
+	case XMMS_PLAYLIST_CHANGED_ADD_MANY:
+		xmmsv_dict_get (val, "ids", &ids);
+		for (i = 0; xmmsv_list_get_int (ids, i, &id); i++) {
+			xmmsv_list_insert_int (cache->active_playlist, pos + i, id);
+		}
+		break;
+
 	case XMMS_PLAYLIST_CHANGED_MOVE:
 		xmmsv_dict_entry_get_int (val, "newposition", &newpos);
 		xmmsv_list_remove (cache->active_playlist, pos);
@@ -173,6 +181,13 @@ update_active_playlist (xmmsv_t *val, void *udata)
 		xmmsv_list_remove (cache->active_playlist, pos);
 		break;
 
+	case XMMS_PLAYLIST_CHANGED_REMOVE_MANY:
+		xmmsv_dict_entry_get_int (val, "count", &count);
+		for (i = 0; i < count; i++) {
+			xmmsv_list_remove (cache->active_playlist, pos);
+		}
+		break;
+
 	case XMMS_PLAYLIST_CHANGED_SHUFFLE:
 	case XMMS_PLAYLIST_CHANGED_SORT:
 	case XMMS_PLAYLIST_CHANGED_CLEAR:
@@ -41,11 +41,16 @@ typedef struct cli_move_positions_St {
 	gint pos;
 } cli_move_positions_t;
 
-typedef struct cli_list_positions_St {
+/* Rows are resolved in pages of this many entries per server request */
+#define CLI_LIST_PAGE_SIZE 256
+
+typedef struct cli_list_page_St {
 	xmmsc_connection_t *sync;
 	column_display_t *coldisp;
 	xmmsv_t *entries;
-} cli_list_positions_t;
+	xmmsv_t *ids;
+	GArray *positions;
+} cli_list_page_t;
 
 typedef struct cli_remove_positions_St {
 	xmmsc_connection_t *sync;
@@ -231,27 +236,93 @@ cli_list_classic_column_display (cli_context_t *ctx)
 
 
 static void
-cli_list_print_row (column_display_t *coldisp, xmmsv_t *propdict)
+cli_list_page_init (cli_list_page_t *page, cli_context_t *ctx,
+                    column_display_t *coldisp, xmmsv_t *entries)
 {
-	xmmsv_t *info = xmmsv_propdict_to_dict (propdict, NULL);
-	enrich_mediainfo (info);
-	column_display_print (coldisp, info);
+	page->sync = cli_context_xmms_sync (ctx);
+	page->coldisp = coldisp;
+	page->entries = entries;
+	page->ids = xmmsv_new_list ();
+	page->positions = g_array_sized_new (FALSE, FALSE, sizeof (gint),
+	                                     CLI_LIST_PAGE_SIZE);
+}
+
+/* Print the rows of the page, infos holds the ones that exist in order */
+static void
+cli_list_page_print (cli_list_page_t *page, xmmsv_t *infos)
+{
+	xmmsv_t *propdict, *info = NULL;
+	gint i, j, id, info_id;
+
+	for (i = 0, j = 0; xmmsv_list_get_int (page->ids, i, &id); i++) {
+		if (info == NULL) {
+			if (!xmmsv_list_get (infos, j++, &propdict)) {
+				break;
+			}
+			info = xmmsv_propdict_to_dict (propdict, NULL);
+			enrich_mediainfo (info);
+		}
+
+		if (xmmsv_dict_entry_get_int (info, "id", &info_id) && info_id == id) {
+			column_display_set_position (page->coldisp,
+			                             g_array_index (page->positions, gint, i));
+			column_display_print (page->coldisp, info);
+			xmmsv_unref (info);
+			info = NULL;
+		}
+	}
+
+	if (info != NULL) {
+		xmmsv_unref (info);
+	}
+}
+
+static void
+cli_list_page_flush (cli_list_page_t *page)
+{
+	if (xmmsv_list_get_size (page->ids) == 0) {
+		return;
+	}
+
+	XMMS_CALL_CHAIN (XMMS_CALL_P (xmmsc_medialib_get_infos, page->sync, page->ids, NULL),
+	                 FUNC_CALL_P (cli_list_page_print, page, XMMS_PREV_VALUE));
+
+	xmmsv_list_clear (page->ids);
+	g_array_set_size (page->positions, 0);
+}
+
+static void
+cli_list_page_add (cli_list_page_t *page, gint pos, gint id)
+{
+	xmmsv_list_append_int (page->ids, id);
+	g_array_append_val (page->positions, pos);
+
+	if (xmmsv_list_get_size (page->ids) >= CLI_LIST_PAGE_SIZE) {
+		cli_list_page_flush (page);
+	}
+}
+
+static void
+cli_list_page_finish (cli_list_page_t *page)
+{
+	cli_list_page_flush (page);
+
+	xmmsv_unref (page->ids);
+	g_array_free (page->positions, TRUE);
 }
 
 static void
 cli_list_print_positions_row (gint pos, void *udata)
 {
-	cli_list_positions_t *pack = (cli_list_positions_t *) udata;
+	cli_list_page_t *page = (cli_list_page_t *) udata;
 	gint id;
 
-	if (pos >= xmmsv_list_get_size (pack->entries)) {
+	if (pos >= xmmsv_list_get_size (page->entries)) {
 		return;
 	}
 
-	if (xmmsv_list_get_int (pack->entries, pos, &id)) {
-		column_display_set_position (pack->coldisp, pos);
-		XMMS_CALL_CHAIN (XMMS_CALL_P (xmmsc_medialib_get_info, pack->sync, id),
-		                 FUNC_CALL_P (cli_list_print_row, pack->coldisp, XMMS_PREV_VALUE));
+	if (xmmsv_list_get_int (page->entries, pos, &id)) {
+		cli_list_page_add (page, pos, id);
 	}
 }
 
@@ -259,21 +330,20 @@ static void
 cli_list_print_positions (cli_context_t *ctx, column_display_t *coldisp,
                           xmmsv_t *list, gpointer udata)
 {
-	cli_list_positions_t pudata = {
-		.sync = cli_context_xmms_sync (ctx),
-		.coldisp = coldisp,
-		.entries = list
-	};
 	playlist_positions_t *positions = (playlist_positions_t *) udata;
-	playlist_positions_foreach (positions, cli_list_print_positions_row, TRUE, &pudata);
+	cli_list_page_t page;
+
+	cli_list_page_init (&page, ctx, coldisp, list);
+	playlist_positions_foreach (positions, cli_list_print_positions_row, TRUE, &page);
+	cli_list_page_finish (&page);
 }
 
 static void
 cli_list_print_ids (cli_context_t *ctx, column_display_t *coldisp,
                     xmmsv_t *list, gpointer udata)
 {
-	xmmsc_connection_t *conn = cli_context_xmms_sync (ctx);
 	xmmsv_list_iter_t *it;
+	cli_list_page_t page;
 	GTree *lookup = NULL;
 	gint id;
 
@@ -282,16 +352,18 @@ cli_list_print_ids (cli_context_t *ctx, column_display_t *coldisp,
 	if (filter != NULL)
 		lookup = g_tree_new_from_xmmsv (filter);
 
+	cli_list_page_init (&page, ctx, coldisp, list);
+
 	xmmsv_get_list_iter (list, &it);
 	while (xmmsv_list_iter_entry_int (it, &id)) {
-		column_display_set_position (coldisp, xmmsv_list_iter_tell (it));
 		if (lookup == NULL || g_tree_lookup (lookup, GINT_TO_POINTER (id)) != NULL) {
-			XMMS_CALL_CHAIN (XMMS_CALL_P (xmmsc_medialib_get_info, conn, id),
-			                 FUNC_CALL_P (cli_list_print_row, coldisp, XMMS_PREV_VALUE));
+			cli_list_page_add (&page, xmmsv_list_iter_tell (it), id);
 		}
 		xmmsv_list_iter_next (it);
 	}
 
+	cli_list_page_finish (&page);
+
 	if (lookup)
 		g_tree_destroy (lookup);
 }
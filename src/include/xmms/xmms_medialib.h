@@ -50,6 +50,8 @@
 #define XMMS_MEDIALIB_ENTRY_PROPERTY_SAMPLE_FMT "sample_format"
 #define XMMS_MEDIALIB_ENTRY_PROPERTY_SAMPLERATE "samplerate"
 #define XMMS_MEDIALIB_ENTRY_PROPERTY_LMOD "lmod"
+/** Size, modification time and inode of a local file, see the file plugin */
+#define XMMS_MEDIALIB_ENTRY_PROPERTY_FINGERPRINT "fingerprint"
 #define XMMS_MEDIALIB_ENTRY_PROPERTY_GAIN_TRACK "gain_track"
 #define XMMS_MEDIALIB_ENTRY_PROPERTY_GAIN_ALBUM "gain_album"
 #define XMMS_MEDIALIB_ENTRY_PROPERTY_PEAK_TRACK "peak_track"
@@ -38,12 +38,30 @@ typedef void (*xmms_object_destroy_func_t) (xmms_object_t *object);
 /** @addtogroup Object
   * @{
   */
+typedef struct {
+	xmmsv_t *args; /* list */
+	xmmsv_t *retval;
+	xmms_error_t error;
+} xmms_object_cmd_arg_t;
+
+typedef void (*xmms_object_cmd_func_t) (xmms_object_t *object, xmms_object_cmd_arg_t *arg);
+
+struct xmms_object_handlers_St;
+
 struct xmms_object_St {
 	guint32 id;
 	GMutex mutex;
 
-	GTree *signals;
-	GTree *cmds;
+	/* handlers per signal id, replaced as a whole under the mutex */
+	struct xmms_object_handlers_St *handlers[XMMS_IPC_SIGNAL_END];
+	/* emits in progress, and replaced handlers they may still be using */
+	gint emitting;
+	GSList *retired;
+
+	/* command table, indexed by command id minus cmds_first */
+	const xmms_object_cmd_func_t *cmds;
+	guint cmds_first;
+	guint cmds_len;
 
 	gint ref;
 	xmms_object_destroy_func_t destroy_func;
@@ -64,13 +82,6 @@ int dummy_identity (xmmsv_t *value, xmmsv_t **arg);
 typedef void (*xmms_object_handler_t) (xmms_object_t *object, xmmsv_t *data, gpointer userdata);
 
 #define XMMS_OBJECT_CMD_MAX_ARGS 6
-typedef struct {
-	xmmsv_t *args; /* list */
-	xmmsv_t *retval;
-	xmms_error_t error;
-} xmms_object_cmd_arg_t;
-
-typedef void (*xmms_object_cmd_func_t) (xmms_object_t *object, xmms_object_cmd_arg_t *arg);
 
 #define XMMS_OBJECT(p) ((xmms_object_t *)p)
 #define XMMS_IS_OBJECT(p) (XMMS_OBJECT (p)->id == XMMS_OBJECT_MID)
@@ -78,14 +89,36 @@ typedef void (*xmms_object_cmd_func_t) (xmms_object_t *object, xmms_object_cmd_a
 void xmms_object_cleanup (xmms_object_t *object);
 
 void xmms_object_connect (xmms_object_t *object, guint32 signalid, xmms_object_handler_t handler, gpointer userdata) XMMS_PUBLIC;
+void xmms_object_connect_sync (xmms_object_t *object, guint32 signalid, xmms_object_handler_t handler, gpointer userdata) XMMS_PUBLIC;
 
 void xmms_object_disconnect (xmms_object_t *object, guint32 signalid, xmms_object_handler_t handler, gpointer userdata) XMMS_PUBLIC;
 
 void xmms_object_emit (xmms_object_t *object, guint32 signalid, xmmsv_t *data);
+xmmsv_t *xmms_object_emit_stats (void);
+
+void xmms_object_emit_async (xmms_object_t *object, guint32 signalid, xmmsv_t *data);
+void xmms_object_dispatch_start (void);
+void xmms_object_dispatch_stop (void);
 
 void xmms_object_cmd_arg_init (xmms_object_cmd_arg_t *arg);
 
-void xmms_object_cmd_add (xmms_object_t *object, guint cmdid, const xmms_object_cmd_func_t desc);
+void xmms_object_cmds_set (xmms_object_t *object, guint first, const xmms_object_cmd_func_t *cmds, guint len);
+
+/**
+ * Look up the function of a command, NULL if the object has no such command.
+ */
+static inline xmms_object_cmd_func_t
+xmms_object_cmd_get (xmms_object_t *object, guint cmdid)
+{
+	guint index = cmdid - object->cmds_first;
+
+	/* ids below the first one wrap around and fail the bounds check */
+	if (index >= object->cmds_len) {
+		return NULL;
+	}
+
+	return object->cmds[index];
+}
 
 void xmms_object_cmd_call (xmms_object_t *object, guint cmdid, xmms_object_cmd_arg_t *arg);
 
@@ -45,7 +45,7 @@ typedef struct xmms_output_St xmms_output_t;
 /**
  * The current API version.
  */
-#define XMMS_OUTPUT_API_VERSION 8
+#define XMMS_OUTPUT_API_VERSION 9
 
 struct xmms_output_plugin_St;
 typedef struct xmms_output_plugin_St xmms_output_plugin_t;
@@ -212,6 +212,21 @@ typedef struct xmms_output_methods_St {
 	 * @return the number of bytes in the soundcard buffer or 0 on failure
 	 */
 	guint (*latency_get)(xmms_output_t *);
+
+	/**
+	 * Start watching for volume changes.
+	 *
+	 * Plugins that get told about volume changes by the sound system
+	 * (mixer events, server subscriptions and the like) should start
+	 * listening here, call #xmms_output_volume_changed whenever the
+	 * volume may have changed and return TRUE. They stop when the
+	 * plugin is destroyed. If this returns FALSE, or isn't implemented,
+	 * the volume is polled through #volume_get instead.
+	 *
+	 * @param output an output object
+	 * @return TRUE if the plugin will report volume changes
+	 */
+	gboolean (*volume_monitor)(xmms_output_t *output);
 } xmms_output_methods_t;
 
 /**
@@ -335,6 +350,16 @@ gint xmms_output_bytes_available (xmms_output_t *output) XMMS_PUBLIC;
  */
 void xmms_output_set_error (xmms_output_t *output, xmms_error_t *error) XMMS_PUBLIC;
 
+/**
+ * Tell the output that the volume may have changed.
+ *
+ * The volume is then read through #volume_get and, if it differs, the
+ * change is broadcast to the clients. Safe to call from any thread.
+ *
+ * @param output an output object
+ */
+void xmms_output_volume_changed (xmms_output_t *output) XMMS_PUBLIC;
+
 /**
  * Check if an output plugin needs format updates on each track change.
  *
@@ -389,6 +389,36 @@ gboolean xmms_xform_iseos (xmms_xform_t *xform) XMMS_PUBLIC;
 
 const xmms_stream_type_t *xmms_xform_get_out_stream_type (xmms_xform_t *xform) XMMS_PUBLIC;
 
+/**
+ * Check whether the chain is set up only to read metadata.
+ *
+ * Plugins finding the format, duration and tags of a stream in its
+ * container may then skip what is only needed to decode it, and end
+ * the chain with #xmms_xform_probe_finish.
+ *
+ * @param xform
+ * @returns TRUE if the metadata is all the chain is set up for
+ */
+gboolean xmms_xform_probing (xmms_xform_t *xform) XMMS_PUBLIC;
+
+/**
+ * End a probing chain at this xform.
+ *
+ * The outdata type, which must be set already, is replaced by the
+ * probe type so no xform is added after this one. Its channels and
+ * samplerate are kept and stored with the metadata, along with format.
+ *
+ * The chain is only ended when format is known and a plugin is there
+ * to decode the stream, so that files which can't be played aren't
+ * taken for playable ones. Otherwise it goes on as usual.
+ *
+ * @param xform
+ * @param format the format the stream decodes to, or
+ * XMMS_SAMPLE_FORMAT_UNKNOWN when it is up to the decoder
+ * @returns TRUE if the chain ends at this xform
+ */
+gboolean xmms_xform_probe_finish (xmms_xform_t *xform, xmms_sample_format_t format) XMMS_PUBLIC;
+
 gboolean xmms_magic_add (const gchar *desc, const gchar *mime, ...) XMMS_PUBLIC;
 gboolean xmms_magic_extension_add (const gchar *mime, const gchar *ext) XMMS_PUBLIC;
 
@@ -20,7 +20,7 @@
 #include <xmmsc/xmmsc_compiler.h>
 
 /* Don't forget to up this when protocol changes */
-#define XMMS_IPC_PROTOCOL_VERSION 22
+#define XMMS_IPC_PROTOCOL_VERSION 26
 
 typedef enum {
 	XMMS_IPC_OBJECT_SIGNAL,
@@ -54,6 +54,7 @@ typedef enum {
 	XMMS_IPC_SIGNAL_QUIT,
 	XMMS_IPC_SIGNAL_MEDIAINFO_READER_STATUS,
 	XMMS_IPC_SIGNAL_MEDIAINFO_READER_UNINDEXED,
+	XMMS_IPC_SIGNAL_MEDIALIB_IMPORT_PROGRESS,
 	XMMS_IPC_SIGNAL_END
 } xmms_ipc_signals_t;
 
@@ -98,7 +99,10 @@ typedef enum {
 	XMMS_IPC_CMD_INSERT_COLL,
 	XMMS_IPC_CMD_LOAD,
 	XMMS_IPC_CMD_RADD,
-	XMMS_IPC_CMD_RINSERT
+	XMMS_IPC_CMD_RINSERT,
+	XMMS_IPC_CMD_ENTRY_POSITIONS,
+	XMMS_IPC_CMD_LIST_RANGE,
+	XMMS_IPC_CMD_LIST_CHANGES
 } xmms_ipc_playlist_cmds_t;
 
 /* Config methods */
@@ -135,7 +139,9 @@ typedef enum {
 	XMMS_IPC_CMD_PROPERTY_SET_INT,
 	XMMS_IPC_CMD_PROPERTY_REMOVE,
 	XMMS_IPC_CMD_MOVE_URL,
-	XMMS_IPC_CMD_MLIB_ADD_URL
+	XMMS_IPC_CMD_MLIB_ADD_URL,
+	XMMS_IPC_CMD_INFOS,
+	XMMS_IPC_CMD_PATH_IMPORT_ASYNC
 } xmms_ipc_medialib_cmds_t;
 
 /* Coll sync methods */
@@ -189,7 +195,9 @@ typedef enum {
 	XMMS_PLAYLIST_CHANGED_MOVE,
 	XMMS_PLAYLIST_CHANGED_SORT, /* deprecated */
 	XMMS_PLAYLIST_CHANGED_UPDATE,
-	XMMS_PLAYLIST_CHANGED_REPLACE
+	XMMS_PLAYLIST_CHANGED_REPLACE,
+	XMMS_PLAYLIST_CHANGED_ADD_MANY, /* "ids" inserted from "position" on */
+	XMMS_PLAYLIST_CHANGED_REMOVE_MANY /* "count" entries removed from "position" on */
 } xmms_playlist_changed_actions_t;
 
 typedef enum {
@@ -61,6 +61,7 @@ xmmsv_t *xmmsv_build_metadata (xmmsv_t *keys, xmmsv_t *get, const char *aggregat
 xmmsv_t *xmmsv_build_cluster_list (xmmsv_t *cluster_by, xmmsv_t *cluster_field, xmmsv_t *cluster_data) XMMS_PUBLIC;
 xmmsv_t *xmmsv_build_cluster_dict (xmmsv_t *cluster_by, xmmsv_t *cluster_field, xmmsv_t *cluster_data) XMMS_PUBLIC;
 xmmsv_t *xmmsv_build_count (void) XMMS_PUBLIC;
+xmmsv_t *xmmsv_build_columns (xmmsv_t *fields, xmmsv_t *sourcepref) XMMS_PUBLIC;
 /** @} */
 
 #ifdef __cplusplus
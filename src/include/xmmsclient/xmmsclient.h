@@ -57,6 +57,9 @@ int xmmsc_io_out_handle (xmmsc_connection_t *c) XMMS_PUBLIC;
 int xmmsc_io_in_handle (xmmsc_connection_t *c) XMMS_PUBLIC;
 int xmmsc_io_fd_get (xmmsc_connection_t *c) XMMS_PUBLIC;
 
+void xmmsc_batch_begin (xmmsc_connection_t *c) XMMS_PUBLIC;
+int xmmsc_batch_flush (xmmsc_connection_t *c) XMMS_PUBLIC;
+
 char *xmmsc_get_last_error (xmmsc_connection_t *c) XMMS_PUBLIC;
 
 xmmsc_result_t *xmmsc_quit(xmmsc_connection_t *c) XMMS_PUBLIC;
@@ -92,6 +95,9 @@ xmmsc_result_t *xmmsc_playlist_clear (xmmsc_connection_t *c, const char *playlis
 xmmsc_result_t *xmmsc_playlist_replace (xmmsc_connection_t *c, const char *playlist, xmmsv_t *coll, xmms_playlist_position_action_t action) XMMS_PUBLIC;
 xmmsc_result_t *xmmsc_playlist_remove (xmmsc_connection_t *c, const char *playlist) XMMS_PUBLIC;
 xmmsc_result_t *xmmsc_playlist_list_entries (xmmsc_connection_t *c, const char *playlist) XMMS_PUBLIC;
+xmmsc_result_t *xmmsc_playlist_entry_positions (xmmsc_connection_t *c, int id) XMMS_PUBLIC;
+xmmsc_result_t *xmmsc_playlist_list_range (xmmsc_connection_t *c, const char *playlist, int start, int length) XMMS_PUBLIC;
+xmmsc_result_t *xmmsc_playlist_list_changes (xmmsc_connection_t *c, const char *playlist, int revision) XMMS_PUBLIC;
 xmmsc_result_t *xmmsc_playlist_sort (xmmsc_connection_t *c, const char *playlist, xmmsv_t *properties) XMMS_PUBLIC;
 xmmsc_result_t *xmmsc_playlist_set_next (xmmsc_connection_t *c, int32_t) XMMS_PUBLIC;
 xmmsc_result_t *xmmsc_playlist_set_next_rel (xmmsc_connection_t *c, int32_t) XMMS_PUBLIC;
@@ -213,10 +219,13 @@ xmmsc_result_t *xmmsc_medialib_add_entry_args (xmmsc_connection_t *conn, const c
 xmmsc_result_t *xmmsc_medialib_add_entry_full (xmmsc_connection_t *conn, const char *url, xmmsv_t *args) XMMS_PUBLIC;
 xmmsc_result_t *xmmsc_medialib_add_entry_encoded (xmmsc_connection_t *conn, const char *url) XMMS_PUBLIC;
 xmmsc_result_t *xmmsc_medialib_get_info (xmmsc_connection_t *, int) XMMS_PUBLIC;
+xmmsc_result_t *xmmsc_medialib_get_infos (xmmsc_connection_t *c, xmmsv_t *ids, xmmsv_t *keys) XMMS_PUBLIC;
 xmmsc_result_t *xmmsc_medialib_path_import (xmmsc_connection_t *conn, const char *path) XMMS_PUBLIC XMMS_DEPRECATED;
 xmmsc_result_t *xmmsc_medialib_path_import_encoded (xmmsc_connection_t *conn, const char *path) XMMS_PUBLIC XMMS_DEPRECATED;
 xmmsc_result_t *xmmsc_medialib_import_path (xmmsc_connection_t *conn, const char *path) XMMS_PUBLIC;
 xmmsc_result_t *xmmsc_medialib_import_path_encoded (xmmsc_connection_t *conn, const char *path) XMMS_PUBLIC;
+xmmsc_result_t *xmmsc_medialib_import_path_async (xmmsc_connection_t *conn, const char *path) XMMS_PUBLIC;
+xmmsc_result_t *xmmsc_medialib_import_path_async_encoded (xmmsc_connection_t *conn, const char *path) XMMS_PUBLIC;
 xmmsc_result_t *xmmsc_medialib_rehash (xmmsc_connection_t *conn, int id) XMMS_PUBLIC;
 xmmsc_result_t *xmmsc_medialib_get_id (xmmsc_connection_t *conn, const char *url) XMMS_PUBLIC;
 xmmsc_result_t *xmmsc_medialib_get_id_encoded (xmmsc_connection_t *conn, const char *url) XMMS_PUBLIC;
@@ -247,6 +256,7 @@ xmmsc_result_t *xmmsc_broadcast_medialib_entry_changed (xmmsc_connection_t *c) X
 xmmsc_result_t *xmmsc_broadcast_medialib_entry_updated (xmmsc_connection_t *c) XMMS_PUBLIC;
 xmmsc_result_t *xmmsc_broadcast_medialib_entry_added (xmmsc_connection_t *c) XMMS_PUBLIC;
 xmmsc_result_t *xmmsc_broadcast_medialib_entry_removed (xmmsc_connection_t *c) XMMS_PUBLIC;
+xmmsc_result_t *xmmsc_broadcast_medialib_import_progress (xmmsc_connection_t *c) XMMS_PUBLIC;
 
 
 /*
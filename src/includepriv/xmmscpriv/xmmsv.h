@@ -17,6 +17,7 @@
 #ifndef __XMMSV_INTERNAL_H__
 #define __XMMSV_INTERNAL_H__
 
+#include <stddef.h>
 #include <stdint.h>
 
 #include <xmmsc/xmmsv.h>
@@ -52,12 +53,50 @@ struct xmmsv_St {
 	xmmsv_type_t type;
 
 	int ref;  /* refcounting */
+	bool frozen; /* see xmmsv_freeze, refcount is atomic */
 };
 
+/* Frozen values are shared between threads, so their refcount and the
+ * iterator lists of frozen lists and dicts need atomic operations.
+ * The allocator and the dict key cache keep per-thread state. */
+#if defined(__GNUC__)
+# define X_THREAD_LOCAL __thread
+# define x_atomic_int_inc(p) ((void) __sync_add_and_fetch ((p), 1))
+# define x_atomic_int_dec_and_test(p) (__sync_sub_and_fetch ((p), 1) == 0)
+# define x_spin_lock(p) while (__sync_lock_test_and_set ((p), 1)) { }
+# define x_spin_unlock(p) __sync_lock_release (p)
+#elif defined(_MSC_VER)
+# include <intrin.h>
+# define X_THREAD_LOCAL __declspec(thread)
+# define x_atomic_int_inc(p) ((void) _InterlockedIncrement ((long *) (p)))
+# define x_atomic_int_dec_and_test(p) (_InterlockedDecrement ((long *) (p)) == 0)
+# define x_spin_lock(p) while (_InterlockedExchange ((long *) (p), 1)) { }
+# define x_spin_unlock(p) _InterlockedExchange ((long *) (p), 0)
+#else
+# error "No atomic operations for this compiler"
+#endif
+
+/* Values are allocated in blocks of two sizes, see xmmsv_alloc.c.
+ * Strings that fit are stored in the block right after the value. */
+#define XMMSV_BLOCK_SMALL 64
+#define XMMSV_BLOCK_LARGE 128
+#define XMMSV_INLINE_DATA(val) ((char *) ((val) + 1))
+
+/* Breaks the build if a type allocated in blocks outgrows them */
+#define XMMSV_BLOCK_ASSERT_FITS(type) \
+	typedef char type##_fits_block[sizeof (type) <= XMMSV_BLOCK_LARGE ? 1 : -1]
+
+void *_xmmsv_block_alloc (size_t size);
+void _xmmsv_block_free (void *block, size_t size);
+
 xmmsv_t *_xmmsv_new (xmmsv_type_t type);
 
 void _xmmsv_list_free (xmmsv_list_internal_t *dict);
 void _xmmsv_dict_free (xmmsv_dict_internal_t *dict);
 void _xmmsv_coll_free (xmmsv_coll_internal_t *coll);
 
+void _xmmsv_list_freeze (xmmsv_list_internal_t *list);
+void _xmmsv_dict_freeze (xmmsv_dict_internal_t *dict);
+void _xmmsv_coll_freeze (xmmsv_coll_internal_t *coll);
+
 #endif
@@ -44,6 +44,7 @@ typedef struct xmms_coll_dag_St xmms_coll_dag_t;
 #include <xmms/xmms_error.h>
 #include <xmmsc/xmmsv_coll.h>
 #include <xmmspriv/xmms_playlist.h>
+#include <xmmspriv/xmms_playlist_index.h>
 #include <xmmspriv/xmms_medialib.h>
 
 typedef void (*FuncApplyToColl)(xmms_coll_dag_t *dag, xmmsv_t *coll, xmmsv_t *parent, void *udata);
@@ -65,7 +66,9 @@ void xmms_collection_apply_to_collection (xmms_coll_dag_t *dag, xmmsv_t *coll, F
 xmmsv_t * xmms_collection_get_pointer (xmms_coll_dag_t *dag, const gchar *collname, guint namespace);
 void xmms_collection_update_pointer (xmms_coll_dag_t *dag, const gchar *name, xmms_collection_namespace_id_t nsid, xmmsv_t *newtarget);
 gchar * xmms_collection_find_alias (xmms_coll_dag_t *dag, xmms_collection_namespace_id_t nsid, xmmsv_t *value, const gchar *key);
+xmms_playlist_index_t *xmms_collection_get_playlist_index (xmms_coll_dag_t *dag);
 xmms_medialib_entry_t xmms_collection_get_random_media (xmms_coll_dag_t *dag, xmmsv_t *source);
+xmmsv_t *xmms_collection_get_random_media_list (xmms_coll_dag_t *dag, xmmsv_t *source, gint count);
 
 xmms_collection_namespace_id_t xmms_collection_get_namespace_id (const gchar *namespace);
 const gchar *xmms_collection_get_namespace_string (xmms_collection_namespace_id_t nsid);
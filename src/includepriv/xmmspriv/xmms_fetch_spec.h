@@ -44,6 +44,7 @@ struct xmms_fetch_spec_St {
 		FETCH_ORGANIZE,
 		FETCH_METADATA,
 		FETCH_COUNT,
+		FETCH_COLUMNS,
 		FETCH_END
 	} type;
 	union {
@@ -76,6 +77,11 @@ struct xmms_fetch_spec_St {
 			const char **keys;
 			xmms_fetch_spec_t **data;
 		} organize;
+		struct {
+			int count;
+			const char **fields;
+			int *cols;
+		} columns;
 	} data;
 };
 
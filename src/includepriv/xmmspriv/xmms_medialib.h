@@ -28,11 +28,13 @@ typedef struct xmms_medialib_session_St xmms_medialib_session_t;
 #include <xmmspriv/xmms_collection.h>
 #include <xmmspriv/xmms_fetch_info.h>
 #include <xmmspriv/xmms_fetch_spec.h>
+#include <xmmspriv/xmms_medialib_unplayable.h>
 #include <s4.h>
 
 xmms_medialib_t *xmms_medialib_init (void);
 s4_t *xmms_medialib_get_database_backend (xmms_medialib_t *medialib);
 s4_sourcepref_t *xmms_medialib_get_source_preferences (xmms_medialib_t *medialib);
+xmms_medialib_unplayable_t *xmms_medialib_get_unplayable (xmms_medialib_t *medialib);
 char *xmms_medialib_uuid (xmms_medialib_t *mlib);
 s4_resultset_t *xmms_medialib_session_query (xmms_medialib_session_t *s, s4_fetchspec_t *spec, s4_condition_t *cond);
 
@@ -44,6 +46,7 @@ xmms_medialib_entry_t xmms_medialib_entry_new_encoded (xmms_medialib_session_t *
 
 void xmms_medialib_entry_remove (xmms_medialib_session_t *s, xmms_medialib_entry_t entry);
 void xmms_medialib_entry_cleanup (xmms_medialib_session_t *s, xmms_medialib_entry_t entry);
+void xmms_medialib_entry_properties_set (xmms_medialib_session_t *s, xmms_medialib_entry_t entry, xmmsv_t *properties, gboolean cleanup, guint *written, guint *skipped);
 
 gint xmms_medialib_entry_property_get_int (xmms_medialib_session_t *s, xmms_medialib_entry_t entry, const gchar *property);
 gchar *xmms_medialib_entry_property_get_str (xmms_medialib_session_t *s, xmms_medialib_entry_t entry, const gchar *property);
@@ -62,6 +65,7 @@ gboolean xmms_medialib_check_id (xmms_medialib_session_t *s, xmms_medialib_entry
 xmmsv_t *xmms_medialib_add_recursive (xmms_medialib_t *medialib, const gchar *path, xmms_error_t *error);
 
 xmms_medialib_entry_t xmms_medialib_query_random_id (xmms_medialib_session_t *s, xmmsv_t *coll);
+xmmsv_t *xmms_medialib_query_random_ids (xmms_medialib_session_t *s, xmmsv_t *coll, gint count);
 
 xmmsv_t *xmms_medialib_query (xmms_medialib_session_t *s, xmmsv_t *coll, xmmsv_t *fetch, xmms_error_t *err);
 s4_resultset_t *xmms_medialib_query_recurs (xmms_medialib_session_t *session, xmmsv_t *coll, xmms_fetch_info_t *fetch);
@@ -75,6 +79,7 @@ gboolean xmms_medialib_session_commit (xmms_medialib_session_t *session);
 s4_resultset_t *xmms_medialib_session_query (xmms_medialib_session_t *session, s4_fetchspec_t *specification, s4_condition_t *condition);
 s4_sourcepref_t *xmms_medialib_session_get_source_preferences (xmms_medialib_session_t *session);
 void xmms_medialib_session_track_garbage (xmms_medialib_session_t *session, xmmsv_t *data);
+gint xmms_medialib_session_property_add (xmms_medialib_session_t *session, xmms_medialib_entry_t entry, const gchar *key, const s4_val_t *value, const gchar *source);
 gint xmms_medialib_session_property_set (xmms_medialib_session_t *session, xmms_medialib_entry_t entry, const gchar *key, const s4_val_t *value, const gchar *source);
 gint xmms_medialib_session_property_unset (xmms_medialib_session_t *session, xmms_medialib_entry_t entry, const gchar *key, const s4_val_t *value, const gchar *source);
 
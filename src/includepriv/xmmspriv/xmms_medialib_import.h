@@ -0,0 +1,32 @@
+/*  XMMS2 - X Music Multiplexer System
+ *  Copyright (C) 2003-2013 XMMS2 Team
+ *
+ *  PLUGINS ARE NOT CONSIDERED TO BE DERIVED WORK !!!
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ */
+
+#ifndef __XMMS_MEDIALIB_IMPORT_H__
+#define __XMMS_MEDIALIB_IMPORT_H__
+
+#include <glib.h>
+#include <xmms/xmms_error.h>
+#include <xmmspriv/xmms_medialib.h>
+
+typedef struct xmms_medialib_import_St xmms_medialib_import_t;
+
+xmms_medialib_import_t *xmms_medialib_import_new (xmms_medialib_t *medialib);
+void xmms_medialib_import_free (xmms_medialib_import_t *import);
+
+gint32 xmms_medialib_import_start (xmms_medialib_import_t *import, const gchar *path);
+gboolean xmms_medialib_import_run (xmms_medialib_import_t *import, const gchar *path, xmms_error_t *err);
+
+#endif
@@ -0,0 +1,33 @@
+/*  XMMS2 - X Music Multiplexer System
+ *  Copyright (C) 2003-2013 XMMS2 Team
+ *
+ *  PLUGINS ARE NOT CONSIDERED TO BE DERIVED WORK !!!
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ */
+
+#ifndef __XMMS_MEDIALIB_UNPLAYABLE_H__
+#define __XMMS_MEDIALIB_UNPLAYABLE_H__
+
+#include <glib.h>
+
+typedef struct xmms_medialib_unplayable_St xmms_medialib_unplayable_t;
+
+xmms_medialib_unplayable_t *xmms_medialib_unplayable_new (const gchar *path);
+void xmms_medialib_unplayable_free (xmms_medialib_unplayable_t *unplayable);
+
+void xmms_medialib_unplayable_add (xmms_medialib_unplayable_t *unplayable, const gchar *url, const gchar *fingerprint, const gchar *chain);
+void xmms_medialib_unplayable_remove (xmms_medialib_unplayable_t *unplayable, const gchar *url);
+gboolean xmms_medialib_unplayable_contains (xmms_medialib_unplayable_t *unplayable, const gchar *url);
+gboolean xmms_medialib_unplayable_lookup (xmms_medialib_unplayable_t *unplayable, const gchar *url, const gchar *fingerprint);
+gboolean xmms_medialib_unplayable_save (xmms_medialib_unplayable_t *unplayable);
+
+#endif
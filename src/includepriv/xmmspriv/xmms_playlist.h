@@ -59,6 +59,8 @@ GList * xmms_playlist_list (xmms_playlist_t *playlist, const gchar *plname, xmms
 
 void xmms_playlist_add_entry (xmms_playlist_t *playlist, const gchar *plname, xmms_medialib_entry_t file, xmms_error_t *err);
 void xmms_playlist_insert_entry (xmms_playlist_t *playlist, const gchar *plname, gint32 pos, xmms_medialib_entry_t file, xmms_error_t *err);
+void xmms_playlist_add_entries (xmms_playlist_t *playlist, const gchar *plname, xmmsv_t *ids, xmms_error_t *err);
+void xmms_playlist_insert_entries (xmms_playlist_t *playlist, const gchar *plname, gint32 pos, xmmsv_t *ids, xmms_error_t *err);
 
 /*
  * Entry modifications
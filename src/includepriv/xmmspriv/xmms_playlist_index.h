@@ -0,0 +1,44 @@
+/*  XMMS2 - X Music Multiplexer System
+ *  Copyright (C) 2003-2013 XMMS2 Team
+ *
+ *  PLUGINS ARE NOT CONSIDERED TO BE DERIVED WORK !!!
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ */
+
+#ifndef __XMMS_PLAYLIST_INDEX_H__
+#define __XMMS_PLAYLIST_INDEX_H__
+
+#include <glib.h>
+#include <xmmsc/xmmsv.h>
+#include <xmms/xmms_medialib.h>
+
+typedef struct xmms_playlist_index_St xmms_playlist_index_t;
+
+xmms_playlist_index_t *xmms_playlist_index_new (void);
+void xmms_playlist_index_free (xmms_playlist_index_t *index);
+
+void xmms_playlist_index_bind (xmms_playlist_index_t *index, xmmsv_t *plcoll);
+void xmms_playlist_index_unbind (xmms_playlist_index_t *index, xmmsv_t *plcoll);
+void xmms_playlist_index_reset (xmms_playlist_index_t *index, xmmsv_t *plcoll);
+
+void xmms_playlist_index_add (xmms_playlist_index_t *index, xmmsv_t *plcoll, xmms_medialib_entry_t id);
+void xmms_playlist_index_add_list (xmms_playlist_index_t *index, xmmsv_t *plcoll, xmmsv_t *ids);
+void xmms_playlist_index_remove (xmms_playlist_index_t *index, xmmsv_t *plcoll, xmms_medialib_entry_t id);
+
+gint xmms_playlist_index_count (xmms_playlist_index_t *index, xmmsv_t *plcoll, xmms_medialib_entry_t id);
+GList *xmms_playlist_index_lookup (xmms_playlist_index_t *index, xmms_medialib_entry_t id);
+
+gint xmms_playlist_index_record (xmms_playlist_index_t *index, xmmsv_t *plcoll, xmmsv_t *change);
+gint xmms_playlist_index_revision (xmms_playlist_index_t *index, xmmsv_t *plcoll);
+xmmsv_t *xmms_playlist_index_changes_since (xmms_playlist_index_t *index, xmmsv_t *plcoll, gint revision);
+
+#endif
@@ -24,6 +24,9 @@
 
 typedef struct xmms_xform_object_St xmms_xform_object_t;
 
+/* Goal type of a chain set up only to read the metadata of an entry */
+#define XMMS_XFORM_PROBE_MIMETYPE "application/x-xmms2-probe"
+
 xmms_xform_object_t *xmms_xform_object_init (void);
 
 xmms_xform_t *xmms_xform_new (xmms_xform_plugin_t *plugin, xmms_xform_t *prev, xmms_medialib_t *medialib, xmms_medialib_entry_t entry, GList *goal_hints);
@@ -34,6 +37,8 @@ xmms_stream_type_t *xmms_xform_outtype_get (xmms_xform_t *xform);
 xmms_plugin_t *xmms_xform_plugin_new (void);
 gboolean xmms_xform_plugin_verify (xmms_plugin_t *plugin);
 
+xmms_xform_t *xmms_converter_new (xmms_xform_t *prev, xmms_medialib_t *medialib, xmms_medialib_entry_t entry, GList *goal_hints);
+
 xmms_xform_t *xmms_xform_chain_setup (xmms_medialib_t *medialib, xmms_medialib_entry_t entry, GList *goal_formats, gboolean rehash);
 xmms_xform_t *xmms_xform_chain_setup_session (xmms_medialib_t *medialib, xmms_medialib_session_t *session, xmms_medialib_entry_t entry, GList *goal_fmts, gboolean rehash);
 xmms_xform_t *xmms_xform_chain_setup_url_session (xmms_medialib_t *medialib, xmms_medialib_session_t *session, xmms_medialib_entry_t entry, const gchar *url, GList *goal_fmts, gboolean rehash);
@@ -52,6 +57,8 @@ xmmsv_t *xmms_xform_browse_method (xmms_xform_t *xform, const gchar *url, xmms_e
 
 const char *xmms_xform_indata_find_str (xmms_xform_t *xform, xmms_stream_type_key_t key);
 
+xmmsv_t *xmms_xform_metadata_stats (void);
+
 #define XMMS_XFORM_BUILTIN(shname, name, ver, desc, setupfunc) XMMS_BUILTIN(XMMS_PLUGIN_TYPE_XFORM, XMMS_XFORM_API_VERSION, shname, name, ver, desc, (gboolean (*)(gpointer))setupfunc)
 
 #endif
@@ -225,6 +225,124 @@ xmms_ipc_msg_write_transport (xmms_ipc_msg_t *msg,
 	return (len == msg->xfered);
 }
 
+/**
+ * Try to write several messages to transport with a single write.
+ *
+ * The unsent parts of the messages are gathered in a buffer of at most
+ * XMMS_IPC_MSG_WRITE_MAX bytes, a first message larger than that is
+ * written on its own.
+ *
+ * @returns the number of messages that were fully written.
+ */
+int
+xmms_ipc_msg_write_transport_many (xmms_ipc_msg_t **msgs, int count,
+                                   xmms_ipc_transport_t *transport,
+                                   bool *disconnected)
+{
+	char buf[XMMS_IPC_MSG_WRITE_MAX];
+	unsigned int len, pos, ret;
+	int i, n;
+
+	x_return_val_if_fail (msgs, 0);
+	x_return_val_if_fail (transport, 0);
+
+	for (n = 0, pos = 0; n < count; n++) {
+		xmmsv_bitbuffer_align (msgs[n]->bb);
+		len = xmmsv_bitbuffer_len (msgs[n]->bb) / 8 - msgs[n]->xfered;
+
+		if (pos + len > sizeof (buf)) {
+			break;
+		}
+
+		memcpy (buf + pos, xmmsv_bitbuffer_buffer (msgs[n]->bb) + msgs[n]->xfered, len);
+		pos += len;
+	}
+
+	if (n < 2) {
+		return xmms_ipc_msg_write_transport (msgs[0], transport, disconnected) ? 1 : 0;
+	}
+
+	ret = xmms_ipc_transport_write (transport, buf, pos);
+
+	if (ret == SOCKET_ERROR) {
+		if (!xmms_socket_error_recoverable () && disconnected) {
+			*disconnected = true;
+		}
+		return 0;
+	} else if (!ret) {
+		if (disconnected) {
+			*disconnected = true;
+		}
+		return 0;
+	}
+
+	/* account the written bytes to the messages they came from */
+	for (i = 0; i < n && ret > 0; i++) {
+		len = xmmsv_bitbuffer_len (msgs[i]->bb) / 8 - msgs[i]->xfered;
+		if (len > ret) {
+			len = ret;
+		}
+		msgs[i]->xfered += len;
+		ret -= len;
+	}
+
+	for (i = 0; i < n; i++) {
+		if (msgs[i]->xfered < xmmsv_bitbuffer_len (msgs[i]->bb) / 8) {
+			break;
+		}
+	}
+
+	return i;
+}
+
+/**
+ * Append received data to a partially read message.
+ *
+ * @param complete Set to TRUE when the message is fully read.
+ * @returns the number of bytes taken from buf, the rest belongs to
+ * the following messages.
+ */
+unsigned int
+xmms_ipc_msg_put_data (xmms_ipc_msg_t *msg, const char *buf, unsigned int len,
+                       bool *complete)
+{
+	unsigned int used = 0, want, n;
+
+	x_return_val_if_fail (msg, 0);
+
+	*complete = false;
+
+	while (true) {
+		want = XMMS_IPC_MSG_HEAD_LEN;
+
+		if (msg->xfered >= XMMS_IPC_MSG_HEAD_LEN) {
+			want += xmms_ipc_msg_get_length (msg);
+
+			if (msg->xfered == want) {
+				*complete = true;
+				return used;
+			}
+		}
+
+		x_return_val_if_fail (msg->xfered < want, used);
+
+		if (used == len) {
+			return used;
+		}
+
+		n = want - msg->xfered;
+		if (n > len - used)
+			n = len - used;
+
+		xmmsv_bitbuffer_goto (msg->bb, msg->xfered * 8);
+		xmmsv_bitbuffer_put_data (msg->bb, (const unsigned char *) buf + used, n);
+		msg->xfered += n;
+		xmmsv_bitbuffer_goto (msg->bb, XMMS_IPC_MSG_HEAD_LEN * 8);
+
+		used += n;
+	}
+}
+
 /**
  * Try to read message from transport into msg.
  *
@@ -237,6 +355,7 @@ xmms_ipc_msg_read_transport (xmms_ipc_msg_t *msg,
 {
 	char buf[512];
 	unsigned int ret, len, rlen;
+	bool complete;
 
 	x_return_val_if_fail (msg, false);
 	x_return_val_if_fail (transport, false);
@@ -277,10 +396,7 @@ xmms_ipc_msg_read_transport (xmms_ipc_msg_t *msg,
 
 			return false;
 		} else {
-			xmmsv_bitbuffer_goto (msg->bb, msg->xfered * 8);
-			xmmsv_bitbuffer_put_data (msg->bb, (unsigned char *) buf, ret);
-			msg->xfered += ret;
-			xmmsv_bitbuffer_goto (msg->bb, XMMS_IPC_MSG_HEAD_LEN * 8);
+			xmms_ipc_msg_put_data (msg, buf, ret, &complete);
 		}
 	}
 }
@@ -0,0 +1,322 @@
+/*  XMMS2 - X Music Multiplexer System
+ *  Copyright (C) 2003-2013 XMMS2 Team
+ *
+ *  PLUGINS ARE NOT CONSIDERED TO BE DERIVED WORK !!!
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ */
+
+/** @file
+ * Block allocator for values.
+ *
+ * Every #xmmsv_t, together with the characters of a short string stored
+ * right after it, lives in a block of one of two sizes, and so do the
+ * list and dict internals and their iterators. Freed blocks go to a free
+ * list of the freeing thread and are handed out again by the next
+ * allocation on that thread, so building and dropping large values
+ * mostly avoids malloc. A free list that grows too long gives a batch
+ * of blocks to a shared depot, which threads refill from before carving
+ * a new slab.
+ *
+ * Slabs are never returned to the system but stay reachable from the
+ * slab registry. When a thread exits its free lists go to the depot, so
+ * threads that come and go don't strand their blocks. Set XMMSV_NO_SLAB in the environment to allocate each block
+ * with malloc instead, for example when checking for memory errors with
+ * valgrind.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+# include <windows.h>
+#else
+# include <pthread.h>
+#endif
+
+#include <xmmscpriv/xmmsv.h>
+#include <xmmscpriv/xmmsc_util.h>
+
+#define SLAB_SIZE 8192
+#define CACHE_MAX 1024
+#define BATCH 512
+
+typedef struct xmmsv_block_St xmmsv_block_t;
+
+struct xmmsv_block_St {
+	xmmsv_block_t *next;
+	xmmsv_block_t *next_batch; /* only used in the depot */
+	int batch_count;           /* only used in the depot */
+};
+
+typedef struct {
+	xmmsv_block_t *free;
+	int count;
+} xmmsv_block_cache_t;
+
+static const int block_sizes[2] = { XMMSV_BLOCK_SMALL, XMMSV_BLOCK_LARGE };
+
+static X_THREAD_LOCAL xmmsv_block_cache_t caches[2];
+static X_THREAD_LOCAL int slab_enabled = -1;
+static X_THREAD_LOCAL int cache_registered;
+
+#ifdef _WIN32
+static INIT_ONCE cache_once = INIT_ONCE_STATIC_INIT;
+static DWORD cache_key;
+#else
+static pthread_once_t cache_once = PTHREAD_ONCE_INIT;
+static pthread_key_t cache_key;
+#endif
+
+/* batches of BATCH blocks given back by threads, and all slabs */
+static int depot_lock;
+static xmmsv_block_t *depot[2];
+static void **slabs;
+static int slabs_len;
+static int slabs_allocated;
+
+static int
+_xmmsv_slab_enabled (void)
+{
+	if (slab_enabled < 0) {
+		slab_enabled = getenv ("XMMSV_NO_SLAB") == NULL;
+	}
+
+	return slab_enabled;
+}
+
+static int
+_xmmsv_slab_register (void *slab)
+{
+	void **newmem;
+	int ret = 1;
+
+	x_spin_lock (&depot_lock);
+
+	if (slabs_len == slabs_allocated) {
+		slabs_allocated = slabs_allocated ? slabs_allocated * 2 : 64;
+		newmem = realloc (slabs, slabs_allocated * sizeof (void *));
+		if (newmem) {
+			slabs = newmem;
+		} else {
+			slabs_allocated = slabs_len;
+			ret = 0;
+		}
+	}
+
+	if (ret) {
+		slabs[slabs_len++] = slab;
+	}
+
+	x_spin_unlock (&depot_lock);
+
+	return ret;
+}
+
+static void
+_xmmsv_block_depot_push (int cls, xmmsv_block_t *batch, int count)
+{
+	batch->batch_count = count;
+
+	x_spin_lock (&depot_lock);
+	batch->next_batch = depot[cls];
+	depot[cls] = batch;
+	x_spin_unlock (&depot_lock);
+}
+
+/* Run when a thread that used the caches exits */
+static void
+#ifdef _WIN32
+WINAPI
+#endif
+_xmmsv_block_cache_release (void *data)
+{
+	int cls;
+
+	for (cls = 0; cls < 2; cls++) {
+		if (caches[cls].free) {
+			_xmmsv_block_depot_push (cls, caches[cls].free, caches[cls].count);
+		}
+		caches[cls].free = NULL;
+		caches[cls].count = 0;
+	}
+
+	/* blocks freed by destructors running after this one register
+	 * the caches again */
+	cache_registered = 0;
+}
+
+#ifdef _WIN32
+static BOOL CALLBACK
+_xmmsv_block_cache_key_create (PINIT_ONCE once, void *param, void **ctx)
+{
+	cache_key = FlsAlloc (_xmmsv_block_cache_release);
+	return cache_key != FLS_OUT_OF_INDEXES;
+}
+#else
+static void
+_xmmsv_block_cache_key_create (void)
+{
+	pthread_key_create (&cache_key, _xmmsv_block_cache_release);
+}
+#endif
+
+static void
+_xmmsv_block_cache_register (void)
+{
+	/* any non-NULL value gets the destructor called */
+#ifdef _WIN32
+	if (InitOnceExecuteOnce (&cache_once, _xmmsv_block_cache_key_create,
+	                         NULL, NULL)) {
+		FlsSetValue (cache_key, caches);
+	}
+#else
+	pthread_once (&cache_once, _xmmsv_block_cache_key_create);
+	pthread_setspecific (cache_key, caches);
+#endif
+
+	cache_registered = 1;
+}
+
+static int
+_xmmsv_block_refill (int cls)
+{
+	xmmsv_block_cache_t *cache = &caches[cls];
+	xmmsv_block_t *block;
+	char *slab;
+	int i, n;
+
+	x_spin_lock (&depot_lock);
+	block = depot[cls];
+	if (block) {
+		depot[cls] = block->next_batch;
+	}
+	x_spin_unlock (&depot_lock);
+
+	if (block) {
+		cache->free = block;
+		cache->count = block->batch_count;
+		return 1;
+	}
+
+	slab = malloc (SLAB_SIZE);
+	if (!slab) {
+		return 0;
+	}
+
+	if (!_xmmsv_slab_register (slab)) {
+		free (slab);
+		return 0;
+	}
+
+	n = SLAB_SIZE / block_sizes[cls];
+	for (i = n - 1; i >= 0; i--) {
+		block = (xmmsv_block_t *) (slab + i * block_sizes[cls]);
+		block->next = cache->free;
+		cache->free = block;
+	}
+	cache->count += n;
+
+	return 1;
+}
+
+static void
+_xmmsv_block_spill (int cls)
+{
+	xmmsv_block_cache_t *cache = &caches[cls];
+	xmmsv_block_t *batch, *last;
+	int i;
+
+	batch = last = cache->free;
+	for (i = 1; i < BATCH; i++) {
+		last = last->next;
+	}
+
+	cache->free = last->next;
+	cache->count -= BATCH;
+	last->next = NULL;
+
+	_xmmsv_block_depot_push (cls, batch, BATCH);
+}
+
+/**
+ * Allocate a block for a value.
+ * @internal
+ *
+ * @param size The size needed, at most #XMMSV_BLOCK_LARGE.
+ * @return The zero filled block, or NULL if out of memory.
+ */
+void *
+_xmmsv_block_alloc (size_t size)
+{
+	xmmsv_block_cache_t *cache;
+	xmmsv_block_t *block;
+	int cls;
+
+	x_return_null_if_fail (size <= XMMSV_BLOCK_LARGE);
+
+	cls = size > XMMSV_BLOCK_SMALL;
+
+	if (!_xmmsv_slab_enabled ()) {
+		return calloc (1, size);
+	}
+
+	cache = &caches[cls];
+	if (!cache->free) {
+		if (!cache_registered) {
+			_xmmsv_block_cache_register ();
+		}
+		if (!_xmmsv_block_refill (cls)) {
+			return NULL;
+		}
+	}
+
+	block = cache->free;
+	cache->free = block->next;
+	cache->count--;
+
+	return memset (block, 0, size);
+}
+
+/**
+ * Give back a block from #_xmmsv_block_alloc.
+ * @internal
+ *
+ * @param ptr The block.
+ * @param size The size it was allocated with.
+ */
+void
+_xmmsv_block_free (void *ptr, size_t size)
+{
+	xmmsv_block_cache_t *cache;
+	xmmsv_block_t *block = ptr;
+	int cls;
+
+	if (!_xmmsv_slab_enabled ()) {
+		free (ptr);
+		return;
+	}
+
+	if (!cache_registered) {
+		_xmmsv_block_cache_register ();
+	}
+
+	cls = size > XMMSV_BLOCK_SMALL;
+	cache = &caches[cls];
+
+	block->next = cache->free;
+	cache->free = block;
+	cache->count++;
+
+	if (cache->count > CACHE_MAX) {
+		_xmmsv_block_spill (cls);
+	}
+}
@@ -124,6 +124,7 @@ xmmsv_bitbuffer_put_bits (xmmsv_t *v, int bits, int64_t d)
 	int i;
 
 	x_api_error_if (v->value.bit.ro, "write to readonly bitbuffer", 0);
+	x_api_error_if (v->frozen, "write to frozen bitbuffer", 0);
 	x_api_error_if (bits < 1, "less than one bit requested", 0);
 
 	if (bits == 1) {
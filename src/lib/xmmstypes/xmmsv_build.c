@@ -277,3 +277,32 @@ xmmsv_t *xmmsv_build_count ()
 	xmmsv_dict_set_string (res, "type", "count");
 	return res;
 }
+
+/**
+ * Creates a columns fetch specification. The result holds one list per
+ * field, with string values replaced by their index in a shared list of
+ * strings.
+ *
+ * @param fields A list of fields to fetch
+ * @param sourcepref A list of sources, first one has the highest priority
+ * @return A new columns fetch specification
+ */
+xmmsv_t *xmmsv_build_columns (xmmsv_t *fields, xmmsv_t *sourcepref)
+{
+	xmmsv_t *res = xmmsv_new_dict ();
+	if (res == NULL)
+		return NULL;
+
+	xmmsv_dict_set_string (res, "type", "columns");
+
+	if (fields != NULL) {
+		xmmsv_dict_set (res, "fields", fields);
+		xmmsv_unref (fields);
+	}
+	if (sourcepref != NULL) {
+		xmmsv_dict_set (res, "source-preference", sourcepref);
+		xmmsv_unref (sourcepref);
+	}
+
+	return res;
+}
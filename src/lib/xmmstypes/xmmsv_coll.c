@@ -159,6 +159,14 @@ _xmmsv_coll_free (xmmsv_coll_internal_t *coll)
 	free (coll);
 }
 
+void
+_xmmsv_coll_freeze (xmmsv_coll_internal_t *coll)
+{
+	xmmsv_freeze (coll->operands);
+	xmmsv_freeze (coll->attributes);
+	xmmsv_freeze (coll->idlist);
+}
+
 /**
  * Set the list of ids in the given collection.
  * The list must be 0-terminated.
@@ -436,6 +444,7 @@ xmmsv_coll_idlist_set (xmmsv_t *coll, xmmsv_t *idlist)
 
 	x_return_if_fail (coll);
 	x_return_if_fail (idlist);
+	x_api_error_if (coll->frozen, "on a frozen collection",);
 	x_return_if_fail (xmmsv_list_restrict_type (idlist, XMMSV_TYPE_INT64));
 
 	old = coll->value.coll->idlist;
@@ -464,6 +473,7 @@ xmmsv_coll_operands_set (xmmsv_t *coll, xmmsv_t *operands)
 
 	x_return_if_fail (coll);
 	x_return_if_fail (operands);
+	x_api_error_if (coll->frozen, "on a frozen collection",);
 	x_return_if_fail (xmmsv_list_restrict_type (operands, XMMSV_TYPE_COLL));
 
 	old = coll->value.coll->operands;
@@ -492,6 +502,7 @@ xmmsv_coll_attributes_set (xmmsv_t *coll, xmmsv_t *attributes)
 
 	x_return_if_fail (coll);
 	x_return_if_fail (attributes);
+	x_api_error_if (coll->frozen, "on a frozen collection",);
 	x_return_if_fail (xmmsv_is_type (attributes, XMMSV_TYPE_DICT));
 
 	old = coll->value.coll->attributes;
@@ -20,18 +20,34 @@
 #include <xmmscpriv/xmmsv.h>
 #include <xmmscpriv/xmms_list.h>
 
-typedef struct xmmsv_dict_data_St {
+/* Keys carry their hash. Short keys are interned, shared by every dict
+ * using them and never freed, up to MAX_INTERNED of them; other keys
+ * belong to the entry holding them. */
+typedef struct xmmsv_dict_key_St {
 	uint32_t hash;
-	char *str;
+	bool interned;
+	char str[];
+} xmmsv_dict_key_t;
+
+typedef struct xmmsv_dict_data_St {
+	xmmsv_dict_key_t *key;
 	xmmsv_t *value;
 } xmmsv_dict_data_t;
 
+#define INLINE_ELEMS 6
+
 struct xmmsv_dict_internal_St {
 	int elems;
-	int size;
+	int size; /* log2 of the hash table size, 0 while data is inline_data */
 	xmmsv_dict_data_t *data;
 
 	x_list_t *iterators;
+	int iterators_lock; /* only taken when frozen */
+	bool frozen;
+
+	/* Small dicts keep their entries here, in insertion order, and are
+	 * searched without hashing. Fills a large value block. */
+	xmmsv_dict_data_t inline_data[INLINE_ELEMS];
 };
 
 struct xmmsv_dict_iter_St {
@@ -39,13 +55,34 @@ struct xmmsv_dict_iter_St {
 	xmmsv_dict_internal_t *parent;
 };
 
+XMMSV_BLOCK_ASSERT_FITS (xmmsv_dict_internal_t);
+XMMSV_BLOCK_ASSERT_FITS (xmmsv_dict_iter_t);
+
+typedef struct {
+	const char *str;
+	xmmsv_dict_key_t *key;
+} xmmsv_dict_key_cache_t;
+
 static void _xmmsv_dict_iter_free (xmmsv_dict_iter_t *it);
 
 #define HASH_MASK(table) ((1 << (table)->size) - 1)
 #define HASH_FILL_LIM 7
-#define DELETED_STR ((char*)-1)
-#define DICT_INIT_DATA(s) {.hash = _xmmsv_dict_hash (s, strlen (s)), .str = (char*)s}
-#define START_SIZE 2
+#define DELETED_KEY ((xmmsv_dict_key_t *) -1)
+#define TABLE_START_SIZE 4
+#define SLOTS(table) ((table)->size ? 1 << (table)->size : (table)->elems)
+#define IS_ENTRY(table, i) ((table)->data[i].key != NULL && (table)->data[i].key != DELETED_KEY)
+
+#define MAX_INTERNED 4096
+#define MAX_INTERNED_LEN 64
+#define KEY_CACHE_SIZE 64
+
+static int interned_lock;
+static xmmsv_dict_key_t **interned;
+static int interned_count;
+static int interned_alloc;
+
+/* the interned keys last asked for by address, checked with strcmp */
+static X_THREAD_LOCAL xmmsv_dict_key_cache_t key_cache[KEY_CACHE_SIZE];
 
 /* MurmurHash2, by Austin Appleby */
 static uint32_t
@@ -99,30 +136,160 @@ _xmmsv_dict_hash (const void *key, int len)
 	return h;
 }
 
-/* Searches the hash table for an entry matching the hash and string in data.
- * It will save the found position in pos.
- * If a deleted position was found before the key, it will be saved in deleted
+static xmmsv_dict_key_t *
+_xmmsv_dict_key_alloc (const char *str, int len, uint32_t hash, bool intern)
+{
+	xmmsv_dict_key_t *key;
+
+	key = malloc (sizeof (xmmsv_dict_key_t) + len + 1);
+	if (!key) {
+		x_oom ();
+		return NULL;
+	}
+
+	key->hash = hash;
+	key->interned = intern;
+	memcpy (key->str, str, len + 1);
+
+	return key;
+}
+
+/* Finds or adds the interned key for str, with interned_lock held.
+ * Returns NULL if the key has to be allocated for the entry instead.
+ */
+static xmmsv_dict_key_t *
+_xmmsv_dict_key_intern (const char *str, int len, uint32_t hash)
+{
+	xmmsv_dict_key_t **table, *key;
+	int i, j, mask = interned_alloc - 1;
+
+	for (i = hash & mask; interned && interned[i]; i = (i + 1) & mask) {
+		if (interned[i]->hash == hash && strcmp (interned[i]->str, str) == 0) {
+			return interned[i];
+		}
+	}
+
+	if (interned_count >= MAX_INTERNED) {
+		return NULL;
+	}
+
+	/* Keep the table at most half full */
+	if (2 * (interned_count + 1) > interned_alloc) {
+		table = x_new0 (xmmsv_dict_key_t *, interned_alloc ? interned_alloc * 2 : 64);
+		if (!table) {
+			return NULL;
+		}
+
+		mask = (interned_alloc ? interned_alloc * 2 : 64) - 1;
+		for (i = 0; i < interned_alloc; i++) {
+			if (interned[i]) {
+				for (j = interned[i]->hash & mask; table[j]; j = (j + 1) & mask);
+				table[j] = interned[i];
+			}
+		}
+
+		free (interned);
+		interned = table;
+		interned_alloc = mask + 1;
+
+		for (i = hash & mask; interned[i]; i = (i + 1) & mask);
+	}
+
+	key = _xmmsv_dict_key_alloc (str, len, hash, true);
+	if (key) {
+		interned[i] = key;
+		interned_count++;
+	}
+
+	return key;
+}
+
+/* Returns the key to store for str in a new entry */
+static xmmsv_dict_key_t *
+_xmmsv_dict_key_get (const char *str)
+{
+	xmmsv_dict_key_cache_t *cached;
+	xmmsv_dict_key_t *key = NULL;
+	uint32_t hash;
+	int len;
+
+	cached = &key_cache[((uintptr_t) str >> 3) % KEY_CACHE_SIZE];
+	if (cached->str == str && strcmp (cached->key->str, str) == 0) {
+		return cached->key;
+	}
+
+	len = strlen (str);
+	hash = _xmmsv_dict_hash (str, len);
+
+	if (len <= MAX_INTERNED_LEN) {
+		x_spin_lock (&interned_lock);
+		key = _xmmsv_dict_key_intern (str, len, hash);
+		x_spin_unlock (&interned_lock);
+	}
+
+	if (!key) {
+		return _xmmsv_dict_key_alloc (str, len, hash, false);
+	}
+
+	cached->str = str;
+	cached->key = key;
+
+	return key;
+}
+
+static void
+_xmmsv_dict_key_free (xmmsv_dict_key_t *key)
+{
+	if (!key->interned) {
+		free (key);
+	}
+}
+
+/* Searches the dict for the entry with the given key and saves its
+ * position in pos.
+ * In the hash table, a deleted position found before the key is saved
+ * in deleted, otherwise deleted is set to -1.
  * Returns 1 if the entry was found, 0 otherwise
  */
 static int
-_xmmsv_dict_search (xmmsv_dict_internal_t *dict, xmmsv_dict_data_t data,
+_xmmsv_dict_search (xmmsv_dict_internal_t *dict, const char *key,
                     int *pos, int *deleted)
 {
-	int bucket = data.hash & HASH_MASK (dict);
-	int stop = bucket;
-	int size = 1 << dict->size;
+	xmmsv_dict_key_t *k;
+	uint32_t hash;
+	int bucket, stop, size;
 
 	*deleted = -1;
 
-	while (dict->data[bucket].str != NULL) {
+	/* Inline entries are packed, and comparing a few short keys is
+	 * cheaper than hashing. Keys taken from another dict are often
+	 * the very same interned string. */
+	if (!dict->size) {
+		for (bucket = 0; bucket < dict->elems; bucket++) {
+			k = dict->data[bucket].key;
+			if (k->str == key || (k->str[0] == key[0] && strcmp (k->str, key) == 0)) {
+				*pos = bucket;
+				return 1;
+			}
+		}
+		*pos = bucket;
+		return 0;
+	}
+
+	hash = _xmmsv_dict_hash (key, strlen (key));
+	bucket = hash & HASH_MASK (dict);
+	stop = bucket;
+	size = 1 << dict->size;
+
+	while ((k = dict->data[bucket].key) != NULL) {
 		/* If this is a free entry we save it in the free pointer */
-		if (dict->data[bucket].str == DELETED_STR) {
+		if (k == DELETED_KEY) {
 			if (*deleted == -1) {
 				*deleted = bucket;
 			}
 			/* If we found the entry we save it in the pos pointer */
-		} else if (dict->data[bucket].hash == data.hash
-		           && strcmp (dict->data[bucket].str, data.str) == 0) {
+		} else if (k->hash == hash
+		           && (k->str == key || strcmp (k->str, key) == 0)) {
 			*pos = bucket;
 			return 1;
 		}
@@ -145,28 +312,88 @@ _xmmsv_dict_search (xmmsv_dict_internal_t *dict, xmmsv_dict_data_t data,
 	return 0;
 }
 
-/* Inserts data into the hash table */
+/* Puts an entry whose key is not in the hash table into the first free
+ * or deleted bucket */
 static void
-_xmmsv_dict_insert (xmmsv_dict_internal_t *dict, xmmsv_dict_data_t data, int alloc)
+_xmmsv_dict_place (xmmsv_dict_internal_t *dict, xmmsv_dict_data_t data)
 {
-	int pos, deleted;
+	int bucket = data.key->hash & HASH_MASK (dict);
 
-	if (_xmmsv_dict_search (dict, data, &pos, &deleted)) {
-		/* If the key already exists we change the data*/
-		xmmsv_unref (dict->data[pos].value);
-		dict->data[pos].value = data.value;
-	} else {
-		/* Otherwise we insert a new entry */
-		if (alloc)
-			data.str = strdup (data.str);
-		dict->elems++;
-		/* If we found a deleted entry before an empty one we use the free entry */
-		if (deleted != -1) {
-			dict->data[deleted] = data;
-		} else {
-			dict->data[pos] = data;
+	while (IS_ENTRY (dict, bucket)) {
+		bucket = (bucket + 1) & HASH_MASK (dict);
+	}
+
+	dict->data[bucket] = data;
+}
+
+/* Moves the entries to a hash table twice the size of the old one, or
+ * out of the inline storage into the first hash table. The hashes are
+ * kept in the keys, so nothing is rehashed.
+ */
+static int
+_xmmsv_dict_resize (xmmsv_dict_internal_t *dict)
+{
+	int i, slots;
+	xmmsv_dict_data_t *old_data;
+
+	old_data = dict->data;
+	slots = SLOTS (dict);
+
+	dict->data = x_new0 (xmmsv_dict_data_t,
+	                     1 << (dict->size ? dict->size + 1 : TABLE_START_SIZE));
+	if (!dict->data) {
+		x_oom ();
+		dict->data = old_data;
+		return 0;
+	}
+
+	dict->size = dict->size ? dict->size + 1 : TABLE_START_SIZE;
+
+	/* Insert all the entries in the old table into the new one */
+	for (i = 0; i < slots; i++) {
+		if (old_data[i].key != NULL && old_data[i].key != DELETED_KEY) {
+			_xmmsv_dict_place (dict, old_data[i]);
+		}
+	}
+
+	if (old_data != dict->inline_data) {
+		free (old_data);
+	}
+
+	return 1;
+}
+
+/* Adds an entry for a key that is not in the dict yet */
+static int
+_xmmsv_dict_insert (xmmsv_dict_internal_t *dict, const char *str,
+                    xmmsv_t *value)
+{
+	xmmsv_dict_data_t data;
+
+	data.key = _xmmsv_dict_key_get (str);
+	data.value = value;
+
+	if (!data.key) {
+		return 0;
+	}
+
+	if (!dict->size && dict->elems < INLINE_ELEMS) {
+		dict->data[dict->elems++] = data;
+		return 1;
+	}
+
+	/* Resize if fill is too high */
+	if (!dict->size || ((dict->elems * 10) >> dict->size) > HASH_FILL_LIM) {
+		if (!_xmmsv_dict_resize (dict)) {
+			_xmmsv_dict_key_free (data.key);
+			return 0;
 		}
 	}
+
+	_xmmsv_dict_place (dict, data);
+	dict->elems++;
+
+	return 1;
 }
 
 /* Remove an entry at the given position
@@ -174,36 +401,51 @@ _xmmsv_dict_insert (xmmsv_dict_internal_t *dict, xmmsv_dict_data_t data, int all
 static void
 _xmmsv_dict_remove (xmmsv_dict_internal_t *dict, int pos)
 {
-	free ((void*)dict->data[pos].str);
-	dict->data[pos].str = DELETED_STR;
+	xmmsv_dict_iter_t *it;
+	x_list_t *n;
+
+	_xmmsv_dict_key_free (dict->data[pos].key);
 	xmmsv_unref (dict->data[pos].value);
-	dict->data[pos].value = NULL;
+
+	if (dict->size) {
+		dict->data[pos].key = DELETED_KEY;
+		dict->data[pos].value = NULL;
+	} else {
+		/* Keep the inline entries packed, and the iterators on the
+		 * entries they pointed at */
+		memmove (&dict->data[pos], &dict->data[pos + 1],
+		         (dict->elems - pos - 1) * sizeof (xmmsv_dict_data_t));
+		for (n = dict->iterators; n; n = n->next) {
+			it = (xmmsv_dict_iter_t *) n->data;
+			if (it->pos > pos) {
+				it->pos--;
+			}
+		}
+	}
+
 	dict->elems--;
 }
 
-/* Resizes the hash table by creating a new data table
- * twice the size of the old one
- */
+/* Drops all entries and goes back to the inline storage */
 static void
-_xmmsv_dict_resize (xmmsv_dict_internal_t *dict)
+_xmmsv_dict_clear (xmmsv_dict_internal_t *dict)
 {
 	int i;
-	xmmsv_dict_data_t *old_data;
-
-	/* Double the table size */
-	dict->size++;
-	dict->elems = 0;
-	old_data = dict->data;
-	dict->data = x_new0 (xmmsv_dict_data_t, 1 << dict->size);
 
-	/* Insert all the entries in the old table into the new one */
-	for (i = 0; i < (1 << (dict->size - 1)); i++) {
-		if (old_data[i].str != NULL) {
-			_xmmsv_dict_insert (dict, old_data[i], 0);
+	for (i = SLOTS (dict) - 1; i >= 0; i--) {
+		if (IS_ENTRY (dict, i)) {
+			_xmmsv_dict_key_free (dict->data[i].key);
+			xmmsv_unref (dict->data[i].value);
 		}
 	}
 
-	free (old_data);
+	if (dict->data != dict->inline_data) {
+		free (dict->data);
+	}
+
+	dict->data = dict->inline_data;
+	dict->size = 0;
+	dict->elems = 0;
 }
 
 static xmmsv_dict_internal_t *
@@ -211,29 +453,35 @@ _xmmsv_dict_new (void)
 {
 	xmmsv_dict_internal_t *dict;
 
-	dict = x_new0 (xmmsv_dict_internal_t, 1);
+	dict = _xmmsv_block_alloc (sizeof (xmmsv_dict_internal_t));
 	if (!dict) {
 		x_oom ();
 		return NULL;
 	}
 
-	dict->size = 2;
-	dict->data = x_new0 (xmmsv_dict_data_t, (1 << dict->size));
+	dict->data = dict->inline_data;
 
-	if (!dict->data) {
-		x_oom ();
-		free (dict);
-		return NULL;
+	return dict;
+}
+
+void
+_xmmsv_dict_freeze (xmmsv_dict_internal_t *dict)
+{
+	int i;
+
+	for (i = SLOTS (dict) - 1; i >= 0; i--) {
+		if (IS_ENTRY (dict, i)) {
+			xmmsv_freeze (dict->data[i].value);
+		}
 	}
 
-	return dict;
+	dict->frozen = true;
 }
 
 void
 _xmmsv_dict_free (xmmsv_dict_internal_t *dict)
 {
 	xmmsv_dict_iter_t *it;
-	int i;
 
 	/* free iterators */
 	while (dict->iterators) {
@@ -241,17 +489,8 @@ _xmmsv_dict_free (xmmsv_dict_internal_t *dict)
 		_xmmsv_dict_iter_free (it);
 	}
 
-	for (i = (1 << dict->size) - 1; i >= 0; i--) {
-		if (dict->data[i].str != NULL) {
-			if (dict->data[i].str != DELETED_STR) {
-				free (dict->data[i].str);
-				xmmsv_unref (dict->data[i].value);
-			}
-			dict->data[i].str = NULL;
-		}
-	}
-	free (dict->data);
-	free (dict);
+	_xmmsv_dict_clear (dict);
+	_xmmsv_block_free (dict, sizeof (xmmsv_dict_internal_t));
 }
 
 /**
@@ -318,18 +557,18 @@ xmmsv_dict_get (xmmsv_t *dictv, const char *key, xmmsv_t **val)
 	x_return_val_if_fail (dictv, 0);
 	x_return_val_if_fail (xmmsv_is_type (dictv, XMMSV_TYPE_DICT), 0);
 
-	xmmsv_dict_data_t data = DICT_INIT_DATA (key);
 	dict = dictv->value.dict;
 
-	if (_xmmsv_dict_search (dict, data, &pos, &deleted)) {
+	if (_xmmsv_dict_search (dict, key, &pos, &deleted)) {
 		/* If there was a deleted entry before the one we found
 		 * we can optimize a little by moving the entry to the
 		 * deleted slot (and thus closer to the actual bucket it
-		 * belongs to)
+		 * belongs to), unless other threads may be reading
 		 */
-		if (deleted != -1) {
+		if (deleted != -1 && !dict->frozen) {
 			dict->data[deleted] = dict->data[pos];
-			dict->data[pos].str = DELETED_STR;
+			dict->data[pos].key = DELETED_KEY;
+			pos = deleted;
 		}
 		if (val != NULL) {
 			*val = dict->data[pos].value;
@@ -354,25 +593,27 @@ int
 xmmsv_dict_set (xmmsv_t *dictv, const char *key, xmmsv_t *val)
 {
 	xmmsv_dict_internal_t *dict;
-	int ret = 1;
+	int pos, deleted;
 
 	x_return_val_if_fail (key, 0);
 	x_return_val_if_fail (val, 0);
 	x_return_val_if_fail (dictv, 0);
 	x_return_val_if_fail (xmmsv_is_type (dictv, XMMSV_TYPE_DICT), 0);
+	x_api_error_if (dictv->frozen, "on a frozen dict", 0);
 
-	xmmsv_dict_data_t data = DICT_INIT_DATA (key);
-	data.value = xmmsv_ref (val);
 	dict = dictv->value.dict;
+	xmmsv_ref (val);
 
-	/* Resize if fill is too high */
-	if (((dict->elems * 10) >> dict->size) > HASH_FILL_LIM) {
-		_xmmsv_dict_resize (dict);
+	if (_xmmsv_dict_search (dict, key, &pos, &deleted)) {
+		/* If the key already exists we change the data */
+		xmmsv_unref (dict->data[pos].value);
+		dict->data[pos].value = val;
+	} else if (!_xmmsv_dict_insert (dict, key, val)) {
+		xmmsv_unref (val);
+		return 0;
 	}
 
-	_xmmsv_dict_insert (dict, data, 1);
-
-	return ret;
+	return 1;
 }
 
 /**
@@ -393,12 +634,12 @@ xmmsv_dict_remove (xmmsv_t *dictv, const char *key)
 	x_return_val_if_fail (key, 0);
 	x_return_val_if_fail (dictv, 0);
 	x_return_val_if_fail (xmmsv_is_type (dictv, XMMSV_TYPE_DICT), 0);
+	x_api_error_if (dictv->frozen, "on a frozen dict", 0);
 
-	xmmsv_dict_data_t data = DICT_INIT_DATA (key);
 	dict = dictv->value.dict;
 
-	/* If we find the entry we free the string and mark it as deleted */
-	if (_xmmsv_dict_search (dict, data, &pos, &deleted)) {
+	/* If we find the entry we free the key and mark it as deleted */
+	if (_xmmsv_dict_search (dict, key, &pos, &deleted)) {
 		_xmmsv_dict_remove (dict, pos);
 		ret = 1;
 	}
@@ -415,23 +656,11 @@ xmmsv_dict_remove (xmmsv_t *dictv, const char *key)
 int
 xmmsv_dict_clear (xmmsv_t *dictv)
 {
-	int i;
-	xmmsv_dict_internal_t *dict;
-
 	x_return_val_if_fail (dictv, 0);
 	x_return_val_if_fail (xmmsv_is_type (dictv, XMMSV_TYPE_DICT), 0);
+	x_api_error_if (dictv->frozen, "on a frozen dict", 0);
 
-	dict = dictv->value.dict;
-
-	for (i = (1 << dict->size) - 1; i >= 0; i--) {
-		if (dict->data[i].str != NULL) {
-			if (dict->data[i].str != DELETED_STR) {
-				free (dict->data[i].str);
-				xmmsv_unref (dict->data[i].value);
-			}
-			dict->data[i].str = NULL;
-		}
-	}
+	_xmmsv_dict_clear (dictv->value.dict);
 
 	return 1;
 }
@@ -488,7 +717,7 @@ _xmmsv_dict_iter_new (xmmsv_dict_internal_t *d)
 {
 	xmmsv_dict_iter_t *it;
 
-	it = x_new0 (xmmsv_dict_iter_t, 1);
+	it = _xmmsv_block_alloc (sizeof (xmmsv_dict_iter_t));
 	if (!it) {
 		x_oom ();
 		return NULL;
@@ -497,8 +726,15 @@ _xmmsv_dict_iter_new (xmmsv_dict_internal_t *d)
 	it->parent = d;
 	xmmsv_dict_iter_first (it);
 
-	/* register iterator into parent */
-	d->iterators = x_list_prepend (d->iterators, it);
+	/* register iterator into parent, readers of a frozen dict may be
+	 * doing the same from other threads */
+	if (d->frozen) {
+		x_spin_lock (&d->iterators_lock);
+		d->iterators = x_list_prepend (d->iterators, it);
+		x_spin_unlock (&d->iterators_lock);
+	} else {
+		d->iterators = x_list_prepend (d->iterators, it);
+	}
 
 	return it;
 }
@@ -506,9 +742,17 @@ _xmmsv_dict_iter_new (xmmsv_dict_internal_t *d)
 static void
 _xmmsv_dict_iter_free (xmmsv_dict_iter_t *it)
 {
+	xmmsv_dict_internal_t *d = it->parent;
+
 	/* unref iterator from dict and free it */
-	it->parent->iterators = x_list_remove (it->parent->iterators, it);
-	free (it);
+	if (d->frozen) {
+		x_spin_lock (&d->iterators_lock);
+		d->iterators = x_list_remove (d->iterators, it);
+		x_spin_unlock (&d->iterators_lock);
+	} else {
+		d->iterators = x_list_remove (d->iterators, it);
+	}
+	_xmmsv_block_free (it, sizeof (xmmsv_dict_iter_t));
 }
 
 /**
@@ -576,7 +820,7 @@ xmmsv_dict_iter_pair (xmmsv_dict_iter_t *it, const char **key,
 	}
 
 	if (key) {
-		*key = it->parent->data[it->pos].str;
+		*key = it->parent->data[it->pos].key->str;
 	}
 
 	if (val) {
@@ -595,9 +839,7 @@ xmmsv_dict_iter_pair (xmmsv_dict_iter_t *it, const char **key,
 int
 xmmsv_dict_iter_valid (xmmsv_dict_iter_t *it)
 {
-	return it && (it->pos < (1 << it->parent->size))
-		&& it->parent->data[it->pos].str != NULL
-		&& it->parent->data[it->pos].str != DELETED_STR;
+	return it && it->pos < SLOTS (it->parent) && IS_ENTRY (it->parent, it->pos);
 }
 
 /**
@@ -613,7 +855,7 @@ xmmsv_dict_iter_first (xmmsv_dict_iter_t *it)
 	xmmsv_dict_internal_t *d = it->parent;
 
 	for (it->pos = 0
-		     ; it->pos < (1 << d->size) && (d->data[it->pos].str == NULL || d->data[it->pos].str == DELETED_STR)
+		     ; it->pos < SLOTS (d) && !IS_ENTRY (d, it->pos)
 		     ; it->pos++);
 }
 
@@ -630,7 +872,7 @@ xmmsv_dict_iter_next (xmmsv_dict_iter_t *it)
 	xmmsv_dict_internal_t *d = it->parent;
 
 	for (it->pos++
-		     ; it->pos < (1 << d->size) && (d->data[it->pos].str == NULL || d->data[it->pos].str == DELETED_STR)
+		     ; it->pos < SLOTS (d) && !IS_ENTRY (d, it->pos)
 		     ; it->pos++);
 }
 
@@ -676,6 +918,7 @@ xmmsv_dict_iter_set (xmmsv_dict_iter_t *it, xmmsv_t *val)
 {
 	x_return_val_if_fail (xmmsv_dict_iter_valid (it), 0);
 	x_return_val_if_fail (val, 0);
+	x_api_error_if (it->parent->frozen, "on a frozen dict", 0);
 
 	/* In case old value is new value, ref first. */
 	xmmsv_ref (val);
@@ -695,9 +938,14 @@ int
 xmmsv_dict_iter_remove (xmmsv_dict_iter_t *it)
 {
 	x_return_val_if_fail (xmmsv_dict_iter_valid (it), 0);
+	x_api_error_if (it->parent->frozen, "on a frozen dict", 0);
 
 	_xmmsv_dict_remove (it->parent, it->pos);
-	xmmsv_dict_iter_next (it);
+
+	/* inline entries after it have moved down to the current position */
+	if (it->parent->size) {
+		xmmsv_dict_iter_next (it);
+	}
 
 	return 1;
 }
@@ -37,17 +37,14 @@ const char *xmmsv_default_source_pref[] = {
 	NULL
 };
 
+XMMSV_BLOCK_ASSERT_FITS (xmmsv_t);
 
-/**
- * Allocates new #xmmsv_t and references it.
- * @internal
- */
-xmmsv_t *
-_xmmsv_new (xmmsv_type_t type)
+static xmmsv_t *
+_xmmsv_new_sized (xmmsv_type_t type, size_t size)
 {
 	xmmsv_t *val;
 
-	val = x_new0 (xmmsv_t, 1);
+	val = _xmmsv_block_alloc (size);
 	if (!val) {
 		x_oom ();
 		return NULL;
@@ -58,6 +55,16 @@ _xmmsv_new (xmmsv_type_t type)
 	return xmmsv_ref (val);
 }
 
+/**
+ * Allocates new #xmmsv_t and references it.
+ * @internal
+ */
+xmmsv_t *
+_xmmsv_new (xmmsv_type_t type)
+{
+	return _xmmsv_new_sized (type, sizeof (xmmsv_t));
+}
+
 /**
  * Free a #xmmsv_t along with its internal data.
  * @internal
@@ -65,6 +72,8 @@ _xmmsv_new (xmmsv_type_t type)
 static void
 _xmmsv_free (xmmsv_t *val)
 {
+	size_t size = sizeof (xmmsv_t);
+
 	x_return_if_fail (val);
 
 	switch (val->type) {
@@ -78,7 +87,11 @@ _xmmsv_free (xmmsv_t *val)
 			val->value.error = NULL;
 			break;
 		case XMMSV_TYPE_STRING :
-			free (val->value.string);
+			if (val->value.string == XMMSV_INLINE_DATA (val)) {
+				size += strlen (val->value.string) + 1;
+			} else {
+				free (val->value.string);
+			}
 			val->value.string = NULL;
 			break;
 		case XMMSV_TYPE_COLL:
@@ -105,7 +118,7 @@ _xmmsv_free (xmmsv_t *val)
 			break;
 	}
 
-	free (val);
+	_xmmsv_block_free (val, size);
 }
 
 
@@ -187,10 +200,22 @@ xmmsv_t *
 xmmsv_new_string (const char *s)
 {
 	xmmsv_t *val;
+	size_t len;
 
 	x_return_val_if_fail (s, NULL);
 	x_return_val_if_fail (xmmsv_utf8_validate (s), NULL);
 
+	len = strlen (s) + 1;
+
+	/* short strings share the block of the value */
+	if (sizeof (xmmsv_t) + len <= XMMSV_BLOCK_LARGE) {
+		val = _xmmsv_new_sized (XMMSV_TYPE_STRING, sizeof (xmmsv_t) + len);
+		if (val) {
+			val->value.string = memcpy (XMMSV_INLINE_DATA (val), s, len);
+		}
+		return val;
+	}
+
 	val = _xmmsv_new (XMMSV_TYPE_STRING);
 	if (val) {
 		val->value.string = strdup (s);
@@ -215,7 +240,7 @@ xmmsv_new_bin (const unsigned char *data, unsigned int len)
 		/* copy the data! */
 		val->value.bin.data = x_malloc (len);
 		if (!val->value.bin.data) {
-			free (val);
+			_xmmsv_block_free (val, sizeof (xmmsv_t));
 			x_oom ();
 			return NULL;
 		}
@@ -236,7 +261,12 @@ xmmsv_t *
 xmmsv_ref (xmmsv_t *val)
 {
 	x_return_val_if_fail (val, NULL);
-	val->ref++;
+
+	if (val->frozen) {
+		x_atomic_int_inc (&val->ref);
+	} else {
+		val->ref++;
+	}
 
 	return val;
 }
@@ -251,6 +281,14 @@ void
 xmmsv_unref (xmmsv_t *val)
 {
 	x_return_if_fail (val);
+
+	if (val->frozen) {
+		if (x_atomic_int_dec_and_test (&val->ref)) {
+			_xmmsv_free (val);
+		}
+		return;
+	}
+
 	x_api_error_if (val->ref < 1, "with a freed value",);
 
 	val->ref--;
@@ -259,6 +297,63 @@ xmmsv_unref (xmmsv_t *val)
 	}
 }
 
+/**
+ * Make a value and everything it contains immutable.
+ *
+ * A frozen value can be shared between threads without copying it:
+ * referencing and unreferencing it is atomic, and it can be read and
+ * iterated from several threads at once. Functions that would modify
+ * it fail with an error instead. Bitbuffers keep their read position
+ * in the value, so they should still be read from one thread only.
+ *
+ * Freezing must happen before the value is handed to other threads,
+ * and cannot be undone. Use #xmmsv_copy to get a mutable copy.
+ *
+ * @param val the value to freeze.
+ * @return val
+ */
+xmmsv_t *
+xmmsv_freeze (xmmsv_t *val)
+{
+	x_return_val_if_fail (val, NULL);
+
+	if (val->frozen) {
+		return val;
+	}
+
+	switch (val->type) {
+		case XMMSV_TYPE_COLL:
+			_xmmsv_coll_freeze (val->value.coll);
+			break;
+		case XMMSV_TYPE_LIST:
+			_xmmsv_list_freeze (val->value.list);
+			break;
+		case XMMSV_TYPE_DICT:
+			_xmmsv_dict_freeze (val->value.dict);
+			break;
+		default:
+			break;
+	}
+
+	val->frozen = true;
+
+	return val;
+}
+
+/**
+ * Check if a value has been frozen with #xmmsv_freeze.
+ *
+ * @param val the value to check.
+ * @return 1 if the value is frozen, otherwise 0.
+ */
+int
+xmmsv_is_frozen (const xmmsv_t *val)
+{
+	x_return_val_if_fail (val, 0);
+
+	return val->frozen;
+}
+
 /**
  * Get the type of the value.
  *
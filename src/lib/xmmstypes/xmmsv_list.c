@@ -25,18 +25,39 @@
 struct xmmsv_list_iter_St {
 	xmmsv_list_internal_t *parent;
 	int position;
+	int chunk;        /* chunk of the last element read, -1 if unknown */
+	int chunk_start;  /* position of its first element */
 };
 
+/* Lists of up to CHUNK_SIZE elements keep them in one flat array. Larger
+ * lists split them into chunks of at most CHUNK_SIZE elements, found by
+ * position through a Fenwick tree of the chunk sizes, so inserting or
+ * removing moves the elements of one chunk instead of the whole tail.
+ * Lists shrinking to half a chunk become flat again. */
+#define CHUNK_SIZE 256
+
+typedef struct xmmsv_list_chunk_St {
+	int size;
+	xmmsv_t *items[CHUNK_SIZE];
+} xmmsv_list_chunk_t;
+
 struct xmmsv_list_internal_St {
-	xmmsv_t **list;
+	xmmsv_t **list;               /* flat storage, NULL when chunked */
+	xmmsv_list_chunk_t **chunks;  /* chunked storage, NULL when flat */
+	int *sizes;                   /* Fenwick tree of chunk sizes, 1-based */
 	xmmsv_t *parent_value;
+	x_list_t *iterators;
 	int size;
-	int allocated;
-	bool restricted;
+	int allocated;                /* slots in list, or in chunks */
+	int nchunks;
+	int iterators_lock; /* only taken when frozen */
 	xmmsv_type_t restricttype;
-	x_list_t *iterators;
+	bool restricted;
 };
 
+XMMSV_BLOCK_ASSERT_FITS (xmmsv_list_internal_t);
+XMMSV_BLOCK_ASSERT_FITS (xmmsv_list_iter_t);
+
 static void _xmmsv_list_iter_free (xmmsv_list_iter_t *it);
 
 static int
@@ -59,12 +80,297 @@ _xmmsv_list_position_normalize (int *pos, int size, int allow_append)
 	return 1;
 }
 
+static void
+_xmmsv_list_tree_rebuild (xmmsv_list_internal_t *l)
+{
+	int i, j;
+
+	for (i = 1; i <= l->nchunks; i++) {
+		l->sizes[i] = l->chunks[i - 1]->size;
+	}
+
+	for (i = 1; i <= l->nchunks; i++) {
+		j = i + (i & -i);
+		if (j <= l->nchunks) {
+			l->sizes[j] += l->sizes[i];
+		}
+	}
+}
+
+static void
+_xmmsv_list_tree_add (xmmsv_list_internal_t *l, int chunk, int delta)
+{
+	int i;
+
+	for (i = chunk + 1; i <= l->nchunks; i += i & -i) {
+		l->sizes[i] += delta;
+	}
+}
+
+/* Find the chunk holding an element, pos must be inside the list */
+static int
+_xmmsv_list_locate (xmmsv_list_internal_t *l, int pos, int *offset)
+{
+	int i = 0, step = 1;
+
+	while (step * 2 <= l->nchunks) {
+		step *= 2;
+	}
+
+	for (; step > 0; step /= 2) {
+		if (i + step <= l->nchunks && l->sizes[i + step] <= pos) {
+			i += step;
+			pos -= l->sizes[i];
+		}
+	}
+
+	*offset = pos;
+
+	return i;
+}
+
+static xmmsv_t **
+_xmmsv_list_slot (xmmsv_list_internal_t *l, int pos)
+{
+	int chunk, offset;
+
+	if (!l->chunks) {
+		return &l->list[pos];
+	}
+
+	chunk = _xmmsv_list_locate (l, pos, &offset);
+
+	return &l->chunks[chunk]->items[offset];
+}
+
+/* Like _xmmsv_list_slot, reading on from the chunk last read */
+static xmmsv_t **
+_xmmsv_list_iter_slot (xmmsv_list_iter_t *it)
+{
+	xmmsv_list_internal_t *l = it->parent;
+	int offset;
+
+	if (!l->chunks) {
+		return &l->list[it->position];
+	}
+
+	if (it->chunk >= 0 && it->chunk < l->nchunks) {
+		offset = it->position - it->chunk_start;
+		if (offset == l->chunks[it->chunk]->size && it->chunk + 1 < l->nchunks) {
+			it->chunk_start += l->chunks[it->chunk]->size;
+			it->chunk++;
+			offset = 0;
+		}
+		if (offset >= 0 && offset < l->chunks[it->chunk]->size) {
+			return &l->chunks[it->chunk]->items[offset];
+		}
+	}
+
+	it->chunk = _xmmsv_list_locate (l, it->position, &offset);
+	it->chunk_start = it->position - offset;
+
+	return &l->chunks[it->chunk]->items[offset];
+}
+
+static xmmsv_list_chunk_t *
+_xmmsv_list_chunk_new (void)
+{
+	xmmsv_list_chunk_t *chunk;
+
+	chunk = malloc (sizeof (xmmsv_list_chunk_t));
+	if (!chunk) {
+		x_oom ();
+		return NULL;
+	}
+
+	chunk->size = 0;
+
+	return chunk;
+}
+
+static int
+_xmmsv_list_chunks_resize (xmmsv_list_internal_t *l, int newsize)
+{
+	xmmsv_list_chunk_t **chunks;
+	int *sizes;
+
+	chunks = realloc (l->chunks, newsize * sizeof (xmmsv_list_chunk_t *));
+	if (!chunks) {
+		x_oom ();
+		return 0;
+	}
+	l->chunks = chunks;
+
+	sizes = realloc (l->sizes, (newsize + 1) * sizeof (int));
+	if (!sizes) {
+		x_oom ();
+		return 0;
+	}
+	l->sizes = sizes;
+
+	l->allocated = newsize;
+
+	return 1;
+}
+
+/* Add a chunk to the chunk array, at the given chunk index */
+static int
+_xmmsv_list_chunks_insert (xmmsv_list_internal_t *l, int index,
+                           xmmsv_list_chunk_t *chunk)
+{
+	if (l->nchunks == l->allocated &&
+	    !_xmmsv_list_chunks_resize (l, l->allocated * 2)) {
+		return 0;
+	}
+
+	memmove (l->chunks + index + 1, l->chunks + index,
+	         (l->nchunks - index) * sizeof (xmmsv_list_chunk_t *));
+	l->chunks[index] = chunk;
+	l->nchunks++;
+
+	_xmmsv_list_tree_rebuild (l);
+
+	return 1;
+}
+
+/* Drop the chunk at the given chunk index from the chunk array */
+static void
+_xmmsv_list_chunks_remove (xmmsv_list_internal_t *l, int index)
+{
+	free (l->chunks[index]);
+
+	l->nchunks--;
+	memmove (l->chunks + index, l->chunks + index + 1,
+	         (l->nchunks - index) * sizeof (xmmsv_list_chunk_t *));
+
+	_xmmsv_list_tree_rebuild (l);
+}
+
+/* Move the elements of a full flat list into half filled chunks */
+static int
+_xmmsv_list_split (xmmsv_list_internal_t *l)
+{
+	int i, n, half = CHUNK_SIZE / 2;
+
+	n = (l->size + half - 1) / half;
+
+	l->allocated = 0;
+	if (!_xmmsv_list_chunks_resize (l, n * 2)) {
+		free (l->chunks);
+		free (l->sizes);
+		l->chunks = NULL;
+		l->sizes = NULL;
+		l->allocated = l->size;
+		return 0;
+	}
+
+	for (i = 0; i < n; i++) {
+		l->chunks[i] = _xmmsv_list_chunk_new ();
+		if (!l->chunks[i]) {
+			while (i-- > 0) {
+				free (l->chunks[i]);
+			}
+			free (l->chunks);
+			free (l->sizes);
+			l->chunks = NULL;
+			l->sizes = NULL;
+			l->allocated = l->size;
+			return 0;
+		}
+
+		l->chunks[i]->size = MIN (half, l->size - i * half);
+		memcpy (l->chunks[i]->items, l->list + i * half,
+		        l->chunks[i]->size * sizeof (xmmsv_t *));
+	}
+
+	l->nchunks = n;
+	_xmmsv_list_tree_rebuild (l);
+
+	free (l->list);
+	l->list = NULL;
+
+	return 1;
+}
+
+/* Move the elements of a chunked list back into one flat array */
+static int
+_xmmsv_list_join (xmmsv_list_internal_t *l)
+{
+	xmmsv_t **list;
+	int i, pos = 0;
+
+	/* stay chunked if we can't, no harm done */
+	list = malloc (CHUNK_SIZE * sizeof (xmmsv_t *));
+	if (!list) {
+		return 0;
+	}
+
+	for (i = 0; i < l->nchunks; i++) {
+		memcpy (list + pos, l->chunks[i]->items,
+		        l->chunks[i]->size * sizeof (xmmsv_t *));
+		pos += l->chunks[i]->size;
+		free (l->chunks[i]);
+	}
+
+	free (l->chunks);
+	free (l->sizes);
+	l->chunks = NULL;
+	l->sizes = NULL;
+	l->nchunks = 0;
+
+	l->list = list;
+	l->allocated = CHUNK_SIZE;
+
+	return 1;
+}
+
+static void
+_xmmsv_list_unref_all (xmmsv_list_internal_t *l)
+{
+	int i, j;
+
+	if (!l->chunks) {
+		for (i = 0; i < l->size; i++) {
+			xmmsv_unref (l->list[i]);
+		}
+		return;
+	}
+
+	for (i = 0; i < l->nchunks; i++) {
+		for (j = 0; j < l->chunks[i]->size; j++) {
+			xmmsv_unref (l->chunks[i]->items[j]);
+		}
+	}
+}
+
+/* Free the storage, leaving an empty flat list */
+static void
+_xmmsv_list_storage_free (xmmsv_list_internal_t *l)
+{
+	int i;
+
+	for (i = 0; i < l->nchunks; i++) {
+		free (l->chunks[i]);
+	}
+
+	free (l->chunks);
+	free (l->sizes);
+	free (l->list);
+
+	l->chunks = NULL;
+	l->sizes = NULL;
+	l->list = NULL;
+	l->nchunks = 0;
+	l->size = 0;
+	l->allocated = 0;
+}
+
 static xmmsv_list_internal_t *
 _xmmsv_list_new (void)
 {
 	xmmsv_list_internal_t *list;
 
-	list = x_new0 (xmmsv_list_internal_t, 1);
+	list = _xmmsv_block_alloc (sizeof (xmmsv_list_internal_t));
 	if (!list) {
 		x_oom ();
 		return NULL;
@@ -79,7 +385,6 @@ void
 _xmmsv_list_free (xmmsv_list_internal_t *l)
 {
 	xmmsv_list_iter_t *it;
-	int i;
 
 	/* free iterators */
 	while (l->iterators) {
@@ -88,12 +393,20 @@ _xmmsv_list_free (xmmsv_list_internal_t *l)
 	}
 
 	/* unref contents */
+	_xmmsv_list_unref_all (l);
+
+	_xmmsv_list_storage_free (l);
+	_xmmsv_block_free (l, sizeof (xmmsv_list_internal_t));
+}
+
+void
+_xmmsv_list_freeze (xmmsv_list_internal_t *l)
+{
+	int i;
+
 	for (i = 0; i < l->size; i++) {
-		xmmsv_unref (l->list[i]);
+		xmmsv_freeze (*_xmmsv_list_slot (l, i));
 	}
-
-	free (l->list);
-	free (l);
 }
 
 static int
@@ -114,6 +427,149 @@ _xmmsv_list_resize (xmmsv_list_internal_t *l, int newsize)
 	return 1;
 }
 
+/* Store an element at a normalized position, without taking a reference */
+static int
+_xmmsv_list_store (xmmsv_list_internal_t *l, int pos, xmmsv_t *val)
+{
+	xmmsv_list_chunk_t *chunk, *next;
+	int index, offset, half = CHUNK_SIZE / 2;
+
+	if (!l->chunks && l->size == CHUNK_SIZE && !_xmmsv_list_split (l)) {
+		return 0;
+	}
+
+	if (!l->chunks) {
+		/* We need more memory, reallocate */
+		if (l->size == l->allocated) {
+			int success;
+			size_t double_size;
+			if (l->allocated > 0) {
+				double_size = l->allocated << 1;
+			} else {
+				double_size = 1;
+			}
+			success = _xmmsv_list_resize (l, double_size);
+			x_return_val_if_fail (success, 0);
+		}
+
+		/* move existing items out of the way */
+		if (l->size > pos) {
+			memmove (l->list + pos + 1, l->list + pos,
+			         (l->size - pos) * sizeof (xmmsv_t *));
+		}
+
+		l->list[pos] = val;
+		l->size++;
+
+		return 1;
+	}
+
+	if (pos == l->size) {
+		index = l->nchunks - 1;
+		offset = l->chunks[index]->size;
+	} else {
+		index = _xmmsv_list_locate (l, pos, &offset);
+	}
+
+	chunk = l->chunks[index];
+
+	/* split a full chunk in two halves */
+	if (chunk->size == CHUNK_SIZE) {
+		next = _xmmsv_list_chunk_new ();
+		x_return_val_if_fail (next, 0);
+
+		memcpy (next->items, chunk->items + half, half * sizeof (xmmsv_t *));
+		next->size = half;
+		chunk->size = half;
+
+		if (!_xmmsv_list_chunks_insert (l, index + 1, next)) {
+			chunk->size = CHUNK_SIZE;
+			free (next);
+			return 0;
+		}
+
+		if (offset > half) {
+			index++;
+			offset -= half;
+			chunk = next;
+		}
+	}
+
+	memmove (chunk->items + offset + 1, chunk->items + offset,
+	         (chunk->size - offset) * sizeof (xmmsv_t *));
+	chunk->items[offset] = val;
+	chunk->size++;
+
+	_xmmsv_list_tree_add (l, index, 1);
+	l->size++;
+
+	return 1;
+}
+
+/* Take the element out of a normalized position, returning its reference */
+static xmmsv_t *
+_xmmsv_list_take (xmmsv_list_internal_t *l, int pos)
+{
+	xmmsv_list_chunk_t *chunk, *next;
+	int index, offset, first;
+	xmmsv_t *val;
+
+	if (!l->chunks) {
+		val = l->list[pos];
+
+		l->size--;
+
+		/* fill the gap */
+		if (pos < l->size) {
+			memmove (l->list + pos, l->list + pos + 1,
+			         (l->size - pos) * sizeof (xmmsv_t *));
+		}
+
+		/* Reduce memory usage by two if possible */
+		if (l->size <= l->allocated >> 1) {
+			_xmmsv_list_resize (l, l->allocated >> 1);
+		}
+
+		return val;
+	}
+
+	index = _xmmsv_list_locate (l, pos, &offset);
+	chunk = l->chunks[index];
+
+	val = chunk->items[offset];
+	chunk->size--;
+	memmove (chunk->items + offset, chunk->items + offset + 1,
+	         (chunk->size - offset) * sizeof (xmmsv_t *));
+
+	l->size--;
+
+	if (l->size <= CHUNK_SIZE / 2 && _xmmsv_list_join (l)) {
+		return val;
+	}
+
+	if (chunk->size == 0) {
+		_xmmsv_list_chunks_remove (l, index);
+		return val;
+	}
+
+	/* merge a sparse chunk with a neighbour, keeping room in the result */
+	first = (index + 1 < l->nchunks) ? index : index - 1;
+	if (chunk->size < CHUNK_SIZE / 4 && first >= 0 &&
+	    l->chunks[first]->size + l->chunks[first + 1]->size <= CHUNK_SIZE * 3 / 4) {
+		chunk = l->chunks[first];
+		next = l->chunks[first + 1];
+		memcpy (chunk->items + chunk->size, next->items,
+		        next->size * sizeof (xmmsv_t *));
+		chunk->size += next->size;
+		_xmmsv_list_chunks_remove (l, first + 1);
+		return val;
+	}
+
+	_xmmsv_list_tree_add (l, index, -1);
+
+	return val;
+}
+
 static int
 _xmmsv_list_insert (xmmsv_list_internal_t *l, int pos, xmmsv_t *val)
 {
@@ -128,31 +584,16 @@ _xmmsv_list_insert (xmmsv_list_internal_t *l, int pos, xmmsv_t *val)
 		x_return_val_if_fail (xmmsv_is_type (val, l->restricttype), 0);
 	}
 
-	/* We need more memory, reallocate */
-	if (l->size == l->allocated) {
-		int success;
-		size_t double_size;
-		if (l->allocated > 0) {
-			double_size = l->allocated << 1;
-		} else {
-			double_size = 1;
-		}
-		success = _xmmsv_list_resize (l, double_size);
-		x_return_val_if_fail (success, 0);
-	}
-
-	/* move existing items out of the way */
-	if (l->size > pos) {
-		memmove (l->list + pos + 1, l->list + pos,
-		         (l->size - pos) * sizeof (xmmsv_t *));
+	if (!_xmmsv_list_store (l, pos, val)) {
+		return 0;
 	}
 
-	l->list[pos] = xmmsv_ref (val);
-	l->size++;
+	xmmsv_ref (val);
 
 	/* update iterators pos */
 	for (n = l->iterators; n; n = n->next) {
 		it = (xmmsv_list_iter_t *) n->data;
+		it->chunk = -1;
 		if (it->position > pos) {
 			it->position++;
 		}
@@ -171,7 +612,6 @@ static int
 _xmmsv_list_remove (xmmsv_list_internal_t *l, int pos)
 {
 	xmmsv_list_iter_t *it;
-	int half_size;
 	x_list_t *n;
 
 	/* prevent removing after the last element */
@@ -179,27 +619,12 @@ _xmmsv_list_remove (xmmsv_list_internal_t *l, int pos)
 		return 0;
 	}
 
-	xmmsv_unref (l->list[pos]);
-
-	l->size--;
-
-	/* fill the gap */
-	if (pos < l->size) {
-		memmove (l->list + pos, l->list + pos + 1,
-		         (l->size - pos) * sizeof (xmmsv_t *));
-	}
-
-	/* Reduce memory usage by two if possible */
-	half_size = l->allocated >> 1;
-	if (l->size <= half_size) {
-		int success;
-		success = _xmmsv_list_resize (l, half_size);
-		x_return_val_if_fail (success, 0);
-	}
+	xmmsv_unref (_xmmsv_list_take (l, pos));
 
 	/* update iterator pos */
 	for (n = l->iterators; n; n = n->next) {
 		it = (xmmsv_list_iter_t *) n->data;
+		it->chunk = -1;
 		if (it->position > pos) {
 			it->position--;
 		}
@@ -222,15 +647,37 @@ _xmmsv_list_move (xmmsv_list_internal_t *l, int old_pos, int new_pos)
 		return 0;
 	}
 
-	v = l->list[old_pos];
-	if (old_pos < new_pos) {
+	if (l->chunks) {
+		v = _xmmsv_list_take (l, old_pos);
+		if (!_xmmsv_list_store (l, new_pos, v)) {
+			/* put it back where it was, the chunks may have been
+			 * rearranged by the take */
+			if (!_xmmsv_list_store (l, old_pos, v)) {
+				xmmsv_unref (v);
+			}
+			for (n = l->iterators; n; n = n->next) {
+				it = (xmmsv_list_iter_t *) n->data;
+				it->chunk = -1;
+			}
+			return 0;
+		}
+	} else if (old_pos < new_pos) {
+		v = l->list[old_pos];
 		memmove (l->list + old_pos, l->list + old_pos + 1,
 		         (new_pos - old_pos) * sizeof (xmmsv_t *));
 		l->list[new_pos] = v;
+	} else {
+		v = l->list[old_pos];
+		memmove (l->list + new_pos + 1, l->list + new_pos,
+		         (old_pos - new_pos) * sizeof (xmmsv_t *));
+		l->list[new_pos] = v;
+	}
 
-		/* update iterator pos */
-		for (n = l->iterators; n; n = n->next) {
-			it = (xmmsv_list_iter_t *) n->data;
+	/* update iterator pos */
+	for (n = l->iterators; n; n = n->next) {
+		it = (xmmsv_list_iter_t *) n->data;
+		it->chunk = -1;
+		if (old_pos < new_pos) {
 			if (it->position >= old_pos && it->position <= new_pos) {
 				if (it->position == old_pos) {
 					it->position = new_pos;
@@ -238,15 +685,7 @@ _xmmsv_list_move (xmmsv_list_internal_t *l, int old_pos, int new_pos)
 					it->position--;
 				}
 			}
-		}
-	} else {
-		memmove (l->list + new_pos + 1, l->list + new_pos,
-		         (old_pos - new_pos) * sizeof (xmmsv_t *));
-		l->list[new_pos] = v;
-
-		/* update iterator pos */
-		for (n = l->iterators; n; n = n->next) {
-			it = (xmmsv_list_iter_t *) n->data;
+		} else {
 			if (it->position >= new_pos && it->position <= old_pos) {
 				if (it->position == old_pos) {
 					it->position = new_pos;
@@ -265,32 +704,56 @@ _xmmsv_list_clear (xmmsv_list_internal_t *l)
 {
 	xmmsv_list_iter_t *it;
 	x_list_t *n;
-	int i;
 
 	/* unref all stored values */
-	for (i = 0; i < l->size; i++) {
-		xmmsv_unref (l->list[i]);
-	}
+	_xmmsv_list_unref_all (l);
 
 	/* free list, declare empty */
-	free (l->list);
-	l->list = NULL;
-
-	l->size = 0;
-	l->allocated = 0;
+	_xmmsv_list_storage_free (l);
 
 	/* reset iterator pos */
 	for (n = l->iterators; n; n = n->next) {
 		it = (xmmsv_list_iter_t *) n->data;
 		it->position = 0;
+		it->chunk = -1;
 	}
 }
 
 static void
 _xmmsv_list_sort (xmmsv_list_internal_t *l, xmmsv_list_compare_func_t comparator)
 {
-	qsort (l->list, l->size, sizeof (xmmsv_t *),
+	xmmsv_t **all;
+	int i, pos = 0;
+
+	if (!l->chunks) {
+		qsort (l->list, l->size, sizeof (xmmsv_t *),
+		       (int (*)(const void *, const void *)) comparator);
+		return;
+	}
+
+	/* sort a flat copy, then put the elements back in the same chunks */
+	all = malloc (l->size * sizeof (xmmsv_t *));
+	if (!all) {
+		x_oom ();
+		return;
+	}
+
+	for (i = 0; i < l->nchunks; i++) {
+		memcpy (all + pos, l->chunks[i]->items,
+		        l->chunks[i]->size * sizeof (xmmsv_t *));
+		pos += l->chunks[i]->size;
+	}
+
+	qsort (all, l->size, sizeof (xmmsv_t *),
 	       (int (*)(const void *, const void *)) comparator);
+
+	for (i = 0, pos = 0; i < l->nchunks; i++) {
+		memcpy (l->chunks[i]->items, all + pos,
+		        l->chunks[i]->size * sizeof (xmmsv_t *));
+		pos += l->chunks[i]->size;
+	}
+
+	free (all);
 }
 
 /**
@@ -339,7 +802,7 @@ xmmsv_list_get (xmmsv_t *listv, int pos, xmmsv_t **val)
 	}
 
 	if (val) {
-		*val = l->list[pos];
+		*val = *_xmmsv_list_slot (l, pos);
 	}
 
 	return 1;
@@ -363,6 +826,7 @@ xmmsv_list_set (xmmsv_t *listv, int pos, xmmsv_t *val)
 	x_return_val_if_fail (listv, 0);
 	x_return_val_if_fail (val, 0);
 	x_return_val_if_fail (xmmsv_is_type (listv, XMMSV_TYPE_LIST), 0);
+	x_api_error_if (listv->frozen, "on a frozen list", 0);
 
 	l = listv->value.list;
 
@@ -370,8 +834,8 @@ xmmsv_list_set (xmmsv_t *listv, int pos, xmmsv_t *val)
 		return 0;
 	}
 
-	old_val = l->list[pos];
-	l->list[pos] = xmmsv_ref (val);
+	old_val = *_xmmsv_list_slot (l, pos);
+	*_xmmsv_list_slot (l, pos) = xmmsv_ref (val);
 	xmmsv_unref (old_val);
 
 	return 1;
@@ -393,6 +857,7 @@ xmmsv_list_insert (xmmsv_t *listv, int pos, xmmsv_t *val)
 	x_return_val_if_fail (listv, 0);
 	x_return_val_if_fail (xmmsv_is_type (listv, XMMSV_TYPE_LIST), 0);
 	x_return_val_if_fail (val, 0);
+	x_api_error_if (listv->frozen, "on a frozen list", 0);
 
 	return _xmmsv_list_insert (listv->value.list, pos, val);
 }
@@ -410,6 +875,7 @@ xmmsv_list_remove (xmmsv_t *listv, int pos)
 {
 	x_return_val_if_fail (listv, 0);
 	x_return_val_if_fail (xmmsv_is_type (listv, XMMSV_TYPE_LIST), 0);
+	x_api_error_if (listv->frozen, "on a frozen list", 0);
 
 	return _xmmsv_list_remove (listv->value.list, pos);
 }
@@ -433,6 +899,7 @@ xmmsv_list_move (xmmsv_t *listv, int old_pos, int new_pos)
 {
 	x_return_val_if_fail (listv, 0);
 	x_return_val_if_fail (xmmsv_is_type (listv, XMMSV_TYPE_LIST), 0);
+	x_api_error_if (listv->frozen, "on a frozen list", 0);
 
 	return _xmmsv_list_move (listv->value.list, old_pos, new_pos);
 }
@@ -451,6 +918,7 @@ xmmsv_list_append (xmmsv_t *listv, xmmsv_t *val)
 	x_return_val_if_fail (listv, 0);
 	x_return_val_if_fail (xmmsv_is_type (listv, XMMSV_TYPE_LIST), 0);
 	x_return_val_if_fail (val, 0);
+	x_api_error_if (listv->frozen, "on a frozen list", 0);
 
 	return _xmmsv_list_append (listv->value.list, val);
 }
@@ -466,6 +934,7 @@ xmmsv_list_clear (xmmsv_t *listv)
 {
 	x_return_val_if_fail (listv, 0);
 	x_return_val_if_fail (xmmsv_is_type (listv, XMMSV_TYPE_LIST), 0);
+	x_api_error_if (listv->frozen, "on a frozen list", 0);
 
 	_xmmsv_list_clear (listv->value.list);
 
@@ -484,6 +953,7 @@ xmmsv_list_sort (xmmsv_t *listv, xmmsv_list_compare_func_t comparator)
 	x_return_val_if_fail (comparator, 0);
 	x_return_val_if_fail (listv, 0);
 	x_return_val_if_fail (xmmsv_is_type (listv, XMMSV_TYPE_LIST), 0);
+	x_api_error_if (listv->frozen, "on a frozen list", 0);
 
 	_xmmsv_list_sort (listv->value.list, comparator);
 
@@ -542,6 +1012,12 @@ xmmsv_list_restrict_type (xmmsv_t *listv, xmmsv_type_t type)
 	x_return_val_if_fail (!listv->value.list->restricted ||
 	                      listv->value.list->restricttype == type, 0);
 
+	if (listv->value.list->restricted) {
+		return 1;
+	}
+
+	x_api_error_if (listv->frozen, "on a frozen list", 0);
+
 	listv->value.list->restricted = true;
 	listv->value.list->restricttype = type;
 
@@ -640,7 +1116,7 @@ _xmmsv_list_iter_new (xmmsv_list_internal_t *l)
 {
 	xmmsv_list_iter_t *it;
 
-	it = x_new0 (xmmsv_list_iter_t, 1);
+	it = _xmmsv_block_alloc (sizeof (xmmsv_list_iter_t));
 	if (!it) {
 		x_oom ();
 		return NULL;
@@ -648,9 +1124,17 @@ _xmmsv_list_iter_new (xmmsv_list_internal_t *l)
 
 	it->parent = l;
 	it->position = 0;
-
-	/* register iterator into parent */
-	l->iterators = x_list_prepend (l->iterators, it);
+	it->chunk = -1;
+
+	/* register iterator into parent, readers of a frozen list may be
+	 * doing the same from other threads */
+	if (l->parent_value->frozen) {
+		x_spin_lock (&l->iterators_lock);
+		l->iterators = x_list_prepend (l->iterators, it);
+		x_spin_unlock (&l->iterators_lock);
+	} else {
+		l->iterators = x_list_prepend (l->iterators, it);
+	}
 
 	return it;
 }
@@ -687,9 +1171,17 @@ xmmsv_get_list_iter (const xmmsv_t *val, xmmsv_list_iter_t **it)
 static void
 _xmmsv_list_iter_free (xmmsv_list_iter_t *it)
 {
+	xmmsv_list_internal_t *l = it->parent;
+
 	/* unref iterator from list and free it */
-	it->parent->iterators = x_list_remove (it->parent->iterators, it);
-	free (it);
+	if (l->parent_value->frozen) {
+		x_spin_lock (&l->iterators_lock);
+		l->iterators = x_list_remove (l->iterators, it);
+		x_spin_unlock (&l->iterators_lock);
+	} else {
+		l->iterators = x_list_remove (l->iterators, it);
+	}
+	_xmmsv_block_free (it, sizeof (xmmsv_list_iter_t));
 }
 
 /**
@@ -725,7 +1217,7 @@ xmmsv_list_iter_entry (xmmsv_list_iter_t *it, xmmsv_t **val)
 	if (!xmmsv_list_iter_valid (it))
 		return 0;
 
-	*val = it->parent->list[it->position];
+	*val = *_xmmsv_list_iter_slot (it);
 
 	return 1;
 }
@@ -882,6 +1374,7 @@ xmmsv_list_iter_insert (xmmsv_list_iter_t *it, xmmsv_t *val)
 {
 	x_return_val_if_fail (it, 0);
 	x_return_val_if_fail (val, 0);
+	x_api_error_if (it->parent->parent_value->frozen, "on a frozen list", 0);
 
 	return _xmmsv_list_insert (it->parent, it->position, val);
 }
@@ -897,6 +1390,7 @@ int
 xmmsv_list_iter_remove (xmmsv_list_iter_t *it)
 {
 	x_return_val_if_fail (it, 0);
+	x_api_error_if (it->parent->parent_value->frozen, "on a frozen list", 0);
 
 	return _xmmsv_list_remove (it->parent, it->position);
 }
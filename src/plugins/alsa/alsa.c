@@ -22,11 +22,17 @@
 
 #include <glib.h>
 
+#include <errno.h>
+#include <poll.h>
+#include <string.h>
+#include <unistd.h>
+
 /*
  *  Defines
  */
 #define BUFFER_TIME        500000
 #define MAX_CHANNELS       8
+#define MAX_MIXER_FDS      16
 
 /*
  * Type definitions
@@ -35,6 +41,11 @@ typedef struct xmms_alsa_data_St {
 	snd_pcm_t *pcm;
 	snd_mixer_t *mixer;
 	snd_mixer_elem_t *mixer_elem;
+
+	/* the mixer is shared with the event thread */
+	GMutex mixer_lock;
+	GThread *mixer_thread;
+	gint mixer_wakeup[2];
 } xmms_alsa_data_t;
 
 static const struct {
@@ -97,6 +108,9 @@ static gboolean xmms_alsa_volume_set (xmms_output_t *output,
 static gboolean xmms_alsa_volume_get (xmms_output_t *output,
                                       const gchar **names, guint *values,
                                       guint *num_channels);
+static gboolean xmms_alsa_volume_monitor (xmms_output_t *output);
+static gpointer xmms_alsa_mixer_thread (gpointer udata);
+static gint xmms_alsa_mixer_elem_cb (snd_mixer_elem_t *elem, guint mask);
 static gboolean xmms_alsa_mixer_setup (xmms_output_t *plugin,
                                        xmms_alsa_data_t *data);
 static gboolean xmms_alsa_probe_modes (xmms_output_t *output,
@@ -136,6 +150,7 @@ xmms_alsa_plugin_setup (xmms_output_plugin_t *plugin)
 
 	methods.volume_get = xmms_alsa_volume_get;
 	methods.volume_set = xmms_alsa_volume_set;
+	methods.volume_monitor = xmms_alsa_volume_monitor;
 
 	methods.write = xmms_alsa_write;
 
@@ -184,7 +199,10 @@ xmms_alsa_new (xmms_output_t *output)
 	data = g_new0 (xmms_alsa_data_t, 1);
 	g_return_val_if_fail (data, FALSE);
 
+	g_mutex_init (&data->mixer_lock);
+
 	if (!xmms_alsa_probe_modes (output, data)) {
+		g_mutex_clear (&data->mixer_lock);
 		g_free (data);
 		return FALSE;
 	}
@@ -308,6 +326,18 @@ xmms_alsa_destroy (xmms_output_t *output)
 	data = xmms_output_private_data_get (output);
 	g_return_if_fail (data);
 
+	if (data->mixer_thread) {
+		/* any byte makes the event thread quit */
+		if (write (data->mixer_wakeup[1], "", 1) != 1) {
+			xmms_log_error ("Unable to stop mixer event thread: %s",
+			                strerror (errno));
+		}
+		g_thread_join (data->mixer_thread);
+
+		close (data->mixer_wakeup[0]);
+		close (data->mixer_wakeup[1]);
+	}
+
 	if (data->mixer) {
 		err = snd_mixer_close (data->mixer);
 		if (err != 0) {
@@ -318,6 +348,7 @@ xmms_alsa_destroy (xmms_output_t *output)
 		}
 	}
 
+	g_mutex_clear (&data->mixer_lock);
 	g_free (data);
 }
 
@@ -665,8 +696,10 @@ xmms_alsa_volume_set (xmms_output_t *output,
 		return FALSE;
 	}
 
+	g_mutex_lock (&data->mixer_lock);
 	err = snd_mixer_selem_set_playback_volume (data->mixer_elem,
 	                                           channel, volume);
+	g_mutex_unlock (&data->mixer_lock);
 
 	return (err >= 0);
 }
@@ -704,8 +737,11 @@ xmms_alsa_volume_get (xmms_output_t *output, const gchar **names,
 	g_return_val_if_fail (names, FALSE);
 	g_return_val_if_fail (values, FALSE);
 
+	g_mutex_lock (&data->mixer_lock);
+
 	err = snd_mixer_handle_events (data->mixer);
 	if (err < 0) {
+		g_mutex_unlock (&data->mixer_lock);
 		xmms_log_error ("Handling of pending mixer events failed: %s",
 		                snd_strerror (err));
 		return FALSE;
@@ -726,9 +762,117 @@ xmms_alsa_volume_get (xmms_output_t *output, const gchar **names,
 		names[i] = channel_map[i].name;
 	}
 
+	g_mutex_unlock (&data->mixer_lock);
+
 	return TRUE;
 }
 
+/**
+ * Report mixer changes to the output, as soon as alsa tells us about
+ * them, instead of being polled.
+ *
+ * @param output The output struct containing alsa data.
+ * @return TRUE if changes will be reported, FALSE if there is no mixer.
+ */
+static gboolean
+xmms_alsa_volume_monitor (xmms_output_t *output)
+{
+	xmms_alsa_data_t *data;
+
+	g_return_val_if_fail (output, FALSE);
+
+	data = xmms_output_private_data_get (output);
+	g_return_val_if_fail (data, FALSE);
+
+	if (!data->mixer || !data->mixer_elem) {
+		return FALSE;
+	}
+
+	if (pipe (data->mixer_wakeup) < 0) {
+		xmms_log_error ("Unable to create mixer wakeup pipe: %s",
+		                strerror (errno));
+		return FALSE;
+	}
+
+	snd_mixer_elem_set_callback_private (data->mixer_elem, output);
+	snd_mixer_elem_set_callback (data->mixer_elem, xmms_alsa_mixer_elem_cb);
+
+	data->mixer_thread = g_thread_new ("x2 alsa mixer",
+	                                   xmms_alsa_mixer_thread, data);
+
+	return TRUE;
+}
+
+static gint
+xmms_alsa_mixer_elem_cb (snd_mixer_elem_t *elem, guint mask)
+{
+	xmms_output_t *output = snd_mixer_elem_get_callback_private (elem);
+
+	xmms_output_volume_changed (output);
+
+	return 0;
+}
+
+/**
+ * Wait for mixer events and dispatch them, which calls
+ * xmms_alsa_mixer_elem_cb for changes of our element. Runs until a
+ * byte is written to the wakeup pipe.
+ */
+static gpointer
+xmms_alsa_mixer_thread (gpointer udata)
+{
+	xmms_alsa_data_t *data = udata;
+	struct pollfd fds[MAX_MIXER_FDS + 1];
+	gushort revents;
+	gint count, err;
+
+	for (;;) {
+		g_mutex_lock (&data->mixer_lock);
+		count = snd_mixer_poll_descriptors (data->mixer, fds, MAX_MIXER_FDS);
+		g_mutex_unlock (&data->mixer_lock);
+
+		if (count < 0) {
+			xmms_log_error ("Unable to get mixer descriptors: %s",
+			                snd_strerror (count));
+			break;
+		}
+
+		fds[count].fd = data->mixer_wakeup[0];
+		fds[count].events = POLLIN;
+		fds[count].revents = 0;
+
+		if (poll (fds, count + 1, -1) < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			xmms_log_error ("Polling the mixer failed: %s", strerror (errno));
+			break;
+		}
+
+		if (fds[count].revents) {
+			break;
+		}
+
+		g_mutex_lock (&data->mixer_lock);
+		err = snd_mixer_poll_descriptors_revents (data->mixer, fds, count,
+		                                          &revents);
+		if (err >= 0 && (revents & (POLLERR | POLLNVAL))) {
+			err = -EIO;
+		} else if (err >= 0 && (revents & POLLIN)) {
+			err = snd_mixer_handle_events (data->mixer);
+		}
+		g_mutex_unlock (&data->mixer_lock);
+
+		if (err < 0) {
+			xmms_log_error ("Handling of mixer events failed: %s",
+			                snd_strerror (err));
+			break;
+		}
+	}
+
+	return NULL;
+}
+
 /**
  * Get bytes in buffer.
  * Calculates bytes in buffer by subtract buffer size with available frames
@@ -105,6 +105,7 @@ typedef struct {
 	guint32 *seektable;
 
 	/* other useful data */
+	guint32 seektablepos;
 	gint32 filesize;
 	guint32 firstframe;
 	guint32 totalsamples;
@@ -124,6 +125,7 @@ static gboolean xmms_apefile_init (xmms_xform_t *decoder);
 static void xmms_apefile_destroy (xmms_xform_t *decoder);
 
 static gboolean xmms_apefile_init_demuxer (xmms_xform_t *xform);
+static gboolean xmms_apefile_read_seektable (xmms_xform_t *xform);
 
 static gint xmms_apefile_read (xmms_xform_t *xform, xmms_sample_t *buffer,
                                gint len, xmms_error_t *err);
@@ -240,6 +242,31 @@ xmms_apefile_init (xmms_xform_t *xform)
 	                             data->samplerate,
 	                             XMMS_STREAM_TYPE_END);
 
+	if (xmms_xform_probing (xform)) {
+		xmms_sample_format_t format;
+
+		/* what avcodec decodes them to, it refuses other sizes */
+		switch (data->samplebits) {
+		case 16:
+			format = XMMS_SAMPLE_FORMAT_S16;
+			break;
+		case 24:
+			format = XMMS_SAMPLE_FORMAT_S32;
+			break;
+		default:
+			format = XMMS_SAMPLE_FORMAT_UNKNOWN;
+			break;
+		}
+
+		/* the header had it all unless a decoder is set up after all,
+		 * and that one needs the seektable */
+		if (!xmms_xform_probe_finish (xform, format) &&
+		    !xmms_apefile_read_seektable (xform)) {
+			xmms_log_error ("Couldn't read the seektable, please check log");
+			return FALSE;
+		}
+	}
+
 	return TRUE;
 }
 
@@ -249,7 +276,6 @@ xmms_apefile_init_demuxer (xmms_xform_t *xform)
 	xmms_apefile_data_t *data;
 	guchar buffer[512];
 	xmms_error_t error;
-	guint32 seektablepos;
 	gint buflen, ret;
 
 	g_return_val_if_fail (xform, FALSE);
@@ -328,8 +354,8 @@ xmms_apefile_init_demuxer (xmms_xform_t *xform)
 		data->channels          = get_le16 (header + 18);
 		data->samplerate        = get_le32 (header + 20);
 
-		seektablepos = data->descriptorlength + data->headerlength;
-		data->firstframe = seektablepos + data->seektablelength * 4 +
+		data->seektablepos = data->descriptorlength + data->headerlength;
+		data->firstframe = data->seektablepos + data->seektablelength * 4 +
 		                   data->wavheaderlength;
 	} else {
 		/* Header includes magic bytes and file version */
@@ -386,8 +412,8 @@ xmms_apefile_init_demuxer (xmms_xform_t *xform)
 			data->blocksperframe = 9216;
 		}
 
-		seektablepos = data->headerlength + data->wavheaderlength;
-		data->firstframe = seektablepos + data->seektablelength * 4;
+		data->seektablepos = data->headerlength + data->wavheaderlength;
+		data->firstframe = data->seektablepos + data->seektablelength * 4;
 	}
 
 	data->totalsamples = data->finalframeblocks;
@@ -395,25 +421,45 @@ xmms_apefile_init_demuxer (xmms_xform_t *xform)
 		data->totalsamples += data->blocksperframe * (data->totalframes - 1);
 	}
 
+	if (data->seektablelength > 0 &&
+	    data->seektablelength < data->totalframes) {
+		xmms_log_error ("Seektable length %d too small, frame count %d",
+		                 data->seektablelength,
+		                 data->totalframes);
+		/* FIXME: this is not really fatal */
+		return FALSE;
+	}
+
+	/* the seektable is only used to decode, read when that's sure */
+	if (xmms_xform_probing (xform)) {
+		return TRUE;
+	}
+
+	return xmms_apefile_read_seektable (xform);
+}
+
+static gboolean
+xmms_apefile_read_seektable (xmms_xform_t *xform)
+{
+	xmms_apefile_data_t *data;
+	xmms_error_t error;
+	gint ret;
+
+	g_return_val_if_fail (xform, FALSE);
+	data = xmms_xform_private_data_get (xform);
+	g_return_val_if_fail (data, FALSE);
+
 	if (data->seektablelength > 0) {
 		guchar *tmpbuf;
 		gint seektablebytes, i;
 
-		if (data->seektablelength < data->totalframes) {
-			xmms_log_error ("Seektable length %d too small, frame count %d",
-			                 data->seektablelength,
-			                 data->totalframes);
-			/* FIXME: this is not really fatal */
-			return FALSE;
-		}
-
-		XMMS_DBG ("Seeking to position %d", seektablepos);
+		XMMS_DBG ("Seeking to position %d", data->seektablepos);
 
 		ret = xmms_xform_seek (xform,
-		                       seektablepos,
+		                       data->seektablepos,
 		                       XMMS_XFORM_SEEK_SET,
 		                       &error);
-		if (ret != seektablepos) {
+		if (ret != data->seektablepos) {
 			xmms_log_error ("Seeking to the beginning of seektable failed");
 			/* FIXME: this is not really fatal */
 			return FALSE;
@@ -435,7 +481,6 @@ xmms_apefile_init_demuxer (xmms_xform_t *xform)
 			/* FIXME: this is not really fatal */
 			return FALSE;
 		}
-		buflen += ret;
 
 		for (i = 0; i < data->seektablelength; i++) {
 			data->seektable[i] = get_le32 (tmpbuf + i * 4);
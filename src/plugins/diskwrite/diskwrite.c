@@ -138,10 +138,10 @@ xmms_diskwrite_new (xmms_output_t *output)
 		g_snprintf (data->destdir, sizeof (data->destdir), "%s", tmp);
 	}
 
-	xmms_object_connect (XMMS_OBJECT (output),
-	                     XMMS_IPC_SIGNAL_PLAYBACK_CURRENTID,
-	                     on_playlist_entry_changed,
-	                     data);
+	xmms_object_connect_sync (XMMS_OBJECT (output),
+	                          XMMS_IPC_SIGNAL_PLAYBACK_CURRENTID,
+	                          on_playlist_entry_changed,
+	                          data);
 
 	return TRUE;
 }
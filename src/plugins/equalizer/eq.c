@@ -22,7 +22,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <math.h>
-#include "iir.h"
+#include "eq_filter.h"
 
 #define EQ_BANDS_LEGACY 10
 
@@ -42,11 +42,19 @@ typedef struct xmms_equalizer_priv_St {
 	guint use_legacy;
 	guint extra_filtering;
 	guint bands;
+	gint srate;
+	gint frame_size;
+	xmms_sample_format_t format;
 	xmms_config_property_t *gain[EQ_MAX_BANDS];
 	xmms_config_property_t *legacy[EQ_BANDS_LEGACY];
+	xmms_config_property_t *preamp;
+	xmms_eq_filter_t *filter;
+	GMutex lock;
 	gboolean enabled;
 } xmms_equalizer_data_t;
 
+static void xmms_eq_configure (xmms_equalizer_data_t *priv);
+
 XMMS_XFORM_PLUGIN ("equalizer",
                    "Equalizer effect",
                    XMMS_VERSION,
@@ -56,9 +64,14 @@ XMMS_XFORM_PLUGIN ("equalizer",
 static gboolean
 xmms_eq_plugin_setup (xmms_xform_plugin_t *xform_plugin)
 {
+	static const xmms_sample_format_t formats[] = {
+		XMMS_SAMPLE_FORMAT_FLOAT,
+		XMMS_SAMPLE_FORMAT_S16
+	};
+	static const gint rates[] = { 48000, 44100, 22050, 11025 };
 	xmms_xform_methods_t methods;
 	gchar buf[16];
-	gint i;
+	gint i, j;
 
 	XMMS_XFORM_METHODS_INIT (methods);
 
@@ -89,41 +102,18 @@ xmms_eq_plugin_setup (xmms_xform_plugin_t *xform_plugin)
 		                                            NULL, NULL);
 	}
 
-	xmms_xform_plugin_indata_add (xform_plugin,
-	                              XMMS_STREAM_TYPE_MIMETYPE,
-	                              "audio/pcm",
-	                              XMMS_STREAM_TYPE_FMT_FORMAT,
-	                              XMMS_SAMPLE_FORMAT_S16,
-	                              XMMS_STREAM_TYPE_FMT_SAMPLERATE,
-	                              48000,
-	                              XMMS_STREAM_TYPE_END);
-
-	xmms_xform_plugin_indata_add (xform_plugin,
-	                              XMMS_STREAM_TYPE_MIMETYPE,
-	                              "audio/pcm",
-	                              XMMS_STREAM_TYPE_FMT_FORMAT,
-	                              XMMS_SAMPLE_FORMAT_S16,
-	                              XMMS_STREAM_TYPE_FMT_SAMPLERATE,
-	                              44100,
-	                              XMMS_STREAM_TYPE_END);
-
-	xmms_xform_plugin_indata_add (xform_plugin,
-	                              XMMS_STREAM_TYPE_MIMETYPE,
-	                              "audio/pcm",
-	                              XMMS_STREAM_TYPE_FMT_FORMAT,
-	                              XMMS_SAMPLE_FORMAT_S16,
-	                              XMMS_STREAM_TYPE_FMT_SAMPLERATE,
-	                              22050,
-	                              XMMS_STREAM_TYPE_END);
-
-	xmms_xform_plugin_indata_add (xform_plugin,
-	                              XMMS_STREAM_TYPE_MIMETYPE,
-	                              "audio/pcm",
-	                              XMMS_STREAM_TYPE_FMT_FORMAT,
-	                              XMMS_SAMPLE_FORMAT_S16,
-	                              XMMS_STREAM_TYPE_FMT_SAMPLERATE,
-	                              11025,
-	                              XMMS_STREAM_TYPE_END);
+	for (i = 0; i < G_N_ELEMENTS (formats); i++) {
+		for (j = 0; j < G_N_ELEMENTS (rates); j++) {
+			xmms_xform_plugin_indata_add (xform_plugin,
+			                              XMMS_STREAM_TYPE_MIMETYPE,
+			                              "audio/pcm",
+			                              XMMS_STREAM_TYPE_FMT_FORMAT,
+			                              formats[i],
+			                              XMMS_STREAM_TYPE_FMT_SAMPLERATE,
+			                              rates[j],
+			                              XMMS_STREAM_TYPE_END);
+		}
+	}
 
 	return TRUE;
 }
@@ -133,16 +123,26 @@ xmms_eq_init (xmms_xform_t *xform)
 {
 	xmms_equalizer_data_t *priv;
 	xmms_config_property_t *config;
-	gint i, j, srate;
-	gfloat gain;
+	gint i, channels;
 
 	g_return_val_if_fail (xform, FALSE);
 
 	priv = g_new0 (xmms_equalizer_data_t, 1);
 	g_return_val_if_fail (priv, FALSE);
 
+	g_mutex_init (&priv->lock);
+
 	xmms_xform_private_data_set (xform, priv);
 
+	priv->format = xmms_xform_indata_get_int (xform, XMMS_STREAM_TYPE_FMT_FORMAT);
+	priv->srate = xmms_xform_indata_get_int (xform, XMMS_STREAM_TYPE_FMT_SAMPLERATE);
+	channels = xmms_xform_indata_get_int (xform, XMMS_STREAM_TYPE_FMT_CHANNELS);
+
+	priv->frame_size = xmms_sample_size_get (priv->format) * channels;
+
+	priv->filter = xmms_eq_filter_new (channels);
+	g_return_val_if_fail (priv->filter, FALSE);
+
 	config = xmms_xform_config_lookup (xform, "enabled");
 	g_return_val_if_fail (config, FALSE);
 	xmms_config_property_callback_set (config, xmms_eq_config_changed, priv);
@@ -166,11 +166,7 @@ xmms_eq_init (xmms_xform_t *xform)
 	config = xmms_xform_config_lookup (xform, "preamp");
 	g_return_val_if_fail (config, FALSE);
 	xmms_config_property_callback_set (config, xmms_eq_gain_changed, priv);
-	gain = xmms_config_property_get_float (config);
-
-	for (i=0; i<EQ_CHANNELS; i++) {
-		set_preamp (i, xmms_eq_gain_scale (gain, TRUE));
-	}
+	priv->preamp = config;
 
 	for (i=0; i<EQ_BANDS_LEGACY; i++) {
 		gchar buf[16];
@@ -181,13 +177,6 @@ xmms_eq_init (xmms_xform_t *xform)
 
 		priv->legacy[i] = config;
 		xmms_config_property_callback_set (config, xmms_eq_gain_changed, priv);
-
-		gain = xmms_config_property_get_float (config);
-		if (priv->use_legacy) {
-			for (j = 0; j < EQ_CHANNELS; j++) {
-				set_gain (i, j, xmms_eq_gain_scale (gain, FALSE));
-			}
-		}
 	}
 
 	for (i=0; i<EQ_MAX_BANDS; i++) {
@@ -199,22 +188,9 @@ xmms_eq_init (xmms_xform_t *xform)
 
 		priv->gain[i] = config;
 		xmms_config_property_callback_set (config, xmms_eq_gain_changed, priv);
-
-		gain = xmms_config_property_get_float (config);
-		if (!priv->use_legacy) {
-			for (j = 0; j < EQ_CHANNELS; j++) {
-				set_gain (i, j, xmms_eq_gain_scale (gain, FALSE));
-			}
-		}
 	}
 
-	init_iir ();
-	srate = xmms_xform_indata_get_int (xform, XMMS_STREAM_TYPE_FMT_SAMPLERATE);
-	if (priv->use_legacy) {
-		config_iir (srate, EQ_BANDS_LEGACY, 1);
-	} else {
-		config_iir (srate, priv->bands, 0);
-	}
+	xmms_eq_configure (priv);
 
 	xmms_xform_outdata_type_copy (xform);
 
@@ -227,7 +203,7 @@ static void
 xmms_eq_destroy (xmms_xform_t *xform)
 {
 	xmms_config_property_t *config;
-	gpointer priv;
+	xmms_equalizer_data_t *priv;
 	gchar buf[16];
 	gint i;
 
@@ -262,6 +238,11 @@ xmms_eq_destroy (xmms_xform_t *xform)
 		xmms_config_property_callback_remove (config, xmms_eq_gain_changed, priv);
 	}
 
+	if (priv->filter) {
+		xmms_eq_filter_free (priv->filter);
+	}
+
+	g_mutex_clear (&priv->lock);
 	g_free (priv);
 }
 
@@ -270,7 +251,7 @@ xmms_eq_read (xmms_xform_t *xform, xmms_sample_t *buf, gint len,
               xmms_error_t *error)
 {
 	xmms_equalizer_data_t *priv;
-	gint read, chan;
+	gint read;
 
 	g_return_val_if_fail (xform, -1);
 
@@ -278,9 +259,16 @@ xmms_eq_read (xmms_xform_t *xform, xmms_sample_t *buf, gint len,
 	g_return_val_if_fail (priv, -1);
 
 	read = xmms_xform_read (xform, buf, len, error);
-	chan = xmms_xform_indata_get_int (xform, XMMS_STREAM_TYPE_FMT_CHANNELS);
-	if (read > 0 && priv->enabled) {
-		iir (buf, read, chan, priv->extra_filtering);
+	if (read <= 0 || !priv->enabled) {
+		return read;
+	}
+
+	if (priv->format == XMMS_SAMPLE_FORMAT_FLOAT) {
+		xmms_eq_filter_process_float (priv->filter, (gfloat *) buf,
+		                              read / priv->frame_size);
+	} else {
+		xmms_eq_filter_process_s16 (priv->filter, (gint16 *) buf,
+		                            read / priv->frame_size);
 	}
 
 	return read;
@@ -292,6 +280,45 @@ xmms_eq_seek (xmms_xform_t *xform, gint64 offset, xmms_xform_seek_mode_t whence,
 	return xmms_xform_seek (xform, offset, whence, err);
 }
 
+/**
+ * Compute the filter setup from the current configuration.
+ *
+ * This runs in whatever thread changed the configuration, the audio
+ * thread only swaps in the finished result.
+ */
+static void
+xmms_eq_configure (xmms_equalizer_data_t *priv)
+{
+	xmms_config_property_t **props;
+	gfloat gains[EQ_MAX_BANDS];
+	gfloat preamp;
+	gint i, bands;
+
+	g_mutex_lock (&priv->lock);
+
+	if (priv->use_legacy) {
+		props = priv->legacy;
+		bands = EQ_BANDS_LEGACY;
+	} else {
+		props = priv->gain;
+		bands = priv->bands;
+	}
+
+	for (i = 0; i < bands; i++) {
+		gains[i] = xmms_eq_gain_scale (xmms_config_property_get_float (props[i]),
+		                               FALSE);
+	}
+
+	preamp = xmms_eq_gain_scale (xmms_config_property_get_float (priv->preamp),
+	                             TRUE);
+
+	xmms_eq_filter_configure (priv->filter, priv->srate, bands,
+	                          priv->use_legacy, gains, preamp,
+	                          priv->extra_filtering);
+
+	g_mutex_unlock (&priv->lock);
+}
+
 static void
 xmms_eq_gain_changed (xmms_object_t *object, xmmsv_t *_data,
                       gpointer userdata)
@@ -299,13 +326,12 @@ xmms_eq_gain_changed (xmms_object_t *object, xmmsv_t *_data,
 	xmms_config_property_t *val;
 	xmms_equalizer_data_t *priv;
 	const gchar *name;
-	gint i;
 	gfloat gain;
 
 	g_return_if_fail (object);
 	g_return_if_fail (userdata);
 
-        val = (xmms_config_property_t *) object;
+	val = (xmms_config_property_t *) object;
 	priv = userdata;
 
 	name = xmms_config_property_get_name (val);
@@ -320,7 +346,9 @@ xmms_eq_gain_changed (xmms_object_t *object, xmmsv_t *_data,
 		gain = CLAMP (gain, -20.0, 20.0);
 		g_snprintf (buf, sizeof (buf), "%g", gain);
 
+		/* triggers another callback with the clamped value */
 		xmms_config_property_set_data (val, buf);
+		return;
 	}
 
 	/* we are passed the full config key, not just the last token,
@@ -329,27 +357,13 @@ xmms_eq_gain_changed (xmms_object_t *object, xmmsv_t *_data,
 	 */
 	name = strrchr (name, '.') + 1;
 
-	if (!strcmp (name, "preamp")) {
-		/* scale the -20.0 - 20.0 value to correct one */
-		for (i=0; i<EQ_CHANNELS; i++) {
-			set_preamp (i, xmms_eq_gain_scale (gain, TRUE));
-		}
-	} else {
-		gint band = -1;
-
-		if (!strncmp (name, "gain", 4) && !priv->use_legacy) {
-			band = atoi (name + 4);
-		} else if (!strncmp (name, "legacy", 6) && priv->use_legacy) {
-			band = atoi (name + 6);
-		}
-
-		if (band >= 0) {
-			/* scale the -20.0 - 20.0 value to correct one */
-			for (i=0; i<EQ_CHANNELS; i++) {
-				set_gain (band, i, xmms_eq_gain_scale (gain, FALSE));
-			}
-		}
+	/* the gains of the inactive set don't matter */
+	if ((!strncmp (name, "gain", 4) && priv->use_legacy) ||
+	    (!strncmp (name, "legacy", 6) && !priv->use_legacy)) {
+		return;
 	}
+
+	xmms_eq_configure (priv);
 }
 
 static void
@@ -358,7 +372,7 @@ xmms_eq_config_changed (xmms_object_t * object, xmmsv_t *_data, gpointer userdat
 	xmms_config_property_t *val;
 	xmms_equalizer_data_t *priv;
 	const gchar *name;
-	gint value, i, j;
+	gint value, i;
 
 	g_return_if_fail (object);
 	g_return_if_fail (userdata);
@@ -381,25 +395,10 @@ xmms_eq_config_changed (xmms_object_t * object, xmmsv_t *_data, gpointer userdat
 		priv->enabled = !!value;
 	} else if (!strcmp (name, "extra_filtering")) {
 		priv->extra_filtering = value;
+		xmms_eq_configure (priv);
 	} else if (!strcmp (name, "use_legacy")) {
-		gfloat gain;
-
 		priv->use_legacy = value;
-		if (priv->use_legacy) {
-			for (i=0; i<EQ_BANDS_LEGACY; i++) {
-				gain = xmms_config_property_get_float (priv->legacy[i]);
-				for (j=0; j<EQ_CHANNELS; j++) {
-					set_gain (j, i, xmms_eq_gain_scale (gain, FALSE));
-				}
-			}
-		} else {
-			for (i=0; i<priv->bands; i++) {
-				gain = xmms_config_property_get_float (priv->gain[i]);
-				for (j=0; j<EQ_CHANNELS; j++) {
-					set_gain (j, i, xmms_eq_gain_scale (gain, FALSE));
-				}
-			}
-		}
+		xmms_eq_configure (priv);
 	} else if (!strcmp (name, "bands")) {
 		if (value != 10 && value != 15 && value != 25 && value != 31) {
 			gchar buf[20];
@@ -411,12 +410,8 @@ xmms_eq_config_changed (xmms_object_t * object, xmmsv_t *_data, gpointer userdat
 			priv->bands = value;
 			for (i=0; i<EQ_MAX_BANDS; i++) {
 				xmms_config_property_set_data (priv->gain[i], "0.0");
-				if (!priv->use_legacy) {
-					for (j=0; j<EQ_CHANNELS; j++) {
-						set_gain (j, i, xmms_eq_gain_scale (0.0, FALSE));
-					}
-				}
 			}
+			xmms_eq_configure (priv);
 		}
 	}
 }
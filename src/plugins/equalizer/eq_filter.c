@@ -0,0 +1,289 @@
+/** @file eq_filter.c
+ *  Per-instance filter bank of the equalizer effect
+ *
+ *  Copyright (C) 2006-2013 XMMS2 Team
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License
+ *  as published by the Free Software Foundation; either version 2
+ *  of the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ */
+
+/*
+ * Every band is a second order band pass section
+ *
+ *   y[n] = alpha * (x[n] - x[n-2]) + gamma * y[n-1] - beta * y[n-2]
+ *
+ * all fed with the same input, and the output is the gain weighted sum
+ * of the bands plus a quarter of the input. With extra filtering the
+ * sum is run through a second bank before the input is added back.
+ *
+ * As the bands only depend on their own history, four of them are
+ * computed at once, and the input difference is shared by all of them.
+ * The band count is padded to a multiple of four with silent bands.
+ */
+
+#include <glib.h>
+#include <math.h>
+#include <string.h>
+
+#ifdef __SSE__
+#include <xmmintrin.h>
+#endif
+
+#include "eq_filter.h"
+
+#define EQ_BANDS_PADDED ((EQ_MAX_BANDS + 3) & ~3)
+
+/* flush-to-zero, the band histories decay into denormals on silence */
+#define EQ_MXCSR_FTZ 0x8000
+
+typedef struct xmms_eq_params_St {
+	gint bands;
+	gboolean extra_filtering;
+	gfloat preamp;
+	gfloat alpha[EQ_BANDS_PADDED];
+	gfloat beta[EQ_BANDS_PADDED];
+	gfloat gamma[EQ_BANDS_PADDED];
+	gfloat gain[EQ_BANDS_PADDED];
+} xmms_eq_params_t;
+
+typedef struct xmms_eq_bank_St {
+	gfloat y1[EQ_BANDS_PADDED];
+	gfloat y2[EQ_BANDS_PADDED];
+	gfloat x1, x2;
+} xmms_eq_bank_t;
+
+typedef struct xmms_eq_history_St {
+	xmms_eq_bank_t bank[2];
+} xmms_eq_history_t;
+
+struct xmms_eq_filter_St {
+	gint channels;
+
+	/* only touched by the processing thread */
+	xmms_eq_params_t *params;
+	xmms_eq_history_t *history;
+
+	/* set by configure, taken over by the processing thread */
+	xmms_eq_params_t *pending;
+};
+
+xmms_eq_filter_t *
+xmms_eq_filter_new (gint channels)
+{
+	xmms_eq_filter_t *filter;
+
+	g_return_val_if_fail (channels > 0, NULL);
+
+	filter = g_new0 (xmms_eq_filter_t, 1);
+	filter->channels = channels;
+	filter->history = g_new0 (xmms_eq_history_t, channels);
+
+	return filter;
+}
+
+void
+xmms_eq_filter_free (xmms_eq_filter_t *filter)
+{
+	g_return_if_fail (filter);
+
+	g_free (filter->pending);
+	g_free (filter->params);
+	g_free (filter->history);
+	g_free (filter);
+}
+
+void
+xmms_eq_filter_configure (xmms_eq_filter_t *filter, gint srate, gint bands,
+                          gboolean original_freqs, const gfloat *gains,
+                          gfloat preamp, gboolean extra_filtering)
+{
+	sIIRCoefficients cfs[EQ_MAX_BANDS];
+	xmms_eq_params_t *params, *old;
+	gint i;
+
+	g_return_if_fail (filter);
+	g_return_if_fail (gains);
+
+	params = g_new0 (xmms_eq_params_t, 1);
+
+	bands = calc_coeffs (cfs, bands, srate, original_freqs);
+	for (i = 0; i < bands; i++) {
+		params->alpha[i] = cfs[i].alpha;
+		params->beta[i] = cfs[i].beta;
+		params->gamma[i] = cfs[i].gamma;
+		params->gain[i] = gains[i];
+	}
+
+	params->bands = (bands + 3) & ~3;
+	params->preamp = preamp;
+	params->extra_filtering = extra_filtering;
+
+	/* replace whatever the processing thread hasn't picked up yet */
+	do {
+		old = g_atomic_pointer_get (&filter->pending);
+	} while (!g_atomic_pointer_compare_and_exchange (&filter->pending,
+	                                                 old, params));
+
+	g_free (old);
+}
+
+/* Take over the latest configuration, if there is a new one */
+static void
+xmms_eq_filter_sync (xmms_eq_filter_t *filter)
+{
+	xmms_eq_params_t *params;
+
+	params = g_atomic_pointer_get (&filter->pending);
+	if (!params) {
+		return;
+	}
+
+	/* lost against configure, pick up the newer one next time */
+	if (!g_atomic_pointer_compare_and_exchange (&filter->pending,
+	                                            params, NULL)) {
+		return;
+	}
+
+	/* different bands, the old history means nothing anymore */
+	if (!filter->params || filter->params->bands != params->bands ||
+	    memcmp (filter->params->alpha, params->alpha,
+	            sizeof (params->alpha))) {
+		memset (filter->history, 0,
+		        filter->channels * sizeof (xmms_eq_history_t));
+	}
+
+	g_free (filter->params);
+	filter->params = params;
+}
+
+/* Run one sample through a bank, returns the gain weighted sum */
+static inline gfloat
+xmms_eq_bank_run (const xmms_eq_params_t *p, xmms_eq_bank_t *bank, gfloat x)
+{
+	gfloat diff, sum;
+	gint i;
+
+	diff = x - bank->x2;
+	bank->x2 = bank->x1;
+	bank->x1 = x;
+
+#ifdef __SSE__
+	{
+		__m128 vdiff = _mm_set1_ps (diff);
+		__m128 acc = _mm_setzero_ps ();
+		gfloat tmp[4];
+
+		for (i = 0; i < p->bands; i += 4) {
+			__m128 y1 = _mm_loadu_ps (bank->y1 + i);
+			__m128 y2 = _mm_loadu_ps (bank->y2 + i);
+			__m128 y;
+
+			y = _mm_mul_ps (_mm_loadu_ps (p->alpha + i), vdiff);
+			y = _mm_add_ps (y, _mm_mul_ps (_mm_loadu_ps (p->gamma + i), y1));
+			y = _mm_sub_ps (y, _mm_mul_ps (_mm_loadu_ps (p->beta + i), y2));
+
+			_mm_storeu_ps (bank->y2 + i, y1);
+			_mm_storeu_ps (bank->y1 + i, y);
+
+			acc = _mm_add_ps (acc, _mm_mul_ps (y, _mm_loadu_ps (p->gain + i)));
+		}
+
+		_mm_storeu_ps (tmp, acc);
+		sum = (tmp[0] + tmp[1]) + (tmp[2] + tmp[3]);
+	}
+#else
+	sum = 0.0f;
+	for (i = 0; i < p->bands; i++) {
+		gfloat y;
+
+		y = p->alpha[i] * diff + p->gamma[i] * bank->y1[i]
+		    - p->beta[i] * bank->y2[i];
+
+		bank->y2[i] = bank->y1[i];
+		bank->y1[i] = y;
+
+		sum += y * p->gain[i];
+	}
+#endif
+
+	return sum;
+}
+
+static inline gfloat
+xmms_eq_filter_run (const xmms_eq_params_t *p, xmms_eq_history_t *history,
+                    gfloat sample)
+{
+	gfloat pcm, out;
+
+	pcm = sample * p->preamp;
+
+	out = xmms_eq_bank_run (p, &history->bank[0], pcm);
+	if (p->extra_filtering) {
+		out += xmms_eq_bank_run (p, &history->bank[1], out);
+	}
+
+	return out + pcm * 0.25f;
+}
+
+void
+xmms_eq_filter_process_s16 (xmms_eq_filter_t *filter, gint16 *samples,
+                            gint frames)
+{
+	xmms_eq_params_t *p;
+	gint i, c;
+#ifdef __SSE__
+	guint mxcsr = _mm_getcsr ();
+	_mm_setcsr (mxcsr | EQ_MXCSR_FTZ);
+#endif
+
+	xmms_eq_filter_sync (filter);
+	p = filter->params;
+
+	for (i = 0; p && i < frames; i++) {
+		for (c = 0; c < filter->channels; c++) {
+			gfloat out;
+
+			out = xmms_eq_filter_run (p, &filter->history[c], *samples);
+			out = CLAMP (out, G_MININT16, G_MAXINT16);
+
+			*samples++ = lrintf (out);
+		}
+	}
+
+#ifdef __SSE__
+	_mm_setcsr (mxcsr);
+#endif
+}
+
+void
+xmms_eq_filter_process_float (xmms_eq_filter_t *filter, gfloat *samples,
+                              gint frames)
+{
+	xmms_eq_params_t *p;
+	gint i, c;
+#ifdef __SSE__
+	guint mxcsr = _mm_getcsr ();
+	_mm_setcsr (mxcsr | EQ_MXCSR_FTZ);
+#endif
+
+	xmms_eq_filter_sync (filter);
+	p = filter->params;
+
+	for (i = 0; p && i < frames; i++) {
+		for (c = 0; c < filter->channels; c++) {
+			*samples = xmms_eq_filter_run (p, &filter->history[c], *samples);
+			samples++;
+		}
+	}
+
+#ifdef __SSE__
+	_mm_setcsr (mxcsr);
+#endif
+}
@@ -0,0 +1,47 @@
+/** @file eq_filter.h
+ *  Per-instance filter bank of the equalizer effect
+ *
+ *  Copyright (C) 2006-2013 XMMS2 Team
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License
+ *  as published by the Free Software Foundation; either version 2
+ *  of the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ */
+
+#ifndef __XMMS_EQ_FILTER_H__
+#define __XMMS_EQ_FILTER_H__
+
+#include <glib.h>
+
+#include "iir_cfs.h"
+
+typedef struct xmms_eq_filter_St xmms_eq_filter_t;
+
+xmms_eq_filter_t *xmms_eq_filter_new (gint channels);
+void xmms_eq_filter_free (xmms_eq_filter_t *filter);
+
+/**
+ * Compute a new set of coefficients and gains and hand it over to the
+ * processing functions, which pick it up on their next call. May be
+ * called from any thread, concurrently with processing.
+ *
+ * @param gains The scaled gain of each of the bands
+ * @param preamp The scaled preamp gain
+ */
+void xmms_eq_filter_configure (xmms_eq_filter_t *filter, gint srate,
+                               gint bands, gboolean original_freqs,
+                               const gfloat *gains, gfloat preamp,
+                               gboolean extra_filtering);
+
+void xmms_eq_filter_process_s16 (xmms_eq_filter_t *filter, gint16 *samples,
+                                 gint frames);
+void xmms_eq_filter_process_float (xmms_eq_filter_t *filter, gfloat *samples,
+                                   gint frames);
+
+#endif
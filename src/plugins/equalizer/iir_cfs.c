@@ -25,22 +25,6 @@
 #include <math.h>
 #include "iir_cfs.h"
 
-/***************************
- * IIR filter coefficients *
- ***************************/
-static sIIRCoefficients iir_cf10_11k_11025[10] __attribute__((aligned));
-static sIIRCoefficients iir_cf10_22k_22050[10] __attribute__((aligned));
-static sIIRCoefficients iir_cforiginal10_44100[10] __attribute__((aligned));
-static sIIRCoefficients iir_cforiginal10_48000[10] __attribute__((aligned));
-static sIIRCoefficients iir_cf10_44100[10] __attribute__((aligned));
-static sIIRCoefficients iir_cf10_48000[10] __attribute__((aligned));
-static sIIRCoefficients iir_cf15_44100[15] __attribute__((aligned));
-static sIIRCoefficients iir_cf15_48000[15] __attribute__((aligned));
-static sIIRCoefficients iir_cf25_44100[25] __attribute__((aligned));
-static sIIRCoefficients iir_cf25_48000[25] __attribute__((aligned));
-static sIIRCoefficients iir_cf31_44100[31] __attribute__((aligned));
-static sIIRCoefficients iir_cf31_48000[31] __attribute__((aligned));
-
 /******************************************************************
  * Definitions and data structures to calculate the coefficients
  ******************************************************************/
@@ -71,8 +55,7 @@ static const double band_f031[] =
 #define GAIN_F0 1.0
 #define GAIN_F1 GAIN_F0 / M_SQRT2
 
-#define SAMPLING_FREQ 44100.0
-#define TETA(f) (2*M_PI*(double)f/bands[n].sfreq)
+#define TETA(f) (2*M_PI*(double)f/sfreq)
 #define TWOPOWER(value) (value * value)
 
 #define BETA2(tf0, tf) \
@@ -94,72 +77,52 @@ static const double band_f031[] =
 #define GAMMA(beta, tf0) ((0.5 + beta) * cos(tf0))
 #define ALPHA(beta) ((0.5 - beta)/2.0)
 
-struct {
-    sIIRCoefficients *coeffs;
+static const struct {
     const double *cfs;
     double octave;
     int band_count;
-    double sfreq;
 } bands[] = {
-  { iir_cf10_11k_11025,     band_f011k,         1.0,     10, 11025.0 },
-  { iir_cf10_22k_22050,     band_f022k,         1.0,     10, 22050.0 },
-  { iir_cforiginal10_44100, band_original_f010, 1.0,     10, 44100.0 },
-  { iir_cforiginal10_48000, band_original_f010, 1.0,     10, 48000.0 },
-  { iir_cf10_44100,         band_f010,          1.0,     10, 44100.0 },
-  { iir_cf10_48000,         band_f010,          1.0,     10, 48000.0 },
-  { iir_cf15_44100,         band_f015,          2.0/3.0, 15, 44100.0 },
-  { iir_cf15_48000,         band_f015,          2.0/3.0, 15, 48000.0 },
-  { iir_cf25_44100,         band_f025,          1.0/3.0, 25, 44100.0 },
-  { iir_cf25_48000,         band_f025,          1.0/3.0, 25, 48000.0 },
-  { iir_cf31_44100,         band_f031,          1.0/3.0, 31, 44100.0 },
-  { iir_cf31_48000,         band_f031,          1.0/3.0, 31, 48000.0 },
-  { 0 }
+  { band_f011k,         1.0,     10 },
+  { band_f022k,         1.0,     10 },
+  { band_original_f010, 1.0,     10 },
+  { band_f010,          1.0,     10 },
+  { band_f015,          2.0/3.0, 15 },
+  { band_f025,          1.0/3.0, 25 },
+  { band_f031,          1.0/3.0, 31 },
+};
+
+enum {
+  BANDS_10_11K,
+  BANDS_10_22K,
+  BANDS_ORIGINAL_10,
+  BANDS_10,
+  BANDS_15,
+  BANDS_25,
+  BANDS_31
 };
 
 /*************
  * Functions *
  *************/
 
-/* Get the coeffs for a given number of bands and sampling frequency */
-sIIRCoefficients* get_coeffs(int *bands, int sfreq, int use_xmms_original_freqs)
+/* Pick the band set for a given number of bands and sampling frequency */
+static int find_band_set(int band_count, int sfreq, int use_xmms_original_freqs)
 {
-  sIIRCoefficients *iir_cf = 0;
   switch(sfreq)
   {
-    case 11025: iir_cf = iir_cf10_11k_11025;
-                *bands = 10;
-                break;
-    case 22050: iir_cf = iir_cf10_22k_22050;
-                *bands = 10;
-                break;
-    case 48000:
-                switch(*bands)
-                {
-                  case 31: iir_cf = iir_cf31_48000; break;
-                  case 25: iir_cf = iir_cf25_48000; break;
-                  case 15: iir_cf = iir_cf15_48000; break;
-                  default:
-                           iir_cf = use_xmms_original_freqs ?
-                             iir_cforiginal10_48000 :
-                             iir_cf10_48000;
-                           break;
-                }
-                break;
+    case 11025: return BANDS_10_11K;
+    case 22050: return BANDS_10_22K;
     default:
-                switch(*bands)
+                switch(band_count)
                 {
-                  case 31: iir_cf = iir_cf31_44100; break;
-                  case 25: iir_cf = iir_cf25_44100; break;
-                  case 15: iir_cf = iir_cf15_44100; break;
+                  case 31: return BANDS_31;
+                  case 25: return BANDS_25;
+                  case 15: return BANDS_15;
                   default:
-                           iir_cf = use_xmms_original_freqs ?
-                             iir_cforiginal10_44100 :
-                             iir_cf10_44100;
-                           break;
+                           return use_xmms_original_freqs ?
+                             BANDS_ORIGINAL_10 : BANDS_10;
                 }
-                break;
   }
-  return iir_cf;
 }
 
 /* Get the freqs at both sides of F0. These will be cut at -3dB */
@@ -185,51 +148,55 @@ static int find_root(double a, double b, double c, double *x0) {
   return 0;
 }
 
-/* Calculate all the coefficients as specified in the bands[] array */
-void calc_coeffs(void)
+/* Calculate the coefficients of the band set matching band_count and
+ * sfreq into cfs, which must have room for EQ_MAX_BANDS entries.
+ * Returns the number of bands of the chosen set. */
+int calc_coeffs(sIIRCoefficients *cfs, int band_count, int sfreq,
+                int use_xmms_original_freqs)
 {
+  const double *freqs;
   int i, n;
   double f1, f2;
   double x0;
 
-  n = 0;
-  for (; bands[n].cfs; n++) {
-    double *freqs = (double *)bands[n].cfs;
-    for (i=0; i<bands[n].band_count; i++)
-    {
+  n = find_band_set(band_count, sfreq, use_xmms_original_freqs);
+  freqs = bands[n].cfs;
+
+  for (i=0; i<bands[n].band_count; i++)
+  {
 
-      /* Find -3dB frequencies for the center freq */
-      find_f1_and_f2(freqs[i], bands[n].octave, &f1, &f2);
-      /* Find Beta */
-      if ( find_root(
-            BETA2(TETA(freqs[i]), TETA(f1)),
-            BETA1(TETA(freqs[i]), TETA(f1)),
-            BETA0(TETA(freqs[i]), TETA(f1)),
-            &x0) == 0)
-      {
-        /* Got a solution, now calculate the rest of the factors */
-        /* Take the smallest root always (find_root returns the smallest one)
-         *
-         * NOTE: The IIR equation is
-         *	y[n] = 2 * (alpha*(x[n]-x[n-2]) + gamma*y[n-1] - beta*y[n-2])
-         *  Now the 2 factor has been distributed in the coefficients
-         */
-        /* Now store the coefficients */
-        bands[n].coeffs[i].beta = 2.0 * x0;
-        bands[n].coeffs[i].alpha = 2.0 * ALPHA(x0);
-        bands[n].coeffs[i].gamma = 2.0 * GAMMA(x0, TETA(freqs[i]));
+    /* Find -3dB frequencies for the center freq */
+    find_f1_and_f2(freqs[i], bands[n].octave, &f1, &f2);
+    /* Find Beta */
+    if ( find_root(
+          BETA2(TETA(freqs[i]), TETA(f1)),
+          BETA1(TETA(freqs[i]), TETA(f1)),
+          BETA0(TETA(freqs[i]), TETA(f1)),
+          &x0) == 0)
+    {
+      /* Got a solution, now calculate the rest of the factors */
+      /* Take the smallest root always (find_root returns the smallest one)
+       *
+       * NOTE: The IIR equation is
+       *	y[n] = 2 * (alpha*(x[n]-x[n-2]) + gamma*y[n-1] - beta*y[n-2])
+       *  Now the 2 factor has been distributed in the coefficients
+       */
+      /* Now store the coefficients */
+      cfs[i].beta = 2.0 * x0;
+      cfs[i].alpha = 2.0 * ALPHA(x0);
+      cfs[i].gamma = 2.0 * GAMMA(x0, TETA(freqs[i]));
 #ifdef DEBUG
-        printf("Freq[%d]: %f. Beta: %.10e Alpha: %.10e Gamma %.10e\n",
-            i, freqs[i], bands[n].coeffs[i].beta,
-            bands[n].coeffs[i].alpha, bands[n].coeffs[i].gamma);
+      printf("Freq[%d]: %f. Beta: %.10e Alpha: %.10e Gamma %.10e\n",
+          i, freqs[i], cfs[i].beta, cfs[i].alpha, cfs[i].gamma);
 #endif
-      } else {
-        /* Shouldn't happen */
-        bands[n].coeffs[i].beta = 0.;
-        bands[n].coeffs[i].alpha = 0.;
-        bands[n].coeffs[i].gamma = 0.;
-        printf("  **** Where are the roots?\n");
-      }
-    }/* for i */
-  }/* for n */
+    } else {
+      /* Shouldn't happen */
+      cfs[i].beta = 0.;
+      cfs[i].alpha = 0.;
+      cfs[i].gamma = 0.;
+      printf("  **** Where are the roots?\n");
+    }
+  }/* for i */
+
+  return bands[n].band_count;
 }
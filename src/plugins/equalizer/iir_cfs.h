@@ -31,8 +31,9 @@ typedef struct
     float dummy; /* Word alignment */
 }sIIRCoefficients;
 
-sIIRCoefficients* get_coeffs(int *bands, int sfreq, 
-                             int use_xmms_original_freqs);
-void calc_coeffs(void);
+#define EQ_MAX_BANDS 31
+
+int calc_coeffs(sIIRCoefficients *cfs, int band_count, int sfreq,
+                int use_xmms_original_freqs);
 
 #endif
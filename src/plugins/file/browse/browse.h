@@ -2,8 +2,11 @@
 #define __XMMS_FILE_BROWSE_H__
 
 #include <xmms/xmms_xformplugin.h>
+#include <sys/types.h>
+#include <sys/stat.h>
 
 gboolean xmms_file_browse (xmms_xform_t *xform, const gchar *url,
                            xmms_error_t *error);
+gchar *xmms_file_fingerprint (const struct stat *st);
 
 #endif
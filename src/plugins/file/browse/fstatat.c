@@ -68,8 +68,15 @@ xmms_file_browse (xmms_xform_t *xform,
 		xmms_xform_browse_add_entry (xform, entry, flags);
 
 		if (!S_ISDIR (st.st_mode)) {
+			gchar *fingerprint;
+
 			xmms_xform_browse_add_entry_property_int (xform, "size",
 			                                          st.st_size);
+
+			fingerprint = xmms_file_fingerprint (&st);
+			xmms_xform_browse_add_entry_property_str (xform, "fingerprint",
+			                                          fingerprint);
+			g_free (fingerprint);
 		}
 	}
 
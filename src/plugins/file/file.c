@@ -14,6 +14,7 @@
  *  Lesser General Public License for more details.
  */
 
+#include <xmms_configuration.h>
 #include <xmms/xmms_xformplugin.h>
 #include <xmms/xmms_log.h>
 
@@ -92,6 +93,7 @@ xmms_file_init (xmms_xform_t *xform)
 	xmms_file_data_t *data;
 	const gchar *url;
 	const gchar *metakey;
+	gchar *fingerprint;
 	struct stat st;
 
 	url = xmms_xform_indata_get_str (xform, XMMS_STREAM_TYPE_URL);
@@ -132,9 +134,36 @@ xmms_file_init (xmms_xform_t *xform)
 	metakey = XMMS_MEDIALIB_ENTRY_PROPERTY_LMOD;
 	xmms_xform_metadata_set_int (xform, metakey, st.st_mtime);
 
+	fingerprint = xmms_file_fingerprint (&st);
+	metakey = XMMS_MEDIALIB_ENTRY_PROPERTY_FINGERPRINT;
+	xmms_xform_metadata_set_str (xform, metakey, fingerprint);
+	g_free (fingerprint);
+
 	return TRUE;
 }
 
+/**
+ * Describe the state of a file cheaply, the fingerprint changes when the
+ * file is rewritten or replaced. Also used for the entries of a directory
+ * listing, so a rescan can compare them with the medialib without
+ * opening the files.
+ */
+gchar *
+xmms_file_fingerprint (const struct stat *st)
+{
+	glong nsec = 0;
+
+	/* tag editors rewrite in place, possibly within the same second */
+#ifdef HAVE_STRUCT_STAT_ST_MTIM
+	nsec = st->st_mtim.tv_nsec;
+#endif
+
+	return g_strdup_printf ("%" G_GUINT64_FORMAT "-%" G_GINT64_FORMAT
+	                        ".%09ld-%" G_GUINT64_FORMAT,
+	                        (guint64) st->st_size, (gint64) st->st_mtime,
+	                        nsec, (guint64) st->st_ino);
+}
+
 static void
 xmms_file_destroy (xmms_xform_t *xform)
 {
@@ -193,10 +193,10 @@ xmms_ices_new (xmms_output_t *output)
 	xmms_output_private_data_set (output, data);
 	xmms_output_format_add (output, XMMS_SAMPLE_FORMAT_FLOAT, 2, 44100);
 
-	xmms_object_connect (XMMS_OBJECT (output),
-	                     XMMS_IPC_SIGNAL_PLAYBACK_CURRENTID,
-	                     on_playlist_entry_changed,
-	                     data);
+	xmms_object_connect_sync (XMMS_OBJECT (output),
+	                          XMMS_IPC_SIGNAL_PLAYBACK_CURRENTID,
+	                          on_playlist_entry_changed,
+	                          data);
 
 	return TRUE;
 }
@@ -51,6 +51,7 @@ static void xmms_mp4_destroy (xmms_xform_t *xform);
 static gint xmms_mp4_read (xmms_xform_t *xform, xmms_sample_t *buf, gint len, xmms_error_t *err);
 static gint64 xmms_mp4_seek (xmms_xform_t *xform, gint64 samples, xmms_xform_seek_mode_t whence, xmms_error_t *err);
 static void xmms_mp4_get_mediainfo (xmms_xform_t *xform);
+static xmms_sample_format_t xmms_mp4_get_format (xmms_xform_t *xform, const guchar *config, guint len);
 static gboolean xmms_mp4_mediainfo_set_coverart (xmms_xform_t *xform, const gchar *key, const gchar *value, gsize length);
 
 static uint32_t xmms_mp4_read_callback (void *user_data, void *buffer, uint32_t length);
@@ -182,6 +183,8 @@ xmms_mp4_init (xmms_xform_t *xform)
 	guchar *tmpbuf;
 	guint tmpbuflen;
 
+	xmms_sample_format_t format;
+
 	g_return_val_if_fail (xform, FALSE);
 
 	data = g_new0 (xmms_mp4_data_t, 1);
@@ -235,10 +238,16 @@ xmms_mp4_init (xmms_xform_t *xform)
 	mp4ff_get_decoder_config (data->mp4ff, data->track, &tmpbuf,
 	                          &tmpbuflen);
 	xmms_xform_auxdata_set_bin (xform, "decoder_config", tmpbuf, tmpbuflen);
+	format = xmms_mp4_get_format (xform, tmpbuf, tmpbuflen);
 	g_free (tmpbuf);
 
 	xmms_mp4_get_mediainfo (xform);
 
+	/* the container had it all, no need to set up a decoder */
+	if (xmms_xform_probing (xform)) {
+		xmms_xform_probe_finish (xform, format);
+	}
+
 	XMMS_DBG ("MP4 demuxer inited successfully!");
 
 	return TRUE;
@@ -343,6 +352,41 @@ xmms_mp4_mediainfo_set_coverart (xmms_xform_t *xform, const gchar *key,
 	return TRUE;
 }
 
+/**
+ * Find the sample format the track decodes to, if the container tells.
+ *
+ * The AAC decoders pick the format themselves, and only the decoder
+ * knows the real samplerate of HE-AAC, where the container has the
+ * rate of the core stream. ALAC has the bit depth in its magic cookie.
+ */
+static xmms_sample_format_t
+xmms_mp4_get_format (xmms_xform_t *xform, const guchar *config, guint len)
+{
+	xmms_mp4_data_t *data;
+
+	data = xmms_xform_private_data_get (xform);
+	g_return_val_if_fail (data, XMMS_SAMPLE_FORMAT_UNKNOWN);
+
+	if (mp4ff_get_audio_type (data->mp4ff, data->track) != 0xff) {
+		return XMMS_SAMPLE_FORMAT_UNKNOWN;
+	}
+
+	/* atom size and name, version, frame length, compatible version */
+	if (!config || len < 18) {
+		return XMMS_SAMPLE_FORMAT_UNKNOWN;
+	}
+
+	/* what avcodec decodes them to, it refuses other depths */
+	switch (config[17]) {
+	case 16:
+		return XMMS_SAMPLE_FORMAT_S16;
+	case 24:
+		return XMMS_SAMPLE_FORMAT_S32;
+	default:
+		return XMMS_SAMPLE_FORMAT_UNKNOWN;
+	}
+}
+
 static void
 xmms_mp4_get_mediainfo (xmms_xform_t *xform)
 {
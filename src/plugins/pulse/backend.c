@@ -53,6 +53,8 @@ struct xmms_pulse {
 	pa_channel_map channel_map;
 	int operation_success;
 	int volume;
+	void (*volume_cb) (void *userdata);
+	void *volume_cb_data;
 };
 
 static gboolean check_pulse_health (xmms_pulse *p, int *rerror)
@@ -127,6 +129,23 @@ static void stream_request_cb (pa_stream *s, size_t length, void *userdata)
 	signal_mainloop (userdata);
 }
 
+static void subscribe_cb (pa_context *c, pa_subscription_event_type_t t,
+                          uint32_t idx, void *userdata)
+{
+	xmms_pulse *p = userdata;
+	assert (p);
+
+	if ((t & PA_SUBSCRIPTION_EVENT_FACILITY_MASK) != PA_SUBSCRIPTION_EVENT_SINK_INPUT)
+		return;
+
+	/* only our own stream is interesting */
+	if (!p->stream || pa_stream_get_index (p->stream) != idx)
+		return;
+
+	if (p->volume_cb)
+		p->volume_cb (p->volume_cb_data);
+}
+
 static void drain_result_cb (pa_stream *s, int success, void *userdata)
 {
 	xmms_pulse *p = userdata;
@@ -201,6 +220,33 @@ xmms_pulse_backend_new (const char *server, const char *name,
 }
 
 
+/*
+ * Call cb whenever the volume of our stream may have changed. The
+ * callback runs in the mainloop thread.
+ */
+void xmms_pulse_backend_set_volume_callback (xmms_pulse *p,
+                                             void (*cb) (void *userdata),
+                                             void *userdata)
+{
+	pa_operation *o;
+	assert (p);
+
+	pa_threaded_mainloop_lock (p->mainloop);
+
+	p->volume_cb = cb;
+	p->volume_cb_data = userdata;
+
+	pa_context_set_subscribe_callback (p->context, subscribe_cb, p);
+
+	o = pa_context_subscribe (p->context, PA_SUBSCRIPTION_MASK_SINK_INPUT,
+	                          NULL, NULL);
+	if (o)
+		pa_operation_unref (o);
+
+	pa_threaded_mainloop_unlock (p->mainloop);
+}
+
+
 void xmms_pulse_backend_free (xmms_pulse *p)
 {
 	assert (p);
@@ -6,6 +6,9 @@ typedef struct xmms_pulse xmms_pulse;
 xmms_pulse* xmms_pulse_backend_new(const char *server, const char *name,
                                    int *rerror);
 void xmms_pulse_backend_free(xmms_pulse *s);
+void xmms_pulse_backend_set_volume_callback(xmms_pulse *p,
+                                            void (*cb) (void *userdata),
+                                            void *userdata);
 gboolean xmms_pulse_backend_set_stream(xmms_pulse *p,
                                        const char *stream_name,
                                        const char *sink,
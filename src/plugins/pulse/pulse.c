@@ -47,6 +47,8 @@ static gboolean xmms_pulse_format_set (xmms_output_t *output,
 static gboolean xmms_pulse_volume_set (xmms_output_t *output,
                                        const gchar *channel,
                                        guint volume);
+static gboolean xmms_pulse_volume_monitor (xmms_output_t *output);
+static void xmms_pulse_volume_changed (void *userdata);
 static gboolean xmms_pulse_volume_get (xmms_output_t *output,
                                        const gchar **names,
                                        guint *values,
@@ -76,6 +78,7 @@ xmms_pulse_plugin_setup (xmms_output_plugin_t *plugin)
 	methods.format_set = xmms_pulse_format_set;
 	methods.volume_set = xmms_pulse_volume_set;
 	methods.volume_get = xmms_pulse_volume_get;
+	methods.volume_monitor = xmms_pulse_volume_monitor;
 
 	xmms_output_plugin_methods_set (plugin, &methods);
 
@@ -160,6 +163,10 @@ xmms_pulse_open (xmms_output_t *output)
 	if (!data->pulse)
 		return FALSE;
 
+	xmms_pulse_backend_set_volume_callback (data->pulse,
+	                                        xmms_pulse_volume_changed,
+	                                        output);
+
 	return TRUE;
 }
 
@@ -177,6 +184,9 @@ xmms_pulse_close (xmms_output_t *output)
 		xmms_pulse_backend_free (data->pulse);
 		data->pulse = NULL;
 	}
+
+	/* no stream, no volume */
+	xmms_output_volume_changed (output);
 }
 
 
@@ -215,6 +225,9 @@ xmms_pulse_format_set (xmms_output_t *output, const xmms_stream_type_t *format)
 	                                    samplerate, channels, NULL))
 		return FALSE;
 
+	/* the volume of the new stream */
+	xmms_output_volume_changed (output);
+
 	return TRUE;
 }
 
@@ -251,6 +264,24 @@ xmms_pulse_volume_set (xmms_output_t *output,
 }
 
 
+/*
+ * Volume changes of our stream are reported by the pulse server, so
+ * there's no need for polling.
+ */
+static gboolean
+xmms_pulse_volume_monitor (xmms_output_t *output)
+{
+	return TRUE;
+}
+
+
+static void
+xmms_pulse_volume_changed (void *userdata)
+{
+	xmms_output_volume_changed ((xmms_output_t *) userdata);
+}
+
+
 static gboolean
 xmms_pulse_volume_get (xmms_output_t *output, const gchar **names,
                        guint *values, guint *num_channels)
@@ -28,8 +28,7 @@
 #include <stdlib.h>
 #include <string.h>
 
-typedef void (*xmms_replaygain_apply_func_t)
-	(void *buf, gint len, gfloat gain);
+#include "replaygain_apply.h"
 
 /**
  * Replaygain modes.
@@ -47,6 +46,9 @@ typedef struct xmms_replaygain_data_St {
 	gfloat gain;
 	gboolean has_replaygain;
 	gboolean enabled;
+	gboolean use_dither;
+	gint sample_size;
+	xmms_replaygain_dither_t dither;
 	xmms_replaygain_apply_func_t apply;
 } xmms_replaygain_data_t;
 
@@ -74,15 +76,6 @@ static void xmms_replaygain_config_changed (xmms_object_t *obj, xmmsv_t *_val, g
 static void compute_gain (xmms_xform_t *xform, xmms_replaygain_data_t *data);
 static xmms_replaygain_mode_t parse_mode (const char *s);
 
-static void apply_s8 (void *buf, gint len, gfloat gain);
-static void apply_u8 (void *buf, gint len, gfloat gain);
-static void apply_s16 (void *buf, gint len, gfloat gain);
-static void apply_u16 (void *buf, gint len, gfloat gain);
-static void apply_s32 (void *buf, gint len, gfloat gain);
-static void apply_u32 (void *buf, gint len, gfloat gain);
-static void apply_float (void *buf, gint len, gfloat gain);
-static void apply_double (void *buf, gint len, gfloat gain);
-
 /*
  * Plugin header
  */
@@ -127,6 +120,9 @@ xmms_replaygain_plugin_setup (xmms_xform_plugin_t *xform_plugin)
 	xmms_xform_plugin_config_property_register (xform_plugin,
 	                                            "preamp", "6.0",
 	                                            NULL, NULL);
+	xmms_xform_plugin_config_property_register (xform_plugin,
+	                                            "dither", "0",
+	                                            NULL, NULL);
 
 	return TRUE;
 }
@@ -166,6 +162,14 @@ xmms_replaygain_init (xmms_xform_t *xform)
 
 	data->preamp = pow (10.0, atof (xmms_config_property_get_string (cfgv)) / 20.0);
 
+	cfgv = xmms_xform_config_lookup (xform, "dither");
+	xmms_config_property_callback_set (cfgv,
+	                                   xmms_replaygain_config_changed,
+	                                   xform);
+
+	data->use_dither = !!xmms_config_property_get_int (cfgv);
+	xmms_replaygain_dither_init (&data->dither, g_random_int ());
+
 	cfgv = xmms_xform_config_lookup (xform, "enabled");
 	xmms_config_property_callback_set (cfgv,
 	                                   xmms_replaygain_config_changed,
@@ -178,31 +182,32 @@ xmms_replaygain_init (xmms_xform_t *xform)
 	compute_gain (xform, data);
 
 	fmt = xmms_xform_indata_get_int (xform, XMMS_STREAM_TYPE_FMT_FORMAT);
+	data->sample_size = xmms_sample_size_get (fmt);
 
 	switch (fmt) {
 		case XMMS_SAMPLE_FORMAT_S8:
-			data->apply = apply_s8;
+			data->apply = xmms_replaygain_apply_s8;
 			break;
 		case XMMS_SAMPLE_FORMAT_U8:
-			data->apply = apply_u8;
+			data->apply = xmms_replaygain_apply_u8;
 			break;
 		case XMMS_SAMPLE_FORMAT_S16:
-			data->apply = apply_s16;
+			data->apply = xmms_replaygain_apply_s16;
 			break;
 		case XMMS_SAMPLE_FORMAT_U16:
-			data->apply = apply_u16;
+			data->apply = xmms_replaygain_apply_u16;
 			break;
 		case XMMS_SAMPLE_FORMAT_S32:
-			data->apply = apply_s32;
+			data->apply = xmms_replaygain_apply_s32;
 			break;
 		case XMMS_SAMPLE_FORMAT_U32:
-			data->apply = apply_u32;
+			data->apply = xmms_replaygain_apply_u32;
 			break;
 		case XMMS_SAMPLE_FORMAT_FLOAT:
-			data->apply = apply_float;
+			data->apply = xmms_replaygain_apply_float;
 			break;
 		case XMMS_SAMPLE_FORMAT_DOUBLE:
-			data->apply = apply_double;
+			data->apply = xmms_replaygain_apply_double;
 			break;
 		default:
 			/* we shouldn't ever get here, since we told the daemon
@@ -236,6 +241,10 @@ xmms_replaygain_destroy (xmms_xform_t *xform)
 	xmms_config_property_callback_remove (cfgv,
 	                                      xmms_replaygain_config_changed, xform);
 
+	cfgv = xmms_xform_config_lookup (xform, "dither");
+	xmms_config_property_callback_remove (cfgv,
+	                                      xmms_replaygain_config_changed, xform);
+
 	cfgv = xmms_xform_config_lookup (xform, "enabled");
 	xmms_config_property_callback_remove (cfgv,
 	                                      xmms_replaygain_config_changed, xform);
@@ -246,7 +255,6 @@ xmms_replaygain_read (xmms_xform_t *xform, xmms_sample_t *buf, gint len,
                       xmms_error_t *error)
 {
 	xmms_replaygain_data_t *data;
-	xmms_sample_format_t fmt;
 	gint read;
 
 	g_return_val_if_fail (xform, -1);
@@ -256,14 +264,12 @@ xmms_replaygain_read (xmms_xform_t *xform, xmms_sample_t *buf, gint len,
 
 	read = xmms_xform_read (xform, buf, len, error);
 
-	if (!data->has_replaygain || !data->enabled) {
+	if (read <= 0 || !data->has_replaygain || !data->enabled) {
 		return read;
 	}
 
-	fmt = xmms_xform_indata_get_int (xform, XMMS_STREAM_TYPE_FMT_FORMAT);
-	len /= xmms_sample_size_get (fmt);
-
-	data->apply (buf, len, data->gain);
+	data->apply (buf, read / data->sample_size, data->gain,
+	             data->use_dither ? &data->dither : NULL);
 
 	return read;
 }
@@ -303,6 +309,8 @@ xmms_replaygain_config_changed (xmms_object_t *obj, xmmsv_t *_val, gpointer udat
 		dirty = TRUE;
 	} else if (!g_ascii_strcasecmp (name, "replaygain.enabled")) {
 		data->enabled = !!atoi (value);
+	} else if (!g_ascii_strcasecmp (name, "replaygain.dither")) {
+		data->use_dither = !!atoi (value);
 	}
 
 	if (dirty) {
@@ -362,101 +370,3 @@ parse_mode (const char *s)
 		return XMMS_REPLAYGAIN_MODE_TRACK;
 	}
 }
-
-static void
-apply_s8 (void *buf, gint len, gfloat gain)
-{
-	xmms_samples8_t *samples = (xmms_samples8_t *) buf;
-	gint i;
-
-	for (i = 0; i < len; i++) {
-		gfloat sample = samples[i] * gain;
-		samples[i] = CLAMP (sample, XMMS_SAMPLES8_MIN,
-		                    XMMS_SAMPLES8_MAX);
-	}
-}
-
-static void
-apply_u8 (void *buf, gint len, gfloat gain)
-{
-	xmms_sampleu8_t *samples = (xmms_sampleu8_t *) buf;
-	gint i;
-
-	for (i = 0; i < len; i++) {
-		gfloat sample = samples[i] * gain;
-		samples[i] = CLAMP (sample, 0, XMMS_SAMPLEU8_MAX);
-	}
-}
-
-static void
-apply_s16 (void *buf, gint len, gfloat gain)
-{
-	xmms_samples16_t *samples = (xmms_samples16_t *) buf;
-	gint i;
-
-	for (i = 0; i < len; i++) {
-		gfloat sample = samples[i] * gain;
-		samples[i] = CLAMP (sample, XMMS_SAMPLES16_MIN,
-		                    XMMS_SAMPLES16_MAX);
-	}
-}
-
-static void
-apply_u16 (void *buf, gint len, gfloat gain)
-{
-	xmms_sampleu16_t *samples = (xmms_sampleu16_t *) buf;
-	gint i;
-
-	for (i = 0; i < len; i++) {
-		gfloat sample = samples[i] * gain;
-		samples[i] = CLAMP (sample, 0, XMMS_SAMPLEU16_MAX);
-	}
-}
-
-static void
-apply_s32 (void *buf, gint len, gfloat gain)
-{
-	xmms_samples32_t *samples = (xmms_samples32_t *) buf;
-	gint i;
-
-	for (i = 0; i < len; i++) {
-		gdouble sample = samples[i] * gain;
-		samples[i] = CLAMP (sample, XMMS_SAMPLES32_MIN,
-		                    XMMS_SAMPLES32_MAX);
-	}
-}
-
-static void
-apply_u32 (void *buf, gint len, gfloat gain)
-{
-	xmms_sampleu32_t *samples = (xmms_sampleu32_t *) buf;
-	gint i;
-
-	for (i = 0; i < len; i++) {
-		gdouble sample = samples[i] * gain;
-		samples[i] = CLAMP (sample, 0, XMMS_SAMPLEU32_MAX);
-	}
-}
-
-static void
-apply_float (void *buf, gint len, gfloat gain)
-{
-	xmms_samplefloat_t *samples = (xmms_samplefloat_t *) buf;
-	gint i;
-
-	for (i = 0; i < len; i++) {
-		samples[i] *= gain;
-	}
-}
-
-static void
-apply_double (void *buf, gint len, gfloat gain)
-{
-	xmms_sampledouble_t *samples = (xmms_sampledouble_t *) buf;
-	gint i;
-
-	for (i = 0; i < len; i++) {
-		samples[i] *= gain;
-	}
-}
-
@@ -0,0 +1,333 @@
+/*  XMMS2 - X Music Multiplexer System
+ *  Copyright (C) 2003-2013 XMMS2 Team
+ *
+ *  PLUGINS ARE NOT CONSIDERED TO BE DERIVED WORK !!!
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ */
+
+/**
+ * @file
+ * Gain and saturate kernels for the replaygain effect.
+ *
+ * The common formats (s16, s32, float, double) have SSE2 versions that
+ * process a full vector per iteration, the remaining samples and the
+ * less common formats are handled by the scalar loops.
+ */
+
+#include <xmms/xmms_sample.h>
+
+#include <math.h>
+#include <glib.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include "replaygain_apply.h"
+
+static inline guint32
+xorshift32 (guint32 *state)
+{
+	guint32 x = *state;
+
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+
+	return *state = x;
+}
+
+/* Triangular noise in (-1, 1): the difference of two uniform values,
+ * taken from the upper and lower half of one random number */
+static inline gfloat
+tpdf (xmms_replaygain_dither_t *dither)
+{
+	guint32 x;
+
+	if (!dither) {
+		return 0.0f;
+	}
+
+	x = xorshift32 (&dither->state[0]);
+
+	return ((gint) (x >> 16) - (gint) (x & 0xffff)) * (1.0f / 65536.0f);
+}
+
+void
+xmms_replaygain_dither_init (xmms_replaygain_dither_t *dither, guint32 seed)
+{
+	gint i;
+
+	for (i = 0; i < G_N_ELEMENTS (dither->state); i++) {
+		/* xorshift gets stuck at zero */
+		dither->state[i] = (seed + i + 1) * 2654435761U;
+		if (!dither->state[i]) {
+			dither->state[i] = 1;
+		}
+	}
+}
+
+#ifdef __SSE2__
+static inline __m128i
+xorshift32_sse2 (__m128i x)
+{
+	x = _mm_xor_si128 (x, _mm_slli_epi32 (x, 13));
+	x = _mm_xor_si128 (x, _mm_srli_epi32 (x, 17));
+	x = _mm_xor_si128 (x, _mm_slli_epi32 (x, 5));
+
+	return x;
+}
+
+static inline __m128
+tpdf_sse2 (__m128i *state)
+{
+	__m128i a, b;
+
+	*state = xorshift32_sse2 (*state);
+
+	a = _mm_srli_epi32 (*state, 16);
+	b = _mm_and_si128 (*state, _mm_set1_epi32 (0xffff));
+
+	return _mm_mul_ps (_mm_cvtepi32_ps (_mm_sub_epi32 (a, b)),
+	                   _mm_set1_ps (1.0f / 65536.0f));
+}
+
+static gint
+apply_s16_sse2 (xmms_samples16_t *samples, gint len, gfloat gain,
+                xmms_replaygain_dither_t *dither)
+{
+	__m128 g = _mm_set1_ps (gain);
+	__m128i state_lo = _mm_setzero_si128 ();
+	__m128i state_hi = _mm_setzero_si128 ();
+	gint i;
+
+	/* two generators, so the halves don't wait for each other */
+	if (dither) {
+		state_lo = _mm_loadu_si128 ((__m128i *) dither->state);
+		state_hi = _mm_loadu_si128 ((__m128i *) (dither->state + 4));
+	}
+
+	for (i = 0; i + 8 <= len; i += 8) {
+		__m128i in, lo, hi;
+		__m128 flo, fhi;
+
+		in = _mm_loadu_si128 ((__m128i *) (samples + i));
+
+		/* sign extend to 32 bits */
+		lo = _mm_srai_epi32 (_mm_unpacklo_epi16 (in, in), 16);
+		hi = _mm_srai_epi32 (_mm_unpackhi_epi16 (in, in), 16);
+
+		flo = _mm_mul_ps (_mm_cvtepi32_ps (lo), g);
+		fhi = _mm_mul_ps (_mm_cvtepi32_ps (hi), g);
+
+		if (dither) {
+			flo = _mm_add_ps (flo, tpdf_sse2 (&state_lo));
+			fhi = _mm_add_ps (fhi, tpdf_sse2 (&state_hi));
+		}
+
+		/* round to nearest, then pack with signed saturation */
+		lo = _mm_cvtps_epi32 (flo);
+		hi = _mm_cvtps_epi32 (fhi);
+
+		_mm_storeu_si128 ((__m128i *) (samples + i), _mm_packs_epi32 (lo, hi));
+	}
+
+	if (dither) {
+		_mm_storeu_si128 ((__m128i *) dither->state, state_lo);
+		_mm_storeu_si128 ((__m128i *) (dither->state + 4), state_hi);
+	}
+
+	return i;
+}
+
+static gint
+apply_s32_sse2 (xmms_samples32_t *samples, gint len, gfloat gain)
+{
+	__m128d g = _mm_set1_pd (gain);
+	__m128d min = _mm_set1_pd (XMMS_SAMPLES32_MIN);
+	__m128d max = _mm_set1_pd (XMMS_SAMPLES32_MAX);
+	gint i;
+
+	for (i = 0; i + 4 <= len; i += 4) {
+		__m128i in, lo, hi;
+		__m128d dlo, dhi;
+
+		in = _mm_loadu_si128 ((__m128i *) (samples + i));
+
+		dlo = _mm_cvtepi32_pd (in);
+		dhi = _mm_cvtepi32_pd (_mm_shuffle_epi32 (in, _MM_SHUFFLE (1, 0, 3, 2)));
+
+		dlo = _mm_min_pd (_mm_max_pd (_mm_mul_pd (dlo, g), min), max);
+		dhi = _mm_min_pd (_mm_max_pd (_mm_mul_pd (dhi, g), min), max);
+
+		lo = _mm_cvtpd_epi32 (dlo);
+		hi = _mm_cvtpd_epi32 (dhi);
+
+		_mm_storeu_si128 ((__m128i *) (samples + i), _mm_unpacklo_epi64 (lo, hi));
+	}
+
+	return i;
+}
+
+static gint
+apply_float_sse2 (xmms_samplefloat_t *samples, gint len, gfloat gain)
+{
+	__m128 g = _mm_set1_ps (gain);
+	gint i;
+
+	for (i = 0; i + 4 <= len; i += 4) {
+		__m128 in = _mm_loadu_ps (samples + i);
+		_mm_storeu_ps (samples + i, _mm_mul_ps (in, g));
+	}
+
+	return i;
+}
+
+static gint
+apply_double_sse2 (xmms_sampledouble_t *samples, gint len, gfloat gain)
+{
+	__m128d g = _mm_set1_pd (gain);
+	gint i;
+
+	for (i = 0; i + 2 <= len; i += 2) {
+		__m128d in = _mm_loadu_pd (samples + i);
+		_mm_storeu_pd (samples + i, _mm_mul_pd (in, g));
+	}
+
+	return i;
+}
+#endif
+
+void
+xmms_replaygain_apply_s8 (void *buf, gint len, gfloat gain,
+                          xmms_replaygain_dither_t *dither)
+{
+	xmms_samples8_t *samples = (xmms_samples8_t *) buf;
+	gint i;
+
+	for (i = 0; i < len; i++) {
+		gfloat sample = samples[i] * gain + tpdf (dither);
+		sample = CLAMP (sample, XMMS_SAMPLES8_MIN, XMMS_SAMPLES8_MAX);
+		samples[i] = lrintf (sample);
+	}
+}
+
+void
+xmms_replaygain_apply_u8 (void *buf, gint len, gfloat gain,
+                          xmms_replaygain_dither_t *dither)
+{
+	xmms_sampleu8_t *samples = (xmms_sampleu8_t *) buf;
+	gint i;
+
+	for (i = 0; i < len; i++) {
+		gfloat sample = samples[i] * gain + tpdf (dither);
+		sample = CLAMP (sample, 0, XMMS_SAMPLEU8_MAX);
+		samples[i] = lrintf (sample);
+	}
+}
+
+void
+xmms_replaygain_apply_s16 (void *buf, gint len, gfloat gain,
+                           xmms_replaygain_dither_t *dither)
+{
+	xmms_samples16_t *samples = (xmms_samples16_t *) buf;
+	gint i = 0;
+
+#ifdef __SSE2__
+	i = apply_s16_sse2 (samples, len, gain, dither);
+#endif
+
+	for (; i < len; i++) {
+		gfloat sample = samples[i] * gain + tpdf (dither);
+		sample = CLAMP (sample, XMMS_SAMPLES16_MIN, XMMS_SAMPLES16_MAX);
+		samples[i] = lrintf (sample);
+	}
+}
+
+void
+xmms_replaygain_apply_u16 (void *buf, gint len, gfloat gain,
+                           xmms_replaygain_dither_t *dither)
+{
+	xmms_sampleu16_t *samples = (xmms_sampleu16_t *) buf;
+	gint i;
+
+	for (i = 0; i < len; i++) {
+		gfloat sample = samples[i] * gain + tpdf (dither);
+		sample = CLAMP (sample, 0, XMMS_SAMPLEU16_MAX);
+		samples[i] = lrintf (sample);
+	}
+}
+
+void
+xmms_replaygain_apply_s32 (void *buf, gint len, gfloat gain,
+                           xmms_replaygain_dither_t *dither)
+{
+	xmms_samples32_t *samples = (xmms_samples32_t *) buf;
+	gint i = 0;
+
+#ifdef __SSE2__
+	i = apply_s32_sse2 (samples, len, gain);
+#endif
+
+	for (; i < len; i++) {
+		gdouble sample = samples[i] * (gdouble) gain;
+		sample = CLAMP (sample, XMMS_SAMPLES32_MIN, XMMS_SAMPLES32_MAX);
+		samples[i] = lrint (sample);
+	}
+}
+
+void
+xmms_replaygain_apply_u32 (void *buf, gint len, gfloat gain,
+                           xmms_replaygain_dither_t *dither)
+{
+	xmms_sampleu32_t *samples = (xmms_sampleu32_t *) buf;
+	gint i;
+
+	for (i = 0; i < len; i++) {
+		gdouble sample = samples[i] * (gdouble) gain;
+		sample = CLAMP (sample, 0, XMMS_SAMPLEU32_MAX);
+		/* non-negative, so truncating after adding 0.5 rounds */
+		samples[i] = (xmms_sampleu32_t) (sample + 0.5);
+	}
+}
+
+void
+xmms_replaygain_apply_float (void *buf, gint len, gfloat gain,
+                             xmms_replaygain_dither_t *dither)
+{
+	xmms_samplefloat_t *samples = (xmms_samplefloat_t *) buf;
+	gint i = 0;
+
+#ifdef __SSE2__
+	i = apply_float_sse2 (samples, len, gain);
+#endif
+
+	for (; i < len; i++) {
+		samples[i] *= gain;
+	}
+}
+
+void
+xmms_replaygain_apply_double (void *buf, gint len, gfloat gain,
+                              xmms_replaygain_dither_t *dither)
+{
+	xmms_sampledouble_t *samples = (xmms_sampledouble_t *) buf;
+	gint i = 0;
+
+#ifdef __SSE2__
+	i = apply_double_sse2 (samples, len, gain);
+#endif
+
+	for (; i < len; i++) {
+		samples[i] *= gain;
+	}
+}
@@ -0,0 +1,50 @@
+/*  XMMS2 - X Music Multiplexer System
+ *  Copyright (C) 2003-2013 XMMS2 Team
+ *
+ *  PLUGINS ARE NOT CONSIDERED TO BE DERIVED WORK !!!
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ */
+
+#ifndef __XMMS_REPLAYGAIN_APPLY_H__
+#define __XMMS_REPLAYGAIN_APPLY_H__
+
+#include <glib.h>
+
+/**
+ * State of the TPDF dither generator, one xorshift32 per SIMD lane for
+ * two independent vectors.
+ */
+typedef struct xmms_replaygain_dither_St {
+	guint32 state[8];
+} xmms_replaygain_dither_t;
+
+/**
+ * Multiply len samples in buf by gain, rounding and saturating to the
+ * range of the sample format. If dither is non-NULL, triangular dither
+ * of +/- 1 LSB is added before rounding (only for 8 and 16 bit formats,
+ * for the others it is ignored).
+ */
+typedef void (*xmms_replaygain_apply_func_t)
+	(void *buf, gint len, gfloat gain, xmms_replaygain_dither_t *dither);
+
+void xmms_replaygain_dither_init (xmms_replaygain_dither_t *dither, guint32 seed);
+
+void xmms_replaygain_apply_s8 (void *buf, gint len, gfloat gain, xmms_replaygain_dither_t *dither);
+void xmms_replaygain_apply_u8 (void *buf, gint len, gfloat gain, xmms_replaygain_dither_t *dither);
+void xmms_replaygain_apply_s16 (void *buf, gint len, gfloat gain, xmms_replaygain_dither_t *dither);
+void xmms_replaygain_apply_u16 (void *buf, gint len, gfloat gain, xmms_replaygain_dither_t *dither);
+void xmms_replaygain_apply_s32 (void *buf, gint len, gfloat gain, xmms_replaygain_dither_t *dither);
+void xmms_replaygain_apply_u32 (void *buf, gint len, gfloat gain, xmms_replaygain_dither_t *dither);
+void xmms_replaygain_apply_float (void *buf, gint len, gfloat gain, xmms_replaygain_dither_t *dither);
+void xmms_replaygain_apply_double (void *buf, gint len, gfloat gain, xmms_replaygain_dither_t *dither);
+
+#endif
@@ -36,6 +36,9 @@ typedef struct {
 	gint channels;
 	gint bufsize;
 
+	xmms_sample_format_t format;
+	gint samplesize;
+
 	xmms_sample_t *iobuf;
 	pvocoder_sample_t *procbuf;
 	gfloat *resbuf;
@@ -96,6 +99,13 @@ xmms_vocoder_plugin_setup (xmms_xform_plugin_t *xform_plugin)
 	                              XMMS_SAMPLE_FORMAT_S16,
 	                              XMMS_STREAM_TYPE_END);
 
+	xmms_xform_plugin_indata_add (xform_plugin,
+	                              XMMS_STREAM_TYPE_MIMETYPE,
+	                              "audio/pcm",
+	                              XMMS_STREAM_TYPE_FMT_FORMAT,
+	                              XMMS_SAMPLE_FORMAT_FLOAT,
+	                              XMMS_STREAM_TYPE_END);
+
 	return TRUE;
 }
 
@@ -111,8 +121,10 @@ xmms_vocoder_init (xmms_xform_t *xform)
 	priv->winsize = 2048;
 	priv->channels = xmms_xform_indata_get_int (xform, XMMS_STREAM_TYPE_FMT_CHANNELS);
 	priv->bufsize = priv->winsize * priv->channels;
+	priv->format = xmms_xform_indata_get_int (xform, XMMS_STREAM_TYPE_FMT_FORMAT);
+	priv->samplesize = xmms_sample_size_get (priv->format);
 
-	priv->iobuf = g_malloc (priv->bufsize * sizeof (gint16));
+	priv->iobuf = g_malloc (priv->bufsize * priv->samplesize);
 	priv->procbuf = g_malloc (priv->bufsize * sizeof (pvocoder_sample_t));
 	priv->resbuf = g_malloc (priv->bufsize * sizeof (gfloat));
 	priv->outbuf = g_string_new (NULL);
@@ -248,6 +260,7 @@ xmms_vocoder_read (xmms_xform_t *xform, xmms_sample_t *buffer, gint len,
 	while (size == 0) {
 		int i, dpos;
 		gint16 *samples = (gint16 *) data->iobuf;
+		gfloat *fsamples = (gfloat *) data->iobuf;
 
 		if (!data->enabled) {
 			return xmms_xform_read (xform, buffer, len, error);
@@ -260,11 +273,11 @@ xmms_vocoder_read (xmms_xform_t *xform, xmms_sample_t *buffer, gint len,
 
 				memset (data->procbuf, 0, data->bufsize *
 				        sizeof (pvocoder_sample_t));
-				while (read < data->bufsize * sizeof (gint16)) {
+				while (read < data->bufsize * data->samplesize) {
 					ret = xmms_xform_read (xform,
 					                       data->iobuf+read,
 					                       data->bufsize *
-					                       sizeof (gint16)-read,
+					                       data->samplesize-read,
 					                       error);
 					if (ret <= 0) {
 						if (!ret && !read) {
@@ -278,8 +291,13 @@ xmms_vocoder_read (xmms_xform_t *xform, xmms_sample_t *buffer, gint len,
 					read += ret;
 				}
 
-				for (i=0; i<data->bufsize; i++) {
-					data->procbuf[i] = (pvocoder_sample_t) samples[i] / 32767;
+				if (data->format == XMMS_SAMPLE_FORMAT_FLOAT) {
+					memcpy (data->procbuf, fsamples,
+					        data->bufsize * sizeof (gfloat));
+				} else {
+					for (i=0; i<data->bufsize; i++) {
+						data->procbuf[i] = (pvocoder_sample_t) samples[i] / 32767;
+					}
 				}
 				pvocoder_add_chunk (data->pvoc, data->procbuf);
 				dpos = pvocoder_get_chunk (data->pvoc, data->procbuf);
@@ -291,13 +309,19 @@ xmms_vocoder_read (xmms_xform_t *xform, xmms_sample_t *buffer, gint len,
 		data->resdata.data_in += data->resdata.input_frames_used * data->channels;
 		data->resdata.input_frames -= data->resdata.input_frames_used;
 
-		for (i=0; i<data->resdata.output_frames_gen * data->channels; i++) {
-			samples[i] = data->resbuf[i] * 32767;
+		if (data->format == XMMS_SAMPLE_FORMAT_FLOAT) {
+			memcpy (fsamples, data->resbuf,
+			        data->resdata.output_frames_gen * data->channels *
+			        sizeof (gfloat));
+		} else {
+			for (i=0; i<data->resdata.output_frames_gen * data->channels; i++) {
+				samples[i] = data->resbuf[i] * 32767;
+			}
 		}
 		g_string_append_len (data->outbuf, data->iobuf,
 		                     data->resdata.output_frames_gen *
 		                     data->channels *
-		                     sizeof (gint16));
+		                     data->samplesize);
 		size = MIN (data->outbuf->len, len);
 	}
 
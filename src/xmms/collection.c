@@ -86,6 +86,8 @@ static void xmms_collection_destroy (xmms_object_t *object);
 static gboolean xmms_collection_validate (xmms_coll_dag_t *dag, xmmsv_t *coll, const gchar *save_name, const gchar *save_namespace, const gchar **err);
 static gboolean xmms_collection_validate_recurs (xmms_coll_dag_t *dag, xmmsv_t *coll, const gchar *save_name, const gchar *save_namespace, const gchar **err);
 static gboolean xmms_collection_unreference (xmms_coll_dag_t *dag, const gchar *name, xmms_collection_namespace_id_t nsid);
+static void xmms_collection_remove_pointer (xmms_coll_dag_t *dag, const gchar *name, xmms_collection_namespace_id_t nsid);
+static xmmsv_t *xmms_collection_find_in_playlists (xmms_coll_dag_t *dag, xmms_medialib_entry_t mid);
 
 static gboolean xmms_collection_has_reference_to (xmms_coll_dag_t *dag, xmmsv_t *coll, const gchar *tg_name, const gchar *tg_ns);
 
@@ -166,6 +168,8 @@ struct xmms_coll_dag_St {
 	GMutex mutex;
 
 	xmms_medialib_t *medialib;
+
+	xmms_playlist_index_t *plindex;
 };
 
 /** Initializes a new xmms_coll_dag_t.
@@ -189,6 +193,8 @@ xmms_collection_init (xmms_medialib_t *medialib)
 		                                          g_free, coll_unref);
 	}
 
+	ret->plindex = xmms_playlist_index_new ();
+
 	xmms_collection_register_ipc_commands (XMMS_OBJECT (ret));
 
 	return ret;
@@ -534,6 +540,11 @@ xmms_collection_client_find (xmms_coll_dag_t *dag, gint32 mid, const gchar *name
 		return NULL;
 	}
 
+	/* Playlists are idlists, the index knows which ones hold the media */
+	if (nsid == XMMS_COLLECTION_NSID_PLAYLISTS) {
+		return xmms_collection_find_in_playlists (dag, mid);
+	}
+
 	/* Prepare the match table of all collections for the given namespace */
 	match_table = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
 	xmms_collection_foreach_in_namespace (dag, nsid, build_match_table, match_table);
@@ -572,6 +583,34 @@ xmms_collection_client_find (xmms_coll_dag_t *dag, gint32 mid, const gchar *name
 	return result;
 }
 
+/** List the playlists containing a media, using the playlist index.
+ *
+ * @param dag  The collection DAG.
+ * @param mid  The id of the media.
+ * @returns  A list of the names of the matching playlists.
+ */
+static xmmsv_t *
+xmms_collection_find_in_playlists (xmms_coll_dag_t *dag, xmms_medialib_entry_t mid)
+{
+	GHashTableIter iter;
+	xmmsv_t *result, *coll;
+	gchar *name;
+
+	result = xmmsv_new_list ();
+
+	g_mutex_lock (&dag->mutex);
+
+	g_hash_table_iter_init (&iter, dag->collrefs[XMMS_COLLECTION_NSID_PLAYLISTS]);
+	while (g_hash_table_iter_next (&iter, (gpointer *) &name, (gpointer *) &coll)) {
+		if (xmms_playlist_index_count (dag->plindex, coll, mid) > 0) {
+			xmmsv_list_append_string (result, name);
+		}
+	}
+
+	g_mutex_unlock (&dag->mutex);
+
+	return result;
+}
 
 /** Rename a collection in a given namespace.
  *
@@ -617,7 +656,7 @@ xmms_collection_client_rename (xmms_coll_dag_t *dag, const gchar *from_name,
 		xmms_collection_update_pointer (dag, to_name, nsid, from_coll);
 
 		/* remove old pair from hashtable */
-		g_hash_table_remove (dag->collrefs[nsid], from_name);
+		xmms_collection_remove_pointer (dag, from_name, nsid);
 
 		/* update name in all reference operators */
 		coll_rename_infos_t infos = { from_name, to_name, namespace };
@@ -842,10 +881,54 @@ void
 xmms_collection_update_pointer (xmms_coll_dag_t *dag, const gchar *name,
                                 xmms_collection_namespace_id_t nsid, xmmsv_t *newtarget)
 {
+	xmmsv_t *oldtarget;
+
+	if (nsid == XMMS_COLLECTION_NSID_PLAYLISTS) {
+		xmms_playlist_index_bind (dag->plindex, newtarget);
+
+		oldtarget = g_hash_table_lookup (dag->collrefs[nsid], name);
+		if (oldtarget != NULL) {
+			xmms_playlist_index_unbind (dag->plindex, oldtarget);
+		}
+	}
+
 	g_hash_table_replace (dag->collrefs[nsid], g_strdup (name), newtarget);
 	xmmsv_ref (newtarget);
 }
 
+/** Remove a reference from the DAG.
+ *
+ * @param dag  The collection DAG.
+ * @param name The name of the reference to remove.
+ * @param nsid The namespace in which to locate the reference.
+ */
+static void
+xmms_collection_remove_pointer (xmms_coll_dag_t *dag, const gchar *name,
+                                xmms_collection_namespace_id_t nsid)
+{
+	xmmsv_t *target;
+
+	if (nsid == XMMS_COLLECTION_NSID_PLAYLISTS) {
+		target = g_hash_table_lookup (dag->collrefs[nsid], name);
+		if (target != NULL) {
+			xmms_playlist_index_unbind (dag->plindex, target);
+		}
+	}
+
+	g_hash_table_remove (dag->collrefs[nsid], name);
+}
+
+/** Get the index of the media in the playlists of the DAG.
+ *
+ * @param dag  The collection DAG.
+ * @returns  The index, owned by the DAG.
+ */
+xmms_playlist_index_t *
+xmms_collection_get_playlist_index (xmms_coll_dag_t *dag)
+{
+	return dag->plindex;
+}
+
 /** Find the collection structure corresponding to the given name in the given namespace.
  *
  * @param dag  The collection DAG.
@@ -979,6 +1062,40 @@ xmms_collection_get_random_media (xmms_coll_dag_t *dag, xmmsv_t *source)
 	return ret;
 }
 
+/**
+ * Get a number of random media entries from the given collection with
+ * one medialib query.
+ *
+ * @param dag  The collection DAG.
+ * @param source  The collection to query.
+ * @param count  The number of entries to pick.
+ * @return  A list of random medias from the source collection, empty if
+ * none found.
+ */
+xmmsv_t *
+xmms_collection_get_random_media_list (xmms_coll_dag_t *dag, xmmsv_t *source,
+                                       gint count)
+{
+	xmms_medialib_session_t *session;
+	xmmsv_t *ret;
+
+	g_mutex_lock (&dag->mutex);
+	xmms_collection_apply_to_collection (dag, source, bind_all_references, NULL);
+
+	for (;;) {
+		session = xmms_medialib_session_begin_ro (dag->medialib);
+		ret = xmms_medialib_query_random_ids (session, source, count);
+		if (xmms_medialib_session_commit (session)) {
+			break;
+		}
+		xmmsv_unref (ret);
+	}
+
+	g_mutex_unlock (&dag->mutex);
+
+	return ret;
+}
+
 /** @} */
 
 
@@ -1004,6 +1121,8 @@ xmms_collection_destroy (xmms_object_t *object)
 		g_hash_table_destroy (dag->collrefs[i]);  /* dag is freed here */
 	}
 
+	xmms_playlist_index_free (dag->plindex);
+
 	xmms_collection_unregister_ipc_commands ();
 }
 
@@ -1372,7 +1491,7 @@ xmms_collection_unreference (xmms_coll_dag_t *dag, const gchar *name,
 			                             matchkey,
 			                             nsname);
 
-			g_hash_table_remove (dag->collrefs[nsid], matchkey);
+			xmms_collection_remove_pointer (dag, matchkey, nsid);
 			g_free (matchkey);
 		}
 
@@ -162,17 +162,18 @@ xmms_converter_plugin_setup (xmms_xform_plugin_t *xform_plugin)
 	return TRUE;
 }
 
-/*
+/**
+ * Explicitly insert a converter after prev, converting to the best
+ * matching format in gt.
+ */
 xmms_xform_t *
-xmms_converter_new (xmms_xform_t *prev, xmms_medialib_entry_t entry, GList *gt)
+xmms_converter_new (xmms_xform_t *prev, xmms_medialib_t *medialib,
+                    xmms_medialib_entry_t entry, GList *gt)
 {
-	xmms_xform_t *xform;
-
-	xform = xmms_xform_new (converter_plugin, prev, entry, gt);
+	g_return_val_if_fail (converter_plugin, NULL);
 
-	return xform;
+	return xmms_xform_new (converter_plugin, prev, medialib, entry, gt);
 }
-*/
 
 XMMS_XFORM_BUILTIN (converter,
                     "Sample format converter",
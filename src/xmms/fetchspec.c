@@ -528,6 +528,55 @@ xmms_fetch_spec_new_count (xmmsv_t *fetch, xmms_fetch_info_t *info,
 	return ret;
 }
 
+/**
+ * Decodes a columns fetch specification from a dictionary.
+ * Each of the 'fields' becomes a list with one entry per media library
+ * entry, holding the first value by source preference. String values
+ * are stored once, in a shared list, and referred to by index.
+ */
+static xmms_fetch_spec_t *
+xmms_fetch_spec_new_columns (xmmsv_t *fetch, xmms_fetch_info_t *info,
+                             s4_sourcepref_t *prefs, xmms_error_t *err)
+{
+	xmms_fetch_spec_t *spec;
+	s4_sourcepref_t *sp;
+	const gchar *key;
+	xmmsv_t *fields;
+	gint i, size;
+
+	fields = normalize_metadata_fields (fetch, err);
+	if (xmms_error_iserror (err)) {
+		return NULL;
+	}
+
+	if (fields == NULL) {
+		const gchar *message = "'fields' must be a non-empty list of strings.";
+		xmms_error_set (err, XMMS_ERROR_INVAL, message);
+		return NULL;
+	}
+
+	sp = normalize_source_preferences (fetch, prefs, err);
+	if (xmms_error_iserror (err)) {
+		return NULL;
+	}
+
+	size = xmmsv_list_get_size (fields);
+
+	spec = g_new0 (xmms_fetch_spec_t, 1);
+	spec->type = FETCH_COLUMNS;
+	spec->data.columns.count = size;
+	spec->data.columns.fields = g_new (const char *, size);
+	spec->data.columns.cols = g_new (gint32, size);
+
+	for (i = 0; xmmsv_list_get_string (fields, i, &key); i++) {
+		spec->data.columns.fields[i] = key;
+		spec->data.columns.cols[i] = xmms_fetch_info_add_key (info, fetch, key, sp);
+	}
+
+	s4_sourcepref_unref (sp);
+
+	return spec;
+}
 
 
 /**
@@ -564,6 +613,8 @@ xmms_fetch_spec_new (xmmsv_t *fetch, xmms_fetch_info_t *info,
 		return xmms_fetch_spec_new_organize (fetch, info, prefs, err);
 	} else if (strcmp (type, "count") == 0) {
 		return xmms_fetch_spec_new_count (fetch, info, prefs, err);
+	} else if (strcmp (type, "columns") == 0) {
+		return xmms_fetch_spec_new_columns (fetch, info, prefs, err);
 	}
 
 	xmms_error_set (err, XMMS_ERROR_INVAL, "Unknown fetch type.");
@@ -597,6 +648,10 @@ xmms_fetch_spec_free (xmms_fetch_spec_t *spec)
 			break;
 		case FETCH_COUNT: /* Nothing to free */
 			break;
+		case FETCH_COLUMNS:
+			g_free (spec->data.columns.fields);
+			g_free (spec->data.columns.cols);
+			break;
 		default:
 			g_assert_not_reached ();
 	}
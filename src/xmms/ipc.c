@@ -167,6 +167,7 @@ static void
 process_msg (xmms_ipc_client_t *client, xmms_ipc_msg_t *msg)
 {
 	xmms_object_t *object;
+	xmms_object_cmd_func_t func;
 	xmms_object_cmd_arg_t arg;
 	xmms_ipc_msg_t *retmsg;
 	xmmsv_t *error, *arguments;
@@ -201,15 +202,14 @@ process_msg (xmms_ipc_client_t *client, xmms_ipc_msg_t *msg)
 		goto out;
 	}
 
-	g_mutex_lock (&ipc_object_pool_lock);
-	object = ipc_object_pool->objects[objid];
-	g_mutex_unlock (&ipc_object_pool_lock);
+	object = g_atomic_pointer_get (&ipc_object_pool->objects[objid]);
 	if (!object) {
 		xmms_log_error ("Object %d was not found!", objid);
 		goto out;
 	}
 
-	if (!g_tree_lookup (object->cmds, GUINT_TO_POINTER (cmdid))) {
+	func = xmms_object_cmd_get (object, cmdid);
+	if (!func) {
 		xmms_log_error ("No such cmd %d on object %d", cmdid, objid);
 		goto out;
 	}
@@ -217,7 +217,7 @@ process_msg (xmms_ipc_client_t *client, xmms_ipc_msg_t *msg)
 	xmms_object_cmd_arg_init (&arg);
 	arg.args = arguments;
 
-	xmms_object_cmd_call (object, cmdid, &arg);
+	func (object, &arg);
 	if (xmms_error_isok (&arg.error)) {
 		retmsg = xmms_ipc_msg_new (objid, XMMS_IPC_CMD_REPLY);
 		xmms_ipc_handle_cmd_value (retmsg, arg.retval);
@@ -694,12 +694,15 @@ xmms_ipc_signal_unregister (xmms_ipc_signals_t signalid)
 /**
  * Register a object to the IPC core. This needs to be done if you
  * want to send commands to that object from the client.
+ *
+ * Objects are looked up by the client threads without taking the pool
+ * lock, the pointer is published atomically instead.
  */
 void
 xmms_ipc_object_register (xmms_ipc_objects_t objectid, xmms_object_t *object)
 {
 	g_mutex_lock (&ipc_object_pool_lock);
-	ipc_object_pool->objects[objectid] = object;
+	g_atomic_pointer_set (&ipc_object_pool->objects[objectid], object);
 	g_mutex_unlock (&ipc_object_pool_lock);
 }
 
@@ -710,7 +713,7 @@ void
 xmms_ipc_object_unregister (xmms_ipc_objects_t objectid)
 {
 	g_mutex_lock (&ipc_object_pool_lock);
-	ipc_object_pool->objects[objectid] = NULL;
+	g_atomic_pointer_set (&ipc_object_pool->objects[objectid], NULL);
 	g_mutex_unlock (&ipc_object_pool_lock);
 }
 
@@ -119,6 +119,8 @@ xmms_main_client_stats (xmms_object_t *object, xmms_error_t *error)
 
 	return xmmsv_build_dict (XMMSV_DICT_ENTRY_STR ("version", XMMS_VERSION),
 	                         XMMSV_DICT_ENTRY_INT ("uptime", uptime),
+	                         XMMSV_DICT_ENTRY ("signal_emits", xmms_object_emit_stats ()),
+	                         XMMSV_DICT_ENTRY ("metadata_writes", xmms_xform_metadata_stats ()),
 	                         XMMSV_DICT_END);
 }
 
@@ -272,6 +274,9 @@ xmms_main_destroy (xmms_object_t *object)
 	xmms_main_t *mainobj = (xmms_main_t *) object;
 	xmms_config_property_t *cv;
 
+	/* from here on signals are emitted on the thread raising them */
+	xmms_object_dispatch_stop ();
+
 	cv = xmms_config_lookup ("core.shutdownpath");
 	do_scriptdir (xmms_config_property_get_string (cv), "stop");
 
@@ -539,6 +544,8 @@ main (int argc, char **argv)
 	}
 
 
+	xmms_object_dispatch_start ();
+
 	mainobj = xmms_object_new (xmms_main_t, xmms_main_destroy);
 
 	mainobj->medialib_object = xmms_medialib_init ();
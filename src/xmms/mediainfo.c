@@ -40,6 +40,10 @@
   * When a item is added to the playlist the mediainfo reader will
   * start extracting the information from this entry and update it
   * if additional information is found.
+  *
+  * The reader only needs the metadata, so its chains also accept the
+  * probe type: plugins finding everything in the container end the
+  * chain there, before any decoder is set up.
   * @{
   */
 
@@ -154,8 +158,9 @@ xmms_mediainfo_reader_thread (gpointer data)
 {
 	GList *goal_format;
 	GTimeVal timeval;
-	xmms_stream_type_t *f;
-	guint num = 0;
+	xmms_stream_type_t *f, *probe;
+	guint num = 0, resolved = 0;
+	gint64 start;
 
 	xmms_mediainfo_reader_t *mrt = (xmms_mediainfo_reader_t *) data;
 
@@ -169,6 +174,14 @@ xmms_mediainfo_reader_thread (gpointer data)
 	                           XMMS_STREAM_TYPE_END);
 	goal_format = g_list_prepend (NULL, f);
 
+	probe = _xmms_stream_type_new (XMMS_STREAM_TYPE_BEGIN,
+	                               XMMS_STREAM_TYPE_MIMETYPE,
+	                               XMMS_XFORM_PROBE_MIMETYPE,
+	                               XMMS_STREAM_TYPE_END);
+	goal_format = g_list_prepend (goal_format, probe);
+
+	start = g_get_monotonic_time ();
+
 	while (mrt->running) {
 		xmmsc_medialib_entry_status_t prev_status;
 		xmms_medialib_entry_t entry;
@@ -181,6 +194,14 @@ xmms_mediainfo_reader_thread (gpointer data)
 
 		if (!entry) {
 			xmms_medialib_session_abort (session);
+
+			if (resolved > 0) {
+				gdouble secs = (g_get_monotonic_time () - start) / 1e6;
+				XMMS_DBG ("Resolved %u entries in %.1f s (%.1f per second)",
+				          resolved, secs, resolved / MAX (secs, 1e-3));
+			}
+			xmms_medialib_unplayable_save (xmms_medialib_get_unplayable (mrt->medialib));
+
 			xmms_object_emit (XMMS_OBJECT (mrt),
 			                  XMMS_IPC_SIGNAL_MEDIAINFO_READER_STATUS,
 			                  xmmsv_new_int (XMMS_MEDIAINFO_READER_STATUS_IDLE));
@@ -190,6 +211,8 @@ xmms_mediainfo_reader_thread (gpointer data)
 			g_mutex_unlock (&mrt->mutex);
 
 			num = 0;
+			resolved = 0;
+			start = g_get_monotonic_time ();
 
 			xmms_object_emit (XMMS_OBJECT (mrt),
 			                  XMMS_IPC_SIGNAL_MEDIAINFO_READER_STATUS,
@@ -228,9 +251,11 @@ xmms_mediainfo_reader_thread (gpointer data)
 			                                      timeval.tv_sec);
 		}
 		xmms_medialib_session_commit (session);
+		resolved++;
 	}
 
 	g_list_free (goal_format);
+	xmms_object_unref (probe);
 	xmms_object_unref (f);
 
 	return NULL;
@@ -16,6 +16,7 @@
 
 #include <xmms_configuration.h>
 #include <xmmspriv/xmms_medialib.h>
+#include <xmmspriv/xmms_medialib_import.h>
 #include <xmmspriv/xmms_xform.h>
 #include <xmmspriv/xmms_utils.h>
 #include <xmms/xmms_error.h>
@@ -50,11 +51,13 @@ gchar *xmms_medialib_url_encode (const gchar *path);
 static void xmms_medialib_client_add_entry (xmms_medialib_t *, const gchar *, xmms_error_t *);
 static void xmms_medialib_client_move_entry (xmms_medialib_t *, gint32 entry, const gchar *, xmms_error_t *);
 static void xmms_medialib_client_import_path (xmms_medialib_t *medialib, const gchar *path, xmms_error_t *error);
+static gint32 xmms_medialib_client_import_path_async (xmms_medialib_t *medialib, const gchar *path, xmms_error_t *error);
 static void xmms_medialib_client_rehash (xmms_medialib_t *medialib, xmms_medialib_entry_t entry, xmms_error_t *error);
 static void xmms_medialib_client_set_property_string (xmms_medialib_t *medialib, xmms_medialib_entry_t entry, const gchar *source, const gchar *key, const gchar *value, xmms_error_t *error);
 static void xmms_medialib_client_set_property_int (xmms_medialib_t *medialib, xmms_medialib_entry_t entry, const gchar *source, const gchar *key, gint32 value, xmms_error_t *error);
 static void xmms_medialib_client_remove_property (xmms_medialib_t *medialib, xmms_medialib_entry_t entry, const gchar *source, const gchar *key, xmms_error_t *error);
 static xmmsv_t *xmms_medialib_client_get_info (xmms_medialib_t *medialib, xmms_medialib_entry_t entry, xmms_error_t *err);
+static xmmsv_t *xmms_medialib_client_get_infos (xmms_medialib_t *medialib, xmmsv_t *ids, xmmsv_t *keys, xmms_error_t *err);
 static gint32 xmms_medialib_client_get_id (xmms_medialib_t *medialib, const gchar *url, xmms_error_t *error);
 
 static s4_t *xmms_medialib_database_open (const gchar *config_path, const gchar *indices[]);
@@ -80,6 +83,8 @@ struct xmms_medialib_St {
 	xmms_object_t object;
 	s4_t *s4;
 	s4_sourcepref_t *default_sp;
+	xmms_medialib_import_t *import;
+	xmms_medialib_unplayable_t *unplayable;
 };
 
 static const gchar *source_pref[] = {
@@ -100,6 +105,9 @@ xmms_medialib_destroy (xmms_object_t *object)
 
 	XMMS_DBG ("Deactivating medialib object.");
 
+	xmms_medialib_import_free (mlib->import);
+	xmms_medialib_unplayable_free (mlib->unplayable);
+
 	s4_sourcepref_unref (mlib->default_sp);
 	s4_close (mlib->s4);
 
@@ -117,9 +125,9 @@ xmms_medialib_destroy (xmms_object_t *object)
 xmms_medialib_t *
 xmms_medialib_init (void)
 {
-	xmms_config_property_t *cfg;
+	xmms_config_property_t *cfg, *unplayable_cfg;
 	xmms_medialib_t *medialib;
-	const gchar *medialib_path;
+	const gchar *medialib_path, *unplayable_path;
 	gchar *path;
 
 	const gchar *indices[] = {
@@ -142,10 +150,26 @@ xmms_medialib_init (void)
 
 	xmms_config_property_register ("sqlite2s4.path", "sqlite2s4", NULL, NULL);
 
+	path = XMMS_BUILD_PATH ("unplayable");
+	unplayable_cfg = xmms_config_property_register ("medialib.unplayable_path",
+	                                                path, NULL, NULL);
+	g_free (path);
+
 	medialib_path = xmms_config_property_get_string (cfg);
+
+	/* a medialib in memory forgets the unplayable files as well */
+	if (strcmp (medialib_path, "memory://") == 0) {
+		medialib->unplayable = xmms_medialib_unplayable_new (NULL);
+	} else {
+		unplayable_path = xmms_config_property_get_string (unplayable_cfg);
+		medialib->unplayable = xmms_medialib_unplayable_new (unplayable_path);
+	}
+
 	medialib->s4 = xmms_medialib_database_open (medialib_path, indices);
 	medialib->default_sp = s4_sourcepref_create (source_pref);
 
+	medialib->import = xmms_medialib_import_new (medialib);
+
 	return medialib;
 }
 
@@ -161,6 +185,12 @@ xmms_medialib_get_database_backend (xmms_medialib_t *medialib)
 	return medialib->s4;
 }
 
+xmms_medialib_unplayable_t *
+xmms_medialib_get_unplayable (xmms_medialib_t *medialib)
+{
+	return medialib->unplayable;
+}
+
 /**
  * Extracts the file name of the old media library
  * and replaces its suffix with .s4
@@ -682,6 +712,168 @@ xmms_medialib_entry_cleanup (xmms_medialib_session_t *session,
 	s4_val_free (song_id);
 }
 
+static gboolean
+entry_value_equal (const s4_val_t *stored, xmmsv_t *value)
+{
+	const gchar *s, *str;
+	gint32 i;
+	gint ival;
+
+	if (s4_val_get_str (stored, &s) && xmmsv_get_string (value, &str)) {
+		return strcmp (s, str) == 0;
+	}
+
+	if (s4_val_get_int (stored, &i) && xmmsv_get_int (value, &ival)) {
+		return i == ival;
+	}
+
+	return FALSE;
+}
+
+static s4_val_t *
+entry_value_new (const gchar *key, xmmsv_t *value)
+{
+	const gchar *s;
+	gint i;
+
+	if (xmmsv_get_string (value, &s)) {
+		if (!g_utf8_validate (s, -1, NULL)) {
+			XMMS_DBG ("OOOOOPS! Trying to set property %s to a NON UTF-8 string (%s) I will deny that!", key, s);
+			return NULL;
+		}
+		return s4_val_new_string (s);
+	}
+
+	if (xmmsv_get_int (value, &i)) {
+		return s4_val_new_int (i);
+	}
+
+	XMMS_DBG ("Unknown type?!?");
+
+	return NULL;
+}
+
+/**
+ * Write a set of properties to an entry in one pass.
+ *
+ * The stored properties are fetched once and values that are already
+ * stored are left alone. Only the values that differ are written, so
+ * the entry is broadcast as updated only if one of them changed. The
+ * status is set like any other property when it is part of properties,
+ * as it is for the metadata collected from a chain.
+ *
+ * @param properties dict of key to dict of source to value, the layout
+ * of an entry info.
+ * @param cleanup if TRUE, derived properties missing from properties
+ * are removed, like #xmms_medialib_entry_cleanup does.
+ * @param written if not NULL, set to the number of values written.
+ * @param skipped if not NULL, set to the number of values left as is.
+ */
+void
+xmms_medialib_entry_properties_set (xmms_medialib_session_t *session,
+                                    xmms_medialib_entry_t entry,
+                                    xmmsv_t *properties, gboolean cleanup,
+                                    guint *written, guint *skipped)
+{
+	xmmsv_dict_iter_t *kit, *sit;
+	const s4_result_t *res;
+	GHashTableIter iter;
+	GHashTable *stored;
+	s4_resultset_t *set;
+	s4_val_t *song_id;
+	guint nwritten = 0, nskipped = 0;
+	gint i;
+
+	song_id = s4_val_new_int (entry);
+
+	set = xmms_medialib_filter (session, "song_id", song_id,
+	                            S4_COND_PARENT, NULL, NULL, S4_FETCH_DATA);
+
+	stored = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+
+	for (i = 0; i < s4_resultset_get_rowcount (set); i++) {
+		res = s4_resultset_get_result (set, i, 0);
+		for (; res != NULL; res = s4_result_next (res)) {
+			g_hash_table_insert (stored,
+			                     g_strconcat (s4_result_get_src (res), "\t",
+			                                  s4_result_get_key (res), NULL),
+			                     (gpointer) res);
+		}
+	}
+
+	xmmsv_get_dict_iter (properties, &kit);
+	for (; xmmsv_dict_iter_valid (kit); xmmsv_dict_iter_next (kit)) {
+		const gchar *key;
+		xmmsv_t *sources;
+
+		xmmsv_dict_iter_pair (kit, &key, &sources);
+
+		xmmsv_get_dict_iter (sources, &sit);
+		for (; xmmsv_dict_iter_valid (sit); xmmsv_dict_iter_next (sit)) {
+			const gchar *source;
+			xmmsv_t *value;
+			s4_val_t *val;
+			gchar *tuple;
+
+			xmmsv_dict_iter_pair (sit, &source, &value);
+
+			tuple = g_strconcat (source, "\t", key, NULL);
+			res = g_hash_table_lookup (stored, tuple);
+
+			if (res != NULL && entry_value_equal (s4_result_get_val (res), value)) {
+				g_hash_table_remove (stored, tuple);
+				g_free (tuple);
+				nskipped++;
+				continue;
+			}
+
+			val = entry_value_new (key, value);
+			if (val == NULL) {
+				g_free (tuple);
+				continue;
+			}
+
+			if (res != NULL) {
+				xmms_medialib_session_property_unset (session, entry, key,
+				                                      s4_result_get_val (res),
+				                                      source);
+				g_hash_table_remove (stored, tuple);
+			}
+
+			xmms_medialib_session_property_add (session, entry, key,
+			                                    val, source);
+			s4_val_free (val);
+			g_free (tuple);
+			nwritten++;
+		}
+	}
+
+	if (cleanup) {
+		g_hash_table_iter_init (&iter, stored);
+		while (g_hash_table_iter_next (&iter, NULL, (gpointer *) &res)) {
+			const gchar *src = s4_result_get_src (res);
+			const gchar *key = s4_result_get_key (res);
+
+			if (entry_attribute_is_derived (src, key)) {
+				xmms_medialib_session_property_unset (session, entry, key,
+				                                      s4_result_get_val (res),
+				                                      src);
+			}
+		}
+	}
+
+	g_hash_table_destroy (stored);
+	s4_resultset_free (set);
+	s4_val_free (song_id);
+
+	if (written != NULL) {
+		*written = nwritten;
+	}
+	if (skipped != NULL) {
+		*skipped = nskipped;
+	}
+}
+
 static void
 xmms_medialib_client_rehash (xmms_medialib_t *medialib,
                              xmms_medialib_entry_t entry,
@@ -804,7 +996,15 @@ static void
 xmms_medialib_client_import_path (xmms_medialib_t *medialib, const gchar *path,
                                   xmms_error_t *error)
 {
-	xmmsv_unref (xmms_medialib_add_recursive (medialib, path, error));
+	xmms_medialib_import_run (medialib->import, path, error);
+}
+
+static gint32
+xmms_medialib_client_import_path_async (xmms_medialib_t *medialib,
+                                        const gchar *path,
+                                        xmms_error_t *error)
+{
+	return xmms_medialib_import_start (medialib->import, path);
 }
 
 static gboolean
@@ -942,6 +1142,35 @@ xmms_medialib_tree_add_tuple (xmmsv_t *dict, const char *key,
 	xmmsv_dict_set (entry, source, value);
 }
 
+/* Add a chain of key-source-value results to a property tree */
+static void
+xmms_medialib_tree_add_results (xmmsv_t *dict, const s4_result_t *res)
+{
+	xmmsv_t *v_entry;
+
+	while (res != NULL) {
+		const s4_val_t *val;
+		const char *s;
+		gint32 i;
+
+		val = s4_result_get_val (res);
+		if (s4_val_get_str (val, &s)) {
+			v_entry = xmmsv_new_string (s);
+		} else if (s4_val_get_int (val, &i)) {
+			v_entry = xmmsv_new_int (i);
+		} else {
+			res = s4_result_next (res);
+			continue;
+		}
+
+		xmms_medialib_tree_add_tuple (dict, s4_result_get_key (res),
+		                              s4_result_get_src (res), v_entry);
+		xmmsv_unref (v_entry);
+
+		res = s4_result_next (res);
+	}
+}
+
 /**
  * Convert a entry and all properties to a key-source-value tree that
  * could be feed to the client or somewhere else in the daemon.
@@ -970,27 +1199,7 @@ xmms_medialib_entry_to_tree (xmms_medialib_session_t *session,
 	ret = xmmsv_new_dict ();
 
 	for (i = 0; i < s4_resultset_get_rowcount (set); i++) {
-		const s4_result_t *res;
-
-		res = s4_resultset_get_result (set, 0, 0);
-		while (res != NULL) {
-			const s4_val_t *val;
-			const char *s;
-			gint32 i;
-
-			val = s4_result_get_val (res);
-			if (s4_val_get_str (val, &s)) {
-				v_entry = xmmsv_new_string (s);
-			} else if (s4_val_get_int (val, &i)) {
-				v_entry = xmmsv_new_int (i);
-			}
-
-			xmms_medialib_tree_add_tuple (ret, s4_result_get_key (res),
-			                              s4_result_get_src (res), v_entry);
-			xmmsv_unref (v_entry);
-
-			res = s4_result_next (res);
-		}
+		xmms_medialib_tree_add_results (ret, s4_resultset_get_result (set, 0, 0));
 	}
 
 	s4_resultset_free (set);
@@ -1021,6 +1230,140 @@ xmms_medialib_client_get_info (xmms_medialib_t *medialib,
 	return ret;
 }
 
+static gint
+xmms_medialib_id_table_filter (const s4_val_t *value, s4_condition_t *cond)
+{
+	GHashTable *id_table;
+	gint32 ival;
+
+	if (!s4_val_get_int (value, &ival)) {
+		return 1;
+	}
+
+	id_table = s4_cond_get_funcdata (cond);
+
+	return g_hash_table_lookup (id_table, GINT_TO_POINTER (ival)) == NULL;
+}
+
+/**
+ * Convert a list of entries to key-source-value trees, fetching the
+ * properties of all of them with a single query.
+ *
+ * @param session The medialib session to be used for the transaction.
+ * @param ids List of entry ids.
+ * @param keys List of property keys to fetch, or an empty list for all.
+ *
+ * @returns A list of trees in the order of ids. Entries that do not exist
+ * are left out, the "id" property tells which tree belongs to which entry.
+ */
+static xmmsv_t *
+xmms_medialib_entries_to_trees (xmms_medialib_session_t *session,
+                                xmmsv_t *ids, xmmsv_t *keys)
+{
+	GHashTable *id_table, *trees;
+	s4_condition_t *cond;
+	s4_fetchspec_t *spec;
+	s4_resultset_t *set;
+	const gchar *key;
+	xmmsv_t *ret, *tree, *v_entry;
+	gint32 id;
+	gint i, j, cols;
+
+	id_table = g_hash_table_new (NULL, NULL);
+	for (i = 0; xmmsv_list_get_int (ids, i, &id); i++) {
+		g_hash_table_insert (id_table, GINT_TO_POINTER (id), GINT_TO_POINTER (1));
+	}
+
+	cond = s4_cond_new_custom_filter (xmms_medialib_id_table_filter, id_table,
+	                                  (free_func_t) g_hash_table_destroy,
+	                                  "song_id", NULL, 0, 0, S4_COND_PARENT);
+
+	spec = s4_fetchspec_create ();
+	s4_fetchspec_add (spec, "song_id", NULL, S4_FETCH_PARENT);
+
+	if (xmmsv_list_get_size (keys) == 0) {
+		s4_fetchspec_add (spec, NULL, NULL, S4_FETCH_PARENT | S4_FETCH_DATA);
+	}
+
+	for (i = 0; xmmsv_list_get_string (keys, i, &key); i++) {
+		/* the id is not a property, it is always added below */
+		if (strcmp (key, XMMS_MEDIALIB_ENTRY_PROPERTY_ID) != 0) {
+			s4_fetchspec_add (spec, key, NULL, S4_FETCH_DATA);
+		}
+	}
+
+	set = xmms_medialib_session_query (session, spec, cond);
+
+	s4_fetchspec_free (spec);
+	s4_cond_free (cond);
+
+	trees = g_hash_table_new_full (NULL, NULL, NULL,
+	                               (GDestroyNotify) xmmsv_unref);
+
+	cols = s4_resultset_get_colcount (set);
+	for (i = 0; i < s4_resultset_get_rowcount (set); i++) {
+		const s4_result_t *res;
+
+		res = s4_resultset_get_result (set, i, 0);
+		if (res == NULL || !s4_val_get_int (s4_result_get_val (res), &id)) {
+			continue;
+		}
+
+		tree = xmmsv_new_dict ();
+		for (j = 1; j < cols; j++) {
+			xmms_medialib_tree_add_results (tree, s4_resultset_get_result (set, i, j));
+		}
+
+		v_entry = xmmsv_new_int (id);
+		xmms_medialib_tree_add_tuple (tree, "id", "server", v_entry);
+		xmmsv_unref (v_entry);
+
+		g_hash_table_insert (trees, GINT_TO_POINTER (id), tree);
+	}
+
+	s4_resultset_free (set);
+
+	ret = xmmsv_new_list ();
+	for (i = 0; xmmsv_list_get_int (ids, i, &id); i++) {
+		tree = g_hash_table_lookup (trees, GINT_TO_POINTER (id));
+		if (tree != NULL) {
+			xmmsv_list_append (ret, tree);
+		}
+	}
+
+	g_hash_table_destroy (trees);
+
+	return ret;
+}
+
+static xmmsv_t *
+xmms_medialib_client_get_infos (xmms_medialib_t *medialib, xmmsv_t *ids,
+                                xmmsv_t *keys, xmms_error_t *err)
+{
+	xmms_medialib_session_t *session;
+	xmmsv_t *ret = NULL;
+
+	if (!xmmsv_list_has_type (ids, XMMSV_TYPE_INT32)) {
+		xmms_error_set (err, XMMS_ERROR_INVAL, "Ids must be integers");
+		return NULL;
+	}
+
+	if (!xmmsv_list_has_type (keys, XMMSV_TYPE_STRING)) {
+		xmms_error_set (err, XMMS_ERROR_INVAL, "Keys must be strings");
+		return NULL;
+	}
+
+	do {
+		if (ret != NULL) {
+			xmmsv_unref (ret);
+		}
+		session = xmms_medialib_session_begin_ro (medialib);
+		ret = xmms_medialib_entries_to_trees (session, ids, keys);
+	} while (!xmms_medialib_session_commit (session));
+
+	return ret;
+}
+
 /**
  * Add a entry to the medialib. Calls #xmms_medialib_entry_new and then
  * wakes up the mediainfo_reader in order to resolve the metadata.
@@ -1223,6 +1566,62 @@ xmms_medialib_query_random_id (xmms_medialib_session_t *session,
 	return ret;
 }
 
+/**
+ * Returns a number of random entries from a collection, each picked
+ * independently like with #xmms_medialib_query_random_id, but with a
+ * single query.
+ *
+ * @param coll The collection to find random entries in
+ * @param count The number of entries to pick
+ * @return A list of count entries, empty if the collection is empty
+ */
+xmmsv_t *
+xmms_medialib_query_random_ids (xmms_medialib_session_t *session,
+                                xmmsv_t *coll, gint count)
+{
+	xmms_medialib_entry_t id;
+	xmmsv_t *spec, *res, *ret;
+	xmms_error_t err;
+	gint size, i;
+
+	ret = xmmsv_new_list ();
+
+	if (count == 1) {
+		id = xmms_medialib_query_random_id (session, coll);
+		if (id > 0) {
+			xmmsv_list_append_int (ret, id);
+		}
+		return ret;
+	}
+
+	spec = xmmsv_build_list (XMMSV_LIST_ENTRY_STR ("id"),
+	                         XMMSV_LIST_END);
+
+	spec = xmmsv_build_dict (XMMSV_DICT_ENTRY_STR ("type", "metadata"),
+	                         XMMSV_DICT_ENTRY_STR ("aggregate", "list"),
+	                         XMMSV_DICT_ENTRY ("get", spec),
+	                         XMMSV_DICT_END);
+
+	res = xmms_medialib_query (session, coll, spec, &err);
+
+	size = 0;
+	if (res != NULL && xmmsv_is_type (res, XMMSV_TYPE_LIST)) {
+		size = xmmsv_list_get_size (res);
+	}
+
+	for (i = 0; size > 0 && i < count; i++) {
+		xmmsv_list_get_int (res, g_random_int_range (0, size), &id);
+		xmmsv_list_append_int (ret, id);
+	}
+
+	xmmsv_unref (spec);
+	if (res != NULL) {
+		xmmsv_unref (res);
+	}
+
+	return ret;
+}
+
 /**
  * @internal
  * Get the next unresolved entry. Used by the mediainfo reader..
@@ -0,0 +1,499 @@
+/*  XMMS2 - X Music Multiplexer System
+ *  Copyright (C) 2003-2013 XMMS2 Team
+ *
+ *  PLUGINS ARE NOT CONSIDERED TO BE DERIVED WORK !!!
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ */
+
+/** @file
+ *  Recursive import of directories into the medialib.
+ *
+ *  Each import is a job, identified by a number handed to the client
+ *  right away. The directories of all jobs are read by a pool of threads,
+ *  at most medialib.import_threads at a time, and every directory read
+ *  queues its subdirectories back to the pool. The files found in a
+ *  directory are added in batches, one medialib session per batch.
+ *
+ *  Importing a directory again rescans it. When the directory listing
+ *  carries a fingerprint of the files, entries already in the medialib
+ *  are compared with it: changed files are queued for a rehash and the
+ *  unchanged ones are left alone, without running their xform chain.
+ *  Files no chain could be set up for are not added again as long as
+ *  neither they nor the plugins changed.
+ *
+ *  Progress is broadcast as the job goes, at most every quarter of a
+ *  second, and once more when the last directory has been read.
+ */
+
+#include <xmmspriv/xmms_medialib_import.h>
+#include <xmmspriv/xmms_xform.h>
+#include <xmms/xmms_config.h>
+#include <xmms/xmms_ipc.h>
+#include <xmms/xmms_log.h>
+
+#include <string.h>
+
+/* Files added per medialib session */
+#define XMMS_MEDIALIB_IMPORT_BATCH_SIZE 128
+
+/* Minimum time between two progress broadcasts of a job, in microseconds */
+#define XMMS_MEDIALIB_IMPORT_PROGRESS_INTERVAL 250000
+
+typedef struct xmms_medialib_import_job_St {
+	gint32 id;
+	gchar *path;
+
+	/* directories queued or being read */
+	gint pending;
+
+	gint directories;
+	gint files;
+	gint entries;
+	gint changed;
+	gint unchanged;
+	gint errors;
+
+	/* the first directory that could not be read */
+	xmms_error_t error;
+
+	gint64 last_progress;
+	gboolean done;
+
+	/* threads waiting for the job to be done, the last one frees it */
+	gint waiters;
+} xmms_medialib_import_job_t;
+
+typedef struct xmms_medialib_import_task_St {
+	xmms_medialib_import_job_t *job;
+	gchar *directory;
+} xmms_medialib_import_task_t;
+
+struct xmms_medialib_import_St {
+	xmms_medialib_t *medialib;
+	GThreadPool *pool;
+
+	/* protects everything below and the jobs */
+	GMutex mutex;
+	GCond cond;
+
+	gint32 next_id;
+	gboolean stopping;
+};
+
+typedef struct xmms_medialib_import_count_St {
+	gint entries;
+	gint changed;
+	gint unchanged;
+} xmms_medialib_import_count_t;
+
+static void xmms_medialib_import_task_run (gpointer data, gpointer udata);
+
+static void
+on_threads_changed (xmms_object_t *object, xmmsv_t *_data, gpointer udata)
+{
+	xmms_medialib_import_t *import = udata;
+	gint value;
+
+	value = xmms_config_property_get_int ((xmms_config_property_t *) object);
+	g_thread_pool_set_max_threads (import->pool, MAX (value, 1), NULL);
+}
+
+xmms_medialib_import_t *
+xmms_medialib_import_new (xmms_medialib_t *medialib)
+{
+	xmms_medialib_import_t *import;
+	xmms_config_property_t *cv;
+
+	import = g_new0 (xmms_medialib_import_t, 1);
+	import->medialib = medialib;
+	import->next_id = 1;
+
+	g_mutex_init (&import->mutex);
+	g_cond_init (&import->cond);
+
+	cv = xmms_config_property_register ("medialib.import_threads", "4",
+	                                    on_threads_changed, import);
+
+	import->pool = g_thread_pool_new (xmms_medialib_import_task_run, import,
+	                                  MAX (xmms_config_property_get_int (cv), 1),
+	                                  FALSE, NULL);
+
+	return import;
+}
+
+/**
+ * Stop the import jobs and free the importer. The directories already
+ * queued are dropped without being read.
+ */
+void
+xmms_medialib_import_free (xmms_medialib_import_t *import)
+{
+	xmms_config_property_t *cv;
+
+	g_return_if_fail (import);
+
+	cv = xmms_config_lookup ("medialib.import_threads");
+	xmms_config_property_callback_remove (cv, on_threads_changed, import);
+
+	g_mutex_lock (&import->mutex);
+	import->stopping = TRUE;
+	g_mutex_unlock (&import->mutex);
+
+	/* the remaining tasks still run, to finish their jobs */
+	g_thread_pool_free (import->pool, FALSE, TRUE);
+
+	g_cond_clear (&import->cond);
+	g_mutex_clear (&import->mutex);
+	g_free (import);
+}
+
+static void
+xmms_medialib_import_job_free (xmms_medialib_import_job_t *job)
+{
+	g_free (job->path);
+	g_free (job);
+}
+
+/**
+ * Queue the reading of a directory, the caller holds the mutex.
+ */
+static void
+xmms_medialib_import_push (xmms_medialib_import_t *import,
+                           xmms_medialib_import_job_t *job,
+                           const gchar *directory)
+{
+	xmms_medialib_import_task_t *task;
+
+	task = g_new0 (xmms_medialib_import_task_t, 1);
+	task->job = job;
+	task->directory = g_strdup (directory);
+
+	job->pending++;
+
+	g_thread_pool_push (import->pool, task, NULL);
+}
+
+/**
+ * Create a job and queue its top directory, the caller holds the mutex.
+ */
+static xmms_medialib_import_job_t *
+xmms_medialib_import_job_new (xmms_medialib_import_t *import,
+                              const gchar *path, gint waiters)
+{
+	xmms_medialib_import_job_t *job;
+
+	job = g_new0 (xmms_medialib_import_job_t, 1);
+	job->id = import->next_id++;
+	job->path = g_strdup (path);
+	job->waiters = waiters;
+	job->last_progress = g_get_monotonic_time ();
+	xmms_error_reset (&job->error);
+
+	xmms_medialib_import_push (import, job, path);
+
+	return job;
+}
+
+/**
+ * Broadcast the progress of a job, the caller holds the mutex so the
+ * broadcasts of a job go out in order.
+ */
+static void
+xmms_medialib_import_progress (xmms_medialib_import_t *import,
+                               xmms_medialib_import_job_t *job)
+{
+	xmmsv_t *dict;
+
+	dict = xmmsv_build_dict (XMMSV_DICT_ENTRY_INT ("job", job->id),
+	                         XMMSV_DICT_ENTRY_STR ("path", job->path),
+	                         XMMSV_DICT_ENTRY_INT ("directories", job->directories),
+	                         XMMSV_DICT_ENTRY_INT ("pending", job->pending),
+	                         XMMSV_DICT_ENTRY_INT ("files", job->files),
+	                         XMMSV_DICT_ENTRY_INT ("entries", job->entries),
+	                         XMMSV_DICT_ENTRY_INT ("changed", job->changed),
+	                         XMMSV_DICT_ENTRY_INT ("unchanged", job->unchanged),
+	                         XMMSV_DICT_ENTRY_INT ("errors", job->errors),
+	                         XMMSV_DICT_ENTRY_INT ("done", job->done),
+	                         XMMSV_DICT_END);
+
+	if (xmms_error_iserror (&job->error)) {
+		xmmsv_dict_set_string (dict, "error",
+		                       xmms_error_message_get (&job->error));
+	}
+
+	xmms_object_emit (XMMS_OBJECT (import->medialib),
+	                  XMMS_IPC_SIGNAL_MEDIALIB_IMPORT_PROGRESS,
+	                  dict);
+}
+
+/**
+ * Compare an entry with the fingerprint of its file and queue it for a
+ * rehash if the file changed. Entries not resolved yet are left to the
+ * mediainfo reader.
+ */
+static void
+xmms_medialib_import_rescan (xmms_medialib_session_t *session,
+                             xmms_medialib_entry_t entry,
+                             const gchar *fingerprint,
+                             xmms_medialib_import_count_t *count)
+{
+	gchar *stored;
+	gint status;
+
+	status = xmms_medialib_entry_property_get_int (session, entry,
+	                                               XMMS_MEDIALIB_ENTRY_PROPERTY_STATUS);
+	if (status != XMMS_MEDIALIB_ENTRY_STATUS_OK &&
+	    status != XMMS_MEDIALIB_ENTRY_STATUS_NOT_AVAILABLE) {
+		return;
+	}
+
+	if (fingerprint == NULL) {
+		count->unchanged++;
+		return;
+	}
+
+	stored = xmms_medialib_entry_property_get_str (session, entry,
+	                                               XMMS_MEDIALIB_ENTRY_PROPERTY_FINGERPRINT);
+
+	/* entries resolved before fingerprints were stored are rehashed once
+	 * to get one, unless their file could not be read back then */
+	if (g_strcmp0 (stored, fingerprint) == 0 ||
+	    (stored == NULL && status == XMMS_MEDIALIB_ENTRY_STATUS_NOT_AVAILABLE)) {
+		count->unchanged++;
+	} else {
+		xmms_medialib_entry_status_set (session, entry,
+		                                XMMS_MEDIALIB_ENTRY_STATUS_REHASH);
+		count->changed++;
+	}
+
+	g_free (stored);
+}
+
+/**
+ * Add a batch of files from a directory listing to the medialib in one
+ * session, and rescan the ones already there.
+ */
+static void
+xmms_medialib_import_batch (xmms_medialib_import_t *import, GPtrArray *files,
+                            xmms_medialib_import_count_t *count)
+{
+	xmms_medialib_unplayable_t *unplayable;
+	xmms_medialib_session_t *session;
+	xmms_medialib_import_count_t batch;
+	xmms_error_t err;
+	guint i;
+
+	if (files->len == 0) {
+		return;
+	}
+
+	unplayable = xmms_medialib_get_unplayable (import->medialib);
+
+	xmms_error_reset (&err);
+
+	do {
+		memset (&batch, 0, sizeof (batch));
+		session = xmms_medialib_session_begin (import->medialib);
+		for (i = 0; i < files->len; i++) {
+			xmms_medialib_entry_t entry;
+			const gchar *url, *fingerprint = NULL;
+			xmmsv_t *file;
+
+			file = g_ptr_array_index (files, i);
+			xmmsv_dict_entry_get_string (file, "path", &url);
+			xmmsv_dict_entry_get_string (file, "fingerprint", &fingerprint);
+
+			if (fingerprint != NULL &&
+			    xmms_medialib_unplayable_lookup (unplayable, url, fingerprint)) {
+				continue;
+			}
+
+			entry = xmms_medialib_entry_new_encoded (session, url, &err);
+			if (entry) {
+				xmms_medialib_import_rescan (session, entry, fingerprint, &batch);
+				batch.entries++;
+			}
+		}
+	} while (!xmms_medialib_session_commit (session));
+
+	count->entries += batch.entries;
+	count->changed += batch.changed;
+	count->unchanged += batch.unchanged;
+}
+
+/**
+ * Read one directory: queue its subdirectories and add its files.
+ */
+static void
+xmms_medialib_import_task_run (gpointer data, gpointer udata)
+{
+	xmms_medialib_import_task_t *task = data;
+	xmms_medialib_import_t *import = udata;
+	xmms_medialib_import_job_t *job = task->job;
+	xmmsv_list_iter_t *it;
+	xmmsv_t *list = NULL, *val;
+	xmms_medialib_import_count_t count = { 0, 0, 0 };
+	GPtrArray *batch;
+	xmms_error_t err;
+	gint files = 0;
+	gboolean stopping;
+	gint64 now;
+
+	xmms_error_reset (&err);
+
+	g_mutex_lock (&import->mutex);
+	stopping = import->stopping;
+	g_mutex_unlock (&import->mutex);
+
+	if (!stopping) {
+		list = xmms_xform_browse (task->directory, &err);
+	}
+
+	batch = g_ptr_array_new ();
+
+	if (list != NULL) {
+		xmmsv_get_list_iter (list, &it);
+
+		for (; xmmsv_list_iter_entry (it, &val); xmmsv_list_iter_next (it)) {
+			const gchar *str;
+			gint isdir;
+
+			xmmsv_dict_entry_get_string (val, "path", &str);
+			xmmsv_dict_entry_get_int (val, "isdir", &isdir);
+
+			if (isdir == 1) {
+				g_mutex_lock (&import->mutex);
+				if (!import->stopping) {
+					xmms_medialib_import_push (import, job, str);
+				}
+				g_mutex_unlock (&import->mutex);
+				continue;
+			}
+
+			g_ptr_array_add (batch, val);
+			files++;
+
+			if (batch->len == XMMS_MEDIALIB_IMPORT_BATCH_SIZE) {
+				xmms_medialib_import_batch (import, batch, &count);
+				g_ptr_array_set_size (batch, 0);
+			}
+		}
+
+		xmms_medialib_import_batch (import, batch, &count);
+	}
+
+	g_ptr_array_free (batch, TRUE);
+
+	g_mutex_lock (&import->mutex);
+
+	if (list != NULL) {
+		job->directories++;
+	} else if (!stopping) {
+		job->errors++;
+		if (!xmms_error_iserror (&job->error)) {
+			job->error = err;
+		}
+	}
+
+	job->files += files;
+	job->entries += count.entries;
+	job->changed += count.changed;
+	job->unchanged += count.unchanged;
+	job->pending--;
+
+	now = g_get_monotonic_time ();
+
+	if (job->pending == 0) {
+		job->done = TRUE;
+		xmms_medialib_import_progress (import, job);
+		g_cond_broadcast (&import->cond);
+		if (job->waiters == 0) {
+			xmms_medialib_import_job_free (job);
+		}
+	} else if (now - job->last_progress >= XMMS_MEDIALIB_IMPORT_PROGRESS_INTERVAL) {
+		job->last_progress = now;
+		xmms_medialib_import_progress (import, job);
+	}
+
+	g_mutex_unlock (&import->mutex);
+
+	if (list != NULL) {
+		xmmsv_unref (list);
+	}
+
+	g_free (task->directory);
+	g_free (task);
+}
+
+/**
+ * Start importing a directory recursively and return at once.
+ *
+ * @param import the importer
+ * @param path the encoded url of the directory
+ * @return the id of the job, found in its progress broadcasts
+ */
+gint32
+xmms_medialib_import_start (xmms_medialib_import_t *import, const gchar *path)
+{
+	xmms_medialib_import_job_t *job;
+	gint32 id;
+
+	g_return_val_if_fail (import, 0);
+	g_return_val_if_fail (path, 0);
+
+	g_mutex_lock (&import->mutex);
+	job = xmms_medialib_import_job_new (import, path, 0);
+	id = job->id;
+	g_mutex_unlock (&import->mutex);
+
+	return id;
+}
+
+/**
+ * Import a directory recursively and wait until it is done.
+ *
+ * @param import the importer
+ * @param path the encoded url of the directory
+ * @param err set to the first directory error, if any
+ * @return TRUE if every directory could be read
+ */
+gboolean
+xmms_medialib_import_run (xmms_medialib_import_t *import, const gchar *path,
+                          xmms_error_t *err)
+{
+	xmms_medialib_import_job_t *job;
+	gboolean ret;
+
+	g_return_val_if_fail (import, FALSE);
+	g_return_val_if_fail (path, FALSE);
+
+	g_mutex_lock (&import->mutex);
+
+	job = xmms_medialib_import_job_new (import, path, 1);
+	while (!job->done) {
+		g_cond_wait (&import->cond, &import->mutex);
+	}
+
+	ret = !xmms_error_iserror (&job->error);
+	if (!ret && err) {
+		xmms_error_set (err, job->error.code,
+		                xmms_error_message_get (&job->error));
+	}
+
+	if (--job->waiters == 0) {
+		xmms_medialib_import_job_free (job);
+	}
+
+	g_mutex_unlock (&import->mutex);
+
+	return ret;
+}
@@ -462,6 +462,99 @@ metadata_to_xmmsv (s4_resultset_t *set, xmms_fetch_spec_t *spec)
 	                         spec->data.metadata.aggr_func);
 }
 
+/* Returns the index of a string in the string list of a columns result,
+ * adding it if it is not there yet */
+static gint
+column_string_index (GHashTable *index, xmmsv_t *strings, const gchar *str)
+{
+	gpointer value;
+	gint pos;
+
+	if (g_hash_table_lookup_extended (index, str, NULL, &value)) {
+		return GPOINTER_TO_INT (value);
+	}
+
+	pos = xmmsv_list_get_size (strings);
+	xmmsv_list_append_string (strings, str);
+	g_hash_table_insert (index, g_strdup (str), GINT_TO_POINTER (pos));
+
+	return pos;
+}
+
+/* Converts an S4 resultset into one list per field, see
+ * xmms_fetch_spec_new_columns
+ */
+static xmmsv_t *
+columns_to_xmmsv (s4_resultset_t *set, xmms_fetch_spec_t *spec)
+{
+	const s4_resultrow_t *row;
+	const s4_result_t *res;
+	const s4_val_t *val;
+	const gchar *str_value;
+	xmmsv_t *columns, *types, *strings, *column, *none;
+	GHashTable *index;
+	gboolean is_string;
+	gint32 int_value;
+	gint i, j, col;
+	gchar buf[12];
+
+	index = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+	columns = xmmsv_new_dict ();
+	types = xmmsv_new_dict ();
+	strings = xmmsv_new_list ();
+	none = xmmsv_new_none ();
+
+	for (j = 0; j < spec->data.columns.count; j++) {
+		col = spec->data.columns.cols[j];
+
+		/* A column with any string value is stored as string indices,
+		 * with integers converted like when clustering */
+		is_string = FALSE;
+		for (i = 0; !is_string && s4_resultset_get_row (set, i, &row); i++) {
+			if (s4_resultrow_get_col (row, col, &res)) {
+				is_string = s4_val_get_str (s4_result_get_val (res), &str_value);
+			}
+		}
+
+		column = xmmsv_new_list ();
+
+		for (i = 0; s4_resultset_get_row (set, i, &row); i++) {
+			if (!s4_resultrow_get_col (row, col, &res)) {
+				xmmsv_list_append (column, none);
+				continue;
+			}
+
+			val = s4_result_get_val (res);
+
+			if (!s4_val_get_str (val, &str_value)) {
+				s4_val_get_int (val, &int_value);
+				if (!is_string) {
+					xmmsv_list_append_int (column, int_value);
+					continue;
+				}
+				g_snprintf (buf, sizeof (buf), "%i", int_value);
+				str_value = buf;
+			}
+
+			xmmsv_list_append_int (column, column_string_index (index, strings, str_value));
+		}
+
+		xmmsv_dict_set (columns, spec->data.columns.fields[j], column);
+		xmmsv_dict_set_string (types, spec->data.columns.fields[j],
+		                       is_string ? "string" : "integer");
+		xmmsv_unref (column);
+	}
+
+	g_hash_table_destroy (index);
+	xmmsv_unref (none);
+
+	return xmmsv_build_dict (XMMSV_DICT_ENTRY_INT ("count", s4_resultset_get_rowcount (set)),
+	                         XMMSV_DICT_ENTRY ("columns", columns),
+	                         XMMSV_DICT_ENTRY ("types", types),
+	                         XMMSV_DICT_ENTRY ("strings", strings),
+	                         XMMSV_DICT_END);
+}
+
 
 /* Divides an S4 set into a list of smaller sets with
  * the same values for the cluster attributes
@@ -586,6 +679,9 @@ xmms_medialib_query_to_xmmsv (s4_resultset_t *set, xmms_fetch_spec_t *spec)
 		case FETCH_METADATA:
 			ret = metadata_to_xmmsv (set, spec);
 			break;
+		case FETCH_COLUMNS:
+			ret = columns_to_xmmsv (set, spec);
+			break;
 		case FETCH_ORGANIZE:
 			ret = xmmsv_new_dict ();
 
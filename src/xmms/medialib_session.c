@@ -132,6 +132,39 @@ xmms_medialib_session_query (xmms_medialib_session_t *session,
 	return s4_query (session->trans, specification, condition);
 }
 
+/**
+ * Add a value to a property without looking for the one it replaces,
+ * for callers that already removed it.
+ */
+gint
+xmms_medialib_session_property_add (xmms_medialib_session_t *session,
+                                    xmms_medialib_entry_t entry,
+                                    const gchar *key,
+                                    const s4_val_t *value,
+                                    const gchar *source)
+{
+	GHashTable *events;
+	s4_val_t *song_id;
+	gint result;
+
+	song_id = s4_val_new_int (entry);
+	result = s4_add (session->trans, "song_id", song_id,
+	                 key, value, source);
+	s4_val_free (song_id);
+
+	if (strcmp (key, XMMS_MEDIALIB_ENTRY_PROPERTY_URL) == 0) {
+		events = xmms_medialib_session_get_table (&session->added);
+	} else {
+		events = xmms_medialib_session_get_table (&session->updated);
+	}
+
+	g_hash_table_insert (events,
+	                     GINT_TO_POINTER (entry),
+	                     GINT_TO_POINTER (entry));
+
+	return result;
+}
+
 gint
 xmms_medialib_session_property_set (xmms_medialib_session_t *session,
                                     xmms_medialib_entry_t entry,
@@ -146,8 +179,6 @@ xmms_medialib_session_property_set (xmms_medialib_session_t *session,
 	s4_resultset_t *set;
 	s4_sourcepref_t *sp;
 	s4_val_t *song_id;
-	gint result;
-	GHashTable *events;
 
 	song_id = s4_val_new_int (entry);
 
@@ -172,23 +203,10 @@ xmms_medialib_session_property_set (xmms_medialib_session_t *session,
 
 	s4_resultset_free (set);
 	s4_sourcepref_unref (sp);
-
-	result = s4_add (session->trans, "song_id", song_id,
-	                 key, value, source);
-
 	s4_val_free (song_id);
 
-	if (strcmp (key, XMMS_MEDIALIB_ENTRY_PROPERTY_URL) == 0) {
-		events = xmms_medialib_session_get_table (&session->added);
-	} else {
-		events = xmms_medialib_session_get_table (&session->updated);
-	}
-
-	g_hash_table_insert (events,
-	                     GINT_TO_POINTER (entry),
-	                     GINT_TO_POINTER (entry));
-
-	return result;
+	return xmms_medialib_session_property_add (session, entry, key,
+	                                           value, source);
 }
 
 gint
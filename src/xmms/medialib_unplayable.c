@@ -0,0 +1,367 @@
+/*  XMMS2 - X Music Multiplexer System
+ *  Copyright (C) 2003-2013 XMMS2 Team
+ *
+ *  PLUGINS ARE NOT CONSIDERED TO BE DERIVED WORK !!!
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ */
+
+/** @file
+ *  Files no xform chain could be set up for.
+ *
+ *  When the mediainfo reader can read a file but no plugin continues
+ *  the chain, the url of the file is recorded along with its fingerprint,
+ *  the partial chain and a stamp of the xform plugins loaded. Imports
+ *  skip the files whose record still matches instead of adding them to
+ *  be probed again, and chains aren't set up for them. A record stops
+ *  matching when the file changes or when plugins are added, removed or
+ *  upgraded, and is dropped the next time it is looked up. Records of
+ *  local files that were deleted are dropped when loading.
+ *
+ *  The records are kept out of the medialib so that they never show up
+ *  in queries, and are saved to a file of their own, one per line:
+ *  url, fingerprint, stamp and chain separated by tabs.
+ */
+
+#include <xmmspriv/xmms_medialib_unplayable.h>
+#include <xmmspriv/xmms_medialib.h>
+#include <xmmspriv/xmms_plugin.h>
+#include <xmms/xmms_log.h>
+
+#include <string.h>
+
+typedef struct xmms_medialib_unplayable_record_St {
+	gchar *fingerprint;
+	gchar *stamp;
+	gchar *chain;
+} xmms_medialib_unplayable_record_t;
+
+struct xmms_medialib_unplayable_St {
+	/* where the records are saved, NULL to keep them in memory */
+	gchar *path;
+
+	/* protects everything below */
+	GMutex mutex;
+
+	/* url -> xmms_medialib_unplayable_record_t */
+	GHashTable *records;
+	gboolean dirty;
+};
+
+static void
+xmms_medialib_unplayable_record_free (gpointer data)
+{
+	xmms_medialib_unplayable_record_t *record = data;
+
+	g_free (record->fingerprint);
+	g_free (record->stamp);
+	g_free (record->chain);
+	g_free (record);
+}
+
+static void
+xmms_medialib_unplayable_insert (xmms_medialib_unplayable_t *unplayable,
+                                 const gchar *url, const gchar *fingerprint,
+                                 const gchar *stamp, const gchar *chain)
+{
+	xmms_medialib_unplayable_record_t *record;
+
+	record = g_new0 (xmms_medialib_unplayable_record_t, 1);
+	record->fingerprint = g_strdup (fingerprint);
+	record->stamp = g_strdup (stamp);
+	record->chain = g_strdup (chain);
+
+	g_hash_table_replace (unplayable->records, g_strdup (url), record);
+}
+
+static gboolean
+xmms_medialib_unplayable_stamp_foreach (xmms_plugin_t *plugin, gpointer udata)
+{
+	guint *hash = udata;
+
+	*hash ^= g_str_hash (xmms_plugin_shortname_get (plugin)) * 31 +
+	         g_str_hash (xmms_plugin_version_get (plugin));
+
+	return TRUE;
+}
+
+/**
+ * Describe the xform plugins loaded, whatever order they were loaded in.
+ */
+static gchar *
+xmms_medialib_unplayable_stamp (void)
+{
+	guint hash = 0;
+
+	xmms_plugin_foreach (XMMS_PLUGIN_TYPE_XFORM,
+	                     xmms_medialib_unplayable_stamp_foreach, &hash);
+
+	return g_strdup_printf ("%08x", hash);
+}
+
+/**
+ * Check whether the file an url points to is still there. Only local
+ * files can be checked, anything else is assumed to be.
+ */
+static gboolean
+xmms_medialib_unplayable_exists (const gchar *url)
+{
+	gboolean ret = TRUE;
+	gchar *path;
+
+	if (!g_str_has_prefix (url, "file://")) {
+		return TRUE;
+	}
+
+	path = g_strdup (url + 7);
+	if (xmms_medialib_decode_url (path)) {
+		ret = g_file_test (path, G_FILE_TEST_EXISTS);
+	}
+	g_free (path);
+
+	return ret;
+}
+
+static void
+xmms_medialib_unplayable_load (xmms_medialib_unplayable_t *unplayable)
+{
+	gchar *contents, **lines;
+	GError *error = NULL;
+	gint i;
+
+	if (!g_file_get_contents (unplayable->path, &contents, NULL, &error)) {
+		if (!g_error_matches (error, G_FILE_ERROR, G_FILE_ERROR_NOENT)) {
+			xmms_log_error ("Could not read %s: %s", unplayable->path,
+			                error->message);
+		}
+		g_error_free (error);
+		return;
+	}
+
+	lines = g_strsplit (contents, "\n", 0);
+	for (i = 0; lines[i]; i++) {
+		gchar **fields;
+
+		fields = g_strsplit (lines[i], "\t", 4);
+		if (g_strv_length (fields) == 4) {
+			if (xmms_medialib_unplayable_exists (fields[0])) {
+				xmms_medialib_unplayable_insert (unplayable, fields[0], fields[1],
+				                                 fields[2], fields[3]);
+			} else {
+				unplayable->dirty = TRUE;
+			}
+		}
+		g_strfreev (fields);
+	}
+	g_strfreev (lines);
+	g_free (contents);
+
+	XMMS_DBG ("%u files known to be unplayable",
+	          g_hash_table_size (unplayable->records));
+}
+
+/**
+ * Create the records of unplayable files.
+ *
+ * @param path the file the records are loaded from and saved to, or
+ * NULL to keep them in memory only
+ */
+xmms_medialib_unplayable_t *
+xmms_medialib_unplayable_new (const gchar *path)
+{
+	xmms_medialib_unplayable_t *unplayable;
+
+	unplayable = g_new0 (xmms_medialib_unplayable_t, 1);
+	unplayable->path = g_strdup (path);
+	unplayable->records = g_hash_table_new_full (g_str_hash, g_str_equal, g_free,
+	                                             xmms_medialib_unplayable_record_free);
+	g_mutex_init (&unplayable->mutex);
+
+	if (unplayable->path != NULL) {
+		xmms_medialib_unplayable_load (unplayable);
+	}
+
+	return unplayable;
+}
+
+/**
+ * Save the records if they changed, and free them.
+ */
+void
+xmms_medialib_unplayable_free (xmms_medialib_unplayable_t *unplayable)
+{
+	g_return_if_fail (unplayable);
+
+	xmms_medialib_unplayable_save (unplayable);
+
+	g_hash_table_destroy (unplayable->records);
+	g_mutex_clear (&unplayable->mutex);
+	g_free (unplayable->path);
+	g_free (unplayable);
+}
+
+/**
+ * Record that no chain could be set up for a file.
+ *
+ * @param unplayable the records
+ * @param url the encoded url of the file
+ * @param fingerprint the fingerprint of the file when it was read
+ * @param chain the shortnames of the plugins the chain got through
+ */
+void
+xmms_medialib_unplayable_add (xmms_medialib_unplayable_t *unplayable,
+                              const gchar *url, const gchar *fingerprint,
+                              const gchar *chain)
+{
+	gchar *stamp;
+
+	g_return_if_fail (unplayable);
+	g_return_if_fail (url);
+	g_return_if_fail (fingerprint);
+	g_return_if_fail (chain);
+
+	stamp = xmms_medialib_unplayable_stamp ();
+
+	g_mutex_lock (&unplayable->mutex);
+	xmms_medialib_unplayable_insert (unplayable, url, fingerprint, stamp, chain);
+	unplayable->dirty = TRUE;
+	g_mutex_unlock (&unplayable->mutex);
+
+	g_free (stamp);
+}
+
+/**
+ * Forget about a file, once a chain could be set up for it.
+ */
+void
+xmms_medialib_unplayable_remove (xmms_medialib_unplayable_t *unplayable,
+                                 const gchar *url)
+{
+	g_return_if_fail (unplayable);
+	g_return_if_fail (url);
+
+	g_mutex_lock (&unplayable->mutex);
+	if (g_hash_table_remove (unplayable->records, url)) {
+		unplayable->dirty = TRUE;
+	}
+	g_mutex_unlock (&unplayable->mutex);
+}
+
+/**
+ * Check whether there is a record for a file, without checking that it
+ * still matches.
+ */
+gboolean
+xmms_medialib_unplayable_contains (xmms_medialib_unplayable_t *unplayable,
+                                   const gchar *url)
+{
+	gboolean ret;
+
+	g_return_val_if_fail (unplayable, FALSE);
+	g_return_val_if_fail (url, FALSE);
+
+	g_mutex_lock (&unplayable->mutex);
+	ret = g_hash_table_contains (unplayable->records, url);
+	g_mutex_unlock (&unplayable->mutex);
+
+	return ret;
+}
+
+/**
+ * Check whether a file is known to be unplayable with the plugins
+ * loaded now. A record that doesn't match anymore is dropped.
+ *
+ * @param unplayable the records
+ * @param url the encoded url of the file
+ * @param fingerprint the current fingerprint of the file
+ * @return TRUE if neither the file nor the plugins changed since no chain
+ * could be set up for it
+ */
+gboolean
+xmms_medialib_unplayable_lookup (xmms_medialib_unplayable_t *unplayable,
+                                 const gchar *url, const gchar *fingerprint)
+{
+	xmms_medialib_unplayable_record_t *record;
+	gboolean ret = FALSE;
+	gchar *stamp;
+
+	g_return_val_if_fail (unplayable, FALSE);
+	g_return_val_if_fail (url, FALSE);
+	g_return_val_if_fail (fingerprint, FALSE);
+
+	g_mutex_lock (&unplayable->mutex);
+	record = g_hash_table_lookup (unplayable->records, url);
+	if (record != NULL) {
+		stamp = xmms_medialib_unplayable_stamp ();
+		ret = strcmp (record->fingerprint, fingerprint) == 0 &&
+		      strcmp (record->stamp, stamp) == 0;
+		g_free (stamp);
+
+		if (!ret) {
+			g_hash_table_remove (unplayable->records, url);
+			unplayable->dirty = TRUE;
+		}
+	}
+	g_mutex_unlock (&unplayable->mutex);
+
+	return ret;
+}
+
+/**
+ * Write the records to their file if they changed since the last time.
+ *
+ * @return FALSE if the file could not be written
+ */
+gboolean
+xmms_medialib_unplayable_save (xmms_medialib_unplayable_t *unplayable)
+{
+	xmms_medialib_unplayable_record_t *record;
+	GHashTableIter iter;
+	GError *error = NULL;
+	gboolean ret = TRUE;
+	GString *contents;
+	gpointer key, value;
+
+	g_return_val_if_fail (unplayable, FALSE);
+
+	g_mutex_lock (&unplayable->mutex);
+
+	if (unplayable->path == NULL || !unplayable->dirty) {
+		g_mutex_unlock (&unplayable->mutex);
+		return TRUE;
+	}
+
+	contents = g_string_new ("");
+
+	g_hash_table_iter_init (&iter, unplayable->records);
+	while (g_hash_table_iter_next (&iter, &key, &value)) {
+		record = value;
+		g_string_append_printf (contents, "%s\t%s\t%s\t%s\n", (gchar *) key,
+		                        record->fingerprint, record->stamp,
+		                        record->chain);
+	}
+
+	if (g_file_set_contents (unplayable->path, contents->str, contents->len,
+	                         &error)) {
+		unplayable->dirty = FALSE;
+	} else {
+		xmms_log_error ("Could not save %s: %s", unplayable->path,
+		                error->message);
+		g_error_free (error);
+		ret = FALSE;
+	}
+
+	g_mutex_unlock (&unplayable->mutex);
+
+	g_string_free (contents, TRUE);
+
+	return ret;
+}
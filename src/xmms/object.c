@@ -35,19 +35,75 @@
 typedef struct {
 	xmms_object_handler_t handler;
 	gpointer userdata;
+	/* called on the emitting thread, also for deferred emits */
+	gboolean sync;
 } xmms_object_handler_entry_t;
 
-static gboolean
-cleanup_signal_list (gpointer key, gpointer value, gpointer data)
+/** Which handlers an emit calls. */
+typedef enum {
+	XMMS_OBJECT_CALL_ALL,
+	XMMS_OBJECT_CALL_SYNC,
+	XMMS_OBJECT_CALL_DEFERRED
+} xmms_object_call_t;
+
+/**
+ * The handlers connected to one signal. Never changed once published,
+ * connect and disconnect build a new one and retire the old.
+ */
+typedef struct xmms_object_handlers_St {
+	guint len;
+	xmms_object_handler_entry_t entries[];
+} xmms_object_handlers_t;
+
+/** Number of emits per signal id, for all objects. */
+static gint emit_counts[XMMS_IPC_SIGNAL_END];
+
+static xmms_object_handlers_t *
+handlers_new (guint len)
 {
-	GList *list = value;
+	xmms_object_handlers_t *handlers;
+
+	handlers = g_malloc (sizeof (xmms_object_handlers_t) +
+	                     len * sizeof (xmms_object_handler_entry_t));
+	handlers->len = len;
+
+	return handlers;
+}
 
-	while (list) {
-		g_free (list->data);
-		list = g_list_delete_link (list, list);
+/**
+ * Free handler arrays that have been replaced, unless an emit that
+ * started before they were replaced might still be walking them.
+ * Must be called with the object mutex held, after publishing the
+ * replacement.
+ */
+static void
+handlers_collect (xmms_object_t *object)
+{
+	if (g_atomic_int_get (&object->emitting)) {
+		return;
 	}
 
-	return FALSE; /* keep going */
+	g_slist_free_full (object->retired, g_free);
+	object->retired = NULL;
+}
+
+/**
+ * Publish new handlers for a signal, must be called with the object
+ * mutex held.
+ */
+static void
+handlers_replace (xmms_object_t *object, guint32 signalid,
+                  xmms_object_handlers_t *handlers)
+{
+	xmms_object_handlers_t *old = object->handlers[signalid];
+
+	g_atomic_pointer_set (&object->handlers[signalid], handlers);
+
+	if (old) {
+		object->retired = g_slist_prepend (object->retired, old);
+	}
+
+	handlers_collect (object);
 }
 
 /**
@@ -56,43 +112,20 @@ cleanup_signal_list (gpointer key, gpointer value, gpointer data)
 void
 xmms_object_cleanup (xmms_object_t *object)
 {
+	gint i;
+
 	g_return_if_fail (object);
 	g_return_if_fail (XMMS_IS_OBJECT (object));
 
-	if (object->signals) {
-		/* destroy the tree manually (ie not via a value_destroy_func
-		 * callback since we're often "replacing" values when we're
-		 * adding new elements to the signal lists. and we don't want
-		 * the value to be destroyed in those cases :)
-		 */
-		g_tree_foreach (object->signals, cleanup_signal_list, NULL);
-		g_tree_destroy (object->signals);
+	for (i = 0; i < XMMS_IPC_SIGNAL_END; i++) {
+		g_free (object->handlers[i]);
 	}
 
-	if (object->cmds) {
-		/* We don't need to free the commands themselves -- they are
-		 * stored in read-only memory.
-		 */
-		g_tree_destroy (object->cmds);
-	}
+	g_slist_free_full (object->retired, g_free);
 
 	g_mutex_clear (&object->mutex);
 }
 
-static gint
-compare_signal_key (gconstpointer a, gconstpointer b)
-{
-	gint aa = GPOINTER_TO_INT (a);
-	gint bb = GPOINTER_TO_INT (b);
-
-	if (aa < bb)
-		return -1;
-	else if (aa > bb)
-		return 1;
-	else
-		return 0;
-}
-
 /**
   * Connect to a signal that is emitted by this object.
   * You can connect many handlers to the same signal as long as
@@ -106,31 +139,60 @@ compare_signal_key (gconstpointer a, gconstpointer b)
   * @param userdata data to the callback function
   */
 
-void
-xmms_object_connect (xmms_object_t *object, guint32 signalid,
-                     xmms_object_handler_t handler, gpointer userdata)
+static void
+connect_handler (xmms_object_t *object, guint32 signalid,
+                 xmms_object_handler_t handler, gpointer userdata,
+                 gboolean sync)
 {
-	GList *list = NULL;
-	xmms_object_handler_entry_t *entry;
+	xmms_object_handlers_t *old, *handlers;
+	guint len;
 
 	g_return_if_fail (object);
 	g_return_if_fail (XMMS_IS_OBJECT (object));
 	g_return_if_fail (handler);
+	g_return_if_fail (signalid < XMMS_IPC_SIGNAL_END);
+
+	g_mutex_lock (&object->mutex);
 
-	entry = g_new0 (xmms_object_handler_entry_t, 1);
-	entry->handler = handler;
-	entry->userdata = userdata;
+	old = object->handlers[signalid];
+	len = old ? old->len : 0;
 
-	if (!object->signals)
-		object->signals = g_tree_new (compare_signal_key);
-	else
-		list = g_tree_lookup (object->signals,
-		                      GINT_TO_POINTER (signalid));
+	/* handlers are called in the order they were connected */
+	handlers = handlers_new (len + 1);
+	if (len) {
+		memcpy (handlers->entries, old->entries,
+		        len * sizeof (xmms_object_handler_entry_t));
+	}
+	handlers->entries[len].handler = handler;
+	handlers->entries[len].userdata = userdata;
+	handlers->entries[len].sync = sync;
+
+	handlers_replace (object, signalid, handlers);
+
+	g_mutex_unlock (&object->mutex);
+}
+
+void
+xmms_object_connect (xmms_object_t *object, guint32 signalid,
+                     xmms_object_handler_t handler, gpointer userdata)
+{
+	connect_handler (object, signalid, handler, userdata, FALSE);
+}
 
-	list = g_list_prepend (list, entry);
+/**
+  * Connect to a signal, and have the handler called on the thread
+  * emitting the signal even when it is emitted with
+  * #xmms_object_emit_async. For handlers that must see the signal at
+  * the exact point it is raised, and are cheap enough to run there.
+  *
+  * Disconnect with #xmms_object_disconnect.
+  */
 
-	/* store the list's new head in the tree */
-	g_tree_insert (object->signals, GINT_TO_POINTER (signalid), list);
+void
+xmms_object_connect_sync (xmms_object_t *object, guint32 signalid,
+                          xmms_object_handler_t handler, gpointer userdata)
+{
+	connect_handler (object, signalid, handler, userdata, TRUE);
 }
 
 /**
@@ -141,86 +203,376 @@ void
 xmms_object_disconnect (xmms_object_t *object, guint32 signalid,
                         xmms_object_handler_t handler, gpointer userdata)
 {
-	GList *list, *node = NULL;
-	xmms_object_handler_entry_t *entry;
+	xmms_object_handlers_t *old, *handlers = NULL;
+	gboolean found = FALSE;
+	guint i;
 
 	g_return_if_fail (object);
 	g_return_if_fail (XMMS_IS_OBJECT (object));
 	g_return_if_fail (handler);
+	g_return_if_fail (signalid < XMMS_IPC_SIGNAL_END);
 
 	g_mutex_lock (&object->mutex);
 
-	if (object->signals) {
-		list = g_tree_lookup (object->signals,
-		                      GINT_TO_POINTER (signalid));
-
-		for (node = list; node; node = g_list_next (node)) {
-			entry = node->data;
+	old = object->handlers[signalid];
 
-			if (entry->handler == handler && entry->userdata == userdata)
-				break;
+	for (i = 0; old && i < old->len; i++) {
+		if (old->entries[i].handler == handler &&
+		    old->entries[i].userdata == userdata) {
+			found = TRUE;
+			break;
 		}
+	}
 
-		if (node) {
-			list = g_list_remove_link (list, node);
-
-			/* store the list's new head in the tree */
-			g_tree_insert (object->signals,
-			               GINT_TO_POINTER (signalid), list);
+	if (found) {
+		if (old->len > 1) {
+			handlers = handlers_new (old->len - 1);
+			memcpy (handlers->entries, old->entries,
+			        i * sizeof (xmms_object_handler_entry_t));
+			memcpy (handlers->entries + i, old->entries + i + 1,
+			        (old->len - i - 1) * sizeof (xmms_object_handler_entry_t));
 		}
+
+		handlers_replace (object, signalid, handlers);
 	}
 
 	g_mutex_unlock (&object->mutex);
 
-	g_return_if_fail (node);
-
-	g_free (node->data);
-	g_list_free_1 (node);
+	g_return_if_fail (found);
 }
 
 /**
   * Emit a signal and thus call all the handlers that are connected.
   *
+  * The handlers are read without taking the object mutex. Handlers
+  * connected or disconnected while the signal is emitted take effect
+  * from the next emit.
+  *
   * @param object the object to signal on.
   * @param signalid the signalid to emit
   * @param data the data that should be sent to the handler.
   */
 
+static void
+handlers_call (xmms_object_t *object, guint32 signalid, xmmsv_t *data,
+               xmms_object_call_t which)
+{
+	xmms_object_handlers_t *handlers;
+	guint i;
+
+	/* keeps whatever handlers we load alive until we are done */
+	g_atomic_int_inc (&object->emitting);
+
+	handlers = g_atomic_pointer_get (&object->handlers[signalid]);
+
+	for (i = 0; handlers && i < handlers->len; i++) {
+		xmms_object_handler_entry_t *entry = &handlers->entries[i];
+
+		if (which == XMMS_OBJECT_CALL_SYNC && !entry->sync) {
+			continue;
+		}
+		if (which == XMMS_OBJECT_CALL_DEFERRED && entry->sync) {
+			continue;
+		}
+
+		entry->handler (object, data, entry->userdata);
+	}
+
+	g_atomic_int_add (&object->emitting, -1);
+}
+
 void
 xmms_object_emit (xmms_object_t *object, guint32 signalid, xmmsv_t *data)
 {
-	GList *list, *node, *list2 = NULL;
-	xmms_object_handler_entry_t *entry;
-
 	g_return_if_fail (object);
 	g_return_if_fail (XMMS_IS_OBJECT (object));
+	g_return_if_fail (signalid < XMMS_IPC_SIGNAL_END);
 
-	g_mutex_lock (&object->mutex);
+	g_atomic_int_inc (&emit_counts[signalid]);
+
+	handlers_call (object, signalid, data, XMMS_OBJECT_CALL_ALL);
+
+	xmmsv_unref (data);
+}
+
+/**
+ * Get the number of times each signal has been emitted.
+ *
+ * @return A list of integers, indexed by signal id.
+ */
+xmmsv_t *
+xmms_object_emit_stats (void)
+{
+	xmmsv_t *list;
+	gint i;
 
-	if (object->signals) {
-		list = g_tree_lookup (object->signals,
-		                      GINT_TO_POINTER (signalid));
+	list = xmmsv_new_list ();
+	for (i = 0; i < XMMS_IPC_SIGNAL_END; i++) {
+		xmmsv_list_append_int (list, g_atomic_int_get (&emit_counts[i]));
+	}
 
-		for (node = list; node; node = g_list_next (node)) {
-			entry = node->data;
+	return list;
+}
 
-			list2 = g_list_prepend (list2, entry);
+/*
+ * Deferred emits. Threads that must not block, like the output writer,
+ * put signals on a bounded queue and the dispatch thread emits them.
+ * Producers claim slots with a compare and exchange, so the queue can
+ * take events from several threads without a lock. The mutex only puts
+ * the dispatch thread to sleep and is taken by a producer when it finds
+ * the dispatch thread asleep.
+ */
+
+#define XMMS_OBJECT_DISPATCH_QUEUE_SIZE 256
+
+/* positions count up and wrap, a slot's seq says which position may use it next */
+typedef struct {
+	guint seq;
+	xmms_object_t *object;
+	guint32 signalid;
+	xmmsv_t *data;
+} xmms_object_event_t;
+
+static xmms_object_event_t dispatch_queue[XMMS_OBJECT_DISPATCH_QUEUE_SIZE];
+static guint dispatch_head;
+static guint dispatch_tail;
+
+static GThread *dispatch_thread;
+static gint dispatch_running;
+static gint dispatch_producers;
+static gint dispatch_sleeping;
+static GMutex dispatch_mutex;
+static GCond dispatch_cond;
+
+/** Emits that found the queue full and had to wait for a slot. */
+static gint dispatch_overflows;
+
+static gboolean
+dispatch_push (xmms_object_t *object, guint32 signalid, xmmsv_t *data)
+{
+	xmms_object_event_t *event;
+	guint pos, seq;
+
+	pos = g_atomic_int_get (&dispatch_head);
+
+	for (;;) {
+		event = &dispatch_queue[pos % XMMS_OBJECT_DISPATCH_QUEUE_SIZE];
+		seq = g_atomic_int_get (&event->seq);
+
+		if (seq == pos) {
+			if (g_atomic_int_compare_and_exchange (&dispatch_head, pos, pos + 1)) {
+				break;
+			}
+		} else if ((gint) (seq - pos) < 0) {
+			/* the dispatch thread has not emptied this slot yet */
+			return FALSE;
 		}
+
+		pos = g_atomic_int_get (&dispatch_head);
 	}
 
-	g_mutex_unlock (&object->mutex);
+	event->object = object;
+	event->signalid = signalid;
+	event->data = data;
+	g_atomic_int_set (&event->seq, pos + 1);
+
+	return TRUE;
+}
 
-	while (list2) {
-		entry = list2->data;
+static gboolean
+dispatch_pending (void)
+{
+	xmms_object_event_t *event;
 
-		/* NULL entries may never be added to the trees. */
-		g_assert (entry);
-		g_assert (entry->handler);
+	event = &dispatch_queue[dispatch_tail % XMMS_OBJECT_DISPATCH_QUEUE_SIZE];
 
-		entry->handler (object, data, entry->userdata);
+	return g_atomic_int_get (&event->seq) == dispatch_tail + 1;
+}
+
+static void
+dispatch_emit (xmms_object_event_t *event)
+{
+	handlers_call (event->object, event->signalid, event->data,
+	               XMMS_OBJECT_CALL_DEFERRED);
+
+	xmmsv_unref (event->data);
+	xmms_object_unref (event->object);
+}
+
+/* only called from the dispatch thread, with an event pending */
+static void
+dispatch_next (void)
+{
+	xmms_object_event_t *event, copy;
+
+	event = &dispatch_queue[dispatch_tail % XMMS_OBJECT_DISPATCH_QUEUE_SIZE];
+	copy = *event;
+
+	/* hand the slot back before emitting */
+	g_atomic_int_set (&event->seq, dispatch_tail + XMMS_OBJECT_DISPATCH_QUEUE_SIZE);
+	dispatch_tail++;
+
+	dispatch_emit (&copy);
+}
 
-		list2 = g_list_delete_link (list2, list2);
+static gpointer
+dispatch_loop (gpointer data)
+{
+	gboolean running = TRUE;
+
+	while (running) {
+		while (dispatch_pending ()) {
+			dispatch_next ();
+		}
+
+		g_mutex_lock (&dispatch_mutex);
+		g_atomic_int_set (&dispatch_sleeping, TRUE);
+
+		/* an event may have been queued before we said we are sleeping */
+		if (!dispatch_pending ()) {
+			if (g_atomic_int_get (&dispatch_running)) {
+				g_cond_wait (&dispatch_cond, &dispatch_mutex);
+			} else {
+				/* stopping, but a producer may not have queued yet */
+				running = g_atomic_int_get (&dispatch_producers) > 0;
+			}
+		}
+
+		g_atomic_int_set (&dispatch_sleeping, FALSE);
+		g_mutex_unlock (&dispatch_mutex);
+	}
+
+	return NULL;
+}
+
+static void
+dispatch_wakeup (void)
+{
+	if (g_atomic_int_get (&dispatch_sleeping)) {
+		g_mutex_lock (&dispatch_mutex);
+		g_cond_signal (&dispatch_cond);
+		g_mutex_unlock (&dispatch_mutex);
 	}
+}
+
+/**
+ * Start the thread that emits signals queued by #xmms_object_emit_async.
+ */
+void
+xmms_object_dispatch_start (void)
+{
+	gint i;
+
+	g_return_if_fail (!dispatch_thread);
+
+	for (i = 0; i < XMMS_OBJECT_DISPATCH_QUEUE_SIZE; i++) {
+		dispatch_queue[i].seq = i;
+	}
+	dispatch_head = 0;
+	dispatch_tail = 0;
+
+	g_mutex_init (&dispatch_mutex);
+	g_cond_init (&dispatch_cond);
+
+	g_atomic_int_set (&dispatch_running, TRUE);
+	dispatch_thread = g_thread_new ("x2 dispatch", dispatch_loop, NULL);
+}
+
+/**
+ * Emit everything still queued and stop the dispatch thread. Signals
+ * emitted with #xmms_object_emit_async afterwards are emitted directly.
+ */
+void
+xmms_object_dispatch_stop (void)
+{
+	if (!dispatch_thread) {
+		return;
+	}
+
+	g_atomic_int_set (&dispatch_running, FALSE);
+
+	/* wait for producers that saw the thread running to finish queueing */
+	while (g_atomic_int_get (&dispatch_producers)) {
+		g_thread_yield ();
+	}
+
+	g_mutex_lock (&dispatch_mutex);
+	g_cond_signal (&dispatch_cond);
+	g_mutex_unlock (&dispatch_mutex);
+
+	g_thread_join (dispatch_thread);
+	dispatch_thread = NULL;
+
+	g_cond_clear (&dispatch_cond);
+	g_mutex_clear (&dispatch_mutex);
+}
+
+/**
+  * Emit a signal from the dispatch thread instead of the calling one.
+  * Handlers connected with #xmms_object_connect_sync are still called
+  * before this returns.
+  *
+  * Meant for threads that must not wait for the handlers, which may
+  * serialize the value for every client and take the IPC locks. Signals
+  * queued from the same thread are emitted in order. If the dispatch
+  * thread has fallen too far behind, this waits for it to free a slot.
+  * If it is not running, the signal is emitted directly.
+  *
+  * The data is frozen, handlers that keep a reference to it may share
+  * it with the dispatch thread.
+  *
+  * @param object the object to signal on, kept alive until emitted.
+  * @param signalid the signalid to emit
+  * @param data the data that should be sent to the handler.
+  */
+
+void
+xmms_object_emit_async (xmms_object_t *object, guint32 signalid, xmmsv_t *data)
+{
+	g_return_if_fail (object);
+	g_return_if_fail (XMMS_IS_OBJECT (object));
+	g_return_if_fail (signalid < XMMS_IPC_SIGNAL_END);
+
+	g_atomic_int_inc (&emit_counts[signalid]);
+
+	if (data) {
+		xmmsv_freeze (data);
+	}
+
+	handlers_call (object, signalid, data, XMMS_OBJECT_CALL_SYNC);
+
+	g_atomic_int_inc (&dispatch_producers);
+
+	if (g_atomic_int_get (&dispatch_running)) {
+		xmms_object_ref (object);
+
+		/* emitting directly would overtake what is still queued */
+		if (!dispatch_push (object, signalid, data)) {
+			if (g_atomic_int_add (&dispatch_overflows, 1) == 0) {
+				xmms_log_info ("Signal queue full, waiting for the dispatch thread");
+			}
+
+			do {
+				if (g_thread_self () == dispatch_thread) {
+					/* a handler emitting, nobody else will make room */
+					if (dispatch_pending ()) {
+						dispatch_next ();
+					}
+				} else {
+					dispatch_wakeup ();
+					g_thread_yield ();
+				}
+			} while (!dispatch_push (object, signalid, data));
+		}
+
+		dispatch_wakeup ();
+		g_atomic_int_add (&dispatch_producers, -1);
+		return;
+	}
+
+	g_atomic_int_add (&dispatch_producers, -1);
+
+	handlers_call (object, signalid, data, XMMS_OBJECT_CALL_DEFERRED);
 
 	xmmsv_unref (data);
 }
@@ -238,39 +590,25 @@ xmms_object_cmd_arg_init (xmms_object_cmd_arg_t *arg)
 	xmms_error_reset (&arg->error);
 }
 
-static gint
-compare_cmd_key (gconstpointer a, gconstpointer b)
-{
-	guint aa = GPOINTER_TO_INT (a);
-	guint bb = GPOINTER_TO_INT (b);
-
-	if (aa < bb)
-		return -1;
-	else if (aa > bb)
-		return 1;
-	else
-		return 0;
-}
-
 /**
-  * Add a command that could be called from the client API to a object.
+  * Set the commands that could be called from the client API on a object.
   *
-  * @param object The object that should have the method.
-  * @param cmdid A command id.
-  * @param desc A command description.
+  * @param object The object that should have the methods.
+  * @param first The command id of the first entry in cmds.
+  * @param cmds The command functions, indexed by command id minus first.
+  * It is not copied and must stay valid for the lifetime of the object.
+  * @param len The number of entries in cmds.
   */
 void
-xmms_object_cmd_add (xmms_object_t *object, guint cmdid,
-                     const xmms_object_cmd_func_t func)
+xmms_object_cmds_set (xmms_object_t *object, guint first,
+                      const xmms_object_cmd_func_t *cmds, guint len)
 {
 	g_return_if_fail (object);
-	g_return_if_fail (func);
-
-	if (!object->cmds)
-		object->cmds = g_tree_new (compare_cmd_key);
+	g_return_if_fail (cmds || !len);
 
-	g_tree_insert (object->cmds, GUINT_TO_POINTER (cmdid),
-	               (gpointer) func);
+	object->cmds = cmds;
+	object->cmds_first = first;
+	object->cmds_len = len;
 }
 
 /**
@@ -284,12 +622,9 @@ xmms_object_cmd_call (xmms_object_t *object, guint cmdid, xmms_object_cmd_arg_t
 
 	g_return_if_fail (object);
 
-	if (object->cmds) {
-		func = g_tree_lookup (object->cmds, GUINT_TO_POINTER (cmdid));
-
-		if (func)
-			func (object, arg);
-	}
+	func = xmms_object_cmd_get (object, cmdid);
+	if (func)
+		func (object, arg);
 }
 
 xmmsv_t *
@@ -349,11 +684,6 @@ __int_xmms_object_new (gint size, xmms_object_destroy_func_t destfunc)
 
 	g_mutex_init (&ret->mutex);
 
-	/* don't create the trees for the signals and the commands yet.
-	 * instead we instantiate those when we need them the first
-	 * time.
-	 */
-
 	xmms_object_ref (ret);
 
 	return ret;
@@ -46,6 +46,8 @@ typedef struct xmms_volume_map_St {
 
 static gboolean xmms_output_format_set (xmms_output_t *output, xmms_stream_type_t *fmt);
 static gpointer xmms_output_monitor_volume_thread (gpointer data);
+static void xmms_output_monitor_volume_start (xmms_output_t *output);
+static void xmms_output_monitor_volume_stop (xmms_output_t *output);
 
 static void xmms_playback_client_start (xmms_output_t *output, xmms_error_t *err);
 static void xmms_playback_client_stop (xmms_output_t *output, xmms_error_t *err);
@@ -71,8 +73,7 @@ static void xmms_output_filler_state (xmms_output_t *output, xmms_output_filler_
 static void xmms_output_filler_state_nolock (xmms_output_t *output, xmms_output_filler_state_t state);
 
 static void xmms_volume_map_init (xmms_volume_map_t *vl);
-static void xmms_volume_map_free (xmms_volume_map_t *vl);
-static void xmms_volume_map_copy (xmms_volume_map_t *src, xmms_volume_map_t *dst);
+static void xmms_output_volume_read (xmms_output_t *output, xmms_volume_map_t *vl);
 static xmmsv_t *xmms_volume_map_to_dict (xmms_volume_map_t *vl);
 static gboolean xmms_output_status_set (xmms_output_t *output, gint status);
 static gboolean set_plugin (xmms_output_t *output, xmms_output_plugin_t *plugin);
@@ -151,6 +152,13 @@ struct xmms_output_St {
 
 	GThread *monitor_volume_thread;
 	gboolean monitor_volume_running;
+	/* protects the two above and wakes the monitor */
+	GMutex monitor_volume_mutex;
+	GCond monitor_volume_cond;
+	gboolean volume_changed;
+
+	/** Longest time the writer thread spent emitting a signal, in us */
+	gint64 emit_time_max;
 };
 
 /** @} */
@@ -218,6 +226,26 @@ xmms_output_format_list_clear(xmms_output_t *output)
 	output->format_list = NULL;
 }
 
+/**
+ * Emit a signal from the thread writing to the output plugin. Handlers
+ * run on the dispatch thread, this only queues the signal.
+ */
+static void
+xmms_output_emit (xmms_output_t *output, guint32 signalid, xmmsv_t *data)
+{
+	gint64 start, elapsed;
+
+	start = g_get_monotonic_time ();
+	xmms_object_emit_async (XMMS_OBJECT (output), signalid, data);
+	elapsed = g_get_monotonic_time () - start;
+
+	if (elapsed > output->emit_time_max) {
+		output->emit_time_max = elapsed;
+		XMMS_DBG ("Longest signal emit on the output thread so far: %"
+		          G_GINT64_FORMAT " us", elapsed);
+	}
+}
+
 static void
 update_playtime (xmms_output_t *output, int advance)
 {
@@ -239,8 +267,7 @@ update_playtime (xmms_output_t *output, int advance)
 		guint ms = xmms_sample_bytes_to_ms (output->format,
 		                                    output->played - buffersize);
 		if ((ms / 100) != (output->played_time / 100)) {
-			xmms_object_emit (XMMS_OBJECT (output),
-			                  XMMS_IPC_SIGNAL_PLAYBACK_PLAYTIME,
+			xmms_output_emit (output, XMMS_IPC_SIGNAL_PLAYBACK_PLAYTIME,
 			                  xmmsv_new_int (ms));
 		}
 		output->played_time = ms;
@@ -265,6 +292,17 @@ xmms_output_set_error (xmms_output_t *output, xmms_error_t *error)
 	}
 }
 
+void
+xmms_output_volume_changed (xmms_output_t *output)
+{
+	g_return_if_fail (output);
+
+	g_mutex_lock (&output->monitor_volume_mutex);
+	output->volume_changed = TRUE;
+	g_cond_signal (&output->monitor_volume_cond);
+	g_mutex_unlock (&output->monitor_volume_mutex);
+}
+
 typedef struct {
 	xmms_output_t *output;
 	xmms_xform_t *chain;
@@ -314,8 +352,7 @@ song_changed (void *data)
 	if (arg->flush)
 		xmms_output_flush (arg->output);
 
-	xmms_object_emit (XMMS_OBJECT (arg->output),
-	                  XMMS_IPC_SIGNAL_PLAYBACK_CURRENTID,
+	xmms_output_emit (arg->output, XMMS_IPC_SIGNAL_PLAYBACK_CURRENTID,
 	                  xmmsv_new_int (entry));
 
 	return TRUE;
@@ -713,12 +750,18 @@ xmms_playback_client_volume_set (xmms_output_t *output, const gchar *channel,
 	if (!xmms_output_plugin_methods_volume_set (output->plugin, output, channel, volume)) {
 		xmms_error_set (error, XMMS_ERROR_GENERIC,
 		                "couldn't set volume");
+		return;
 	}
+
+	/* don't make the clients wait for the next poll */
+	xmms_output_volume_changed (output);
 }
 
 static xmmsv_t *
 xmms_playback_client_volume_get (xmms_output_t *output, xmms_error_t *error)
 {
+	const gchar *names[VOLUME_MAX_CHANNELS];
+	guint values[VOLUME_MAX_CHANNELS];
 	xmmsv_t *ret;
 	xmms_volume_map_t map;
 
@@ -734,37 +777,19 @@ xmms_playback_client_volume_get (xmms_output_t *output, xmms_error_t *error)
 		return NULL;
 	}
 
-	xmms_error_set (error, XMMS_ERROR_GENERIC,
-	                "couldn't get volume");
-
 	xmms_volume_map_init (&map);
+	map.names = names;
+	map.values = values;
 
-	/* ask the plugin how much channels it would like to set */
-	if (!xmms_output_plugin_method_volume_get (output->plugin, output,
-	                                           NULL, NULL, &map.num_channels)) {
+	xmms_output_volume_read (output, &map);
+	if (!map.status) {
+		xmms_error_set (error, XMMS_ERROR_GENERIC,
+		                "couldn't get volume");
 		return NULL;
 	}
 
-	/* check for sane values */
-	g_return_val_if_fail (map.num_channels > 0, NULL);
-	g_return_val_if_fail (map.num_channels <= VOLUME_MAX_CHANNELS, NULL);
-
-	map.names = g_new (const gchar *, map.num_channels);
-	map.values = g_new (guint, map.num_channels);
-
-	map.status = xmms_output_plugin_method_volume_get (output->plugin, output,
-	                                                   map.names, map.values,
-	                                                   &map.num_channels);
-
-	if (!map.status || !map.num_channels) {
-		return NULL; /* error is set (-> no leak) */
-	}
-
 	ret = xmms_volume_map_to_dict (&map);
 
-	/* success! */
-	xmms_error_reset (error);
-
 	return ret;
 }
 
@@ -858,11 +883,7 @@ xmms_output_destroy (xmms_object_t *object)
 
 	XMMS_DBG ("Deactivating output object.");
 
-	output->monitor_volume_running = FALSE;
-	if (output->monitor_volume_thread) {
-		g_thread_join (output->monitor_volume_thread);
-		output->monitor_volume_thread = NULL;
-	}
+	xmms_output_monitor_volume_stop (output);
 
 	xmms_output_filler_state (output, FILLER_QUIT);
 	g_thread_join (output->filler_thread);
@@ -880,6 +901,8 @@ xmms_output_destroy (xmms_object_t *object)
 	g_mutex_clear (&output->playtime_mutex);
 	g_mutex_clear (&output->filler_mutex);
 	g_cond_clear (&output->filler_state_cond);
+	g_mutex_clear (&output->monitor_volume_mutex);
+	g_cond_clear (&output->monitor_volume_cond);
 	xmms_ringbuf_destroy (output->filler_buffer);
 
 	xmms_playback_unregister_ipc_commands ();
@@ -949,6 +972,8 @@ xmms_output_new (xmms_output_plugin_t *plugin, xmms_playlist_t *playlist, xmms_m
 
 	g_mutex_init (&output->status_mutex);
 	g_mutex_init (&output->playtime_mutex);
+	g_mutex_init (&output->monitor_volume_mutex);
+	g_cond_init (&output->monitor_volume_cond);
 
 	prop = xmms_config_property_register ("output.buffersize", "32768", NULL, NULL);
 	size = xmms_config_property_get_int (prop);
@@ -1040,11 +1065,7 @@ set_plugin (xmms_output_t *output, xmms_output_plugin_t *plugin)
 	g_assert (output);
 	g_assert (plugin);
 
-	output->monitor_volume_running = FALSE;
-	if (output->monitor_volume_thread) {
-		g_thread_join (output->monitor_volume_thread);
-		output->monitor_volume_thread = NULL;
-	}
+	xmms_output_monitor_volume_stop (output);
 
 	if (output->plugin) {
 		xmms_output_plugin_method_destroy (output->plugin, output);
@@ -1060,11 +1081,8 @@ set_plugin (xmms_output_t *output, xmms_output_plugin_t *plugin)
 
 	if (!ret) {
 		output->plugin = NULL;
-	} else if (!output->monitor_volume_thread) {
-		output->monitor_volume_running = TRUE;
-		output->monitor_volume_thread = g_thread_new ("x2 volume mon",
-		                                              xmms_output_monitor_volume_thread,
-		                                              output);
+	} else {
+		xmms_output_monitor_volume_start (output);
 	}
 
 	return ret;
@@ -1118,103 +1136,127 @@ xmms_volume_map_init (xmms_volume_map_t *vl)
 	vl->values = NULL;
 }
 
-static void
-xmms_volume_map_free (xmms_volume_map_t *vl)
+static xmmsv_t *
+xmms_volume_map_to_dict (xmms_volume_map_t *vl)
 {
-	g_free (vl->names);
-	g_free (vl->values);
+	xmmsv_t *ret;
+	gint i;
+
+	ret = xmmsv_new_dict ();
+
+	for (i = 0; i < vl->num_channels; i++) {
+		xmmsv_dict_set_int (ret, vl->names[i], vl->values[i]);
+	}
 
-	/* don't free vl here, its always allocated on the stack */
+	return ret;
 }
 
 static void
-xmms_volume_map_copy (xmms_volume_map_t *src, xmms_volume_map_t *dst)
+xmms_output_monitor_volume_start (xmms_output_t *output)
 {
-	dst->num_channels = src->num_channels;
-	dst->status = src->status;
-
-	if (!src->status) {
-		g_free (dst->names);
-		dst->names = NULL;
-
-		g_free (dst->values);
-		dst->values = NULL;
-
+	if (output->monitor_volume_thread) {
 		return;
 	}
 
-	dst->names = g_renew (const gchar *, dst->names, src->num_channels);
-	dst->values = g_renew (guint, dst->values, src->num_channels);
-
-	memcpy (dst->names, src->names, src->num_channels * sizeof (gchar *));
-	memcpy (dst->values, src->values, src->num_channels * sizeof (guint));
+	output->monitor_volume_running = TRUE;
+	output->monitor_volume_thread = g_thread_new ("x2 volume mon",
+	                                              xmms_output_monitor_volume_thread,
+	                                              output);
 }
 
-static xmmsv_t *
-xmms_volume_map_to_dict (xmms_volume_map_t *vl)
+static void
+xmms_output_monitor_volume_stop (xmms_output_t *output)
 {
-	xmmsv_t *ret;
-	gint i;
+	g_mutex_lock (&output->monitor_volume_mutex);
+	output->monitor_volume_running = FALSE;
+	g_cond_signal (&output->monitor_volume_cond);
+	g_mutex_unlock (&output->monitor_volume_mutex);
 
-	ret = xmmsv_new_dict ();
+	if (output->monitor_volume_thread) {
+		g_thread_join (output->monitor_volume_thread);
+		output->monitor_volume_thread = NULL;
+	}
+}
 
-	for (i = 0; i < vl->num_channels; i++) {
-		xmmsv_dict_set_int (ret, vl->names[i], vl->values[i]);
+/**
+ * Read the current volume into vl, which has room for
+ * VOLUME_MAX_CHANNELS channels.
+ */
+static void
+xmms_output_volume_read (xmms_output_t *output, xmms_volume_map_t *vl)
+{
+	vl->num_channels = 0;
+	vl->status = xmms_output_plugin_method_volume_get (output->plugin,
+	                                                   output, NULL, NULL,
+	                                                   &vl->num_channels);
+
+	/* check for sane values */
+	if (vl->status && (vl->num_channels < 1 ||
+	                   vl->num_channels > VOLUME_MAX_CHANNELS)) {
+		vl->status = FALSE;
 	}
 
-	return ret;
+	if (vl->status) {
+		vl->status = xmms_output_plugin_method_volume_get (output->plugin,
+		                                                   output, vl->names,
+		                                                   vl->values,
+		                                                   &vl->num_channels);
+	}
 }
 
+/**
+ * Broadcast volume changes. Plugins that implement volume_monitor wake
+ * this thread when something changed, for the others the volume is
+ * polled once a second. Nothing is allocated unless the volume changed.
+ */
 static gpointer
 xmms_output_monitor_volume_thread (gpointer data)
 {
 	xmms_output_t *output = data;
-	xmms_volume_map_t old, cur;
+	const gchar *names[2][VOLUME_MAX_CHANNELS];
+	guint values[2][VOLUME_MAX_CHANNELS];
+	xmms_volume_map_t maps[2], *old, *cur, *tmp;
+	gboolean notified;
 
 	if (!xmms_output_plugin_method_volume_get_available (output->plugin)) {
 		return NULL;
 	}
 
-	xmms_volume_map_init (&old);
-	xmms_volume_map_init (&cur);
+	xmms_volume_map_init (&maps[0]);
+	maps[0].names = names[0];
+	maps[0].values = values[0];
+
+	xmms_volume_map_init (&maps[1]);
+	maps[1].names = names[1];
+	maps[1].values = values[1];
+
+	old = &maps[0];
+	cur = &maps[1];
+
+	notified = xmms_output_plugin_method_volume_monitor (output->plugin,
+	                                                     output);
+	XMMS_DBG ("%s volume changes",
+	          notified ? "Waiting for notifications of" : "Polling for");
+
+	g_mutex_lock (&output->monitor_volume_mutex);
 
 	while (output->monitor_volume_running) {
-		cur.num_channels = 0;
-		cur.status = xmms_output_plugin_method_volume_get (output->plugin,
-		                                                   output, NULL, NULL,
-		                                                   &cur.num_channels);
-
-		if (cur.status) {
-			/* check for sane values */
-			if (cur.num_channels < 1 ||
-			    cur.num_channels > VOLUME_MAX_CHANNELS) {
-				cur.status = FALSE;
-			} else {
-				cur.names = g_renew (const gchar *, cur.names,
-				                     cur.num_channels);
-				cur.values = g_renew (guint, cur.values, cur.num_channels);
-			}
-		}
+		output->volume_changed = FALSE;
+		g_mutex_unlock (&output->monitor_volume_mutex);
 
-		if (cur.status) {
-			cur.status =
-				xmms_output_plugin_method_volume_get (output->plugin,
-				                                      output, cur.names,
-				                                      cur.values,
-				                                      &cur.num_channels);
-		}
+		xmms_output_volume_read (output, cur);
 
 		/* we failed at getting volume for one of the two maps or
 		 * we succeeded both times and they differ -> changed
 		 */
-		if ((cur.status ^ old.status) ||
-		    (cur.status && old.status &&
-		     !xmms_volume_map_equal (&old, &cur))) {
+		if ((cur->status ^ old->status) ||
+		    (cur->status && old->status &&
+		     !xmms_volume_map_equal (old, cur))) {
 			/* emit the broadcast */
-			if (cur.status) {
+			if (cur->status) {
 				xmms_object_emit (XMMS_OBJECT (output),
 				                  XMMS_IPC_SIGNAL_PLAYBACK_VOLUME_CHANGED,
-				                  xmms_volume_map_to_dict (&cur));
+				                  xmms_volume_map_to_dict (cur));
 			} else {
 				/** @todo When bug 691 is solved, emit an error here */
 				xmms_object_emit (XMMS_OBJECT (output),
@@ -1223,13 +1265,30 @@ xmms_output_monitor_volume_thread (gpointer data)
 			}
 		}
 
-		xmms_volume_map_copy (&cur, &old);
+		tmp = old;
+		old = cur;
+		cur = tmp;
+
+		g_mutex_lock (&output->monitor_volume_mutex);
 
-		g_usleep (G_USEC_PER_SEC);
+		if (notified) {
+			while (output->monitor_volume_running && !output->volume_changed) {
+				g_cond_wait (&output->monitor_volume_cond,
+				             &output->monitor_volume_mutex);
+			}
+		} else {
+			gint64 end = g_get_monotonic_time () + G_USEC_PER_SEC;
+
+			while (output->monitor_volume_running && !output->volume_changed) {
+				if (!g_cond_wait_until (&output->monitor_volume_cond,
+				                        &output->monitor_volume_mutex, end)) {
+					break;
+				}
+			}
+		}
 	}
 
-	xmms_volume_map_free (&old);
-	xmms_volume_map_free (&cur);
+	g_mutex_unlock (&output->monitor_volume_mutex);
 
 	return NULL;
 }
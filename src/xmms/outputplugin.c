@@ -347,6 +347,23 @@ xmms_output_plugin_method_volume_get (xmms_output_plugin_t *plugin,
 }
 
 
+gboolean
+xmms_output_plugin_method_volume_monitor (xmms_output_plugin_t *plugin,
+                                          xmms_output_t *output)
+{
+	gboolean res = FALSE;
+
+	g_return_val_if_fail (output, FALSE);
+	g_return_val_if_fail (plugin, FALSE);
+
+	if (plugin->methods.volume_monitor) {
+		res = plugin->methods.volume_monitor (output);
+	}
+
+	return res;
+}
+
+
 /* Used when we have to drive the output... */
 
 static gboolean
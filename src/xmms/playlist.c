@@ -38,6 +38,9 @@
 static void xmms_playlist_destroy (xmms_object_t *object);
 static void xmms_playlist_client_replace (xmms_playlist_t *playlist, const gchar *plname, xmmsv_t *coll, xmms_playlist_position_action_t action, xmms_error_t *err);
 static xmmsv_t * xmms_playlist_client_list_entries (xmms_playlist_t *playlist, const gchar *plname, xmms_error_t *err);
+static xmmsv_t * xmms_playlist_client_entry_positions (xmms_playlist_t *playlist, gint32 id, xmms_error_t *err);
+static xmmsv_t * xmms_playlist_client_list_range (xmms_playlist_t *playlist, const gchar *plname, gint32 start, gint32 length, xmms_error_t *err);
+static xmmsv_t * xmms_playlist_client_list_changes (xmms_playlist_t *playlist, const gchar *plname, gint32 revision, xmms_error_t *err);
 static gchar *xmms_playlist_client_current_active (xmms_playlist_t *playlist, xmms_error_t *err);
 static void xmms_playlist_destroy (xmms_object_t *object);
 
@@ -47,6 +50,8 @@ static xmmsv_t * xmms_playlist_client_current_pos (xmms_playlist_t *playlist, co
 static gint xmms_playlist_client_set_next (xmms_playlist_t *playlist, gint32 pos, xmms_error_t *error);
 static void xmms_playlist_client_remove_entry (xmms_playlist_t *playlist, const gchar *plname, gint32 pos, xmms_error_t *err);
 static gboolean xmms_playlist_remove_unlocked (xmms_playlist_t *playlist, const gchar *plname, xmmsv_t *plcoll, gint pos, xmms_error_t *err);
+static gboolean xmms_playlist_remove_range_unlocked (xmms_playlist_t *playlist, const gchar *plname, xmmsv_t *plcoll, gint pos, gint count, xmms_error_t *err);
+static void xmms_playlist_insert_entries_unlocked (xmms_playlist_t *playlist, const gchar *plname, xmmsv_t *plcoll, gint32 pos, xmmsv_t *ids, gboolean append);
 static void xmms_playlist_client_move_entry (xmms_playlist_t *playlist, const gchar *plname, gint32 pos, gint32 newpos, xmms_error_t *err);
 static gint xmms_playlist_client_set_next_rel (xmms_playlist_t *playlist, gint32 pos, xmms_error_t *error);
 static gint xmms_playlist_set_current_position_do (xmms_playlist_t *playlist, gint32 pos, xmms_error_t *err);
@@ -73,6 +78,7 @@ static void xmms_playlist_current_pos_msg_send (xmms_playlist_t *playlist, xmmsv
 static xmmsv_t *xmms_playlist_current_pos_msg_new (xmms_playlist_t *playlist, gint32 pos, const gchar *plname);
 
 static void xmms_playlist_changed_msg_send (xmms_playlist_t *playlist, xmmsv_t *dict);
+static void xmms_playlist_changed_msg_record (xmms_playlist_t *playlist, const gchar *plname, gint type, xmmsv_t *dict);
 static xmmsv_t *xmms_playlist_changed_msg_new (xmms_playlist_t *playlist, xmms_playlist_changed_actions_t type, xmms_medialib_entry_t id, const gchar *plname);
 
 #define XMMS_PLAYLIST_CHANGED_MSG(type, id, name) xmms_playlist_changed_msg_send (playlist, xmms_playlist_changed_msg_new (playlist, type, id, name))
@@ -95,6 +101,9 @@ struct xmms_playlist_St {
 	/* playlists are in the collection DAG */
 	xmms_coll_dag_t *colldag;
 
+	/* which playlists hold an id, owned by the DAG */
+	xmms_playlist_index_t *index;
+
 	gboolean repeat_one;
 	gboolean repeat_all;
 
@@ -164,10 +173,9 @@ xmms_playlist_update_queue (xmms_playlist_t *playlist, const gchar *plname,
 	}
 
 	currpos = xmms_playlist_coll_get_currpos (coll);
-	while (currpos > history) {
-		/* Removing entries is fast enough to be processed at once. */
-		xmms_playlist_remove_unlocked (playlist, plname, coll, 0, NULL);
-		currpos = xmms_playlist_coll_get_currpos (coll);
+	if (currpos > history) {
+		xmms_playlist_remove_range_unlocked (playlist, plname, coll, 0,
+		                                     currpos - history, NULL);
 	}
 }
 
@@ -189,30 +197,32 @@ xmms_playlist_update_partyshuffle (xmms_playlist_t *playlist,
 	}
 
 	currpos = xmms_playlist_coll_get_currpos (coll);
-	while (currpos > history) {
-		/* Removing entries is fast enough to be processed at once. */
-		xmms_playlist_remove_unlocked (playlist, plname, coll, 0, NULL);
+	if (currpos > history) {
+		xmms_playlist_remove_range_unlocked (playlist, plname, coll, 0,
+		                                     currpos - history, NULL);
 		currpos = xmms_playlist_coll_get_currpos (coll);
 	}
 
 	g_return_if_fail(xmmsv_list_get (xmmsv_coll_operands_get (coll), 0, &src));
 
-	/* Since getting random media can be slow on huge medialibs, we refill only
-	 * one entry at a time. This let other threads a chance to get the lock on
-	 * the playlist object as soon as possible. */
+	/* All the missing entries are picked with a single medialib query, as
+	 * each query scans the whole source collection anyway. */
 	size = xmms_playlist_coll_get_size (coll);
 	if (size < currpos + 1 + upcoming) {
-		xmms_medialib_entry_t randentry;
-		randentry = xmms_collection_get_random_media (playlist->colldag, src);
-		if (randentry > 0) {
-			xmms_playlist_add_entry_unlocked (playlist, plname, coll, randentry, NULL);
-		}
+		xmmsv_t *ids;
+		ids = xmms_collection_get_random_media_list (playlist->colldag, src,
+		                                             currpos + 1 + upcoming - size);
+		xmms_playlist_insert_entries_unlocked (playlist, plname, coll, size,
+		                                       ids, TRUE);
+		xmmsv_unref (ids);
 	}
 }
 
 /**
  *  Update playlist entries.
- *  Currently called by the playlist updater. An update can be partial.
+ *  Currently called by the playlist updater. The history is trimmed with
+ *  one edit and the upcoming entries are refilled with another, so one
+ *  call brings the playlist up to date.
  *  The function will emit at least one signal
  *  (playlist/collection/current_position changed) when something is updated.
  *  No more signal means everything is up to date.
@@ -226,48 +236,49 @@ xmms_playlist_update (xmms_playlist_t *playlist, const gchar *plname)
 }
 
 
-typedef struct {
-	xmms_playlist_t *pls;
-	xmms_medialib_entry_t entry;
-} playlist_remove_context_t;
-
 static void
-remove_from_playlist (gpointer key, gpointer value, gpointer udata)
+remove_from_playlist (xmms_playlist_t *playlist, xmmsv_t *plcoll,
+                      xmms_medialib_entry_t entry)
 {
-	playlist_remove_context_t *ctx = (playlist_remove_context_t *) udata;
-	xmmsv_t *coll = (xmmsv_t *) value;
-	const gchar *name = (const gchar *) key;
-
 	xmms_medialib_entry_t val;
+	gchar *name;
 	gint32 i;
 
-	for (i = 0; xmmsv_coll_idlist_get_index (coll, i, &val); i++) {
-		if (val == ctx->entry) {
+	name = xmms_collection_find_alias (playlist->colldag,
+	                                   XMMS_COLLECTION_NSID_PLAYLISTS,
+	                                   plcoll, NULL);
+	if (name == NULL) {
+		return;
+	}
+
+	/* back to front, so that the matches left keep their positions */
+	for (i = xmms_playlist_coll_get_size (plcoll) - 1; i >= 0; i--) {
+		if (xmmsv_coll_idlist_get_index (plcoll, i, &val) && val == entry) {
 			XMMS_DBG ("removing entry on pos %d in %s", i, name);
-			xmms_playlist_remove_unlocked (ctx->pls, name, coll, i, NULL);
-			i--; /* reset it */
+			xmms_playlist_remove_unlocked (playlist, name, plcoll, i, NULL);
 		}
 	}
+
+	g_free (name);
 }
 
 static void
 on_medialib_entry_removed (xmms_object_t *object, xmmsv_t *val, gpointer udata)
 {
 	xmms_playlist_t *playlist = (xmms_playlist_t *) udata;
-	playlist_remove_context_t ctx;
+	GList *colls, *n;
 	gint entry;
 
 	g_return_if_fail (playlist);
 	g_return_if_fail (xmmsv_get_int (val, &entry));
 
-	ctx.pls = playlist;
-	ctx.entry = entry;
-
 	g_mutex_lock (&playlist->mutex);
 
-	xmms_collection_foreach_in_namespace (playlist->colldag,
-	                                      XMMS_COLLECTION_NSID_PLAYLISTS,
-	                                      remove_from_playlist, &ctx);
+	colls = xmms_playlist_index_lookup (playlist->index, entry);
+	for (n = colls; n; n = g_list_next (n)) {
+		remove_from_playlist (playlist, n->data, entry);
+	}
+	g_list_free_full (colls, (GDestroyNotify) xmmsv_unref);
 
 	g_mutex_unlock (&playlist->mutex);
 }
@@ -319,6 +330,7 @@ xmms_playlist_init (xmms_medialib_t *medialib, xmms_coll_dag_t *colldag)
 
 	xmms_object_ref (colldag);
 	ret->colldag = colldag;
+	ret->index = xmms_collection_get_playlist_index (colldag);
 
 	xmms_object_connect (XMMS_OBJECT (ret->medialib),
 	                     XMMS_IPC_SIGNAL_MEDIALIB_ENTRY_REMOVED,
@@ -555,27 +567,58 @@ static gboolean
 xmms_playlist_remove_unlocked (xmms_playlist_t *playlist, const gchar *plname,
                                xmmsv_t *plcoll, gint pos, xmms_error_t *err)
 {
-	gint currpos;
+	return xmms_playlist_remove_range_unlocked (playlist, plname, plcoll,
+	                                            pos, 1, err);
+}
+
+/**
+ * Remove count entries starting at pos without locking the mutex, and
+ * tell the clients about it with a single message.
+ *
+ * A single entry is announced with a plain REMOVE message, more entries
+ * with one REMOVE_MANY message holding the position and the count.
+ */
+static gboolean
+xmms_playlist_remove_range_unlocked (xmms_playlist_t *playlist,
+                                     const gchar *plname, xmmsv_t *plcoll,
+                                     gint pos, gint count, xmms_error_t *err)
+{
+	xmms_medialib_entry_t id;
+	gint currpos, removed;
 	xmmsv_t *dict;
 
 	g_return_val_if_fail (playlist, FALSE);
 
 	currpos = xmms_playlist_coll_get_currpos (plcoll);
 
-	if (!xmmsv_coll_idlist_remove (plcoll, pos)) {
+	for (removed = 0; removed < count; removed++) {
+		if (!xmmsv_coll_idlist_get_index (plcoll, pos, &id) ||
+		    !xmmsv_coll_idlist_remove (plcoll, pos)) {
+			break;
+		}
+		xmms_playlist_index_remove (playlist->index, plcoll, id);
+	}
+
+	if (removed == 0) {
 		if (err) xmms_error_set (err, XMMS_ERROR_NOENT, "Entry was not in list!");
 		return FALSE;
 	}
 
-	dict = xmms_playlist_changed_msg_new (playlist, XMMS_PLAYLIST_CHANGED_REMOVE, 0, plname);
+	if (removed > 1) {
+		dict = xmms_playlist_changed_msg_new (playlist, XMMS_PLAYLIST_CHANGED_REMOVE_MANY, 0, plname);
+		xmmsv_dict_set_int (dict, "count", removed);
+	} else {
+		dict = xmms_playlist_changed_msg_new (playlist, XMMS_PLAYLIST_CHANGED_REMOVE, 0, plname);
+	}
 	xmmsv_dict_set_int (dict, "position", pos);
 	xmms_playlist_changed_msg_send (playlist, dict);
 
-	/* decrease current position if removed entry was before or if it's
-	 * the current entry, but only if current position is a valid entry.
+	/* same as removing the entries one by one: the current position moves
+	 * back by one per entry removed before or at it, but not below the
+	 * entry preceding the range.
 	 */
 	if (currpos != -1 && pos <= currpos) {
-		currpos = MAX (0, currpos - 1);
+		currpos = MAX (MAX (0, pos - 1), currpos - removed);
 		xmms_collection_set_int_attr (plcoll, "position", currpos);
 		XMMS_PLAYLIST_CURRPOS_MSG (currpos, plname);
 	}
@@ -719,20 +762,11 @@ static void
 xmms_playlist_client_rinsert (xmms_playlist_t *playlist, const gchar *plname, gint32 pos,
                               const gchar *path, xmms_error_t *err)
 {
-	xmms_medialib_entry_t entry;
 	xmmsv_t *idlist;
-	xmmsv_list_iter_t *it;
-	xmmsv_t *list;
 
 	idlist = xmms_medialib_add_recursive (playlist->medialib, path, err);
-	list = xmmsv_coll_idlist_get (idlist);
-
-	xmmsv_get_list_iter (list, &it);
-	xmmsv_list_iter_last (it);
-	while (xmmsv_list_iter_entry_int (it, &entry)) {
-		xmms_playlist_insert_entry (playlist, plname, pos, entry, err);
-		xmmsv_list_iter_prev (it);
-	}
+	xmms_playlist_insert_entries (playlist, plname, pos,
+	                              xmmsv_coll_idlist_get (idlist), err);
 
 	xmmsv_unref (idlist);
 }
@@ -751,8 +785,6 @@ static void
 xmms_playlist_client_insert_collection (xmms_playlist_t *playlist, const gchar *plname,
                                         gint32 pos, xmmsv_t *coll, xmms_error_t *err)
 {
-	xmms_medialib_entry_t mid;
-	xmmsv_list_iter_t *it;
 	xmmsv_t *list;
 
 	list = xmms_collection_query_ids (playlist->colldag, coll, err);
@@ -760,14 +792,7 @@ xmms_playlist_client_insert_collection (xmms_playlist_t *playlist, const gchar *
 		return;
 	}
 
-	xmmsv_get_list_iter (list, &it);
-
-	xmmsv_list_iter_last (it);
-
-	while (xmmsv_list_iter_entry_int (it, &mid)) {
-		xmms_playlist_insert_entry (playlist, plname, pos, mid, err);
-		xmmsv_list_iter_prev (it);
-	}
+	xmms_playlist_insert_entries (playlist, plname, pos, list, err);
 
 	xmmsv_unref (list);
 }
@@ -820,6 +845,7 @@ xmms_playlist_insert_entry (xmms_playlist_t *playlist, const gchar *plname,
 		return;
 	}
 	xmmsv_coll_idlist_insert (plcoll, pos, file);
+	xmms_playlist_index_add (playlist->index, plcoll, file);
 
 	/** propagate the MID ! */
 	dict = xmms_playlist_changed_msg_new (playlist, XMMS_PLAYLIST_CHANGED_INSERT, file, plname);
@@ -880,19 +906,11 @@ static void
 xmms_playlist_client_radd (xmms_playlist_t *playlist, const gchar *plname,
                            const gchar *path, xmms_error_t *err)
 {
-	xmms_medialib_entry_t entry;
 	xmmsv_t *idlist;
-	xmmsv_list_iter_t *it;
-	xmmsv_t *list;
 
 	idlist = xmms_medialib_add_recursive (playlist->medialib, path, err);
-	list = xmmsv_coll_idlist_get (idlist);
-
-	xmmsv_get_list_iter (list, &it);
-	while (xmmsv_list_iter_entry_int (it, &entry)) {
-		xmms_playlist_add_entry (playlist, plname, entry, err);
-		xmmsv_list_iter_next (it);
-	}
+	xmms_playlist_add_entries (playlist, plname,
+	                           xmmsv_coll_idlist_get (idlist), err);
 
 	xmmsv_unref (idlist);
 }
@@ -902,15 +920,14 @@ xmms_playlist_client_add_collection (xmms_playlist_t *playlist, const gchar *pln
                                      xmmsv_t *coll, xmms_error_t *err)
 {
 	xmmsv_t *res;
-	int32_t id;
-	int i;
 
 	res = xmms_collection_query_ids (playlist->colldag, coll, err);
-
-	for (i = 0; xmmsv_list_get_int (res, i, &id); i++) {
-		xmms_playlist_add_entry (playlist, plname, id, err);
+	if (xmms_error_iserror (err)) {
+		return;
 	}
 
+	xmms_playlist_add_entries (playlist, plname, res, err);
+
 	xmmsv_unref (res);
 }
 
@@ -951,6 +968,7 @@ xmms_playlist_add_entry_unlocked (xmms_playlist_t *playlist,
 
 	prev_size = xmms_playlist_coll_get_size (plcoll);
 	xmmsv_coll_idlist_append (plcoll, file);
+	xmms_playlist_index_add (playlist->index, plcoll, file);
 
 	/** propagate the MID ! */
 	dict = xmms_playlist_changed_msg_new (playlist, XMMS_PLAYLIST_CHANGED_ADD, file, plname);
@@ -958,6 +976,143 @@ xmms_playlist_add_entry_unlocked (xmms_playlist_t *playlist,
 	xmms_playlist_changed_msg_send (playlist, dict);
 }
 
+/**
+ * Insert a list of entries at a given position without locking the
+ * mutex, and tell the clients about it with a single message.
+ *
+ * A single entry is announced with a plain ADD or INSERT message, more
+ * entries with one ADD_MANY message holding the position of the first
+ * entry and the list of ids.
+ */
+static void
+xmms_playlist_insert_entries_unlocked (xmms_playlist_t *playlist,
+                                       const gchar *plname, xmmsv_t *plcoll,
+                                       gint32 pos, xmmsv_t *ids,
+                                       gboolean append)
+{
+	xmms_playlist_changed_actions_t type;
+	xmms_medialib_entry_t id = 0;
+	gint currpos, count, i;
+	xmmsv_t *dict;
+
+	count = xmmsv_list_get_size (ids);
+	if (count == 0) {
+		return;
+	}
+
+	for (i = 0; xmmsv_list_get_int (ids, i, &id); i++) {
+		if (append) {
+			xmmsv_coll_idlist_append (plcoll, id);
+		} else {
+			xmmsv_coll_idlist_insert (plcoll, pos + i, id);
+		}
+	}
+	xmms_playlist_index_add_list (playlist->index, plcoll, ids);
+
+	if (count > 1) {
+		dict = xmms_playlist_changed_msg_new (playlist, XMMS_PLAYLIST_CHANGED_ADD_MANY, 0, plname);
+		xmmsv_dict_set (dict, "ids", ids);
+	} else {
+		type = append ? XMMS_PLAYLIST_CHANGED_ADD : XMMS_PLAYLIST_CHANGED_INSERT;
+		dict = xmms_playlist_changed_msg_new (playlist, type, id, plname);
+	}
+	xmmsv_dict_set_int (dict, "position", pos);
+	xmms_playlist_changed_msg_send (playlist, dict);
+
+	/** update position once client is familiar with the new items. */
+	currpos = xmms_playlist_coll_get_currpos (plcoll);
+	if (pos <= currpos) {
+		currpos += count;
+		xmms_collection_set_int_attr (plcoll, "position", currpos);
+		XMMS_PLAYLIST_CURRPOS_MSG (currpos, plname);
+	}
+}
+
+/**
+ * Add a list of entries to the end of the playlist without validating
+ * them. The playlist is locked once and the clients get one message for
+ * the whole list.
+ *
+ * @param playlist the playlist to add the entries to.
+ * @param plname the name of the playlist to modify.
+ * @param ids a list of medialib ids.
+ * @param err an #xmms_error_t that should be defined upon error.
+ */
+void
+xmms_playlist_add_entries (xmms_playlist_t *playlist, const gchar *plname,
+                           xmmsv_t *ids, xmms_error_t *err)
+{
+	xmmsv_t *plcoll;
+
+	g_mutex_lock (&playlist->mutex);
+
+	plcoll = xmms_playlist_get_coll (playlist, plname, err);
+	if (plcoll != NULL) {
+		xmms_playlist_insert_entries_unlocked (playlist, plname, plcoll,
+		                                       xmms_playlist_coll_get_size (plcoll),
+		                                       ids, TRUE);
+	}
+
+	g_mutex_unlock (&playlist->mutex);
+}
+
+/**
+ * Insert a list of entries at a given position in the playlist, keeping
+ * their order. Nothing is inserted unless all ids are valid. The
+ * playlist is locked once and the clients get one message for the whole
+ * list.
+ *
+ * @param playlist the playlist to add the entries to.
+ * @param plname the name of the playlist to modify.
+ * @param pos the position where the first entry is inserted.
+ * @param ids a list of medialib ids.
+ * @param err an #xmms_error_t that should be defined upon error.
+ */
+void
+xmms_playlist_insert_entries (xmms_playlist_t *playlist, const gchar *plname,
+                              gint32 pos, xmmsv_t *ids, xmms_error_t *err)
+{
+	xmms_medialib_session_t *session;
+	xmms_medialib_entry_t id;
+	xmmsv_t *plcoll;
+	gboolean valid;
+	gint i;
+
+	do {
+		session = xmms_medialib_session_begin_ro (playlist->medialib);
+		valid = TRUE;
+		for (i = 0; valid && xmmsv_list_get_int (ids, i, &id); i++) {
+			valid = xmms_medialib_check_id (session, id);
+		}
+	} while (!xmms_medialib_session_commit (session));
+
+	if (!valid) {
+		xmms_error_set (err, XMMS_ERROR_NOENT,
+		                "That is not a valid medialib id!");
+		return;
+	}
+
+	g_mutex_lock (&playlist->mutex);
+
+	plcoll = xmms_playlist_get_coll (playlist, plname, err);
+	if (plcoll == NULL) {
+		g_mutex_unlock (&playlist->mutex);
+		return;
+	}
+
+	if (pos < 0 || pos > xmms_playlist_coll_get_size (plcoll)) {
+		xmms_error_set (err, XMMS_ERROR_GENERIC,
+		                "Could not insert entry outside of playlist!");
+		g_mutex_unlock (&playlist->mutex);
+		return;
+	}
+
+	xmms_playlist_insert_entries_unlocked (playlist, plname, plcoll,
+	                                       pos, ids, FALSE);
+
+	g_mutex_unlock (&playlist->mutex);
+}
+
 
 /** Set the nextentry pointer in the playlist.
  *
@@ -1123,6 +1278,7 @@ xmms_playlist_client_replace (xmms_playlist_t *playlist, const gchar *plname,
 			current_position = i;
 		xmmsv_coll_idlist_append (plcoll, id);
 	}
+	xmms_playlist_index_reset (playlist->index, plcoll);
 
 	switch (action) {
 		case XMMS_PLAYLIST_CURRENT_ID_FORGET:
@@ -1187,6 +1343,147 @@ xmms_playlist_client_list_entries (xmms_playlist_t *playlist, const gchar *plnam
 	return entries;
 }
 
+/** List a part of a playlist, along with its revision */
+static xmmsv_t *
+xmms_playlist_client_list_range (xmms_playlist_t *playlist, const gchar *plname,
+                                 gint32 start, gint32 length, xmms_error_t *err)
+{
+	xmmsv_t *plcoll, *ids;
+	xmms_medialib_entry_t entry;
+	xmmsv_list_iter_t *it;
+	gint i, size, revision;
+
+	g_return_val_if_fail (playlist, NULL);
+
+	g_mutex_lock (&playlist->mutex);
+
+	plcoll = xmms_playlist_get_coll (playlist, plname, err);
+	if (plcoll == NULL) {
+		g_mutex_unlock (&playlist->mutex);
+		return NULL;
+	}
+
+	size = xmms_playlist_coll_get_size (plcoll);
+	if (start < 0 || start > size) {
+		xmms_error_set (err, XMMS_ERROR_INVAL, "trying to list from outside of playlist!");
+		g_mutex_unlock (&playlist->mutex);
+		return NULL;
+	}
+
+	/* a negative length lists up to the end */
+	if (length < 0 || length > size - start) {
+		length = size - start;
+	}
+
+	ids = xmmsv_new_list ();
+
+	xmmsv_get_list_iter (xmmsv_coll_idlist_get (plcoll), &it);
+	xmmsv_list_iter_seek (it, start);
+	for (i = 0; i < length && xmmsv_list_iter_entry_int (it, &entry); i++) {
+		xmmsv_list_append_int (ids, entry);
+		xmmsv_list_iter_next (it);
+	}
+	xmmsv_list_iter_explicit_destroy (it);
+
+	revision = xmms_playlist_index_revision (playlist->index, plcoll);
+
+	g_mutex_unlock (&playlist->mutex);
+
+	return xmmsv_build_dict (XMMSV_DICT_ENTRY_INT ("revision", revision),
+	                         XMMSV_DICT_ENTRY_INT ("position", start),
+	                         XMMSV_DICT_ENTRY ("ids", ids),
+	                         XMMSV_DICT_END);
+}
+
+/** List the changes of a playlist since a revision */
+static xmmsv_t *
+xmms_playlist_client_list_changes (xmms_playlist_t *playlist, const gchar *plname,
+                                   gint32 revision, xmms_error_t *err)
+{
+	xmmsv_t *plcoll, *changes;
+
+	g_return_val_if_fail (playlist, NULL);
+
+	g_mutex_lock (&playlist->mutex);
+
+	plcoll = xmms_playlist_get_coll (playlist, plname, err);
+	if (plcoll == NULL) {
+		g_mutex_unlock (&playlist->mutex);
+		return NULL;
+	}
+
+	changes = xmms_playlist_index_changes_since (playlist->index, plcoll, revision);
+	if (changes == NULL) {
+		xmms_error_set (err, XMMS_ERROR_NOENT, "revision no longer known, list the playlist again");
+		g_mutex_unlock (&playlist->mutex);
+		return NULL;
+	}
+
+	revision = xmms_playlist_index_revision (playlist->index, plcoll);
+
+	g_mutex_unlock (&playlist->mutex);
+
+	return xmmsv_build_dict (XMMSV_DICT_ENTRY_INT ("revision", revision),
+	                         XMMSV_DICT_ENTRY ("changes", changes),
+	                         XMMSV_DICT_END);
+}
+
+typedef struct {
+	xmmsv_t *plcoll;
+	xmmsv_t *positions;
+	xmmsv_t *result;
+} playlist_positions_context_t;
+
+static void
+set_positions_for_names (gpointer key, gpointer value, gpointer udata)
+{
+	playlist_positions_context_t *ctx = (playlist_positions_context_t *) udata;
+
+	if (value == ctx->plcoll) {
+		xmmsv_dict_set (ctx->result, (const gchar *) key, ctx->positions);
+	}
+}
+
+/** List where a medialib entry is in the playlists */
+static xmmsv_t *
+xmms_playlist_client_entry_positions (xmms_playlist_t *playlist, gint32 id,
+                                      xmms_error_t *err)
+{
+	playlist_positions_context_t ctx;
+	xmms_medialib_entry_t val;
+	GList *colls, *n;
+	gint i;
+
+	g_return_val_if_fail (playlist, NULL);
+
+	ctx.result = xmmsv_new_dict ();
+
+	g_mutex_lock (&playlist->mutex);
+
+	colls = xmms_playlist_index_lookup (playlist->index, id);
+	for (n = colls; n; n = g_list_next (n)) {
+		ctx.plcoll = n->data;
+		ctx.positions = xmmsv_new_list ();
+
+		for (i = 0; xmmsv_coll_idlist_get_index (ctx.plcoll, i, &val); i++) {
+			if (val == id) {
+				xmmsv_list_append_int (ctx.positions, i);
+			}
+		}
+
+		/* every name pointing at the playlist gets the positions */
+		xmms_collection_foreach_in_namespace (playlist->colldag,
+		                                      XMMS_COLLECTION_NSID_PLAYLISTS,
+		                                      set_positions_for_names, &ctx);
+		xmmsv_unref (ctx.positions);
+	}
+	g_list_free_full (colls, (GDestroyNotify) xmmsv_unref);
+
+	g_mutex_unlock (&playlist->mutex);
+
+	return ctx.result;
+}
+
 /** @} */
 
 /** Free the playlist and other memory in the xmms_playlist_t
@@ -1342,6 +1639,7 @@ xmms_playlist_changed_msg_send (xmms_playlist_t *playlist, xmmsv_t *dict)
 	if (xmmsv_dict_entry_get_int (dict, "type", &type) &&
 	    xmmsv_dict_entry_get_string (dict, "name", &plname) &&
 	    type != XMMS_PLAYLIST_CHANGED_UPDATE) {
+		xmms_playlist_changed_msg_record (playlist, plname, type, dict);
 		XMMS_COLLECTION_PLAYLIST_CHANGED_MSG (playlist->colldag, plname);
 	}
 
@@ -1350,6 +1648,37 @@ xmms_playlist_changed_msg_send (xmms_playlist_t *playlist, xmmsv_t *dict)
 	                  dict);
 }
 
+/**
+ * Add a change to the journal of the playlist, for clients catching up
+ * with list_changes. A replace restarts the journal instead, which the
+ * playlist index already did.
+ */
+static void
+xmms_playlist_changed_msg_record (xmms_playlist_t *playlist,
+                                  const gchar *plname, gint type,
+                                  xmmsv_t *dict)
+{
+	xmmsv_t *plcoll;
+
+	switch (type) {
+		case XMMS_PLAYLIST_CHANGED_ADD:
+		case XMMS_PLAYLIST_CHANGED_INSERT:
+		case XMMS_PLAYLIST_CHANGED_ADD_MANY:
+		case XMMS_PLAYLIST_CHANGED_REMOVE:
+		case XMMS_PLAYLIST_CHANGED_REMOVE_MANY:
+		case XMMS_PLAYLIST_CHANGED_MOVE:
+		case XMMS_PLAYLIST_CHANGED_CLEAR:
+			break;
+		default:
+			return;
+	}
+
+	plcoll = xmms_playlist_get_coll (playlist, plname, NULL);
+	if (plcoll != NULL) {
+		xmms_playlist_index_record (playlist->index, plcoll, dict);
+	}
+}
+
 static void
 xmms_playlist_current_pos_msg_send (xmms_playlist_t *playlist,
                                     xmmsv_t *dict)
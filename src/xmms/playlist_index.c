@@ -0,0 +1,523 @@
+/*  XMMS2 - X Music Multiplexer System
+ *  Copyright (C) 2003-2013 XMMS2 Team
+ *
+ *  PLUGINS ARE NOT CONSIDERED TO BE DERIVED WORK !!!
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ */
+
+/** @file
+ *  Index from medialib ids to the playlists containing them.
+ *
+ *  The collection DAG binds every collection of the playlists namespace
+ *  to the index, once per name pointing at it, and the playlist reports
+ *  each id it adds to or removes from such a collection. Finding the
+ *  playlists that contain an id then costs as much as there are matches,
+ *  instead of a scan of every playlist.
+ *
+ *  Only the number of occurrences per playlist is kept. Positions change
+ *  with every edit before them, so they are found by scanning the
+ *  matching playlists.
+ *
+ *  Each bound collection also carries a revision and a short journal of
+ *  the changes that led to it, so clients holding a copy of a playlist
+ *  can catch up without fetching it again. Revisions are drawn from one
+ *  counter for the whole index, so a revision never names two states,
+ *  not even of different collections.
+ */
+
+#include <xmmspriv/xmms_playlist_index.h>
+
+/* Changes kept per playlist, older clients fetch the playlist again */
+#define XMMS_PLAYLIST_INDEX_JOURNAL_SIZE 256
+
+typedef struct {
+	xmmsv_t *coll;
+	gint binds;
+	GHashTable *counts; /* id -> number of occurrences */
+	gint base;          /* revision the journal starts from */
+	GQueue journal;     /* change dicts, each with its "revision" */
+} xmms_playlist_index_entry_t;
+
+struct xmms_playlist_index_St {
+	GMutex mutex;
+	GHashTable *playlists; /* coll -> xmms_playlist_index_entry_t */
+	GHashTable *ids;       /* id -> GSList of xmms_playlist_index_entry_t */
+	gint revision;
+};
+
+static void
+xmms_playlist_index_entry_add (xmms_playlist_index_t *index,
+                               xmms_playlist_index_entry_t *entry,
+                               xmms_medialib_entry_t id)
+{
+	gpointer key = GINT_TO_POINTER (id);
+	GSList *list;
+	gint count;
+
+	count = GPOINTER_TO_INT (g_hash_table_lookup (entry->counts, key));
+	if (count == 0) {
+		list = g_hash_table_lookup (index->ids, key);
+		g_hash_table_insert (index->ids, key, g_slist_prepend (list, entry));
+	}
+
+	g_hash_table_insert (entry->counts, key, GINT_TO_POINTER (count + 1));
+}
+
+static void
+xmms_playlist_index_entry_forget (xmms_playlist_index_t *index,
+                                  xmms_playlist_index_entry_t *entry,
+                                  gpointer key)
+{
+	GSList *list;
+
+	list = g_hash_table_lookup (index->ids, key);
+	list = g_slist_remove (list, entry);
+
+	if (list) {
+		g_hash_table_insert (index->ids, key, list);
+	} else {
+		g_hash_table_remove (index->ids, key);
+	}
+}
+
+static void
+xmms_playlist_index_entry_remove (xmms_playlist_index_t *index,
+                                  xmms_playlist_index_entry_t *entry,
+                                  xmms_medialib_entry_t id)
+{
+	gpointer key = GINT_TO_POINTER (id);
+	gint count;
+
+	count = GPOINTER_TO_INT (g_hash_table_lookup (entry->counts, key));
+	if (count > 1) {
+		g_hash_table_insert (entry->counts, key, GINT_TO_POINTER (count - 1));
+	} else if (count == 1) {
+		g_hash_table_remove (entry->counts, key);
+		xmms_playlist_index_entry_forget (index, entry, key);
+	}
+}
+
+static void
+xmms_playlist_index_entry_fill (xmms_playlist_index_t *index,
+                                xmms_playlist_index_entry_t *entry)
+{
+	xmms_medialib_entry_t id;
+	gint i;
+
+	for (i = 0; xmmsv_coll_idlist_get_index (entry->coll, i, &id); i++) {
+		xmms_playlist_index_entry_add (index, entry, id);
+	}
+}
+
+static void
+xmms_playlist_index_entry_clear (xmms_playlist_index_t *index,
+                                 xmms_playlist_index_entry_t *entry)
+{
+	GHashTableIter iter;
+	gpointer key;
+
+	g_hash_table_iter_init (&iter, entry->counts);
+	while (g_hash_table_iter_next (&iter, &key, NULL)) {
+		xmms_playlist_index_entry_forget (index, entry, key);
+	}
+
+	g_hash_table_remove_all (entry->counts);
+}
+
+static void
+xmms_playlist_index_entry_restart (xmms_playlist_index_t *index,
+                                   xmms_playlist_index_entry_t *entry)
+{
+	xmmsv_t *change;
+
+	while ((change = g_queue_pop_head (&entry->journal)) != NULL) {
+		xmmsv_unref (change);
+	}
+
+	entry->base = ++index->revision;
+}
+
+static gint
+xmms_playlist_index_entry_revision (xmms_playlist_index_entry_t *entry)
+{
+	xmmsv_t *change;
+	gint revision;
+
+	change = g_queue_peek_tail (&entry->journal);
+	if (change == NULL || !xmmsv_dict_entry_get_int (change, "revision", &revision)) {
+		revision = entry->base;
+	}
+
+	return revision;
+}
+
+static void
+xmms_playlist_index_entry_free (xmms_playlist_index_entry_t *entry)
+{
+	xmmsv_t *change;
+
+	while ((change = g_queue_pop_head (&entry->journal)) != NULL) {
+		xmmsv_unref (change);
+	}
+
+	g_hash_table_destroy (entry->counts);
+	xmmsv_unref (entry->coll);
+	g_free (entry);
+}
+
+/**
+ * Create an empty index.
+ */
+xmms_playlist_index_t *
+xmms_playlist_index_new (void)
+{
+	xmms_playlist_index_t *index;
+
+	index = g_new0 (xmms_playlist_index_t, 1);
+	g_mutex_init (&index->mutex);
+
+	index->playlists = g_hash_table_new_full (NULL, NULL, NULL,
+	                                          (GDestroyNotify) xmms_playlist_index_entry_free);
+	/* the lists are replaced in place, so they are freed by hand */
+	index->ids = g_hash_table_new (NULL, NULL);
+
+	return index;
+}
+
+void
+xmms_playlist_index_free (xmms_playlist_index_t *index)
+{
+	GHashTableIter iter;
+	gpointer list;
+
+	g_return_if_fail (index);
+
+	g_hash_table_iter_init (&iter, index->ids);
+	while (g_hash_table_iter_next (&iter, NULL, &list)) {
+		g_slist_free (list);
+	}
+
+	g_hash_table_destroy (index->ids);
+	g_hash_table_destroy (index->playlists);
+	g_mutex_clear (&index->mutex);
+	g_free (index);
+}
+
+/**
+ * Record that a name of the playlists namespace points at a collection.
+ * The ids of a collection that was not bound yet are added to the index.
+ */
+void
+xmms_playlist_index_bind (xmms_playlist_index_t *index, xmmsv_t *plcoll)
+{
+	xmms_playlist_index_entry_t *entry;
+
+	g_return_if_fail (index);
+	g_return_if_fail (plcoll);
+
+	g_mutex_lock (&index->mutex);
+
+	entry = g_hash_table_lookup (index->playlists, plcoll);
+	if (entry == NULL) {
+		entry = g_new0 (xmms_playlist_index_entry_t, 1);
+		entry->coll = xmmsv_ref (plcoll);
+		entry->counts = g_hash_table_new (NULL, NULL);
+		entry->base = ++index->revision;
+		g_queue_init (&entry->journal);
+		g_hash_table_insert (index->playlists, plcoll, entry);
+
+		xmms_playlist_index_entry_fill (index, entry);
+	}
+
+	entry->binds++;
+
+	g_mutex_unlock (&index->mutex);
+}
+
+/**
+ * Record that a name no longer points at a collection. The collection
+ * leaves the index with the last name.
+ */
+void
+xmms_playlist_index_unbind (xmms_playlist_index_t *index, xmmsv_t *plcoll)
+{
+	xmms_playlist_index_entry_t *entry;
+
+	g_return_if_fail (index);
+	g_return_if_fail (plcoll);
+
+	g_mutex_lock (&index->mutex);
+
+	entry = g_hash_table_lookup (index->playlists, plcoll);
+	if (entry != NULL && --entry->binds == 0) {
+		xmms_playlist_index_entry_clear (index, entry);
+		g_hash_table_remove (index->playlists, plcoll);
+	}
+
+	g_mutex_unlock (&index->mutex);
+}
+
+/**
+ * Index the ids of a bound collection again, after its idlist was
+ * rebuilt as a whole. This also starts a new revision with an empty
+ * journal.
+ */
+void
+xmms_playlist_index_reset (xmms_playlist_index_t *index, xmmsv_t *plcoll)
+{
+	xmms_playlist_index_entry_t *entry;
+
+	g_return_if_fail (index);
+
+	g_mutex_lock (&index->mutex);
+
+	entry = g_hash_table_lookup (index->playlists, plcoll);
+	if (entry != NULL) {
+		xmms_playlist_index_entry_clear (index, entry);
+		xmms_playlist_index_entry_fill (index, entry);
+		xmms_playlist_index_entry_restart (index, entry);
+	}
+
+	g_mutex_unlock (&index->mutex);
+}
+
+/**
+ * Record an id added to a bound collection.
+ */
+void
+xmms_playlist_index_add (xmms_playlist_index_t *index, xmmsv_t *plcoll,
+                         xmms_medialib_entry_t id)
+{
+	xmms_playlist_index_entry_t *entry;
+
+	g_return_if_fail (index);
+
+	g_mutex_lock (&index->mutex);
+
+	entry = g_hash_table_lookup (index->playlists, plcoll);
+	if (entry != NULL) {
+		xmms_playlist_index_entry_add (index, entry, id);
+	}
+
+	g_mutex_unlock (&index->mutex);
+}
+
+/**
+ * Record a list of ids added to a bound collection.
+ */
+void
+xmms_playlist_index_add_list (xmms_playlist_index_t *index, xmmsv_t *plcoll,
+                              xmmsv_t *ids)
+{
+	xmms_playlist_index_entry_t *entry;
+	xmms_medialib_entry_t id;
+	gint i;
+
+	g_return_if_fail (index);
+
+	g_mutex_lock (&index->mutex);
+
+	entry = g_hash_table_lookup (index->playlists, plcoll);
+	if (entry != NULL) {
+		for (i = 0; xmmsv_list_get_int (ids, i, &id); i++) {
+			xmms_playlist_index_entry_add (index, entry, id);
+		}
+	}
+
+	g_mutex_unlock (&index->mutex);
+}
+
+/**
+ * Record an id removed from a bound collection.
+ */
+void
+xmms_playlist_index_remove (xmms_playlist_index_t *index, xmmsv_t *plcoll,
+                            xmms_medialib_entry_t id)
+{
+	xmms_playlist_index_entry_t *entry;
+
+	g_return_if_fail (index);
+
+	g_mutex_lock (&index->mutex);
+
+	entry = g_hash_table_lookup (index->playlists, plcoll);
+	if (entry != NULL) {
+		xmms_playlist_index_entry_remove (index, entry, id);
+	}
+
+	g_mutex_unlock (&index->mutex);
+}
+
+/**
+ * Get the number of times an id occurs in a bound collection.
+ */
+gint
+xmms_playlist_index_count (xmms_playlist_index_t *index, xmmsv_t *plcoll,
+                           xmms_medialib_entry_t id)
+{
+	xmms_playlist_index_entry_t *entry;
+	gint count = 0;
+
+	g_return_val_if_fail (index, 0);
+
+	g_mutex_lock (&index->mutex);
+
+	entry = g_hash_table_lookup (index->playlists, plcoll);
+	if (entry != NULL) {
+		count = GPOINTER_TO_INT (g_hash_table_lookup (entry->counts,
+		                                              GINT_TO_POINTER (id)));
+	}
+
+	g_mutex_unlock (&index->mutex);
+
+	return count;
+}
+
+/**
+ * Get the collections that contain an id.
+ *
+ * @return A list of referenced collections, to be freed with
+ * g_list_free_full and xmmsv_unref.
+ */
+GList *
+xmms_playlist_index_lookup (xmms_playlist_index_t *index,
+                            xmms_medialib_entry_t id)
+{
+	xmms_playlist_index_entry_t *entry;
+	GList *result = NULL;
+	GSList *n;
+
+	g_return_val_if_fail (index, NULL);
+
+	g_mutex_lock (&index->mutex);
+
+	n = g_hash_table_lookup (index->ids, GINT_TO_POINTER (id));
+	for (; n; n = g_slist_next (n)) {
+		entry = n->data;
+		result = g_list_prepend (result, xmmsv_ref (entry->coll));
+	}
+
+	g_mutex_unlock (&index->mutex);
+
+	return result;
+}
+
+/**
+ * Record a change of a bound collection in its journal.
+ *
+ * @param change A playlist changed message, a copy of it is kept.
+ * @return The new revision of the collection, or -1 if it is not bound.
+ */
+gint
+xmms_playlist_index_record (xmms_playlist_index_t *index, xmmsv_t *plcoll,
+                            xmmsv_t *change)
+{
+	xmms_playlist_index_entry_t *entry;
+	gint revision = -1;
+	xmmsv_t *copy;
+
+	g_return_val_if_fail (index, -1);
+	g_return_val_if_fail (change, -1);
+
+	g_mutex_lock (&index->mutex);
+
+	entry = g_hash_table_lookup (index->playlists, plcoll);
+	if (entry != NULL) {
+		revision = ++index->revision;
+
+		copy = xmmsv_copy (change);
+		xmmsv_dict_set_int (copy, "revision", revision);
+		g_queue_push_tail (&entry->journal, copy);
+
+		if (g_queue_get_length (&entry->journal) > XMMS_PLAYLIST_INDEX_JOURNAL_SIZE) {
+			copy = g_queue_pop_head (&entry->journal);
+			xmmsv_dict_entry_get_int (copy, "revision", &entry->base);
+			xmmsv_unref (copy);
+		}
+	}
+
+	g_mutex_unlock (&index->mutex);
+
+	return revision;
+}
+
+/**
+ * Get the current revision of a bound collection.
+ *
+ * @return The revision, or -1 if the collection is not bound.
+ */
+gint
+xmms_playlist_index_revision (xmms_playlist_index_t *index, xmmsv_t *plcoll)
+{
+	xmms_playlist_index_entry_t *entry;
+	gint revision = -1;
+
+	g_return_val_if_fail (index, -1);
+
+	g_mutex_lock (&index->mutex);
+
+	entry = g_hash_table_lookup (index->playlists, plcoll);
+	if (entry != NULL) {
+		revision = xmms_playlist_index_entry_revision (entry);
+	}
+
+	g_mutex_unlock (&index->mutex);
+
+	return revision;
+}
+
+/**
+ * Get the changes of a bound collection after a given revision.
+ *
+ * @param revision A revision the collection went through.
+ * @return A list of change dicts, oldest first, or NULL if the revision
+ * is not one of this collection or has left the journal.
+ */
+xmmsv_t *
+xmms_playlist_index_changes_since (xmms_playlist_index_t *index,
+                                   xmmsv_t *plcoll, gint revision)
+{
+	xmms_playlist_index_entry_t *entry;
+	xmmsv_t *changes = NULL;
+	xmmsv_t *change;
+	GList *n;
+	gint rev;
+
+	g_return_val_if_fail (index, NULL);
+
+	g_mutex_lock (&index->mutex);
+
+	entry = g_hash_table_lookup (index->playlists, plcoll);
+	if (entry == NULL) {
+		g_mutex_unlock (&index->mutex);
+		return NULL;
+	}
+
+	if (revision == entry->base) {
+		changes = xmmsv_new_list ();
+	}
+
+	for (n = entry->journal.head; n; n = g_list_next (n)) {
+		change = n->data;
+		xmmsv_dict_entry_get_int (change, "revision", &rev);
+
+		if (changes != NULL) {
+			xmmsv_list_append (changes, change);
+		} else if (rev == revision) {
+			changes = xmmsv_new_list ();
+		}
+	}
+
+	g_mutex_unlock (&index->mutex);
+
+	return changes;
+}
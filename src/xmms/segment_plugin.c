@@ -118,6 +118,12 @@ xmms_segment_plugin_setup (xmms_xform_plugin_t *xform_plugin)
 	                              "audio/pcm",
 	                              XMMS_STREAM_TYPE_END);
 
+	/* sets the duration of segments probed by the mediainfo reader */
+	xmms_xform_plugin_indata_add (xform_plugin,
+	                              XMMS_STREAM_TYPE_MIMETYPE,
+	                              XMMS_XFORM_PROBE_MIMETYPE,
+	                              XMMS_STREAM_TYPE_END);
+
 	return TRUE;
 }
 
@@ -177,6 +183,11 @@ xmms_segment_init (xmms_xform_t *xform)
 		xmms_xform_metadata_set_int (xform, metakey, stopms - startms);
 	}
 
+	/* the duration is all a probe needs, don't decode up to startms */
+	if (xmms_xform_probing (xform)) {
+		return TRUE;
+	}
+
 	/* some calculation */
 	channels = xmms_xform_indata_get_int (xform, XMMS_STREAM_TYPE_FMT_CHANNELS);
 	fmt = xmms_xform_indata_get_int (xform, XMMS_STREAM_TYPE_FMT_FORMAT);
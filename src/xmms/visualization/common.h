@@ -23,6 +23,8 @@
 #include <xmmspriv/xmms_visualization.h>
 #include <xmmsc/xmmsc_visualization.h>
 
+#include "fft.h"
+
 /**
  * The structures for a vis client
  */
@@ -56,7 +58,9 @@ void cleanup_udp (xmmsc_vis_udp_t *t, xmms_socket_t socket);
 gboolean write_udp (xmmsc_vis_udp_t *t, xmms_vis_client_t *c, int32_t id, struct timeval *time, int channels, int size, short *buf, int socket);
 
 /* provided by format.c */
-void fft_init (void);
+gboolean spectrum_configure (gint size, xmms_vis_window_t window);
+void spectrum_shutdown (void);
+void spectrum_next_chunk (void);
 short fill_buffer (int16_t *dest, xmmsc_vis_properties_t* prop, int channels, int size, short *src);
 
 /* never call a fetch without a guaranteed release following! */
@@ -84,6 +88,9 @@ struct xmms_visualization_St {
 	GMutex clientlock;
 	int32_t clientc;
 	xmms_vis_client_t **clientv;
+
+	xmms_config_property_t *fft_size;
+	xmms_config_property_t *fft_window;
 };
 
 #endif
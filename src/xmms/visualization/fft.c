@@ -0,0 +1,273 @@
+/*  XMMS2 - X Music Multiplexer System
+ *  Copyright (C) 2003-2013 XMMS2 Team
+ *
+ *  PLUGINS ARE NOT CONSIDERED TO BE DERIVED WORK !!!
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ */
+
+/** @file
+ * Windowed real FFT for the spectrum visualization.
+ *
+ * A real input of size n is packed into a complex sequence of size n/2
+ * (even samples real, odd samples imaginary), transformed with an
+ * iterative radix-2 FFT, and split into the spectrum of the real input
+ * afterwards. Window, bit reversal and all twiddle factors are computed
+ * once when the engine is created.
+ */
+
+#include <math.h>
+#include <string.h>
+
+#ifdef __SSE__
+#include <xmmintrin.h>
+#endif
+
+#include "fft.h"
+
+struct xmms_vis_fft_St {
+	gint size;
+
+	gfloat *window;
+	gfloat scale;
+
+	/* complex transform of size / 2, split in real and imaginary part */
+	gfloat *re;
+	gfloat *im;
+	guint *bitrev;
+
+	/* twiddles of the stage with half size h start at index h - 1 */
+	gfloat *tw_re;
+	gfloat *tw_im;
+
+	/* twiddles for splitting the packed transform */
+	gfloat *split_re;
+	gfloat *split_im;
+};
+
+static const struct {
+	const gchar *name;
+	xmms_vis_window_t window;
+} windows[] = {
+	{ "rectangular", XMMS_VIS_WINDOW_RECTANGULAR },
+	{ "hann", XMMS_VIS_WINDOW_HANN },
+	{ "hamming", XMMS_VIS_WINDOW_HAMMING },
+	{ "blackman", XMMS_VIS_WINDOW_BLACKMAN }
+};
+
+gboolean
+xmms_vis_window_from_string (const gchar *name, xmms_vis_window_t *window)
+{
+	gint i;
+
+	for (i = 0; i < G_N_ELEMENTS (windows); i++) {
+		if (!g_ascii_strcasecmp (name, windows[i].name)) {
+			*window = windows[i].window;
+			return TRUE;
+		}
+	}
+
+	return FALSE;
+}
+
+static gdouble
+window_value (xmms_vis_window_t window, gint i, gint n)
+{
+	gdouble x = 2.0 * M_PI * i / n;
+
+	switch (window) {
+		case XMMS_VIS_WINDOW_HANN:
+			return 0.5 - 0.5 * cos (x);
+		case XMMS_VIS_WINDOW_HAMMING:
+			return 0.54 - 0.46 * cos (x);
+		case XMMS_VIS_WINDOW_BLACKMAN:
+			return 0.42 - 0.5 * cos (x) + 0.08 * cos (2.0 * x);
+		default:
+			return 1.0;
+	}
+}
+
+/**
+ * Create an FFT engine for size real samples.
+ *
+ * @param size A power of two, at least 8.
+ * @param window The window applied to the input.
+ */
+xmms_vis_fft_t *
+xmms_vis_fft_new (gint size, xmms_vis_window_t window)
+{
+	xmms_vis_fft_t *fft;
+	gdouble sum = 0.0;
+	gint i, h, bits, half;
+
+	g_return_val_if_fail (size >= 8, NULL);
+	g_return_val_if_fail ((size & (size - 1)) == 0, NULL);
+
+	half = size / 2;
+
+	fft = g_new0 (xmms_vis_fft_t, 1);
+	fft->size = size;
+
+	fft->window = g_new (gfloat, size);
+	for (i = 0; i < size; i++) {
+		fft->window[i] = window_value (window, i, size);
+		sum += fft->window[i];
+	}
+
+	/* a sine of amplitude a ends up at a / 2 for every size and window,
+	 * which is what 2 * |X| / n gives with the hann window */
+	fft->scale = 0.5 / sum;
+
+	fft->re = g_new (gfloat, half);
+	fft->im = g_new (gfloat, half);
+
+	for (bits = 0; (1 << bits) < half; bits++);
+
+	fft->bitrev = g_new (guint, half);
+	for (i = 0; i < half; i++) {
+		guint r = 0;
+		gint b;
+
+		for (b = 0; b < bits; b++) {
+			r |= ((i >> b) & 1) << (bits - 1 - b);
+		}
+		fft->bitrev[i] = r;
+	}
+
+	fft->tw_re = g_new (gfloat, half);
+	fft->tw_im = g_new (gfloat, half);
+	for (h = 1; h < half; h <<= 1) {
+		for (i = 0; i < h; i++) {
+			fft->tw_re[h - 1 + i] = cos (M_PI * i / h);
+			fft->tw_im[h - 1 + i] = -sin (M_PI * i / h);
+		}
+	}
+
+	fft->split_re = g_new (gfloat, half);
+	fft->split_im = g_new (gfloat, half);
+	for (i = 0; i < half; i++) {
+		fft->split_re[i] = cos (2.0 * M_PI * i / size);
+		fft->split_im[i] = -sin (2.0 * M_PI * i / size);
+	}
+
+	return fft;
+}
+
+void
+xmms_vis_fft_free (xmms_vis_fft_t *fft)
+{
+	g_return_if_fail (fft);
+
+	g_free (fft->window);
+	g_free (fft->re);
+	g_free (fft->im);
+	g_free (fft->bitrev);
+	g_free (fft->tw_re);
+	g_free (fft->tw_im);
+	g_free (fft->split_re);
+	g_free (fft->split_im);
+	g_free (fft);
+}
+
+gint
+xmms_vis_fft_size (xmms_vis_fft_t *fft)
+{
+	return fft->size;
+}
+
+static void
+butterflies (xmms_vis_fft_t *fft, gint i, gint h)
+{
+	gfloat *re = fft->re + i, *im = fft->im + i;
+	const gfloat *wr = fft->tw_re + h - 1, *wi = fft->tw_im + h - 1;
+	gint j = 0;
+
+#ifdef __SSE__
+	for (; j + 4 <= h; j += 4) {
+		__m128 ar = _mm_loadu_ps (re + j);
+		__m128 ai = _mm_loadu_ps (im + j);
+		__m128 br = _mm_loadu_ps (re + j + h);
+		__m128 bi = _mm_loadu_ps (im + j + h);
+		__m128 cr = _mm_loadu_ps (wr + j);
+		__m128 ci = _mm_loadu_ps (wi + j);
+		__m128 tr, ti;
+
+		tr = _mm_sub_ps (_mm_mul_ps (br, cr), _mm_mul_ps (bi, ci));
+		ti = _mm_add_ps (_mm_mul_ps (br, ci), _mm_mul_ps (bi, cr));
+
+		_mm_storeu_ps (re + j + h, _mm_sub_ps (ar, tr));
+		_mm_storeu_ps (im + j + h, _mm_sub_ps (ai, ti));
+		_mm_storeu_ps (re + j, _mm_add_ps (ar, tr));
+		_mm_storeu_ps (im + j, _mm_add_ps (ai, ti));
+	}
+#endif
+
+	for (; j < h; j++) {
+		gfloat tr = re[j + h] * wr[j] - im[j + h] * wi[j];
+		gfloat ti = re[j + h] * wi[j] + im[j + h] * wr[j];
+
+		re[j + h] = re[j] - tr;
+		im[j + h] = im[j] - ti;
+		re[j] += tr;
+		im[j] += ti;
+	}
+}
+
+/**
+ * Compute the magnitude spectrum of size real samples.
+ *
+ * @param in The samples, size values.
+ * @param spec Receives the magnitudes of the first size / 2 bins.
+ */
+void
+xmms_vis_fft_spectrum (xmms_vis_fft_t *fft, const gfloat *in, gfloat *spec)
+{
+	gfloat *re = fft->re, *im = fft->im;
+	const gfloat *w = fft->window;
+	gint half = fft->size / 2;
+	gint i, h;
+
+	for (i = 0; i < half; i++) {
+		guint r = fft->bitrev[i];
+
+		re[r] = in[2 * i] * w[2 * i];
+		im[r] = in[2 * i + 1] * w[2 * i + 1];
+	}
+
+	for (h = 1; h < half; h <<= 1) {
+		for (i = 0; i < half; i += 2 * h) {
+			butterflies (fft, i, h);
+		}
+	}
+
+	/* the DC bin is the sum of both halves of the packed transform,
+	 * scaled like the others as the old spectrum did */
+	spec[0] = 2.0f * fabsf (re[0] + im[0]) * fft->scale;
+
+	for (i = 1; i < half; i++) {
+		/* a = Z[i], b = conj (Z[half - i]) */
+		gfloat ar = re[i], ai = im[i];
+		gfloat br = re[half - i], bi = -im[half - i];
+		gfloat er, ei, or, oi, xr, xi;
+
+		/* even part (a + b) / 2, odd part (a - b) / 2i */
+		er = 0.5f * (ar + br);
+		ei = 0.5f * (ai + bi);
+		or = 0.5f * (ai - bi);
+		oi = -0.5f * (ar - br);
+
+		xr = er + or * fft->split_re[i] - oi * fft->split_im[i];
+		xi = ei + or * fft->split_im[i] + oi * fft->split_re[i];
+
+		/* both sides of the spectrum contribute */
+		spec[i] = 2.0f * sqrtf (xr * xr + xi * xi) * fft->scale;
+	}
+}
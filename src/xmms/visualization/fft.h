@@ -0,0 +1,38 @@
+/*  XMMS2 - X Music Multiplexer System
+ *  Copyright (C) 2003-2013 XMMS2 Team
+ *
+ *  PLUGINS ARE NOT CONSIDERED TO BE DERIVED WORK !!!
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ */
+
+#ifndef __VISUALIZATION_FFT_H__
+#define __VISUALIZATION_FFT_H__
+
+#include <glib.h>
+
+typedef enum {
+	XMMS_VIS_WINDOW_RECTANGULAR,
+	XMMS_VIS_WINDOW_HANN,
+	XMMS_VIS_WINDOW_HAMMING,
+	XMMS_VIS_WINDOW_BLACKMAN
+} xmms_vis_window_t;
+
+typedef struct xmms_vis_fft_St xmms_vis_fft_t;
+
+xmms_vis_fft_t *xmms_vis_fft_new (gint size, xmms_vis_window_t window);
+void xmms_vis_fft_free (xmms_vis_fft_t *fft);
+gint xmms_vis_fft_size (xmms_vis_fft_t *fft);
+void xmms_vis_fft_spectrum (xmms_vis_fft_t *fft, const gfloat *in, gfloat *spec);
+
+gboolean xmms_vis_window_from_string (const gchar *name, xmms_vis_window_t *window);
+
+#endif
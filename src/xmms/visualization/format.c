@@ -1,147 +1,157 @@
 #include <math.h>
+#include <string.h>
 #include "common.h"
 
-#define FFT_LEN XMMSC_VISUALIZATION_WINDOW_SIZE
-/* TODO: better way, check this! */
-#define FFT_BITS 9
+#define SPEC_BINS (XMMSC_VISUALIZATION_WINDOW_SIZE / 2)
 
 /* Log scale settings */
 #define AMP_LOG_SCALE_THRESHOLD0	0.001f
 #define AMP_LOG_SCALE_DIVISOR		6.908f	/* divisor = -log threshold */
 #define FREQ_LOG_SCALE_BASE		2.0f
 
-static gfloat window[FFT_LEN];
-static gfloat spec[FFT_LEN/2];
-static gboolean fft_ready = FALSE;
-static gboolean fft_done;
+/**
+ * The spectrum is the same for every client, so it is computed once per
+ * chunk, the first time a client asks for it. All of this is protected
+ * by the clientlock.
+ */
+static struct {
+	xmms_vis_fft_t *fft;
+
+	/* the last fft size mono samples, oldest first from pos */
+	gfloat *history;
+	gint pos;
+
+	gfloat *input;
+	gfloat *spec;
+
+	gboolean done;
+	int16_t result[SPEC_BINS];
+} spectrum;
 
-void fft_init ()
+/**
+ * (Re)create the FFT engine. Larger sizes are folded down to the
+ * SPEC_BINS values sent to the clients.
+ */
+gboolean
+spectrum_configure (gint size, xmms_vis_window_t window)
 {
-	if (!fft_ready) {
-		int i;
-		/* calculate Hann window used to reduce spectral leakage */
-		for (i = 0; i < FFT_LEN; i++) {
-			window[i] = 0.5 - 0.5 * cos (2.0 * M_PI * i / FFT_LEN);
-		}
-		fft_done = TRUE;
+	xmms_vis_fft_t *fft;
+
+	if (size < XMMSC_VISUALIZATION_WINDOW_SIZE || (size & (size - 1))) {
+		return FALSE;
+	}
+
+	fft = xmms_vis_fft_new (size, window);
+	if (!fft) {
+		return FALSE;
+	}
+
+	spectrum_shutdown ();
+
+	spectrum.fft = fft;
+	spectrum.history = g_new0 (gfloat, size);
+	spectrum.input = g_new (gfloat, size);
+	spectrum.spec = g_new (gfloat, size / 2);
+	spectrum.pos = 0;
+	spectrum.done = FALSE;
+
+	return TRUE;
+}
+
+void
+spectrum_shutdown (void)
+{
+	if (spectrum.fft) {
+		xmms_vis_fft_free (spectrum.fft);
+		g_free (spectrum.history);
+		g_free (spectrum.input);
+		g_free (spectrum.spec);
+		spectrum.fft = NULL;
 	}
-	fft_done = FALSE;
+}
+
+/**
+ * Invalidate the spectrum, a new chunk is about to be sent.
+ */
+void
+spectrum_next_chunk (void)
+{
+	spectrum.done = FALSE;
 }
 
 /* interesting:	data->value.uint32 = xmms_sample_samples_to_ms (vis->format, pos); */
 
 static void
-fft (short *samples, gfloat *spec)
+spectrum_compute (int channels, int size, short *samples)
 {
-	gint nv2, k, l, j = 0, i;
-	gfloat t_r, t_i;
-	gfloat buf[FFT_LEN][2];
-
-	for (i = 0; i < FFT_LEN; i++){
-		buf[i][0]  = (float) samples[j++];
-		buf[i][0] += (float) samples[j++];
-		buf[i][0] /= (float) (1 << 17);
-		buf[i][0] *= window[i];
-		buf[i][1] = 0.0f;
+	gint n = xmms_vis_fft_size (spectrum.fft);
+	gint frames = size / channels;
+	gint i, c, group;
+
+	/* keep the downmixed samples, enough for one fft */
+	if (frames > n) {
+		samples += (frames - n) * channels;
+		frames = n;
 	}
 
-	/* reorder... */  /* this is crappy! Go rewrite it using real bitreversing */
-	nv2 = FFT_LEN / 2;
-	j = 1;
-
-	for (i = 1; i < FFT_LEN; i++) {
-		if (i < j) {
-			t_r = buf[i - 1][0];
-			t_i = buf[i - 1][1];
-			buf[i - 1][0] = buf[j - 1][0];
-			buf[i - 1][1] = buf[j - 1][1];
-			buf[j - 1][0] = t_r;
-			buf[j - 1][1] = t_i;
-		}
-
-		k = nv2;
+	for (i = 0; i < frames; i++) {
+		gint sum = 0;
 
-		while (k < j) {
-			j -= k;
-			k >>= 1;
+		for (c = 0; c < channels; c++) {
+			sum += *samples++;
 		}
 
-		j += k;
+		/* same level as the old (left + right) / 2^17 */
+		spectrum.history[spectrum.pos] = sum / (channels * 65536.0f);
+		spectrum.pos = (spectrum.pos + 1) & (n - 1);
 	}
 
-	/* do fft */
-	for (l = 1; l <= FFT_BITS; l++) {
-		gint le = 1 << l;
-		gint le1 = le / 2;
-		gfloat u_r = 1.0;
-		gfloat u_i = 0.0;
-		gfloat w_r =  cosf (M_PI / (float) le1);
-		gfloat w_i = -sinf (M_PI / (float) le1);
+	memcpy (spectrum.input, spectrum.history + spectrum.pos,
+	        (n - spectrum.pos) * sizeof (gfloat));
+	memcpy (spectrum.input + n - spectrum.pos, spectrum.history,
+	        spectrum.pos * sizeof (gfloat));
 
-		for (j = 1; j <= le1; j++) {
-			for (i = j; i <= FFT_LEN; i += le) {
-				gint ip = i + le1;
+	xmms_vis_fft_spectrum (spectrum.fft, spectrum.input, spectrum.spec);
 
-				t_r = buf[ip - 1][0] * u_r - u_i * buf[ip - 1][1];
-				t_i = buf[ip - 1][1] * u_r + u_i * buf[ip - 1][0];
+	group = n / 2 / SPEC_BINS;
 
-				buf[ip - 1][0] = buf[i - 1][0] - t_r;
-				buf[ip - 1][1] = buf[i - 1][1] - t_i;
-
-				buf[i - 1][0] =  buf[i - 1][0] + t_r;
-				buf[i - 1][1] =  buf[i - 1][1] + t_i;
-			}
+	/* TODO: more sophisticated! */
+	for (i = 0; i < SPEC_BINS; i++) {
+		gfloat tmp = spectrum.spec[i * group];
 
-			t_r = u_r * w_r - w_i * u_i;
-			u_i = w_r * u_i + w_i * u_r;
-			u_r = t_r;
+		for (c = 1; c < group; c++) {
+			tmp = MAX (tmp, spectrum.spec[i * group + c]);
 		}
-	}
 
-	/* output abs-value instead */
-	for (i = 0; i < nv2; i++) {
-		spec[i] = 2 * hypot (buf[i][0], buf[i][1]) / FFT_LEN;
+		if (tmp >= 1.0) {
+			spectrum.result[i] = htons (SHRT_MAX);
+		} else if (tmp > AMP_LOG_SCALE_THRESHOLD0) {
+//			tmp = 1.0f + (logf (tmp) /  AMP_LOG_SCALE_DIVISOR);
+			spectrum.result[i] = htons ((int16_t)(tmp * SHRT_MAX));
+		} else {
+			spectrum.result[i] = 0;
+		}
 	}
-
-	/* correct the scale */
-	spec[nv2 - 1] /= 2;
 }
 
 /**
- * Calcualte the FFT on the decoded data buffer.
+ * Fill in the spectrum of the current chunk.
  */
 static short
-fill_buffer_fft (int16_t* dest, int size, short *src)
+fill_buffer_fft (int16_t* dest, int channels, int size, short *src)
 {
-	int i;
-	float tmp;
-
-	if (size != FFT_LEN * 2) {
+	if (!spectrum.fft || channels < 1) {
 		return 0;
 	}
 
-	if (!fft_done) {
-		fft (src, spec);
-		fft_done = TRUE;
+	if (!spectrum.done) {
+		spectrum_compute (channels, size, src);
+		spectrum.done = TRUE;
 	}
 
-	/* TODO: more sophisticated! */
-	for (i = 0; i < FFT_LEN / 2; ++i) {
-		if (spec[i] >= 1.0) {
-			dest[i] = htons (SHRT_MAX);
-		} else if (spec[i] < 0.0) {
-			dest[i] = 0;
-		} else {
-			tmp = spec[i];
-			if (tmp > AMP_LOG_SCALE_THRESHOLD0) {
-//				tmp = 1.0f + (logf (tmp) /  AMP_LOG_SCALE_DIVISOR);
-			} else {
-				tmp = 0.0f;
-			}
-			dest[i] = htons ((int16_t)(tmp * SHRT_MAX));
-		}
-	}
-	return FFT_LEN / 2;
+	memcpy (dest, spectrum.result, sizeof (spectrum.result));
+
+	return SPEC_BINS;
 }
 
 short
@@ -203,7 +213,7 @@ fill_buffer (int16_t *dest, xmmsc_vis_properties_t* prop, int channels, int size
 		}
 	}
 	if (prop->type == VIS_SPECTRUM) {
-		size = fill_buffer_fft (dest, size, src);
+		size = fill_buffer_fft (dest, channels, size, src);
 	}
 	return size;
 }
@@ -19,6 +19,7 @@
 #include <stdlib.h>
 
 #include <xmms/xmms_object.h>
+#include <xmmspriv/xmms_config.h>
 #include <xmmspriv/xmms_ipc.h>
 #include <xmmspriv/xmms_sample.h>
 
@@ -40,6 +41,7 @@ static int32_t xmms_visualization_client_set_property (xmms_visualization_t *vis
 static int32_t xmms_visualization_client_set_properties (xmms_visualization_t *vis, int32_t id, xmmsv_t *prop, xmms_error_t *err);
 static void xmms_visualization_client_shutdown (xmms_visualization_t *vis, int32_t id, xmms_error_t *err);
 static void xmms_visualization_destroy (xmms_object_t *object);
+static void xmms_visualization_spectrum_changed (xmms_object_t *object, xmmsv_t *data, gpointer userdata);
 
 #include "visualization/object_ipc.c"
 
@@ -123,9 +125,48 @@ xmms_visualization_new (xmms_output_t *output)
 
 	xmms_socket_invalidate (&vis->socket);
 
+	vis->fft_size = xmms_config_property_register ("visualization.fft_size", "512",
+	                                               xmms_visualization_spectrum_changed,
+	                                               vis);
+	vis->fft_window = xmms_config_property_register ("visualization.fft_window", "hann",
+	                                                 xmms_visualization_spectrum_changed,
+	                                                 vis);
+	xmms_visualization_spectrum_changed (NULL, NULL, vis);
+
 	return vis;
 }
 
+/**
+ * Set up the spectrum analyzer from the configuration, falling back to
+ * the defaults on values that don't make sense.
+ */
+static void
+xmms_visualization_spectrum_changed (xmms_object_t *object, xmmsv_t *data,
+                                     gpointer userdata)
+{
+	xmms_visualization_t *vis = (xmms_visualization_t *) userdata;
+	xmms_vis_window_t window;
+	const gchar *name;
+	gint size;
+
+	size = xmms_config_property_get_int (vis->fft_size);
+	name = xmms_config_property_get_string (vis->fft_window);
+
+	if (!xmms_vis_window_from_string (name, &window)) {
+		xmms_log_error ("Unknown visualization.fft_window '%s', using hann", name);
+		window = XMMS_VIS_WINDOW_HANN;
+	}
+
+	g_mutex_lock (&vis->clientlock);
+	if (!spectrum_configure (size, window)) {
+		xmms_log_error ("Invalid visualization.fft_size %d, must be a power "
+		                "of two of at least %d", size,
+		                XMMSC_VISUALIZATION_WINDOW_SIZE);
+		spectrum_configure (XMMSC_VISUALIZATION_WINDOW_SIZE, window);
+	}
+	g_mutex_unlock (&vis->clientlock);
+}
+
 /**
  * Free all resoures used by visualization module.
  * TODO: Fill this in properly, unregister etc!
@@ -138,6 +179,13 @@ xmms_visualization_destroy (xmms_object_t *object)
 
 	xmms_object_unref (vis->output);
 
+	xmms_config_property_callback_remove (vis->fft_size,
+	                                      xmms_visualization_spectrum_changed,
+	                                      vis);
+	xmms_config_property_callback_remove (vis->fft_window,
+	                                      xmms_visualization_spectrum_changed,
+	                                      vis);
+
 	/* TODO: assure that the xform is already dead! */
 	g_mutex_clear (&vis->clientlock);
 	xmms_log_debug ("starting cleanup of %d vis clients", vis->clientc);
@@ -145,6 +193,8 @@ xmms_visualization_destroy (xmms_object_t *object)
 		delete_client (vis->clientc - 1);
 	}
 
+	spectrum_shutdown ();
+
 	if (xmms_socket_valid (vis->socket)) {
 		/* it seems there is no way to remove the watch */
 		g_io_channel_shutdown (vis->socketio, FALSE, NULL);
@@ -326,8 +376,6 @@ send_data (int channels, int size, short *buf)
 
 	latency = xmms_output_latency (vis->output);
 
-	fft_init ();
-
 	gettimeofday (&time, NULL);
 	time.tv_sec += (latency / 1000);
 	time.tv_usec += (latency % 1000) * 1000;
@@ -337,6 +385,7 @@ send_data (int channels, int size, short *buf)
 	}
 
 	g_mutex_lock (&vis->clientlock);
+	spectrum_next_chunk ();
 	for (i = 0; i < vis->clientc; ++i) {
 		if (vis->clientv[i]) {
 			package_write (vis->clientv[i], i, &time, channels, size, buf);
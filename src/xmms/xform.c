@@ -92,11 +92,13 @@ xmms_xform_t *xmms_xform_find (xmms_xform_t *prev, xmms_medialib_entry_t entry,
 const char *xmms_xform_shortname (xmms_xform_t *xform);
 static xmms_xform_t *add_effects (xmms_xform_t *last,
                                   xmms_medialib_entry_t entry,
-                                  GList *goal_formats);
+                                  GList *goal_formats,
+                                  gboolean float_pipeline);
 static xmms_xform_t *xmms_xform_new_effect (xmms_xform_t* last,
                                             xmms_medialib_entry_t entry,
                                             GList *goal_formats,
-                                            const gchar *name);
+                                            const gchar *name,
+                                            gboolean float_pipeline);
 static void xmms_xform_destroy (xmms_object_t *object);
 static void effect_callbacks_init (void);
 
@@ -339,6 +341,8 @@ xmms_xform_object_init ()
 
 	xmms_xform_register_ipc_commands (XMMS_OBJECT (obj));
 
+	xmms_config_property_register ("effect.float_pipeline", "0", NULL, NULL);
+
 	effect_callbacks_init ();
 
 	return obj;
@@ -607,9 +611,29 @@ xmms_xform_metadata_get_str (xmms_xform_t *xform, const char *key,
 typedef struct {
 	xmms_medialib_entry_t entry;
 	xmms_medialib_session_t *session;
+	xmmsv_t *properties;
 	gchar *source;
 } metadata_festate_t;
 
+/* values written and left as they were by all metadata collections */
+static gint metadata_written;
+static gint metadata_skipped;
+
+static void
+metadata_festate_add (metadata_festate_t *st, const gchar *key,
+                      const gchar *source, xmmsv_t *value)
+{
+	xmmsv_t *sources;
+
+	if (!xmmsv_dict_get (st->properties, key, &sources)) {
+		sources = xmmsv_new_dict ();
+		xmmsv_dict_set (st->properties, key, sources);
+		xmmsv_unref (sources);
+	}
+
+	xmmsv_dict_set (sources, source, value);
+}
+
 static void
 add_metadatum (gpointer _key, gpointer _value, gpointer user_data)
 {
@@ -617,25 +641,7 @@ add_metadatum (gpointer _key, gpointer _value, gpointer user_data)
 	gchar *key = (gchar *) _key;
 	metadata_festate_t *st = (metadata_festate_t *) user_data;
 
-	if (xmmsv_get_type (value) == XMMSV_TYPE_STRING) {
-		const gchar *s;
-		xmmsv_get_string (value, &s);
-		xmms_medialib_entry_property_set_str_source (st->session,
-		                                             st->entry,
-		                                             key,
-		                                             s,
-		                                             st->source);
-	} else if (xmmsv_get_type (value) == XMMSV_TYPE_INT32) {
-		gint i;
-		xmmsv_get_int (value, &i);
-		xmms_medialib_entry_property_set_int_source (st->session,
-		                                             st->entry,
-		                                             key,
-		                                             i,
-		                                             st->source);
-	} else {
-		XMMS_DBG ("Unknown type?!?");
-	}
+	metadata_festate_add (st, key, st->source, value);
 }
 
 static void
@@ -683,13 +689,15 @@ xmms_xform_metadata_collect (xmms_medialib_session_t *session,
                              gboolean rehashing)
 {
 	metadata_festate_t info;
+	guint written, skipped;
 	gint times_played;
 	gint last_started;
 	GTimeVal now;
+	xmmsv_t *value;
 
 	info.entry = start->entry;
-
 	info.session = session;
+	info.properties = xmmsv_new_dict ();
 	times_played = xmms_medialib_entry_property_get_int (session, info.entry,
 	                                                     XMMS_MEDIALIB_ENTRY_PROPERTY_TIMESPLAYED);
 
@@ -703,28 +711,60 @@ xmms_xform_metadata_collect (xmms_medialib_session_t *session,
 	last_started = xmms_medialib_entry_property_get_int (session, info.entry,
 	                                                     XMMS_MEDIALIB_ENTRY_PROPERTY_LASTSTARTED);
 
-	xmms_medialib_entry_cleanup (session, info.entry);
-
 	xmms_xform_metadata_collect_r (start, &info, namestr);
 
-	xmms_medialib_entry_property_set_str (session, info.entry,
-	                                      XMMS_MEDIALIB_ENTRY_PROPERTY_CHAIN,
-	                                      namestr->str);
+	value = xmmsv_new_string (namestr->str);
+	metadata_festate_add (&info, XMMS_MEDIALIB_ENTRY_PROPERTY_CHAIN,
+	                      "server", value);
+	xmmsv_unref (value);
 
-	xmms_medialib_entry_property_set_int (session, info.entry,
-	                                      XMMS_MEDIALIB_ENTRY_PROPERTY_TIMESPLAYED,
-	                                      times_played + (rehashing ? 0 : 1));
+	value = xmmsv_new_int (times_played + (rehashing ? 0 : 1));
+	metadata_festate_add (&info, XMMS_MEDIALIB_ENTRY_PROPERTY_TIMESPLAYED,
+	                      "server", value);
+	xmmsv_unref (value);
 
 	if (!rehashing || (rehashing && last_started)) {
 		g_get_current_time (&now);
 
-		xmms_medialib_entry_property_set_int (session, info.entry,
-		                                      XMMS_MEDIALIB_ENTRY_PROPERTY_LASTSTARTED,
-		                                      (rehashing ? last_started : now.tv_sec));
+		value = xmmsv_new_int (rehashing ? last_started : now.tv_sec);
+		metadata_festate_add (&info, XMMS_MEDIALIB_ENTRY_PROPERTY_LASTSTARTED,
+		                      "server", value);
+		xmmsv_unref (value);
 	}
 
-	xmms_medialib_entry_status_set (session, info.entry,
-	                                XMMS_MEDIALIB_ENTRY_STATUS_OK);
+	value = xmmsv_new_int (XMMS_MEDIALIB_ENTRY_STATUS_OK);
+	metadata_festate_add (&info, XMMS_MEDIALIB_ENTRY_PROPERTY_STATUS,
+	                      "server", value);
+	xmmsv_unref (value);
+
+	/* Derived properties the chain no longer provides are dropped here,
+	 * everything already stored with the same value is left untouched. */
+	xmms_medialib_entry_properties_set (session, info.entry, info.properties,
+	                                    TRUE, &written, &skipped);
+	xmmsv_unref (info.properties);
+
+	g_atomic_int_add (&metadata_written, written);
+	g_atomic_int_add (&metadata_skipped, skipped);
+
+	XMMS_DBG ("Collected metadata for entry %d, %u properties written, "
+	          "%u unchanged", info.entry, written, skipped);
+}
+
+/**
+ * Get how many collected metadata values have been written to the
+ * medialib, and how many were left alone because they were stored
+ * already.
+ *
+ * @return A dict with the counts as "written" and "skipped".
+ */
+xmmsv_t *
+xmms_xform_metadata_stats (void)
+{
+	return xmmsv_build_dict (XMMSV_DICT_ENTRY_INT ("written",
+	                                               g_atomic_int_get (&metadata_written)),
+	                         XMMSV_DICT_ENTRY_INT ("skipped",
+	                                               g_atomic_int_get (&metadata_skipped)),
+	                         XMMSV_DICT_END);
 }
 
 static void
@@ -740,8 +780,14 @@ xmms_xform_metadata_update (xmms_xform_t *xform)
 
 		info.entry = xform->entry;
 		info.session = session;
+		info.properties = xmmsv_new_dict ();
 
 		xmms_xform_metadata_collect_one (xform, &info);
+
+		xmms_medialib_entry_properties_set (session, info.entry,
+		                                    info.properties, FALSE,
+		                                    NULL, NULL);
+		xmmsv_unref (info.properties);
 	} while (!xmms_medialib_session_commit (session));
 }
 
@@ -1265,6 +1311,69 @@ has_goalformat (xmms_xform_t *xform, GList *goal_formats)
 	return ret;
 }
 
+gboolean
+xmms_xform_probing (xmms_xform_t *xform)
+{
+	GList *n;
+
+	g_return_val_if_fail (xform, FALSE);
+
+	for (n = xform->goal_hints; n; n = g_list_next (n)) {
+		const gchar *mime;
+
+		mime = xmms_stream_type_get_str (n->data, XMMS_STREAM_TYPE_MIMETYPE);
+		if (mime && strcmp (mime, XMMS_XFORM_PROBE_MIMETYPE) == 0) {
+			return TRUE;
+		}
+	}
+
+	return FALSE;
+}
+
+gboolean
+xmms_xform_probe_finish (xmms_xform_t *xform, xmms_sample_format_t format)
+{
+	xmms_stream_type_t *type;
+	match_state_t state;
+
+	g_return_val_if_fail (xform, FALSE);
+	g_return_val_if_fail (xform->out_type, FALSE);
+
+	if (format == XMMS_SAMPLE_FORMAT_UNKNOWN) {
+		return FALSE;
+	}
+
+	/* the decoder xmms_xform_find would pick, were it decoding */
+	state.out_type = xform->out_type;
+	state.match = NULL;
+	state.priority = -1;
+
+	xmms_plugin_foreach (XMMS_PLUGIN_TYPE_XFORM, xmms_xform_match, &state);
+
+	if (!state.match) {
+		XMMS_DBG ("Nothing decodes the stream, not ending the chain here");
+		return FALSE;
+	}
+
+	type = _xmms_stream_type_new (XMMS_STREAM_TYPE_BEGIN,
+	                              XMMS_STREAM_TYPE_MIMETYPE,
+	                              XMMS_XFORM_PROBE_MIMETYPE,
+	                              XMMS_STREAM_TYPE_FMT_FORMAT,
+	                              format,
+	                              XMMS_STREAM_TYPE_FMT_CHANNELS,
+	                              xmms_stream_type_get_int (xform->out_type,
+	                                                        XMMS_STREAM_TYPE_FMT_CHANNELS),
+	                              XMMS_STREAM_TYPE_FMT_SAMPLERATE,
+	                              xmms_stream_type_get_int (xform->out_type,
+	                                                        XMMS_STREAM_TYPE_FMT_SAMPLERATE),
+	                              XMMS_STREAM_TYPE_END);
+
+	xmms_object_unref (xform->out_type);
+	xform->out_type = type;
+
+	return TRUE;
+}
+
 static void
 outdata_type_metadata_collect (xmms_xform_t *xform)
 {
@@ -1272,9 +1381,11 @@ outdata_type_metadata_collect (xmms_xform_t *xform)
 	const char *mime;
 	xmms_stream_type_t *type;
 
+	/* a probing chain keeps the format found by its last xform */
 	type = xform->out_type;
 	mime = xmms_stream_type_get_str (type, XMMS_STREAM_TYPE_MIMETYPE);
-	if (strcmp (mime, "audio/pcm") != 0) {
+	if (strcmp (mime, "audio/pcm") != 0 &&
+	    strcmp (mime, XMMS_XFORM_PROBE_MIMETYPE) != 0) {
 		return;
 	}
 
@@ -1301,17 +1412,52 @@ outdata_type_metadata_collect (xmms_xform_t *xform)
 	}
 }
 
-static xmms_xform_t *
-chain_setup (xmms_medialib_t *medialib, xmms_medialib_entry_t entry,
-             const gchar *url, GList *goal_formats)
+/**
+ * Remember that no chain could be set up for a file, along with its
+ * fingerprint, so that it isn't probed or imported again until it
+ * changes.
+ *
+ * Only files that were read are remembered, anything else may well work
+ * the next time.
+ */
+static void
+chain_failure_record (xmms_medialib_t *medialib, xmms_xform_t *last,
+                      const gchar *url)
 {
-	xmms_xform_t *xform, *last;
-	gchar *durl, *args;
+	const gchar *fingerprint;
+	xmms_xform_t *xform;
+	GString *namestr;
 
-	if (!entry) {
-		entry = 1; /* FIXME: this is soooo ugly, don't do this */
+	if (!xmms_xform_metadata_get_str (last, XMMS_MEDIALIB_ENTRY_PROPERTY_FINGERPRINT,
+	                                  &fingerprint)) {
+		return;
+	}
+
+	namestr = g_string_new ("");
+	for (xform = last; xform; xform = xform->prev) {
+		if (xform->plugin) {
+			if (namestr->len) {
+				g_string_prepend_c (namestr, ':');
+			}
+			g_string_prepend (namestr, xmms_xform_shortname (xform));
+		}
 	}
 
+	xmms_medialib_unplayable_add (xmms_medialib_get_unplayable (medialib),
+	                              url, fingerprint, namestr->str);
+
+	g_string_free (namestr, TRUE);
+}
+
+/**
+ * Create the start of a chain, which outputs the url to read.
+ */
+static xmms_xform_t *
+chain_start (xmms_medialib_t *medialib, const gchar *url, GList *goal_formats)
+{
+	xmms_xform_t *xform;
+	gchar *durl, *args;
+
 	xform = xmms_xform_new (NULL, NULL, medialib , 0, goal_formats);
 
 	durl = g_strdup (url);
@@ -1347,13 +1493,76 @@ chain_setup (xmms_medialib_t *medialib, xmms_medialib_entry_t entry,
 
 	g_free (durl);
 
-	last = xform;
+	return xform;
+}
+
+/**
+ * Check whether no chain could be set up the last time the file was
+ * read, and neither the file nor the plugins changed since.
+ *
+ * Only the transport is set up to get the current fingerprint of the
+ * file, and only when there is a record for it.
+ */
+static gboolean
+chain_known_unplayable (xmms_medialib_t *medialib, xmms_medialib_entry_t entry,
+                        const gchar *url)
+{
+	xmms_medialib_unplayable_t *unplayable;
+	const gchar *fingerprint;
+	xmms_xform_t *start, *transport;
+	gboolean ret = FALSE;
+
+	unplayable = xmms_medialib_get_unplayable (medialib);
+	if (!xmms_medialib_unplayable_contains (unplayable, url)) {
+		return FALSE;
+	}
+
+	if (!entry) {
+		entry = 1; /* FIXME: see chain_setup */
+	}
+
+	start = chain_start (medialib, url, NULL);
+	transport = xmms_xform_find (start, entry, NULL);
+	xmms_object_unref (start);
+
+	if (!transport) {
+		/* gone, or it can't be told whether it changed */
+		xmms_medialib_unplayable_remove (unplayable, url);
+		return FALSE;
+	}
+
+	if (xmms_xform_metadata_get_str (transport, XMMS_MEDIALIB_ENTRY_PROPERTY_FINGERPRINT,
+	                                 &fingerprint)) {
+		ret = xmms_medialib_unplayable_lookup (unplayable, url, fingerprint);
+	} else {
+		xmms_medialib_unplayable_remove (unplayable, url);
+	}
+
+	xmms_object_unref (transport);
+
+	return ret;
+}
+
+static xmms_xform_t *
+chain_setup (xmms_medialib_t *medialib, xmms_medialib_entry_t entry,
+             const gchar *url, GList *goal_formats, gboolean remember)
+{
+	xmms_xform_t *xform, *last;
+
+	if (!entry) {
+		entry = 1; /* FIXME: this is soooo ugly, don't do this */
+	}
+
+	last = chain_start (medialib, url, goal_formats);
 
 	do {
 		xform = xmms_xform_find (last, entry, goal_formats);
 		if (!xform) {
 			xmms_log_error ("Couldn't set up chain for '%s' (%d)",
 			                url, entry);
+			if (remember) {
+				chain_failure_record (medialib, last, url);
+			}
 			xmms_object_unref (last);
 
 			return NULL;
@@ -1426,6 +1635,13 @@ xmms_xform_chain_setup_session (xmms_medialib_t *medialib,
 		return NULL;
 	}
 
+	if (chain_known_unplayable (medialib, entry, url)) {
+		XMMS_DBG ("Not setting up chain for '%s' (%d), it didn't work "
+		          "before and nothing changed since", url, entry);
+		g_free (url);
+		return NULL;
+	}
+
 	xform = xmms_xform_chain_setup_url_session (medialib, session, entry,
 	                                            url, goal_formats, rehash);
 	g_free (url);
@@ -1433,23 +1649,141 @@ xmms_xform_chain_setup_session (xmms_medialib_t *medialib,
 	return xform;
 }
 
+/**
+ * Check whether effects should be run on float samples.
+ *
+ * When enabled the decoder output is converted to float once, all effects
+ * operate on float and a single conversion to the output format is done
+ * at the end of the chain.
+ */
+static gboolean
+float_pipeline_enabled (void)
+{
+	xmms_config_property_t *cfg;
+
+	cfg = xmms_config_lookup ("effect.float_pipeline");
+	if (!cfg) {
+		return FALSE;
+	}
+
+	return !!xmms_config_property_get_int (cfg);
+}
+
+static xmms_stream_type_t *
+pcm_stream_type_new (xmms_xform_t *xform, xmms_sample_format_t format)
+{
+	gint channels, samplerate;
+
+	channels = xmms_stream_type_get_int (xform->out_type,
+	                                     XMMS_STREAM_TYPE_FMT_CHANNELS);
+	samplerate = xmms_stream_type_get_int (xform->out_type,
+	                                       XMMS_STREAM_TYPE_FMT_SAMPLERATE);
+
+	return _xmms_stream_type_new (XMMS_STREAM_TYPE_BEGIN,
+	                              XMMS_STREAM_TYPE_MIMETYPE, "audio/pcm",
+	                              XMMS_STREAM_TYPE_FMT_FORMAT, format,
+	                              XMMS_STREAM_TYPE_FMT_CHANNELS, channels,
+	                              XMMS_STREAM_TYPE_FMT_SAMPLERATE, samplerate,
+	                              XMMS_STREAM_TYPE_END);
+}
+
+/**
+ * Convert the output of last to one of to_formats, unless it already
+ * is in one of them.
+ */
+static xmms_xform_t *
+add_conversion (xmms_xform_t *last, xmms_medialib_entry_t entry,
+                GList *to_formats, GList *goal_formats)
+{
+	xmms_xform_t *xform;
+
+	if (has_goalformat (last, to_formats)) {
+		return last;
+	}
+
+	xform = xmms_converter_new (last, last->medialib, entry, to_formats);
+	xmms_object_unref (last);
+
+	if (!xform) {
+		xmms_log_error ("Couldn't convert to any of %d formats",
+		                g_list_length (to_formats));
+		return NULL;
+	}
+
+	/* to_formats is only needed while the converter is initialized */
+	xform->goal_hints = goal_formats;
+
+	return xform;
+}
+
+static xmms_xform_t *
+add_float_conversion (xmms_xform_t *last, xmms_medialib_entry_t entry,
+                      GList *goal_formats)
+{
+	xmms_stream_type_t *type;
+	GList *formats;
+
+	type = pcm_stream_type_new (last, XMMS_SAMPLE_FORMAT_FLOAT);
+	formats = g_list_prepend (NULL, type);
+
+	last = add_conversion (last, entry, formats, goal_formats);
+
+	g_list_free (formats);
+	xmms_object_unref (type);
+
+	return last;
+}
+
 xmms_xform_t *
 xmms_xform_chain_setup_url_session (xmms_medialib_t *medialib,
                                     xmms_medialib_session_t *session,
                                     xmms_medialib_entry_t entry, const gchar *url,
                                     GList *goal_formats, gboolean rehash)
 {
-	xmms_xform_t *last;
+	xmms_xform_t *last, *xform;
 	xmms_plugin_t *plugin;
 	xmms_xform_plugin_t *xform_plugin;
+	xmms_stream_type_t *pcm_type = NULL;
+	GList *decode_formats = goal_formats;
 	gboolean add_segment = FALSE;
+	gboolean float_pipeline, remember;
 	gint priority;
 
-	last = chain_setup (medialib, entry, url, goal_formats);
+	float_pipeline = !rehash && float_pipeline_enabled ();
+
+	/* only failures of the mediainfo reader are remembered, one during
+	 * playback says little about the file itself */
+	remember = rehash && entry != 0;
+
+	/* stop right after the decoder, so that the samples are converted
+	 * to float only once */
+	if (float_pipeline) {
+		pcm_type = _xmms_stream_type_new (XMMS_STREAM_TYPE_BEGIN,
+		                                  XMMS_STREAM_TYPE_MIMETYPE,
+		                                  "audio/pcm",
+		                                  XMMS_STREAM_TYPE_END);
+		decode_formats = g_list_prepend (NULL, pcm_type);
+	}
+
+	last = chain_setup (medialib, entry, url, decode_formats, remember);
+
+	if (float_pipeline) {
+		for (xform = last; xform; xform = xform->prev) {
+			xform->goal_hints = goal_formats;
+		}
+		g_list_free (decode_formats);
+		xmms_object_unref (pcm_type);
+	}
+
 	if (!last) {
 		return NULL;
 	}
 
+	if (remember) {
+		xmms_medialib_unplayable_remove (xmms_medialib_get_unplayable (medialib),
+		                                 url);
+	}
+
 	/* first check that segment plugin is available in the system */
 	plugin = xmms_plugin_find (XMMS_PLUGIN_TYPE_XFORM, "segment");
 	xform_plugin = (xmms_xform_plugin_t *) plugin;
@@ -1465,7 +1799,8 @@ xmms_xform_chain_setup_url_session (xmms_medialib_t *medialib,
 
 	/* add segment plugin to the chain if it can be added */
 	if (add_segment) {
-		last = xmms_xform_new_effect (last, entry, goal_formats, "segment");
+		last = xmms_xform_new_effect (last, entry, goal_formats, "segment",
+		                              FALSE);
 		if (!last) {
 			return NULL;
 		}
@@ -1473,10 +1808,24 @@ xmms_xform_chain_setup_url_session (xmms_medialib_t *medialib,
 
 	/* if not rehashing, also initialize all the effect plugins */
 	if (!rehash) {
-		last = add_effects (last, entry, goal_formats);
+		if (float_pipeline) {
+			last = add_float_conversion (last, entry, goal_formats);
+			if (!last) {
+				return NULL;
+			}
+		}
+
+		last = add_effects (last, entry, goal_formats, float_pipeline);
 		if (!last) {
 			return NULL;
 		}
+
+		if (float_pipeline) {
+			last = add_conversion (last, entry, goal_formats, goal_formats);
+			if (!last) {
+				return NULL;
+			}
+		}
 	}
 
 	chain_finalize (session, last, entry, url, rehash);
@@ -1512,7 +1861,7 @@ xmms_xform_config_lookup (xmms_xform_t *xform, const gchar *path)
 
 static xmms_xform_t *
 add_effects (xmms_xform_t *last, xmms_medialib_entry_t entry,
-             GList *goal_formats)
+             GList *goal_formats, gboolean float_pipeline)
 {
 	gint effect_no;
 
@@ -1534,19 +1883,61 @@ add_effects (xmms_xform_t *last, xmms_medialib_entry_t entry,
 			continue;
 		}
 
-		last = xmms_xform_new_effect (last, entry, goal_formats, name);
+		last = xmms_xform_new_effect (last, entry, goal_formats, name,
+		                              float_pipeline);
+		if (!last) {
+			break;
+		}
 	}
 
 	return last;
 }
 
+/**
+ * Convert the float output of last to an integer format the effect
+ * supports. Returns NULL if the effect takes none of them.
+ */
+static xmms_xform_t *
+add_effect_conversion (xmms_xform_t *last, xmms_medialib_entry_t entry,
+                       GList *goal_formats, xmms_xform_plugin_t *xform_plugin)
+{
+	static const xmms_sample_format_t formats[] = {
+		XMMS_SAMPLE_FORMAT_S32,
+		XMMS_SAMPLE_FORMAT_S16
+	};
+	xmms_stream_type_t *type;
+	GList *to_formats;
+	gint i, priority;
+
+	for (i = 0; i < G_N_ELEMENTS (formats); i++) {
+		type = pcm_stream_type_new (last, formats[i]);
+
+		if (xmms_xform_plugin_supports (xform_plugin, type, &priority)) {
+			to_formats = g_list_prepend (NULL, type);
+
+			xmms_object_ref (last);
+			last = add_conversion (last, entry, to_formats, goal_formats);
+
+			g_list_free (to_formats);
+			xmms_object_unref (type);
+
+			return last;
+		}
+
+		xmms_object_unref (type);
+	}
+
+	return NULL;
+}
+
 static xmms_xform_t *
 xmms_xform_new_effect (xmms_xform_t *last, xmms_medialib_entry_t entry,
-                       GList *goal_formats, const gchar *name)
+                       GList *goal_formats, const gchar *name,
+                       gboolean float_pipeline)
 {
 	xmms_plugin_t *plugin;
 	xmms_xform_plugin_t *xform_plugin;
-	xmms_xform_t *xform;
+	xmms_xform_t *xform, *converted = NULL;
 	gint priority;
 
 	plugin = xmms_plugin_find (XMMS_PLUGIN_TYPE_XFORM, name);
@@ -1557,10 +1948,25 @@ xmms_xform_new_effect (xmms_xform_t *last, xmms_medialib_entry_t entry,
 
 	xform_plugin = (xmms_xform_plugin_t *) plugin;
 	if (!xmms_xform_plugin_supports (xform_plugin, last->out_type, &priority)) {
-		xmms_log_info ("Effect '%s' doesn't support format, skipping",
-		               xmms_plugin_shortname_get (plugin));
-		xmms_object_unref (plugin);
-		return last;
+		/* in float pipeline mode, run integer-only effects on a
+		 * converted copy of the stream rather than skipping them */
+		if (float_pipeline) {
+			converted = add_effect_conversion (last, entry, goal_formats,
+			                                   xform_plugin);
+		}
+
+		if (!converted) {
+			xmms_log_info ("Effect '%s' doesn't support format, skipping",
+			               xmms_plugin_shortname_get (plugin));
+			xmms_object_unref (plugin);
+			return last;
+		}
+
+		XMMS_DBG ("Effect '%s' doesn't support float, converting",
+		          xmms_plugin_shortname_get (plugin));
+
+		xmms_object_unref (last);
+		last = converted;
 	}
 
 	xform = xmms_xform_new (xform_plugin, last, last->medialib, entry, goal_formats);
@@ -1576,6 +1982,11 @@ xmms_xform_new_effect (xmms_xform_t *last, xmms_medialib_entry_t entry,
 	                                            "enabled", "0",
 	                                            NULL, NULL);
 	xmms_object_unref (plugin);
+
+	if (converted) {
+		last = add_float_conversion (last, entry, goal_formats);
+	}
+
 	return last;
 }
 
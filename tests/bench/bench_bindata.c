@@ -0,0 +1,207 @@
+/*  XMMS2 - X Music Multiplexer System
+ *  Copyright (C) 2003-2013 XMMS2 Team
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License
+ *  as published by the Free Software Foundation; either version 2
+ *  of the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ */
+
+/*
+ * Measures bindata retrieval from a store of many blobs: the previous
+ * read loop, mapping each blob, and mapping with a cache large enough
+ * for all of them.
+ *
+ * Usage: bench_bindata [blobs] [blob size] [retrieves]
+ */
+
+#include <glib.h>
+#include <glib/gstdio.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <xmms/xmms_log.h>
+#include <xmmspriv/xmms_bindata.h>
+#include <xmmspriv/xmms_config.h>
+#include <xmmspriv/xmms_ipc.h>
+
+#include "server-utils/ipc_call.h"
+
+/* The previous retrieve, 1 KiB reads into a GString and a copy. */
+static xmmsv_t *
+reference_retrieve (const gchar *dir, const gchar *hash)
+{
+	gchar shard[3] = { hash[0], hash[1], '\0' };
+	xmmsv_t *res;
+	GString *str;
+	gchar *path;
+	FILE *fp;
+
+	path = g_build_filename (dir, shard, hash, NULL);
+	fp = fopen (path, "rb");
+	g_free (path);
+
+	if (!fp) {
+		return NULL;
+	}
+
+	str = g_string_new (NULL);
+	while (!feof (fp)) {
+		gchar buf[1024];
+		gint l;
+
+		l = fread (buf, 1, 1024, fp);
+		g_string_append_len (str, buf, l);
+	}
+	fclose (fp);
+
+	res = xmmsv_new_bin ((unsigned char *) str->str, str->len);
+	g_string_free (str, TRUE);
+
+	return res;
+}
+
+static gdouble
+run (xmms_bindata_t *bindata, const gchar *dir, gchar **hashes, gint blobs,
+     gint retrieves, gboolean reference)
+{
+	xmmsv_t *res;
+	gint64 start;
+	gint i;
+
+	start = g_get_monotonic_time ();
+
+	for (i = 0; i < retrieves; i++) {
+		const gchar *hash = hashes[g_random_int_range (0, blobs)];
+
+		if (reference) {
+			res = reference_retrieve (dir, hash);
+		} else {
+			res = XMMS_IPC_CALL (bindata, XMMS_IPC_CMD_GET_DATA,
+			                     xmmsv_new_string (hash));
+		}
+
+		if (!res || xmmsv_is_type (res, XMMSV_TYPE_ERROR)) {
+			fprintf (stderr, "could not retrieve %s\n", hash);
+			exit (EXIT_FAILURE);
+		}
+		xmmsv_unref (res);
+	}
+
+	return retrieves * 1000000.0 / MAX (g_get_monotonic_time () - start, 1);
+}
+
+int
+main (int argc, char **argv)
+{
+	xmms_config_property_t *cachesize;
+	xmms_bindata_t *bindata;
+	gint blobs = 10000, size = 8192, retrieves = 100000;
+	gdouble ref_rate, rate;
+	guchar *data;
+	gchar **hashes, *dir, *tmp;
+	const gchar *str;
+	xmmsv_t *res;
+	gint64 start;
+	gint i, j;
+
+	if (argc > 1) {
+		blobs = atoi (argv[1]);
+	}
+	if (argc > 2) {
+		size = atoi (argv[2]);
+	}
+	if (argc > 3) {
+		retrieves = atoi (argv[3]);
+	}
+
+	dir = g_dir_make_tmp ("bench_bindata-XXXXXX", NULL);
+	if (!dir) {
+		fprintf (stderr, "could not create a temporary directory\n");
+		return EXIT_FAILURE;
+	}
+
+	xmms_ipc_init ();
+	xmms_log_init (0);
+	xmms_config_init ("memory://");
+
+	xmms_config_property_register ("bindata.path", dir, NULL, NULL);
+	bindata = xmms_bindata_init ();
+
+	hashes = g_new0 (gchar *, blobs + 1);
+	data = g_malloc (size);
+
+	for (i = 0; i < blobs; i++) {
+		for (j = 0; j < size; j++) {
+			data[j] = g_random_int ();
+		}
+
+		res = XMMS_IPC_CALL (bindata, XMMS_IPC_CMD_ADD_DATA,
+		                     xmmsv_new_bin (data, size));
+		if (!xmmsv_get_string (res, &str)) {
+			fprintf (stderr, "could not add blob\n");
+			return EXIT_FAILURE;
+		}
+		hashes[i] = g_strdup (str);
+		xmmsv_unref (res);
+	}
+
+	printf ("retrieving %d random blobs out of %d of %d bytes\n\n",
+	        retrieves, blobs, size);
+
+	cachesize = xmms_config_lookup ("bindata.cachesize");
+
+	ref_rate = run (bindata, dir, hashes, blobs, retrieves, TRUE);
+	printf ("  %-10s %10.0f blobs/s %8.1f MB/s\n", "reference",
+	        ref_rate, ref_rate * size / 1e6);
+
+	xmms_config_property_set_data (cachesize, "0");
+	rate = run (bindata, dir, hashes, blobs, retrieves, FALSE);
+	printf ("  %-10s %10.0f blobs/s %8.1f MB/s %6.2fx\n", "mapped",
+	        rate, rate * size / 1e6, rate / ref_rate);
+
+	tmp = g_strdup_printf ("%d", blobs * size);
+	xmms_config_property_set_data (cachesize, tmp);
+	g_free (tmp);
+
+	/* one pass to fill the cache */
+	run (bindata, dir, hashes, blobs, blobs, FALSE);
+	rate = run (bindata, dir, hashes, blobs, retrieves, FALSE);
+	printf ("  %-10s %10.0f blobs/s %8.1f MB/s %6.2fx\n", "cached",
+	        rate, rate * size / 1e6, rate / ref_rate);
+
+	start = g_get_monotonic_time ();
+	res = XMMS_IPC_CALL (bindata, XMMS_IPC_CMD_LIST_DATA, NULL);
+	printf ("\n  listing %d blobs took %" G_GINT64_FORMAT " us\n",
+	        xmmsv_list_get_size (res), g_get_monotonic_time () - start);
+	xmmsv_unref (res);
+
+	for (i = 0; i < blobs; i++) {
+		res = XMMS_IPC_CALL (bindata, XMMS_IPC_CMD_REMOVE_DATA,
+		                     xmmsv_new_string (hashes[i]));
+		xmmsv_unref (res);
+	}
+
+	for (i = 0; i < 256; i++) {
+		tmp = g_strdup_printf ("%s" G_DIR_SEPARATOR_S "%02x", dir, i);
+		g_rmdir (tmp);
+		g_free (tmp);
+	}
+	g_rmdir (dir);
+
+	xmms_object_unref (bindata);
+	xmms_config_shutdown ();
+	xmms_ipc_shutdown ();
+
+	g_strfreev (hashes);
+	g_free (data);
+	g_free (dir);
+
+	return EXIT_SUCCESS;
+}
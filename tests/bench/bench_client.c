@@ -0,0 +1,129 @@
+/*  XMMS2 - X Music Multiplexer System
+ *  Copyright (C) 2003-2013 XMMS2 Team
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License
+ *  as published by the Free Software Foundation; either version 2
+ *  of the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ */
+
+/*
+ * Measures the command rate against a running xmms2d, waiting for each
+ * reply before sending the next command versus sending batches of
+ * commands and collecting the replies afterwards.
+ *
+ * Usage: bench_client [commands] [batch size]
+ */
+
+#include <glib.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <xmmsclient/xmmsclient.h>
+
+static gboolean
+check_result (xmmsc_result_t *res)
+{
+	xmmsv_t *value;
+	const gchar *err;
+
+	value = xmmsc_result_get_value (res);
+	if (xmmsv_get_error (value, &err)) {
+		fprintf (stderr, "server error: %s\n", err);
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
+static gint
+run_sequential (xmmsc_connection_t *conn, gint commands)
+{
+	xmmsc_result_t *res;
+	gint i, failed = 0;
+
+	for (i = 0; i < commands; i++) {
+		res = xmmsc_playback_status (conn);
+		xmmsc_result_wait (res);
+		failed += !check_result (res);
+		xmmsc_result_unref (res);
+	}
+
+	return failed;
+}
+
+static gint
+run_batched (xmmsc_connection_t *conn, gint commands, gint batch)
+{
+	xmmsc_result_t **res;
+	gint i, n, done, failed = 0;
+
+	res = g_new (xmmsc_result_t *, batch);
+
+	for (done = 0; done < commands; done += n) {
+		n = MIN (batch, commands - done);
+
+		xmmsc_batch_begin (conn);
+		for (i = 0; i < n; i++) {
+			res[i] = xmmsc_playback_status (conn);
+		}
+		if (!xmmsc_batch_flush (conn)) {
+			fprintf (stderr, "disconnected\n");
+			exit (EXIT_FAILURE);
+		}
+
+		for (i = 0; i < n; i++) {
+			xmmsc_result_wait (res[i]);
+			failed += !check_result (res[i]);
+			xmmsc_result_unref (res[i]);
+		}
+	}
+
+	g_free (res);
+
+	return failed;
+}
+
+int
+main (int argc, char **argv)
+{
+	xmmsc_connection_t *conn;
+	gint commands = 100000, batch = 256;
+	gdouble seq_rate, rate;
+	gint64 start;
+	gint failed;
+
+	if (argc > 1) {
+		commands = atoi (argv[1]);
+	}
+	if (argc > 2) {
+		batch = MAX (atoi (argv[2]), 1);
+	}
+
+	conn = xmmsc_init ("bench_client");
+	if (!xmmsc_connect (conn, getenv ("XMMS_PATH"))) {
+		fprintf (stderr, "could not connect: %s\n", xmmsc_get_last_error (conn));
+		return EXIT_FAILURE;
+	}
+
+	printf ("sending %d commands\n\n", commands);
+
+	start = g_get_monotonic_time ();
+	failed = run_sequential (conn, commands);
+	seq_rate = commands * 1000000.0 / MAX (g_get_monotonic_time () - start, 1);
+	printf ("  %-16s %10.0f ops/s\n", "sequential", seq_rate);
+
+	start = g_get_monotonic_time ();
+	failed += run_batched (conn, commands, batch);
+	rate = commands * 1000000.0 / MAX (g_get_monotonic_time () - start, 1);
+	printf ("  batches of %-5d %10.0f ops/s %6.2fx\n", batch, rate, rate / seq_rate);
+
+	xmmsc_unref (conn);
+
+	return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
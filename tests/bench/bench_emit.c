@@ -0,0 +1,139 @@
+/*  XMMS2 - X Music Multiplexer System
+ *  Copyright (C) 2003-2013 XMMS2 Team
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License
+ *  as published by the Free Software Foundation; either version 2
+ *  of the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ */
+
+/*
+ * Measures how long a writer thread is held up by emitting playtime
+ * signals, with handlers that do what the IPC broadcast does for every
+ * client, emitted directly versus through the dispatch thread.
+ *
+ * Usage: bench_emit [signals] [clients]
+ */
+
+#include <glib.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <xmms/xmms_object.h>
+#include <xmmsc/xmmsc_idnumbers.h>
+#include <xmmsc/xmmsc_ipc_msg.h>
+
+static GMutex clients_lock;
+static gint clients = 16;
+static gint received;
+
+/* Like the broadcast handler, encode a message per client. */
+static void
+broadcast (xmms_object_t *object, xmmsv_t *data, gpointer userdata)
+{
+	xmms_ipc_msg_t *msg;
+	gint i;
+
+	g_mutex_lock (&clients_lock);
+
+	for (i = 0; i < clients; i++) {
+		msg = xmms_ipc_msg_new (XMMS_IPC_OBJECT_SIGNAL, XMMS_IPC_CMD_BROADCAST);
+		xmms_ipc_msg_put_value (msg, data);
+		xmms_ipc_msg_destroy (msg);
+	}
+
+	g_mutex_unlock (&clients_lock);
+
+	g_atomic_int_inc (&received);
+}
+
+typedef struct {
+	xmms_object_t *object;
+	gint signals;
+	gboolean async;
+	gint64 total;
+	gint64 max;
+} writer_t;
+
+static gpointer
+writer (gpointer data)
+{
+	writer_t *w = data;
+	gint64 start, elapsed;
+	gint i;
+
+	for (i = 0; i < w->signals; i++) {
+		start = g_get_monotonic_time ();
+
+		if (w->async) {
+			xmms_object_emit_async (w->object, XMMS_IPC_SIGNAL_PLAYBACK_PLAYTIME,
+			                        xmmsv_new_int (i * 100));
+		} else {
+			xmms_object_emit (w->object, XMMS_IPC_SIGNAL_PLAYBACK_PLAYTIME,
+			                  xmmsv_new_int (i * 100));
+		}
+
+		elapsed = g_get_monotonic_time () - start;
+		w->total += elapsed;
+		w->max = MAX (w->max, elapsed);
+
+		/* time for the output plugin to write the next chunk */
+		g_usleep (200);
+	}
+
+	return NULL;
+}
+
+static void
+run (xmms_object_t *object, gint signals, gboolean async)
+{
+	writer_t w = { object, signals, async, 0, 0 };
+
+	if (async) {
+		xmms_object_dispatch_start ();
+	}
+
+	g_thread_join (g_thread_new ("writer", writer, &w));
+
+	if (async) {
+		xmms_object_dispatch_stop ();
+	}
+
+	printf ("  %-8s mean %8.2f us  max %6" G_GINT64_FORMAT " us\n",
+	        async ? "async" : "direct", (gdouble) w.total / signals, w.max);
+}
+
+int
+main (int argc, char **argv)
+{
+	xmms_object_t *object;
+	gint signals = 10000;
+
+	if (argc > 1) {
+		signals = atoi (argv[1]);
+	}
+	if (argc > 2) {
+		clients = atoi (argv[2]);
+	}
+
+	g_mutex_init (&clients_lock);
+
+	object = xmms_object_new (xmms_object_t, NULL);
+	xmms_object_connect (object, XMMS_IPC_SIGNAL_PLAYBACK_PLAYTIME, broadcast, NULL);
+
+	printf ("emitting %d signals to %d clients, time spent in the writer\n\n",
+	        signals, clients);
+
+	run (object, signals, FALSE);
+	run (object, signals, TRUE);
+
+	xmms_object_unref (object);
+	g_mutex_clear (&clients_lock);
+
+	return received == 2 * signals ? EXIT_SUCCESS : EXIT_FAILURE;
+}
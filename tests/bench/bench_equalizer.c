@@ -0,0 +1,220 @@
+/*  XMMS2 - X Music Multiplexer System
+ *  Copyright (C) 2003-2013 XMMS2 Team
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License
+ *  as published by the Free Software Foundation; either version 2
+ *  of the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ */
+
+/*
+ * Measures the equalizer filter bank against the original one band at
+ * a time, double precision implementation, at 10 and 31 bands.
+ *
+ * Usage: bench_equalizer [seconds of audio]
+ */
+
+#include <glib.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "eq_filter.h"
+
+#define CHUNK 4096
+#define CHANNELS 2
+#define RATE 44100
+
+/* The previous implementation, with its state moved into a struct */
+typedef struct {
+	sIIRCoefficients cf[EQ_MAX_BANDS];
+	gint bands;
+	gfloat gain[EQ_MAX_BANDS];
+	gfloat preamp;
+	gdouble x[2][EQ_MAX_BANDS][CHANNELS][3];
+	gdouble y[2][EQ_MAX_BANDS][CHANNELS][3];
+	gint i, j, k;
+} reference_t;
+
+static void
+reference_init (reference_t *ref, gint bands, const gfloat *gains, gfloat preamp)
+{
+	memset (ref, 0, sizeof (*ref));
+
+	ref->bands = calc_coeffs (ref->cf, bands, RATE, FALSE);
+	memcpy (ref->gain, gains, bands * sizeof (gfloat));
+	ref->preamp = preamp;
+	ref->i = 2;
+	ref->j = 1;
+}
+
+static gdouble
+reference_bank (reference_t *ref, gint pass, gint c, gdouble in)
+{
+	gdouble out = 0.0;
+	gint b;
+
+	for (b = 0; b < ref->bands; b++) {
+		gdouble (*x)[3] = ref->x[pass][b];
+		gdouble (*y)[3] = ref->y[pass][b];
+
+		x[c][ref->i] = in;
+		y[c][ref->i] = ref->cf[b].alpha * (x[c][ref->i] - x[c][ref->k])
+		             + ref->cf[b].gamma * y[c][ref->j]
+		             - ref->cf[b].beta * y[c][ref->k];
+		out += y[c][ref->i] * ref->gain[b];
+	}
+
+	return out;
+}
+
+static void
+reference_process (reference_t *ref, gint16 *data, gint frames,
+                   gboolean extra_filtering)
+{
+	gint n, c;
+
+	for (n = 0; n < frames; n++) {
+		for (c = 0; c < CHANNELS; c++) {
+			gdouble pcm, out;
+			gint value;
+
+			pcm = data[c] * ref->preamp;
+			out = reference_bank (ref, 0, c, pcm);
+			if (extra_filtering) {
+				out += reference_bank (ref, 1, c, out);
+			}
+			out += pcm * 0.25;
+
+			value = (gint) out;
+			data[c] = CLAMP (value, G_MININT16, G_MAXINT16);
+		}
+
+		data += CHANNELS;
+
+		ref->i = (ref->i + 1) % 3;
+		ref->j = (ref->j + 1) % 3;
+		ref->k = (ref->k + 1) % 3;
+	}
+}
+
+static void
+fill (gint16 *buf, gfloat *fbuf, gint len)
+{
+	gint i;
+
+	for (i = 0; i < len; i++) {
+		buf[i] = g_random_int_range (-8192, 8192);
+		fbuf[i] = buf[i] / 32768.0f;
+	}
+}
+
+static gdouble
+rate_of (gint64 samples, gint64 start)
+{
+	return (gdouble) samples / MAX (g_get_monotonic_time () - start, 1);
+}
+
+static void
+run (gint bands, gboolean extra, gint64 samples)
+{
+	gfloat gains[EQ_MAX_BANDS];
+	xmms_eq_filter_t *filter;
+	reference_t ref;
+	gint16 *input, *a, *b;
+	gfloat *finput, *f;
+	gdouble ref_rate, rate;
+	gint64 start, done;
+	gint i, diff = 0;
+
+	for (i = 0; i < bands; i++) {
+		gains[i] = (i & 1) ? 0.1f : -0.05f;
+	}
+
+	input = g_new (gint16, CHUNK * CHANNELS);
+	finput = g_new (gfloat, CHUNK * CHANNELS);
+	a = g_new (gint16, CHUNK * CHANNELS);
+	b = g_new (gint16, CHUNK * CHANNELS);
+	f = g_new (gfloat, CHUNK * CHANNELS);
+
+	fill (input, finput, CHUNK * CHANNELS);
+
+	reference_init (&ref, bands, gains, 1.0f);
+	filter = xmms_eq_filter_new (CHANNELS);
+	xmms_eq_filter_configure (filter, RATE, bands, FALSE, gains, 1.0f, extra);
+
+	/* same input through both, to see how far apart they end up */
+	for (done = 0; done < RATE * CHANNELS; done += CHUNK * CHANNELS) {
+		memcpy (a, input, CHUNK * CHANNELS * sizeof (gint16));
+		memcpy (b, input, CHUNK * CHANNELS * sizeof (gint16));
+
+		reference_process (&ref, a, CHUNK, extra);
+		xmms_eq_filter_process_s16 (filter, b, CHUNK);
+
+		for (i = 0; i < CHUNK * CHANNELS; i++) {
+			diff = MAX (diff, ABS (a[i] - b[i]));
+		}
+	}
+
+	printf ("%d bands%s, max difference %d\n", bands,
+	        extra ? " extra filtering" : "", diff);
+
+	start = g_get_monotonic_time ();
+	for (done = 0; done < samples; done += CHUNK * CHANNELS) {
+		memcpy (a, input, CHUNK * CHANNELS * sizeof (gint16));
+		reference_process (&ref, a, CHUNK, extra);
+	}
+	ref_rate = rate_of (done, start);
+	printf ("  %-12s %8.1f Msamples/s\n", "reference", ref_rate);
+
+	start = g_get_monotonic_time ();
+	for (done = 0; done < samples; done += CHUNK * CHANNELS) {
+		memcpy (b, input, CHUNK * CHANNELS * sizeof (gint16));
+		xmms_eq_filter_process_s16 (filter, b, CHUNK);
+	}
+	rate = rate_of (done, start);
+	printf ("  %-12s %8.1f Msamples/s %6.2fx\n", "s16", rate, rate / ref_rate);
+
+	start = g_get_monotonic_time ();
+	for (done = 0; done < samples; done += CHUNK * CHANNELS) {
+		memcpy (f, finput, CHUNK * CHANNELS * sizeof (gfloat));
+		xmms_eq_filter_process_float (filter, f, CHUNK);
+	}
+	rate = rate_of (done, start);
+	printf ("  %-12s %8.1f Msamples/s %6.2fx\n\n", "float", rate, rate / ref_rate);
+
+	xmms_eq_filter_free (filter);
+
+	g_free (input);
+	g_free (finput);
+	g_free (a);
+	g_free (b);
+	g_free (f);
+}
+
+int
+main (int argc, char **argv)
+{
+	gint64 samples;
+	gint seconds = 60;
+
+	if (argc > 1) {
+		seconds = atoi (argv[1]);
+	}
+
+	samples = (gint64) seconds * RATE * CHANNELS;
+
+	printf ("equalizing %d seconds of 44.1kHz stereo\n\n", seconds);
+
+	run (10, FALSE, samples);
+	run (31, FALSE, samples);
+	run (31, TRUE, samples);
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,239 @@
+/*  XMMS2 - X Music Multiplexer System
+ *  Copyright (C) 2003-2013 XMMS2 Team
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License
+ *  as published by the Free Software Foundation; either version 2
+ *  of the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ */
+
+/*
+ * Measures the server side of no-op commands: decoding the request,
+ * finding the object and command, calling it and encoding the reply.
+ * The previous lookup, a locked object pool and a command tree searched
+ * twice, is run next to the dispatch table.
+ *
+ * Usage: bench_ipc_dispatch [commands]
+ */
+
+#include <glib.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <xmms/xmms_object.h>
+#include <xmmsc/xmmsc_idnumbers.h>
+#include <xmmsc/xmmsc_ipc_msg.h>
+#include <xmmsc/xmmsv_bitbuffer.h>
+
+#define COMMANDS 12
+
+static gint calls;
+
+static void
+noop (xmms_object_t *object, xmms_object_cmd_arg_t *arg)
+{
+	calls++;
+	arg->retval = xmmsv_new_none ();
+}
+
+static const xmms_object_cmd_func_t noop_cmds[COMMANDS] = {
+	noop, noop, noop, noop, noop, noop,
+	noop, noop, noop, noop, noop, noop
+};
+
+static xmms_object_t *pool[XMMS_IPC_OBJECT_END];
+static GMutex pool_lock;
+static GTree *cmd_tree;
+
+static gint
+compare_cmd_key (gconstpointer a, gconstpointer b)
+{
+	guint aa = GPOINTER_TO_UINT (a);
+	guint bb = GPOINTER_TO_UINT (b);
+
+	return aa < bb ? -1 : aa > bb;
+}
+
+static xmms_object_cmd_func_t
+lookup_tree (guint objid, guint cmdid, xmms_object_t **object)
+{
+	g_mutex_lock (&pool_lock);
+	*object = pool[objid];
+	g_mutex_unlock (&pool_lock);
+
+	if (!g_tree_lookup (cmd_tree, GUINT_TO_POINTER (cmdid))) {
+		return NULL;
+	}
+
+	return g_tree_lookup (cmd_tree, GUINT_TO_POINTER (cmdid));
+}
+
+static xmms_object_cmd_func_t
+lookup_table (guint objid, guint cmdid, xmms_object_t **object)
+{
+	*object = g_atomic_pointer_get (&pool[objid]);
+
+	return xmms_object_cmd_get (*object, cmdid);
+}
+
+/* Encode a request the way it arrives on the wire. */
+static xmmsv_t *
+request_new (guint objid, guint cmdid)
+{
+	xmmsv_t *bb, *args;
+
+	bb = xmmsv_new_bitbuffer ();
+	xmmsv_bitbuffer_put_bits (bb, 32, objid);
+	xmmsv_bitbuffer_put_bits (bb, 32, cmdid);
+	xmmsv_bitbuffer_put_bits (bb, 32, 1);
+	xmmsv_bitbuffer_put_bits (bb, 32, 0);
+
+	args = xmmsv_new_list ();
+	xmmsv_bitbuffer_serialize_value (bb, args);
+	xmmsv_unref (args);
+
+	xmmsv_bitbuffer_put_bits_at (bb, 32,
+	                             xmmsv_bitbuffer_len (bb) / 8 - XMMS_IPC_MSG_HEAD_LEN,
+	                             12 * 8);
+
+	return bb;
+}
+
+static gdouble
+run (gint commands, gboolean table)
+{
+	xmmsv_t *requests[COMMANDS];
+	xmms_object_cmd_func_t func;
+	xmms_object_cmd_arg_t arg;
+	xmms_object_t *object;
+	xmms_ipc_msg_t *msg, *reply;
+	xmmsv_t *args;
+	gboolean complete;
+	gint64 start;
+	gint i;
+
+	for (i = 0; i < COMMANDS; i++) {
+		requests[i] = request_new (XMMS_IPC_OBJECT_PLAYBACK, XMMS_IPC_CMD_FIRST + i);
+	}
+
+	start = g_get_monotonic_time ();
+
+	for (i = 0; i < commands; i++) {
+		xmmsv_t *request = requests[i % COMMANDS];
+		guint cmdid;
+
+		msg = xmms_ipc_msg_alloc ();
+		xmms_ipc_msg_put_data (msg, (const gchar *) xmmsv_bitbuffer_buffer (request),
+		                       xmmsv_bitbuffer_len (request) / 8, &complete);
+
+		cmdid = xmms_ipc_msg_get_cmd (msg);
+		if (!complete || !xmms_ipc_msg_get_value (msg, &args)) {
+			fprintf (stderr, "could not decode arguments\n");
+			exit (EXIT_FAILURE);
+		}
+
+		if (table) {
+			func = lookup_table (xmms_ipc_msg_get_object (msg), cmdid, &object);
+		} else {
+			func = lookup_tree (xmms_ipc_msg_get_object (msg), cmdid, &object);
+		}
+
+		xmms_object_cmd_arg_init (&arg);
+		arg.args = args;
+		func (object, &arg);
+
+		reply = xmms_ipc_msg_new (XMMS_IPC_OBJECT_PLAYBACK, XMMS_IPC_CMD_REPLY);
+		xmms_ipc_msg_put_value (reply, arg.retval);
+		xmms_ipc_msg_set_cookie (reply, xmms_ipc_msg_get_cookie (msg));
+
+		xmmsv_unref (arg.retval);
+		xmmsv_unref (args);
+		xmms_ipc_msg_destroy (reply);
+		xmms_ipc_msg_destroy (msg);
+	}
+
+	for (i = 0; i < COMMANDS; i++) {
+		xmmsv_unref (requests[i]);
+	}
+
+	return commands * 1000000.0 / MAX (g_get_monotonic_time () - start, 1);
+}
+
+/* Only the object and command lookup, without any message handling. */
+static gdouble
+run_lookup (gint commands, gboolean table)
+{
+	xmms_object_cmd_func_t func;
+	xmms_object_t *object;
+	gint64 start;
+	gsize found = 0;
+	gint i;
+
+	start = g_get_monotonic_time ();
+
+	for (i = 0; i < commands; i++) {
+		guint cmdid = XMMS_IPC_CMD_FIRST + i % COMMANDS;
+
+		if (table) {
+			func = lookup_table (XMMS_IPC_OBJECT_PLAYBACK, cmdid, &object);
+		} else {
+			func = lookup_tree (XMMS_IPC_OBJECT_PLAYBACK, cmdid, &object);
+		}
+		found += func != NULL;
+	}
+
+	if (found != commands) {
+		fprintf (stderr, "lookup failed\n");
+		exit (EXIT_FAILURE);
+	}
+
+	return commands * 1000000.0 / MAX (g_get_monotonic_time () - start, 1);
+}
+
+int
+main (int argc, char **argv)
+{
+	xmms_object_t object = { 0, };
+	gdouble tree_rate, rate;
+	gint commands = 2000000;
+	gint i;
+
+	if (argc > 1) {
+		commands = atoi (argv[1]);
+	}
+
+	object.id = XMMS_OBJECT_MID;
+	xmms_object_cmds_set (&object, XMMS_IPC_CMD_FIRST, noop_cmds, COMMANDS);
+	pool[XMMS_IPC_OBJECT_PLAYBACK] = &object;
+
+	g_mutex_init (&pool_lock);
+	cmd_tree = g_tree_new (compare_cmd_key);
+	for (i = 0; i < COMMANDS; i++) {
+		g_tree_insert (cmd_tree, GUINT_TO_POINTER (XMMS_IPC_CMD_FIRST + i),
+		               (gpointer) noop_cmds[i]);
+	}
+
+	printf ("dispatching %d no-op commands\n\n", commands);
+
+	tree_rate = run_lookup (commands, FALSE);
+	printf ("  %-16s %12.0f lookups/s\n", "tree lookup", tree_rate);
+
+	rate = run_lookup (commands, TRUE);
+	printf ("  %-16s %12.0f lookups/s %6.2fx\n", "table lookup", rate, rate / tree_rate);
+
+	tree_rate = run (commands, FALSE);
+	printf ("  %-16s %12.0f commands/s\n", "tree", tree_rate);
+
+	rate = run (commands, TRUE);
+	printf ("  %-16s %12.0f commands/s %6.2fx\n", "table", rate, rate / tree_rate);
+
+	g_tree_destroy (cmd_tree);
+	g_mutex_clear (&pool_lock);
+
+	return calls == 2 * commands ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,224 @@
+/*  XMMS2 - X Music Multiplexer System
+ *  Copyright (C) 2003-2013 XMMS2 Team
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License
+ *  as published by the Free Software Foundation; either version 2
+ *  of the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ */
+
+/*
+ * Measures how long a party shuffle playlist takes to reach its target
+ * size: the previous refill, one random entry and one message per
+ * updater pass, and the updater filling it in one pass. Then measures
+ * the update following each advance, which trims the history and picks
+ * a single new entry.
+ *
+ * Usage: bench_pshuffle [library size] [upcoming] [advances]
+ */
+
+#include <glib.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <xmmspriv/xmms_log.h>
+#include <xmmspriv/xmms_config.h>
+#include <xmmspriv/xmms_ipc.h>
+#include <xmmspriv/xmms_medialib.h>
+#include <xmmspriv/xmms_collection.h>
+#include <xmmspriv/xmms_playlist.h>
+
+#include "server-utils/ipc_call.h"
+
+static gint
+playlist_size (xmms_playlist_t *playlist, const gchar *plname)
+{
+	xmmsv_t *res;
+	gint size;
+
+	res = XMMS_IPC_CALL (playlist, XMMS_IPC_CMD_LIST, xmmsv_new_string (plname));
+	size = xmmsv_list_get_size (res);
+	xmmsv_unref (res);
+
+	return size;
+}
+
+static void
+save_playlist (xmms_coll_dag_t *colldag, const gchar *plname,
+               const gchar *type, gint upcoming, gboolean active)
+{
+	xmmsv_t *coll, *universe;
+	gchar *tmp;
+
+	coll = xmmsv_new_coll (XMMS_COLLECTION_TYPE_IDLIST);
+	xmmsv_coll_attribute_set_string (coll, "type", type);
+	xmmsv_coll_attribute_set_string (coll, "history", "1");
+
+	tmp = g_strdup_printf ("%d", upcoming);
+	xmmsv_coll_attribute_set_string (coll, "upcoming", tmp);
+	g_free (tmp);
+
+	universe = xmmsv_new_coll (XMMS_COLLECTION_TYPE_UNIVERSE);
+	xmmsv_coll_add_operand (coll, universe);
+	xmmsv_unref (universe);
+
+	xmms_collection_update_pointer (colldag, plname,
+	                                XMMS_COLLECTION_NSID_PLAYLISTS, coll);
+	if (active) {
+		xmms_collection_update_pointer (colldag, XMMS_ACTIVE_PLAYLIST,
+		                                XMMS_COLLECTION_NSID_PLAYLISTS, coll);
+	}
+	xmmsv_unref (coll);
+}
+
+static void
+fill_library (xmms_medialib_t *medialib, gint entries)
+{
+	xmms_medialib_session_t *session;
+	xmms_error_t err;
+	gchar url[64];
+	gint i;
+
+	xmms_error_reset (&err);
+
+	for (i = 0; i < entries; i++) {
+		if (i % 10000 == 0) {
+			session = xmms_medialib_session_begin (medialib);
+		}
+
+		g_snprintf (url, sizeof (url), "file:///bench/%08d.ogg", i);
+		xmms_medialib_entry_new (session, url, &err);
+
+		if (i % 10000 == 9999 || i == entries - 1) {
+			xmms_medialib_session_commit (session);
+		}
+	}
+}
+
+/* The previous refill, one random pick and one add per updater pass.
+ * The playlist starts out empty, so it takes target passes; it isn't
+ * listed after each one, which would be timed as well. */
+static gint
+reference_fill (xmms_playlist_t *playlist, xmms_coll_dag_t *colldag,
+                gint target)
+{
+	xmms_medialib_entry_t id;
+	xmms_error_t err;
+	xmmsv_t *universe;
+	gint passes;
+
+	xmms_error_reset (&err);
+	universe = xmmsv_new_coll (XMMS_COLLECTION_TYPE_UNIVERSE);
+
+	for (passes = 0; passes < target; passes++) {
+		id = xmms_collection_get_random_media (colldag, universe);
+		xmms_playlist_add_entry (playlist, "Reference", id, &err);
+	}
+
+	xmmsv_unref (universe);
+
+	return passes;
+}
+
+/* Run the updater until the playlist stops changing, like the updater
+ * thread does as long as the playlist keeps sending signals. */
+static gint
+converge (xmms_playlist_t *playlist)
+{
+	gint passes, size, prev = -1;
+
+	for (passes = 0; ; passes++) {
+		xmms_playlist_update (playlist, "Default");
+		size = playlist_size (playlist, "Default");
+		if (size == prev) {
+			return passes;
+		}
+		prev = size;
+	}
+}
+
+int
+main (int argc, char **argv)
+{
+	xmms_medialib_t *medialib;
+	xmms_coll_dag_t *colldag;
+	xmms_playlist_t *playlist;
+	gint entries = 1000000, upcoming = 500, advances = 20;
+	gint passes, i;
+	gint64 start, elapsed;
+
+	if (argc > 1) {
+		entries = MAX (atoi (argv[1]), 1);
+	}
+	if (argc > 2) {
+		upcoming = MAX (atoi (argv[2]), 1);
+	}
+	if (argc > 3) {
+		advances = atoi (argv[3]);
+	}
+
+	xmms_ipc_init ();
+	xmms_log_init (0);
+	xmms_config_init ("memory://");
+
+	xmms_config_property_register ("medialib.path", "memory://", NULL, NULL);
+	xmms_config_property_register ("playlist.repeat_one", "0", NULL, NULL);
+	xmms_config_property_register ("playlist.repeat_all", "0", NULL, NULL);
+
+	medialib = xmms_medialib_init ();
+	colldag = xmms_collection_init (medialib);
+
+	save_playlist (colldag, "Reference", "classic", upcoming, FALSE);
+	save_playlist (colldag, "Default", "pshuffle", upcoming, TRUE);
+
+	playlist = xmms_playlist_init (medialib, colldag);
+
+	start = g_get_monotonic_time ();
+	fill_library (medialib, entries);
+	printf ("library of %d entries filled in %.1f s\n\n", entries,
+	        (g_get_monotonic_time () - start) / 1e6);
+
+	printf ("filling %d upcoming entries\n", upcoming);
+
+	start = g_get_monotonic_time ();
+	passes = reference_fill (playlist, colldag, upcoming);
+	elapsed = g_get_monotonic_time () - start;
+	printf ("  %-10s %5d passes %10.1f ms\n", "reference",
+	        passes, elapsed / 1e3);
+
+	if (playlist_size (playlist, "Reference") != upcoming) {
+		fprintf (stderr, "reference playlist did not reach %d entries\n",
+		         upcoming);
+		return EXIT_FAILURE;
+	}
+
+	start = g_get_monotonic_time ();
+	passes = converge (playlist);
+	elapsed = g_get_monotonic_time () - start;
+	printf ("  %-10s %5d passes %10.1f ms\n", "batched",
+	        passes, elapsed / 1e3);
+
+	if (advances > 0) {
+		start = g_get_monotonic_time ();
+		for (i = 0; i < advances; i++) {
+			xmms_playlist_advance (playlist);
+			converge (playlist);
+		}
+		elapsed = g_get_monotonic_time () - start;
+		printf ("\n  %d advances, %.1f ms per update\n", advances,
+		        elapsed / 1e3 / advances);
+	}
+
+	xmms_object_unref (playlist);
+	xmms_object_unref (colldag);
+	xmms_object_unref (medialib);
+	xmms_config_shutdown ();
+	xmms_ipc_shutdown ();
+
+	return EXIT_SUCCESS;
+}
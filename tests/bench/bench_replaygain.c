@@ -0,0 +1,160 @@
+/*  XMMS2 - X Music Multiplexer System
+ *  Copyright (C) 2003-2013 XMMS2 Team
+ *
+ *  PLUGINS ARE NOT CONSIDERED TO BE DERIVED WORK !!!
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ */
+
+/*
+ * Measures the replaygain kernels against the original one sample at a
+ * time implementation.
+ *
+ * Usage: bench_replaygain [seconds of audio]
+ */
+
+#include <glib.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <xmms/xmms_sample.h>
+
+#include "replaygain_apply.h"
+
+#define CHUNK 4096
+
+static void
+reference_s16 (void *buf, gint len, gfloat gain, xmms_replaygain_dither_t *d)
+{
+	xmms_samples16_t *samples = (xmms_samples16_t *) buf;
+	gint i;
+
+	for (i = 0; i < len; i++) {
+		gfloat sample = samples[i] * gain;
+		samples[i] = CLAMP (sample, XMMS_SAMPLES16_MIN,
+		                    XMMS_SAMPLES16_MAX);
+	}
+}
+
+static void
+reference_s32 (void *buf, gint len, gfloat gain, xmms_replaygain_dither_t *d)
+{
+	xmms_samples32_t *samples = (xmms_samples32_t *) buf;
+	gint i;
+
+	for (i = 0; i < len; i++) {
+		gdouble sample = samples[i] * gain;
+		samples[i] = CLAMP (sample, XMMS_SAMPLES32_MIN,
+		                    XMMS_SAMPLES32_MAX);
+	}
+}
+
+static void
+reference_float (void *buf, gint len, gfloat gain, xmms_replaygain_dither_t *d)
+{
+	xmms_samplefloat_t *samples = (xmms_samplefloat_t *) buf;
+	gint i;
+
+	for (i = 0; i < len; i++) {
+		samples[i] *= gain;
+	}
+}
+
+static void
+fill (void *buf, gint size)
+{
+	guint8 *p = buf;
+	gint i;
+
+	for (i = 0; i < size; i++) {
+		p[i] = g_random_int ();
+	}
+}
+
+static void
+fill_float (gfloat *buf, gint len)
+{
+	gint i;
+
+	for (i = 0; i < len; i++) {
+		buf[i] = g_random_double_range (-1.0, 1.0);
+	}
+}
+
+static gdouble
+run (const gchar *name, xmms_replaygain_apply_func_t func, gint size,
+     gboolean is_float, gint64 samples, xmms_replaygain_dither_t *dither)
+{
+	gint64 start, elapsed, done;
+	void *buf;
+	gdouble rate;
+
+	buf = g_malloc (CHUNK * size);
+
+	if (is_float) {
+		fill_float (buf, CHUNK);
+	} else {
+		fill (buf, CHUNK * size);
+	}
+
+	start = g_get_monotonic_time ();
+
+	/* alternate gains, so that the values stay bounded */
+	for (done = 0; done < samples; done += CHUNK) {
+		func (buf, CHUNK, (done / CHUNK) & 1 ? 1.25f : 0.8f, dither);
+	}
+
+	elapsed = MAX (g_get_monotonic_time () - start, 1);
+	rate = (gdouble) done / elapsed;
+
+	printf ("%-16s %10.1f Msamples/s\n", name, rate);
+
+	g_free (buf);
+
+	return rate;
+}
+
+int
+main (int argc, char **argv)
+{
+	xmms_replaygain_dither_t dither;
+	gint64 samples;
+	gdouble ref, rate;
+	gint seconds = 600;
+
+	if (argc > 1) {
+		seconds = atoi (argv[1]);
+	}
+
+	/* stereo 44.1kHz */
+	samples = (gint64) seconds * 44100 * 2;
+
+	xmms_replaygain_dither_init (&dither, 1);
+
+	printf ("applying gain to %d seconds of 44.1kHz stereo\n\n", seconds);
+
+	ref = run ("s16 reference", reference_s16, 2, FALSE, samples, NULL);
+	rate = run ("s16", xmms_replaygain_apply_s16, 2, FALSE, samples, NULL);
+	printf ("%-16s %10.2fx\n", "", rate / ref);
+	rate = run ("s16 dithered", xmms_replaygain_apply_s16, 2, FALSE, samples, &dither);
+	printf ("%-16s %10.2fx\n\n", "", rate / ref);
+
+	ref = run ("s32 reference", reference_s32, 4, FALSE, samples, NULL);
+	rate = run ("s32", xmms_replaygain_apply_s32, 4, FALSE, samples, NULL);
+	printf ("%-16s %10.2fx\n\n", "", rate / ref);
+
+	ref = run ("float reference", reference_float, 4, TRUE, samples, NULL);
+	rate = run ("float", xmms_replaygain_apply_float, 4, TRUE, samples, NULL);
+	printf ("%-16s %10.2fx\n", "", rate / ref);
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,130 @@
+/*  XMMS2 - X Music Multiplexer System
+ *  Copyright (C) 2003-2013 XMMS2 Team
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License
+ *  as published by the Free Software Foundation; either version 2
+ *  of the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ */
+
+/*
+ * Measures building and dropping a query result shaped like the list
+ * of dicts a medialib query returns, with values allocated from the
+ * value slabs and, in a child process started with XMMSV_NO_SLAB, with
+ * malloc.
+ *
+ * Usage: bench_xmmsv_alloc [rows] [rounds]
+ */
+
+#include <glib.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <xmmsc/xmmsv.h>
+
+static const gchar *artists[] = {
+	"Air", "Boards of Canada", "Can", "Daft Punk", "Eels",
+	"Four Tet", "Godspeed You! Black Emperor", "Hot Chip"
+};
+
+static xmmsv_t *
+build_result (gint rows)
+{
+	xmmsv_t *result, *row;
+	gchar title[64];
+	gint i;
+
+	result = xmmsv_new_list ();
+
+	for (i = 0; i < rows; i++) {
+		g_snprintf (title, sizeof (title), "Track number %d", i);
+
+		row = xmmsv_build_dict (XMMSV_DICT_ENTRY_INT ("id", i + 1),
+		                        XMMSV_DICT_ENTRY_STR ("artist", artists[i % G_N_ELEMENTS (artists)]),
+		                        XMMSV_DICT_ENTRY_STR ("album", "Some album"),
+		                        XMMSV_DICT_ENTRY_STR ("title", title),
+		                        XMMSV_DICT_ENTRY_INT ("tracknr", i % 20 + 1),
+		                        XMMSV_DICT_ENTRY_INT ("duration", 180000 + i),
+		                        XMMSV_DICT_END);
+		xmmsv_list_append (result, row);
+		xmmsv_unref (row);
+	}
+
+	return result;
+}
+
+static gdouble
+run (gint rows, gint rounds)
+{
+	gint64 start;
+	gint i;
+
+	/* warm up */
+	xmmsv_unref (build_result (rows));
+
+	start = g_get_monotonic_time ();
+	for (i = 0; i < rounds; i++) {
+		xmmsv_unref (build_result (rows));
+	}
+
+	return (gdouble) rounds * rows / MAX (g_get_monotonic_time () - start, 1);
+}
+
+int
+main (int argc, char **argv)
+{
+	gdouble malloc_rate, rate;
+	gint rows = 300000, rounds = 10;
+	gint fds[2], status;
+	pid_t pid;
+
+	if (argc > 1) {
+		rows = atoi (argv[1]);
+	}
+	if (argc > 2) {
+		rounds = MAX (atoi (argv[2]), 1);
+	}
+
+	printf ("building and freeing %d rows, %d times\n\n", rows, rounds);
+
+	/* the allocator is chosen on first use, so malloc runs in a child */
+	if (pipe (fds) < 0) {
+		perror ("pipe");
+		return EXIT_FAILURE;
+	}
+
+	pid = fork ();
+	if (pid < 0) {
+		perror ("fork");
+		return EXIT_FAILURE;
+	}
+
+	if (pid == 0) {
+		setenv ("XMMSV_NO_SLAB", "1", 1);
+		malloc_rate = run (rows, rounds);
+		if (write (fds[1], &malloc_rate, sizeof (malloc_rate)) != sizeof (malloc_rate)) {
+			_exit (EXIT_FAILURE);
+		}
+		_exit (EXIT_SUCCESS);
+	}
+
+	if (read (fds[0], &malloc_rate, sizeof (malloc_rate)) != sizeof (malloc_rate) ||
+	    waitpid (pid, &status, 0) < 0 || !WIFEXITED (status)) {
+		fprintf (stderr, "malloc run failed\n");
+		return EXIT_FAILURE;
+	}
+
+	printf ("  %-8s %8.2f Mrows/s\n", "malloc", malloc_rate);
+
+	rate = run (rows, rounds);
+	printf ("  %-8s %8.2f Mrows/s %6.2fx\n", "slab", rate, rate / malloc_rate);
+
+	return EXIT_SUCCESS;
+}
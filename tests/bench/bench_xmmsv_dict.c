@@ -0,0 +1,158 @@
+/*  XMMS2 - X Music Multiplexer System
+ *  Copyright (C) 2003-2013 XMMS2 Team
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License
+ *  as published by the Free Software Foundation; either version 2
+ *  of the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ */
+
+/*
+ * Measures the dict heavy parts of handling a query result: building
+ * rows of a few fields, looking fields up, copying and serializing the
+ * rows, and for comparison a single dict with many keys.
+ *
+ * Usage: bench_xmmsv_dict [rows] [rounds]
+ */
+
+#include <glib.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <xmmsc/xmmsv.h>
+
+static const gchar *fields[] = {
+	"id", "artist", "album", "title", "tracknr", "duration"
+};
+
+static xmmsv_t *
+build_result (gint rows)
+{
+	xmmsv_t *result, *row;
+	gchar title[64];
+	gint i;
+
+	result = xmmsv_new_list ();
+
+	for (i = 0; i < rows; i++) {
+		g_snprintf (title, sizeof (title), "Track number %d", i);
+
+		row = xmmsv_build_dict (XMMSV_DICT_ENTRY_INT ("id", i + 1),
+		                        XMMSV_DICT_ENTRY_STR ("artist", "Boards of Canada"),
+		                        XMMSV_DICT_ENTRY_STR ("album", "Some album"),
+		                        XMMSV_DICT_ENTRY_STR ("title", title),
+		                        XMMSV_DICT_ENTRY_INT ("tracknr", i % 20 + 1),
+		                        XMMSV_DICT_ENTRY_INT ("duration", 180000 + i),
+		                        XMMSV_DICT_END);
+		xmmsv_list_append (result, row);
+		xmmsv_unref (row);
+	}
+
+	return result;
+}
+
+static gint
+lookup_result (xmmsv_t *result)
+{
+	xmmsv_list_iter_t *it;
+	xmmsv_t *row, *value;
+	gint i, found = 0;
+
+	xmmsv_get_list_iter (result, &it);
+	for (; xmmsv_list_iter_entry (it, &row); xmmsv_list_iter_next (it)) {
+		for (i = 0; i < G_N_ELEMENTS (fields); i++) {
+			found += xmmsv_dict_get (row, fields[i], &value);
+		}
+		found += xmmsv_dict_get (row, "genre", &value);
+	}
+	xmmsv_list_iter_explicit_destroy (it);
+
+	return found;
+}
+
+static void
+report (const gchar *what, gdouble count, gint64 start)
+{
+	printf ("  %-12s %8.2f M/s\n", what,
+	        count / MAX (g_get_monotonic_time () - start, 1));
+}
+
+int
+main (int argc, char **argv)
+{
+	xmmsv_t *result, *copy, *bin, *big;
+	gint rows = 100000, rounds = 10;
+	gchar key[32];
+	gint64 start;
+	gint i, j;
+
+	if (argc > 1) {
+		rows = atoi (argv[1]);
+	}
+	if (argc > 2) {
+		rounds = MAX (atoi (argv[2]), 1);
+	}
+
+	printf ("%d rows of %d fields, %d times\n\n",
+	        rows, (gint) G_N_ELEMENTS (fields), rounds);
+
+	/* warm up */
+	xmmsv_unref (build_result (rows));
+
+	start = g_get_monotonic_time ();
+	for (i = 0; i < rounds; i++) {
+		xmmsv_unref (build_result (rows));
+	}
+	report ("build rows", (gdouble) rounds * rows, start);
+
+	result = build_result (rows);
+
+	start = g_get_monotonic_time ();
+	for (i = 0; i < rounds; i++) {
+		if (lookup_result (result) != rows * G_N_ELEMENTS (fields)) {
+			fprintf (stderr, "lookup failed\n");
+			return EXIT_FAILURE;
+		}
+	}
+	report ("lookups", (gdouble) rounds * rows * (G_N_ELEMENTS (fields) + 1), start);
+
+	start = g_get_monotonic_time ();
+	for (i = 0; i < rounds; i++) {
+		copy = xmmsv_copy (result);
+		xmmsv_unref (copy);
+	}
+	report ("copy rows", (gdouble) rounds * rows, start);
+
+	start = g_get_monotonic_time ();
+	for (i = 0; i < rounds; i++) {
+		bin = xmmsv_serialize (result);
+		copy = xmmsv_deserialize (bin);
+		xmmsv_unref (copy);
+		xmmsv_unref (bin);
+	}
+	report ("serialize", (gdouble) rounds * rows, start);
+
+	xmmsv_unref (result);
+
+	start = g_get_monotonic_time ();
+	for (i = 0; i < rounds; i++) {
+		big = xmmsv_new_dict ();
+		for (j = 0; j < rows; j++) {
+			g_snprintf (key, sizeof (key), "key %d", j);
+			xmmsv_dict_set_int (big, key, j);
+		}
+		for (j = 0; j < rows; j++) {
+			g_snprintf (key, sizeof (key), "key %d", j);
+			xmmsv_dict_remove (big, key);
+		}
+		xmmsv_unref (big);
+	}
+	report ("large dict", (gdouble) rounds * rows * 2, start);
+
+	return EXIT_SUCCESS;
+}
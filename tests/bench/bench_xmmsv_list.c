@@ -0,0 +1,102 @@
+/*  XMMS2 - X Music Multiplexer System
+ *  Copyright (C) 2003-2013 XMMS2 Team
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License
+ *  as published by the Free Software Foundation; either version 2
+ *  of the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ */
+
+/*
+ * Measures positional edits of a long idlist: removing the head while
+ * appending to the tail like a radio playlist does, inserting and moving
+ * at random positions, and walking the list by index and by iterator.
+ *
+ * Usage: bench_xmmsv_list [size] [edits]
+ */
+
+#include <glib.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <xmmsc/xmmsv.h>
+
+static void
+report (const gchar *what, gdouble count, gint64 start)
+{
+	printf ("  %-12s %8.2f M/s\n", what,
+	        count / MAX (g_get_monotonic_time () - start, 1));
+}
+
+int
+main (int argc, char **argv)
+{
+	xmmsv_list_iter_t *it;
+	xmmsv_t *coll;
+	gint size = 200000, edits = 100000;
+	gint64 start, sum = 0;
+	gint i, id;
+
+	if (argc > 1) {
+		size = MAX (atoi (argv[1]), 1);
+	}
+	if (argc > 2) {
+		edits = atoi (argv[2]);
+	}
+
+	printf ("idlist of %d entries, %d edits\n\n", size, edits);
+
+	coll = xmmsv_new_coll (XMMS_COLLECTION_TYPE_IDLIST);
+
+	start = g_get_monotonic_time ();
+	for (i = 0; i < size; i++) {
+		xmmsv_coll_idlist_append (coll, i + 1);
+	}
+	report ("append", size, start);
+
+	start = g_get_monotonic_time ();
+	for (i = 0; i < edits; i++) {
+		xmmsv_coll_idlist_remove (coll, 0);
+		xmmsv_coll_idlist_append (coll, i + 1);
+	}
+	report ("head/tail", edits, start);
+
+	srand (1);
+
+	start = g_get_monotonic_time ();
+	for (i = 0; i < edits; i++) {
+		xmmsv_coll_idlist_insert (coll, rand () % size, i + 1);
+		xmmsv_coll_idlist_remove (coll, rand () % size);
+	}
+	report ("insert", edits, start);
+
+	start = g_get_monotonic_time ();
+	for (i = 0; i < edits; i++) {
+		xmmsv_coll_idlist_move (coll, rand () % size, rand () % size);
+	}
+	report ("move", edits, start);
+
+	start = g_get_monotonic_time ();
+	for (i = 0; i < size; i++) {
+		xmmsv_coll_idlist_get_index (coll, i, &id);
+		sum += id;
+	}
+	report ("get index", size, start);
+
+	start = g_get_monotonic_time ();
+	xmmsv_get_list_iter (xmmsv_coll_idlist_get (coll), &it);
+	for (; xmmsv_list_iter_entry_int (it, &id); xmmsv_list_iter_next (it)) {
+		sum -= id;
+	}
+	xmmsv_list_iter_explicit_destroy (it);
+	report ("iterate", size, start);
+
+	xmmsv_unref (coll);
+
+	return sum == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,412 @@
+/*  XMMS2 - X Music Multiplexer System
+ *  Copyright (C) 2003-2013 XMMS2 Team
+ *
+ *  PLUGINS ARE NOT CONSIDERED TO BE DERIVED WORK !!!
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ */
+
+#include "xcu.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+#include <xmmsc/xmmsc_ipc_msg.h>
+#include <xmmsc/xmmsc_ipc_transport.h>
+
+#define MOCK_BUFFER_SIZE (4 * XMMS_IPC_MSG_WRITE_MAX)
+
+/* A transport that writes to memory instead of a socket */
+typedef struct {
+	char buf[MOCK_BUFFER_SIZE];
+	int len;
+
+	/* most bytes taken by a single write, 0 for no limit */
+	int limit;
+
+	/* what the next write returns instead of writing: 0 for a
+	 * disconnect, SOCKET_ERROR with errno set, or 1 to write */
+	int result;
+	int error;
+
+	int writes;
+} mock_t;
+
+static mock_t mock;
+static xmms_ipc_transport_t transport;
+
+static int
+mock_write (xmms_ipc_transport_t *ipct, char *buffer, int len)
+{
+	mock_t *m = ipct->data;
+
+	m->writes++;
+
+	if (m->result != 1) {
+		errno = m->error;
+		return m->result;
+	}
+
+	if (m->limit > 0 && len > m->limit) {
+		len = m->limit;
+	}
+
+	memcpy (m->buf + m->len, buffer, len);
+	m->len += len;
+
+	return len;
+}
+
+static xmms_ipc_msg_t *
+create_msg (uint32_t cookie, int size)
+{
+	xmms_ipc_msg_t *msg;
+	xmmsv_t *value;
+	char *str;
+
+	str = malloc (size + 1);
+	memset (str, 'a' + cookie % 26, size);
+	str[size] = '\0';
+
+	msg = xmms_ipc_msg_new (cookie % 7, cookie % 11);
+	xmms_ipc_msg_set_cookie (msg, cookie);
+
+	value = xmmsv_new_string (str);
+	xmms_ipc_msg_put_value (msg, value);
+	xmmsv_unref (value);
+
+	free (str);
+
+	return msg;
+}
+
+/* The bytes of msg as written by itself */
+static int
+serialize_msg (xmms_ipc_msg_t *msg, char *buf)
+{
+	mock_t single;
+	xmms_ipc_transport_t t;
+
+	memset (&single, 0, sizeof (single));
+	single.result = 1;
+
+	memset (&t, 0, sizeof (t));
+	t.data = &single;
+	t.write_func = mock_write;
+
+	CU_ASSERT_TRUE (xmms_ipc_msg_write_transport (msg, &t, NULL));
+	memcpy (buf, single.buf, single.len);
+
+	return single.len;
+}
+
+/* Create count messages, and the bytes they should be written as */
+static int
+create_msgs (xmms_ipc_msg_t **msgs, int count, int size, char *expected)
+{
+	xmms_ipc_msg_t *copy;
+	int i, len = 0;
+
+	for (i = 0; i < count; i++) {
+		msgs[i] = create_msg (i, size);
+
+		/* serializing marks a message as written, use a twin */
+		copy = create_msg (i, size);
+		len += serialize_msg (copy, expected + len);
+		xmms_ipc_msg_destroy (copy);
+	}
+
+	return len;
+}
+
+static void
+destroy_msgs (xmms_ipc_msg_t **msgs, int count)
+{
+	int i;
+
+	for (i = 0; i < count; i++) {
+		xmms_ipc_msg_destroy (msgs[i]);
+	}
+}
+
+/* Check that msg is the one create_msg made for cookie */
+static void
+check_msg (xmms_ipc_msg_t *msg, uint32_t cookie, int size)
+{
+	const char *str;
+	xmmsv_t *value;
+
+	CU_ASSERT_EQUAL (cookie, xmms_ipc_msg_get_cookie (msg));
+	CU_ASSERT_EQUAL (cookie % 7, xmms_ipc_msg_get_object (msg));
+	CU_ASSERT_EQUAL (cookie % 11, xmms_ipc_msg_get_cmd (msg));
+
+	CU_ASSERT_TRUE (xmms_ipc_msg_get_value (msg, &value));
+	CU_ASSERT_TRUE (xmmsv_get_string (value, &str));
+	CU_ASSERT_EQUAL (size, strlen (str));
+	CU_ASSERT_EQUAL ('a' + cookie % 26, str[0]);
+	CU_ASSERT_EQUAL ('a' + cookie % 26, str[size - 1]);
+	xmmsv_unref (value);
+}
+
+/* Feed buf to put_data in chunks of step bytes, return the messages read */
+static int
+split_msgs (const char *buf, int len, int step, xmms_ipc_msg_t **msgs)
+{
+	xmms_ipc_msg_t *msg;
+	unsigned int used;
+	int pos, end, count = 0;
+	bool complete;
+
+	msg = xmms_ipc_msg_alloc ();
+
+	for (pos = 0; pos < len; pos = end) {
+		end = pos + step < len ? pos + step : len;
+
+		while (pos < end) {
+			used = xmms_ipc_msg_put_data (msg, buf + pos, end - pos, &complete);
+			pos += used;
+
+			if (complete) {
+				msgs[count++] = msg;
+				msg = xmms_ipc_msg_alloc ();
+			} else {
+				/* everything is taken until the message is complete */
+				CU_ASSERT_EQUAL (end, pos);
+			}
+		}
+	}
+
+	xmms_ipc_msg_destroy (msg);
+
+	return count;
+}
+
+SETUP (ipc_msg) {
+	memset (&mock, 0, sizeof (mock));
+	mock.result = 1;
+
+	memset (&transport, 0, sizeof (transport));
+	transport.data = &mock;
+	transport.write_func = mock_write;
+
+	return 0;
+}
+
+CLEANUP () {
+	return 0;
+}
+
+CASE (test_write_many_single_write)
+{
+	xmms_ipc_msg_t *msgs[8];
+	char expected[MOCK_BUFFER_SIZE];
+	bool disconnected = false;
+	int len;
+
+	len = create_msgs (msgs, 8, 100, expected);
+
+	CU_ASSERT_EQUAL (8, xmms_ipc_msg_write_transport_many (msgs, 8, &transport,
+	                                                        &disconnected));
+	CU_ASSERT_FALSE (disconnected);
+	CU_ASSERT_EQUAL (1, mock.writes);
+	CU_ASSERT_EQUAL (len, mock.len);
+	CU_ASSERT_EQUAL (0, memcmp (expected, mock.buf, len));
+
+	destroy_msgs (msgs, 8);
+}
+
+CASE (test_write_many_multiple_chunks)
+{
+	xmms_ipc_msg_t *msgs[6];
+	char expected[MOCK_BUFFER_SIZE];
+	bool disconnected = false;
+	int len, written, sent = 0;
+
+	/* two messages fit in a single write, three don't */
+	len = create_msgs (msgs, 6, XMMS_IPC_MSG_WRITE_MAX / 3, expected);
+
+	while (sent < 6) {
+		written = xmms_ipc_msg_write_transport_many (msgs + sent, 6 - sent,
+		                                             &transport, &disconnected);
+		CU_ASSERT_EQUAL (2, written);
+		if (written == 0) {
+			break;
+		}
+		sent += written;
+	}
+
+	CU_ASSERT_FALSE (disconnected);
+	CU_ASSERT_EQUAL (3, mock.writes);
+	CU_ASSERT_EQUAL (len, mock.len);
+	CU_ASSERT_EQUAL (0, memcmp (expected, mock.buf, len));
+
+	destroy_msgs (msgs, 6);
+}
+
+CASE (test_write_many_oversized)
+{
+	xmms_ipc_msg_t *msgs[2];
+	char expected[MOCK_BUFFER_SIZE];
+	bool disconnected = false;
+	int len;
+
+	/* larger than a single gathered write, sent on its own */
+	len = create_msgs (msgs, 2, XMMS_IPC_MSG_WRITE_MAX + 100, expected);
+
+	CU_ASSERT_EQUAL (1, xmms_ipc_msg_write_transport_many (msgs, 2, &transport,
+	                                                        &disconnected));
+	CU_ASSERT_EQUAL (1, xmms_ipc_msg_write_transport_many (msgs + 1, 1, &transport,
+	                                                        &disconnected));
+	CU_ASSERT_FALSE (disconnected);
+	CU_ASSERT_EQUAL (2, mock.writes);
+	CU_ASSERT_EQUAL (len, mock.len);
+	CU_ASSERT_EQUAL (0, memcmp (expected, mock.buf, len));
+
+	destroy_msgs (msgs, 2);
+}
+
+CASE (test_write_many_partial)
+{
+	xmms_ipc_msg_t *msgs[5];
+	char expected[MOCK_BUFFER_SIZE];
+	bool disconnected = false;
+	int len, written, sent = 0, calls = 0;
+
+	len = create_msgs (msgs, 5, 50, expected);
+
+	/* each write stops in the middle of a message */
+	mock.limit = 37;
+
+	while (sent < 5 && calls++ < 100) {
+		written = xmms_ipc_msg_write_transport_many (msgs + sent, 5 - sent,
+		                                             &transport, &disconnected);
+		CU_ASSERT_TRUE (written >= 0 && written <= 2);
+		sent += written;
+	}
+
+	CU_ASSERT_EQUAL (5, sent);
+	CU_ASSERT_FALSE (disconnected);
+	CU_ASSERT_EQUAL (len, mock.len);
+	CU_ASSERT_EQUAL (0, memcmp (expected, mock.buf, len));
+
+	destroy_msgs (msgs, 5);
+}
+
+CASE (test_write_many_errors)
+{
+	xmms_ipc_msg_t *msgs[3];
+	char expected[MOCK_BUFFER_SIZE];
+	bool disconnected = false;
+	int len;
+
+	len = create_msgs (msgs, 3, 10, expected);
+
+	/* nothing is lost when the socket would block */
+	mock.result = SOCKET_ERROR;
+	mock.error = EAGAIN;
+	CU_ASSERT_EQUAL (0, xmms_ipc_msg_write_transport_many (msgs, 3, &transport,
+	                                                        &disconnected));
+	CU_ASSERT_FALSE (disconnected);
+
+	mock.result = 1;
+	CU_ASSERT_EQUAL (3, xmms_ipc_msg_write_transport_many (msgs, 3, &transport,
+	                                                        &disconnected));
+	CU_ASSERT_FALSE (disconnected);
+	CU_ASSERT_EQUAL (len, mock.len);
+	CU_ASSERT_EQUAL (0, memcmp (expected, mock.buf, len));
+
+	destroy_msgs (msgs, 3);
+
+	create_msgs (msgs, 3, 10, expected);
+
+	mock.result = SOCKET_ERROR;
+	mock.error = EPIPE;
+	CU_ASSERT_EQUAL (0, xmms_ipc_msg_write_transport_many (msgs, 3, &transport,
+	                                                        &disconnected));
+	CU_ASSERT_TRUE (disconnected);
+
+	disconnected = false;
+	mock.result = 0;
+	CU_ASSERT_EQUAL (0, xmms_ipc_msg_write_transport_many (msgs, 3, &transport,
+	                                                        &disconnected));
+	CU_ASSERT_TRUE (disconnected);
+
+	destroy_msgs (msgs, 3);
+}
+
+CASE (test_put_data_chunks)
+{
+	xmms_ipc_msg_t *msgs[4], *read[5];
+	char buf[MOCK_BUFFER_SIZE];
+	const int steps[] = { 1, 7, 16, 17, 100, 4096, MOCK_BUFFER_SIZE };
+	int i, j, len, count;
+
+	len = create_msgs (msgs, 4, 300, buf);
+	destroy_msgs (msgs, 4);
+
+	for (i = 0; i < sizeof (steps) / sizeof (steps[0]); i++) {
+		count = split_msgs (buf, len, steps[i], read);
+		CU_ASSERT_EQUAL (4, count);
+
+		for (j = 0; j < count; j++) {
+			check_msg (read[j], j, 300);
+		}
+
+		destroy_msgs (read, count);
+	}
+}
+
+CASE (test_put_data_partial)
+{
+	xmms_ipc_msg_t *msgs[2], *msg;
+	char buf[MOCK_BUFFER_SIZE];
+	unsigned int used;
+	bool complete;
+	int len, first;
+
+	len = create_msgs (msgs, 2, 20, buf);
+	destroy_msgs (msgs, 2);
+	first = len / 2;
+
+	msg = xmms_ipc_msg_alloc ();
+
+	/* nothing to take */
+	CU_ASSERT_EQUAL (0, xmms_ipc_msg_put_data (msg, buf, 0, &complete));
+	CU_ASSERT_FALSE (complete);
+
+	/* only part of the header */
+	CU_ASSERT_EQUAL (10, xmms_ipc_msg_put_data (msg, buf, 10, &complete));
+	CU_ASSERT_FALSE (complete);
+
+	/* the rest of the first message and the start of the second,
+	 * only the first message is taken */
+	used = xmms_ipc_msg_put_data (msg, buf + 10, len - 10 - 5, &complete);
+	CU_ASSERT_TRUE (complete);
+	CU_ASSERT_EQUAL (first - 10, used);
+	check_msg (msg, 0, 20);
+
+	/* a complete message doesn't take any more */
+	CU_ASSERT_EQUAL (0, xmms_ipc_msg_put_data (msg, buf + first, len - first,
+	                                           &complete));
+	CU_ASSERT_TRUE (complete);
+	xmms_ipc_msg_destroy (msg);
+
+	msg = xmms_ipc_msg_alloc ();
+	CU_ASSERT_EQUAL (len - first - 5,
+	                 xmms_ipc_msg_put_data (msg, buf + first, len - first - 5,
+	                                        &complete));
+	CU_ASSERT_FALSE (complete);
+	CU_ASSERT_EQUAL (5, xmms_ipc_msg_put_data (msg, buf + len - 5, 5, &complete));
+	CU_ASSERT_TRUE (complete);
+	check_msg (msg, 1, 20);
+	xmms_ipc_msg_destroy (msg);
+}
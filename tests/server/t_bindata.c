@@ -0,0 +1,280 @@
+/*  XMMS2 - X Music Multiplexer System
+ *  Copyright (C) 2003-2013 XMMS2 Team
+ *
+ *  PLUGINS ARE NOT CONSIDERED TO BE DERIVED WORK !!!
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ */
+
+#include "xcu.h"
+
+#include <glib.h>
+#include <glib/gstdio.h>
+#include <string.h>
+
+#include <xmmspriv/xmms_log.h>
+#include <xmmspriv/xmms_ipc.h>
+#include <xmmspriv/xmms_config.h>
+#include <xmms/xmms_bindata.h>
+#include <xmmspriv/xmms_bindata.h>
+
+#include "server-utils/ipc_call.h"
+
+/* stored flat in the bindata directory, as older versions did */
+#define LEGACY_DATA "legacy blob"
+
+static xmms_bindata_t *bindata;
+static gchar *bindir;
+static gchar legacy[33];
+
+static gchar *
+blob_path (const gchar *hash)
+{
+	gchar shard[3] = { hash[0], hash[1], '\0' };
+
+	return g_build_filename (bindir, shard, hash, NULL);
+}
+
+static void
+remove_tree (const gchar *path)
+{
+	const gchar *name;
+	gchar *child;
+	GDir *dir;
+
+	dir = g_dir_open (path, 0, NULL);
+	if (dir != NULL) {
+		while ((name = g_dir_read_name (dir))) {
+			child = g_build_filename (path, name, NULL);
+			remove_tree (child);
+			g_free (child);
+		}
+		g_dir_close (dir);
+		g_rmdir (path);
+	} else {
+		g_unlink (path);
+	}
+}
+
+static gboolean
+list_contains (xmmsv_t *list, const gchar *hash)
+{
+	const gchar *str;
+	gint i;
+
+	for (i = 0; xmmsv_list_get_string (list, i, &str); i++) {
+		if (strcmp (str, hash) == 0) {
+			return TRUE;
+		}
+	}
+
+	return FALSE;
+}
+
+static gchar *
+add_data (const gchar *data)
+{
+	const gchar *hash;
+	gchar *ret = NULL;
+	xmmsv_t *result;
+
+	result = XMMS_IPC_CALL (bindata, XMMS_IPC_CMD_ADD_DATA,
+	                        xmmsv_new_bin ((const guchar *) data, strlen (data)));
+	if (xmmsv_get_string (result, &hash)) {
+		ret = g_strdup (hash);
+	}
+	xmmsv_unref (result);
+
+	return ret;
+}
+
+SETUP (bindata) {
+	gchar *path;
+
+	xmms_ipc_init ();
+
+	xmms_log_init (0);
+
+	bindir = g_dir_make_tmp ("t_bindata-XXXXXX", NULL);
+
+	xmms_bindata_calculate_md5 ((const guchar *) LEGACY_DATA,
+	                            strlen (LEGACY_DATA), legacy);
+
+	path = g_build_filename (bindir, legacy, NULL);
+	g_file_set_contents (path, LEGACY_DATA, -1, NULL);
+	g_free (path);
+
+	path = g_build_filename (bindir, "notes.txt", NULL);
+	g_file_set_contents (path, "not a blob", -1, NULL);
+	g_free (path);
+
+	xmms_config_init ("memory://");
+	xmms_config_property_register ("bindata.path", bindir, NULL, NULL);
+
+	bindata = xmms_bindata_init ();
+
+	return 0;
+}
+
+CLEANUP () {
+	xmms_object_unref (bindata); bindata = NULL;
+	xmms_config_shutdown ();
+	xmms_ipc_shutdown ();
+
+	remove_tree (bindir);
+	g_free (bindir); bindir = NULL;
+
+	return 0;
+}
+
+CASE (test_index_load_moves_flat_blobs)
+{
+	const guchar *data;
+	xmmsv_t *result;
+	gchar *path;
+	guint len;
+
+	path = g_build_filename (bindir, legacy, NULL);
+	CU_ASSERT_FALSE (g_file_test (path, G_FILE_TEST_EXISTS));
+	g_free (path);
+
+	path = blob_path (legacy);
+	CU_ASSERT_TRUE (g_file_test (path, G_FILE_TEST_IS_REGULAR));
+	g_free (path);
+
+	/* anything not named by a hash is left alone */
+	path = g_build_filename (bindir, "notes.txt", NULL);
+	CU_ASSERT_TRUE (g_file_test (path, G_FILE_TEST_IS_REGULAR));
+	g_free (path);
+
+	result = XMMS_IPC_CALL (bindata, XMMS_IPC_CMD_LIST_DATA, NULL);
+	CU_ASSERT_EQUAL (1, xmmsv_list_get_size (result));
+	CU_ASSERT_TRUE (list_contains (result, legacy));
+	xmmsv_unref (result);
+
+	result = XMMS_IPC_CALL (bindata, XMMS_IPC_CMD_GET_DATA,
+	                        xmmsv_new_string (legacy));
+	CU_ASSERT_TRUE (xmmsv_get_bin (result, &data, &len));
+	CU_ASSERT_EQUAL (strlen (LEGACY_DATA), len);
+	CU_ASSERT_EQUAL (0, memcmp (LEGACY_DATA, data, len));
+	xmmsv_unref (result);
+}
+
+CASE (test_invalid_hash)
+{
+	const gchar *invalid[] = {
+		"",
+		"0123456789abcdef",
+		"0123456789abcdef0123456789abcdef0",
+		"0123456789abcdef0123456789abcdeg",
+		"0123456789abcdef0123456789abcde/",
+		"../../../../../../../../etc/passwd",
+		"../notes.txt",
+		NULL
+	};
+	xmmsv_t *result;
+	gchar *path;
+	gint i;
+
+	for (i = 0; invalid[i]; i++) {
+		result = XMMS_IPC_CALL (bindata, XMMS_IPC_CMD_GET_DATA,
+		                        xmmsv_new_string (invalid[i]));
+		CU_ASSERT_TRUE (xmmsv_is_type (result, XMMSV_TYPE_ERROR));
+		xmmsv_unref (result);
+
+		result = XMMS_IPC_CALL (bindata, XMMS_IPC_CMD_REMOVE_DATA,
+		                        xmmsv_new_string (invalid[i]));
+		CU_ASSERT_TRUE (xmmsv_is_type (result, XMMSV_TYPE_ERROR));
+		xmmsv_unref (result);
+	}
+
+	path = g_build_filename (bindir, "notes.txt", NULL);
+	CU_ASSERT_TRUE (g_file_test (path, G_FILE_TEST_IS_REGULAR));
+	g_free (path);
+}
+
+CASE (test_remove_drops_cache_and_index)
+{
+	xmmsv_t *result;
+	gchar *hash, *path;
+
+	hash = add_data ("cached blob");
+	CU_ASSERT_PTR_NOT_NULL_FATAL (hash);
+
+	/* mapped and kept in the cache */
+	result = XMMS_IPC_CALL (bindata, XMMS_IPC_CMD_GET_DATA,
+	                        xmmsv_new_string (hash));
+	CU_ASSERT_TRUE (xmmsv_is_type (result, XMMSV_TYPE_BIN));
+	xmmsv_unref (result);
+
+	result = XMMS_IPC_CALL (bindata, XMMS_IPC_CMD_REMOVE_DATA,
+	                        xmmsv_new_string (hash));
+	CU_ASSERT_FALSE (xmmsv_is_type (result, XMMSV_TYPE_ERROR));
+	xmmsv_unref (result);
+
+	path = blob_path (hash);
+	CU_ASSERT_FALSE (g_file_test (path, G_FILE_TEST_EXISTS));
+	g_free (path);
+
+	/* not served from the cache either */
+	result = XMMS_IPC_CALL (bindata, XMMS_IPC_CMD_GET_DATA,
+	                        xmmsv_new_string (hash));
+	CU_ASSERT_TRUE (xmmsv_is_type (result, XMMSV_TYPE_ERROR));
+	xmmsv_unref (result);
+
+	result = XMMS_IPC_CALL (bindata, XMMS_IPC_CMD_LIST_DATA, NULL);
+	CU_ASSERT_FALSE (list_contains (result, hash));
+	CU_ASSERT_TRUE (list_contains (result, legacy));
+	xmmsv_unref (result);
+
+	/* adding it again writes it back */
+	g_free (hash);
+	hash = add_data ("cached blob");
+	CU_ASSERT_PTR_NOT_NULL_FATAL (hash);
+
+	path = blob_path (hash);
+	CU_ASSERT_TRUE (g_file_test (path, G_FILE_TEST_IS_REGULAR));
+	g_free (path);
+
+	g_free (hash);
+}
+
+CASE (test_list_from_index)
+{
+	gchar *hash, *path, *shard;
+	gchar stray[33];
+	xmmsv_t *result;
+
+	hash = add_data ("listed blob");
+	CU_ASSERT_PTR_NOT_NULL_FATAL (hash);
+
+	/* files changed behind the back of the server aren't noticed */
+	path = blob_path (hash);
+	g_unlink (path);
+	g_free (path);
+
+	xmms_bindata_calculate_md5 ((const guchar *) "stray", 5, stray);
+	path = blob_path (stray);
+	shard = g_path_get_dirname (path);
+	g_mkdir (shard, 0755);
+	g_file_set_contents (path, "stray", -1, NULL);
+	g_free (shard);
+	g_free (path);
+
+	result = XMMS_IPC_CALL (bindata, XMMS_IPC_CMD_LIST_DATA, NULL);
+	CU_ASSERT_EQUAL (2, xmmsv_list_get_size (result));
+	CU_ASSERT_TRUE (list_contains (result, hash));
+	CU_ASSERT_TRUE (list_contains (result, legacy));
+	CU_ASSERT_FALSE (list_contains (result, stray));
+	xmmsv_unref (result);
+
+	g_free (hash);
+}
@@ -4,6 +4,8 @@
 #include <xmmspriv/xmms_ipc.h>
 #include <xmmspriv/xmms_config.h>
 #include <xmmspriv/xmms_medialib.h>
+#include <xmmspriv/xmms_plugin.h>
+#include <xmmspriv/xmms_xform.h>
 
 #include "utils/jsonism.h"
 #include "utils/value_utils.h"
@@ -182,6 +184,53 @@ CASE (test_entry_cleanup)
 	xmmsv_unref (universe);
 }
 
+CASE (test_entry_properties_set)
+{
+	xmms_medialib_session_t *session;
+	xmms_medialib_entry_t entry;
+	xmmsv_t *properties, *result;
+	guint written, skipped;
+	gchar *string;
+
+	entry = xmms_mock_entry (medialib, 1, "Red Fang", "Red Fang", "Prehistoric Dog");
+
+	properties = xmmsv_from_xson ("{ 'title': { 'server': 'Prehistoric Dog' },"
+	                              "  'tracknr': { 'server': 2 },"
+	                              "  'genre': { 'plugin/id3v2': 'Stoner' } }");
+
+	/* unchanged title is skipped, stale derived album and artist go away */
+	session = xmms_medialib_session_begin (medialib);
+	xmms_medialib_entry_properties_set (session, entry, properties, TRUE,
+	                                    &written, &skipped);
+	xmms_medialib_session_commit (session);
+
+	CU_ASSERT_EQUAL (2, written);
+	CU_ASSERT_EQUAL (1, skipped);
+
+	session = xmms_medialib_session_begin (medialib);
+	CU_ASSERT_EQUAL (2, xmms_medialib_entry_property_get_int (session, entry, "tracknr"));
+	string = xmms_medialib_entry_property_get_str (session, entry, "genre");
+	CU_ASSERT_STRING_EQUAL ("Stoner", string);
+	g_free (string);
+	result = xmms_medialib_entry_property_get_value (session, entry, "artist");
+	CU_ASSERT_PTR_NULL (result);
+	string = xmms_medialib_entry_property_get_str (session, entry, "url");
+	CU_ASSERT_PTR_NOT_NULL (string);
+	g_free (string);
+	xmms_medialib_session_commit (session);
+
+	/* a second pass with the same values writes nothing */
+	session = xmms_medialib_session_begin (medialib);
+	xmms_medialib_entry_properties_set (session, entry, properties, TRUE,
+	                                    &written, &skipped);
+	xmms_medialib_session_commit (session);
+
+	CU_ASSERT_EQUAL (0, written);
+	CU_ASSERT_EQUAL (3, skipped);
+
+	xmmsv_unref (properties);
+}
+
 CASE (test_not_resolved)
 {
 	xmms_medialib_session_t *session;
@@ -492,6 +541,59 @@ CASE (test_organize_fetch_spec)
 	xmmsv_unref (universe);
 }
 
+CASE (test_columns_fetch_spec)
+{
+	xmmsv_t *universe, *spec, *result, *columns, *column, *strings;
+	xmms_error_t err;
+	const gchar *str;
+	gint count, pos;
+
+	xmms_mock_entry (medialib, 1, "Red Fang", "Red Fang", "Prehistoric Dog");
+
+	universe = xmmsv_new_coll (XMMS_COLLECTION_TYPE_UNIVERSE);
+
+	/* missing 'fields' parameter */
+	spec = xmmsv_from_xson ("{ 'type': 'columns' }");
+	CU_ASSERT_PTR_NULL (medialib_query (universe, spec, &err));
+	CU_ASSERT_TRUE (xmms_error_iserror (&err));
+	xmmsv_unref (spec);
+
+	/* empty 'fields' parameter */
+	spec = xmmsv_from_xson ("{ 'type': 'columns', 'fields': [] }");
+	CU_ASSERT_PTR_NULL (medialib_query (universe, spec, &err));
+	CU_ASSERT_TRUE (xmms_error_iserror (&err));
+	xmmsv_unref (spec);
+
+	/* invalid 'fields' content */
+	spec = xmmsv_from_xson ("{ 'type': 'columns', 'fields': [0] }");
+	CU_ASSERT_PTR_NULL (medialib_query (universe, spec, &err));
+	CU_ASSERT_TRUE (xmms_error_iserror (&err));
+	xmmsv_unref (spec);
+
+	/* valid 'fields' content */
+	spec = xmmsv_build_columns (xmmsv_from_xson ("['artist', 'tracknr']"), NULL);
+	result = medialib_query (universe, spec, &err);
+	CU_ASSERT_FALSE (xmms_error_iserror (&err));
+	CU_ASSERT_TRUE (xmmsv_dict_entry_get_int (result, "count", &count));
+	CU_ASSERT_EQUAL (1, count);
+
+	CU_ASSERT_TRUE (xmmsv_dict_get (result, "columns", &columns));
+	CU_ASSERT_TRUE (xmmsv_dict_get (columns, "tracknr", &column));
+	CU_ASSERT_TRUE (xmmsv_list_get_int (column, 0, &pos));
+	CU_ASSERT_EQUAL (1, pos);
+
+	CU_ASSERT_TRUE (xmmsv_dict_get (columns, "artist", &column));
+	CU_ASSERT_TRUE (xmmsv_list_get_int (column, 0, &pos));
+	CU_ASSERT_TRUE (xmmsv_dict_get (result, "strings", &strings));
+	CU_ASSERT_TRUE (xmmsv_list_get_string (strings, pos, &str));
+	CU_ASSERT_STRING_EQUAL ("Red Fang", str);
+
+	xmmsv_unref (spec);
+	xmmsv_unref (result);
+
+	xmmsv_unref (universe);
+}
+
 CASE(test_client_rehash)
 {
 	xmms_medialib_session_t *session;
@@ -574,6 +676,160 @@ CASE(test_client_get_info)
 	xmmsv_unref (result);
 }
 
+/* The id of the tree at pos in a get_infos result, or -1 */
+static gint
+infos_get_id (xmmsv_t *infos, gint pos)
+{
+	xmmsv_t *tree, *id, *server;
+	gint value;
+
+	if (!xmmsv_list_get (infos, pos, &tree) ||
+	    !xmmsv_dict_get (tree, "id", &id) ||
+	    !xmmsv_dict_get (id, "server", &server) ||
+	    !xmmsv_get_int (server, &value)) {
+		return -1;
+	}
+
+	return value;
+}
+
+CASE(test_client_get_infos_order)
+{
+	xmms_medialib_entry_t first, second, third;
+	xmmsv_t *result, *tree, *title, *server;
+	const gchar *value;
+
+	first = xmms_mock_entry (medialib, 1, "Red Fang", "Red Fang", "Prehistoric Dog");
+	second = xmms_mock_entry (medialib, 2, "Red Fang", "Red Fang", "Reverse Thunder");
+	third = xmms_mock_entry (medialib, 3, "Red Fang", "Red Fang", "Night Destroyer");
+
+	result = XMMS_IPC_CALL (medialib, XMMS_IPC_CMD_INFOS,
+	                        xmmsv_build_list (XMMSV_LIST_ENTRY_INT (third),
+	                                          XMMSV_LIST_ENTRY_INT (first),
+	                                          XMMSV_LIST_ENTRY_INT (second),
+	                                          XMMSV_LIST_END),
+	                        xmmsv_new_list ());
+	CU_ASSERT (xmmsv_is_type (result, XMMSV_TYPE_LIST));
+	CU_ASSERT_EQUAL (3, xmmsv_list_get_size (result));
+	CU_ASSERT_EQUAL (third, infos_get_id (result, 0));
+	CU_ASSERT_EQUAL (first, infos_get_id (result, 1));
+	CU_ASSERT_EQUAL (second, infos_get_id (result, 2));
+
+	CU_ASSERT (xmmsv_list_get (result, 0, &tree));
+	CU_ASSERT (xmmsv_dict_get (tree, "title", &title));
+	CU_ASSERT (xmmsv_dict_get (title, "server", &server));
+	CU_ASSERT (xmmsv_get_string (server, &value));
+	CU_ASSERT_STRING_EQUAL ("Night Destroyer", value);
+	xmmsv_unref (result);
+
+	result = XMMS_IPC_CALL (medialib, XMMS_IPC_CMD_INFOS,
+	                        xmmsv_new_list (), xmmsv_new_list ());
+	CU_ASSERT (xmmsv_is_type (result, XMMSV_TYPE_LIST));
+	CU_ASSERT_EQUAL (0, xmmsv_list_get_size (result));
+	xmmsv_unref (result);
+}
+
+CASE(test_client_get_infos_missing)
+{
+	xmms_medialib_entry_t first, second;
+	xmmsv_t *result;
+
+	first = xmms_mock_entry (medialib, 1, "Red Fang", "Red Fang", "Prehistoric Dog");
+	second = xmms_mock_entry (medialib, 2, "Red Fang", "Red Fang", "Reverse Thunder");
+
+	/* entries that don't exist are left out */
+	result = XMMS_IPC_CALL (medialib, XMMS_IPC_CMD_INFOS,
+	                        xmmsv_build_list (XMMSV_LIST_ENTRY_INT (1337),
+	                                          XMMSV_LIST_ENTRY_INT (second),
+	                                          XMMSV_LIST_ENTRY_INT (0),
+	                                          XMMSV_LIST_ENTRY_INT (-1),
+	                                          XMMSV_LIST_ENTRY_INT (first),
+	                                          XMMSV_LIST_END),
+	                        xmmsv_new_list ());
+	CU_ASSERT (xmmsv_is_type (result, XMMSV_TYPE_LIST));
+	CU_ASSERT_EQUAL (2, xmmsv_list_get_size (result));
+	CU_ASSERT_EQUAL (second, infos_get_id (result, 0));
+	CU_ASSERT_EQUAL (first, infos_get_id (result, 1));
+	xmmsv_unref (result);
+
+	result = XMMS_IPC_CALL (medialib, XMMS_IPC_CMD_INFOS,
+	                        xmmsv_build_list (XMMSV_LIST_ENTRY_INT (1337),
+	                                          XMMSV_LIST_END),
+	                        xmmsv_new_list ());
+	CU_ASSERT (xmmsv_is_type (result, XMMSV_TYPE_LIST));
+	CU_ASSERT_EQUAL (0, xmmsv_list_get_size (result));
+	xmmsv_unref (result);
+
+	/* ids must all be integers */
+	result = XMMS_IPC_CALL (medialib, XMMS_IPC_CMD_INFOS,
+	                        xmmsv_build_list (XMMSV_LIST_ENTRY_INT (first),
+	                                          XMMSV_LIST_ENTRY_STR ("2"),
+	                                          XMMSV_LIST_END),
+	                        xmmsv_new_list ());
+	CU_ASSERT (xmmsv_is_type (result, XMMSV_TYPE_ERROR));
+	xmmsv_unref (result);
+}
+
+CASE(test_client_get_infos_keys)
+{
+	xmms_medialib_entry_t first, second;
+	xmmsv_t *result, *tree, *title, *server;
+	const gchar *value;
+	gint i;
+
+	first = xmms_mock_entry (medialib, 1, "Red Fang", "Red Fang", "Prehistoric Dog");
+	second = xmms_mock_entry (medialib, 2, "Red Fang", "Red Fang", "Reverse Thunder");
+
+	result = XMMS_IPC_CALL (medialib, XMMS_IPC_CMD_INFOS,
+	                        xmmsv_build_list (XMMSV_LIST_ENTRY_INT (first),
+	                                          XMMSV_LIST_ENTRY_INT (second),
+	                                          XMMSV_LIST_END),
+	                        xmmsv_build_list (XMMSV_LIST_ENTRY_STR ("title"),
+	                                          XMMSV_LIST_ENTRY_STR ("id"),
+	                                          XMMSV_LIST_END));
+	CU_ASSERT (xmmsv_is_type (result, XMMSV_TYPE_LIST));
+	CU_ASSERT_EQUAL (2, xmmsv_list_get_size (result));
+	CU_ASSERT_EQUAL (first, infos_get_id (result, 0));
+	CU_ASSERT_EQUAL (second, infos_get_id (result, 1));
+
+	for (i = 0; xmmsv_list_get (result, i, &tree); i++) {
+		CU_ASSERT_EQUAL (2, xmmsv_dict_get_size (tree));
+		CU_ASSERT (xmmsv_dict_get (tree, "title", &title));
+		CU_ASSERT_FALSE (xmmsv_dict_get (tree, "artist", NULL));
+		CU_ASSERT_FALSE (xmmsv_dict_get (tree, "tracknr", NULL));
+	}
+
+	CU_ASSERT (xmmsv_list_get (result, 1, &tree));
+	CU_ASSERT (xmmsv_dict_get (tree, "title", &title));
+	CU_ASSERT (xmmsv_dict_get (title, "server", &server));
+	CU_ASSERT (xmmsv_get_string (server, &value));
+	CU_ASSERT_STRING_EQUAL ("Reverse Thunder", value);
+	xmmsv_unref (result);
+
+	/* the id is there even when no key matches */
+	result = XMMS_IPC_CALL (medialib, XMMS_IPC_CMD_INFOS,
+	                        xmmsv_build_list (XMMSV_LIST_ENTRY_INT (first),
+	                                          XMMSV_LIST_END),
+	                        xmmsv_build_list (XMMSV_LIST_ENTRY_STR ("monkey"),
+	                                          XMMSV_LIST_END));
+	CU_ASSERT (xmmsv_is_type (result, XMMSV_TYPE_LIST));
+	CU_ASSERT_EQUAL (1, xmmsv_list_get_size (result));
+	CU_ASSERT (xmmsv_list_get (result, 0, &tree));
+	CU_ASSERT_EQUAL (1, xmmsv_dict_get_size (tree));
+	CU_ASSERT_EQUAL (first, infos_get_id (result, 0));
+	xmmsv_unref (result);
+
+	/* keys must all be strings */
+	result = XMMS_IPC_CALL (medialib, XMMS_IPC_CMD_INFOS,
+	                        xmmsv_build_list (XMMSV_LIST_ENTRY_INT (first),
+	                                          XMMSV_LIST_END),
+	                        xmmsv_build_list (XMMSV_LIST_ENTRY_STR ("title"),
+	                                          XMMSV_LIST_ENTRY_INT (1),
+	                                          XMMSV_LIST_END));
+	CU_ASSERT (xmmsv_is_type (result, XMMSV_TYPE_ERROR));
+	xmmsv_unref (result);
+}
+
 CASE(test_client_entry_add)
 {
 	xmms_medialib_session_t *session;
@@ -593,6 +849,147 @@ CASE(test_client_entry_add)
 }
 
 
+CASE(test_client_import_path_async)
+{
+	xmms_future_t *future;
+	xmmsv_t *result, *progress;
+	const gchar *error;
+	gint job, value;
+
+	future = XMMS_IPC_CHECK_SIGNAL (medialib, XMMS_IPC_SIGNAL_MEDIALIB_IMPORT_PROGRESS);
+
+	result = XMMS_IPC_CALL (medialib, XMMS_IPC_CMD_PATH_IMPORT_ASYNC,
+	                        xmmsv_new_string ("file:///apankorv"));
+	CU_ASSERT (xmmsv_get_int (result, &job));
+	xmmsv_unref (result);
+
+	/* no transport is loaded, the job ends after failing to read the path */
+	result = xmms_future_await (future, 1);
+	CU_ASSERT (xmmsv_list_get (result, 0, &progress));
+	CU_ASSERT (xmmsv_dict_entry_get_int (progress, "job", &value));
+	CU_ASSERT_EQUAL (job, value);
+	CU_ASSERT (xmmsv_dict_entry_get_int (progress, "done", &value));
+	CU_ASSERT_EQUAL (1, value);
+	CU_ASSERT (xmmsv_dict_entry_get_int (progress, "errors", &value));
+	CU_ASSERT_EQUAL (1, value);
+	CU_ASSERT (xmmsv_dict_entry_get_int (progress, "entries", &value));
+	CU_ASSERT_EQUAL (0, value);
+	CU_ASSERT (xmmsv_dict_entry_get_string (progress, "error", &error));
+	xmmsv_unref (result);
+
+	xmms_future_free (future);
+
+	/* the blocking import waits for its job and reports the error */
+	result = XMMS_IPC_CALL (medialib, XMMS_IPC_CMD_PATH_IMPORT,
+	                        xmmsv_new_string ("file:///apankorv"));
+	CU_ASSERT (xmmsv_is_type (result, XMMSV_TYPE_ERROR));
+	xmmsv_unref (result);
+}
+
+
+static const gchar *rescan_fingerprint = "2-2-2";
+
+static gboolean
+xmms_rescan_test_browse (xmms_xform_t *xform, const gchar *url, xmms_error_t *error)
+{
+	xmms_xform_browse_add_entry (xform, "a.ogg", 0);
+	xmms_xform_browse_add_entry_property_str (xform, "fingerprint", "1-1-1");
+	xmms_xform_browse_add_entry (xform, "b.ogg", 0);
+	xmms_xform_browse_add_entry_property_str (xform, "fingerprint", rescan_fingerprint);
+	return TRUE;
+}
+
+static gboolean
+xmms_rescan_test_init (xmms_xform_t *xform)
+{
+	return TRUE;
+}
+
+static gboolean
+xmms_rescan_test_xform_plugin_setup (xmms_xform_plugin_t *xform_plugin)
+{
+	xmms_xform_methods_t methods;
+
+	XMMS_XFORM_METHODS_INIT (methods);
+
+	methods.init = xmms_rescan_test_init;
+	methods.browse = xmms_rescan_test_browse;
+
+	xmms_xform_plugin_methods_set (xform_plugin, &methods);
+
+	xmms_xform_plugin_indata_add (xform_plugin,
+	                              XMMS_STREAM_TYPE_MIMETYPE, "application/x-url",
+	                              XMMS_STREAM_TYPE_URL, "file://*",
+	                              XMMS_STREAM_TYPE_END);
+
+	return TRUE;
+}
+
+XMMS_XFORM_BUILTIN (rescan_test_xform,
+                    "rescan test xform",
+                    XMMS_VERSION,
+                    "rescan test xform",
+                    xmms_rescan_test_xform_plugin_setup);
+
+CASE(test_client_import_path_rescan)
+{
+	xmms_medialib_session_t *session;
+	xmms_future_t *future;
+	xmmsv_t *result, *progress;
+	gint value;
+
+	xmms_plugin_load (&xmms_builtin_rescan_test_xform, NULL);
+
+	result = XMMS_IPC_CALL (medialib, XMMS_IPC_CMD_PATH_IMPORT,
+	                        xmmsv_new_string ("file:///rescan"));
+	CU_ASSERT (xmmsv_is_type (result, XMMSV_TYPE_NONE));
+	xmmsv_unref (result);
+
+	/* pretend both entries were resolved, then the second file changes */
+	session = xmms_medialib_session_begin (medialib);
+	CU_ASSERT_TRUE (xmms_medialib_check_id (session, 2));
+	xmms_medialib_entry_status_set (session, 1, XMMS_MEDIALIB_ENTRY_STATUS_OK);
+	xmms_medialib_entry_status_set (session, 2, XMMS_MEDIALIB_ENTRY_STATUS_OK);
+	xmms_medialib_entry_property_set_str_source (session, 1, "fingerprint",
+	                                             "1-1-1", "plugin/file");
+	xmms_medialib_entry_property_set_str_source (session, 2, "fingerprint",
+	                                             "2-2-2", "plugin/file");
+	xmms_medialib_session_commit (session);
+
+	rescan_fingerprint = "2-2-3";
+
+	future = XMMS_IPC_CHECK_SIGNAL (medialib, XMMS_IPC_SIGNAL_MEDIALIB_IMPORT_PROGRESS);
+
+	result = XMMS_IPC_CALL (medialib, XMMS_IPC_CMD_PATH_IMPORT,
+	                        xmmsv_new_string ("file:///rescan"));
+	CU_ASSERT (xmmsv_is_type (result, XMMSV_TYPE_NONE));
+	xmmsv_unref (result);
+
+	result = xmms_future_await (future, 1);
+	CU_ASSERT (xmmsv_list_get (result, 0, &progress));
+	CU_ASSERT (xmmsv_dict_entry_get_int (progress, "entries", &value));
+	CU_ASSERT_EQUAL (2, value);
+	CU_ASSERT (xmmsv_dict_entry_get_int (progress, "changed", &value));
+	CU_ASSERT_EQUAL (1, value);
+	CU_ASSERT (xmmsv_dict_entry_get_int (progress, "unchanged", &value));
+	CU_ASSERT_EQUAL (1, value);
+	xmmsv_unref (result);
+
+	xmms_future_free (future);
+
+	/* only the changed file is rehashed */
+	session = xmms_medialib_session_begin_ro (medialib);
+	value = xmms_medialib_entry_property_get_int (session, 1, "status");
+	CU_ASSERT_EQUAL (XMMS_MEDIALIB_ENTRY_STATUS_OK, value);
+	value = xmms_medialib_entry_property_get_int (session, 2, "status");
+	CU_ASSERT_EQUAL (XMMS_MEDIALIB_ENTRY_STATUS_REHASH, value);
+	xmms_medialib_session_abort (session);
+
+	rescan_fingerprint = "2-2-2";
+	xmms_plugin_shutdown ();
+}
+
+
 CASE(test_client_entry_remove)
 {
 	xmms_medialib_session_t *session;
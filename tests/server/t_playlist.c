@@ -232,6 +232,139 @@ CASE(test_medialib_remove)
 	xmms_future_free (future3);
 }
 
+CASE(test_client_entry_positions)
+{
+	xmms_medialib_entry_t first, second;
+	xmms_medialib_session_t *session;
+	xmms_error_t err;
+	xmmsv_t *coll, *result, *expected;
+
+	first  = xmms_mock_entry (medialib, 1, "Red Fang", "Red Fang", "Prehistoric Dog");
+	second = xmms_mock_entry (medialib, 2, "Red Fang", "Red Fang", "Reverse Thunder");
+
+	coll = xmmsv_new_coll (XMMS_COLLECTION_TYPE_IDLIST);
+	xmms_collection_update_pointer (colldag, "Other",
+	                                XMMS_COLLECTION_NSID_PLAYLISTS, coll);
+	xmmsv_unref (coll);
+
+	xmms_error_reset (&err);
+
+	xmms_playlist_add_entry (playlist, "Default", first, &err);
+	xmms_playlist_add_entry (playlist, "Default", second, &err);
+	xmms_playlist_add_entry (playlist, "Default", first, &err);
+	xmms_playlist_add_entry (playlist, "Other", first, &err);
+	CU_ASSERT_FALSE (xmms_error_iserror (&err));
+
+	result = XMMS_IPC_CALL (playlist, XMMS_IPC_CMD_ENTRY_POSITIONS,
+	                        xmmsv_new_int (first));
+	expected = xmmsv_from_xson ("{ 'Default': [0, 2], '_active': [0, 2], 'Other': [0] }");
+	CU_ASSERT (xmmsv_compare (expected, result));
+	xmmsv_unref (result);
+	xmmsv_unref (expected);
+
+	result = XMMS_IPC_CALL (colldag, XMMS_IPC_CMD_COLLECTION_FIND,
+	                        xmmsv_new_int (second),
+	                        xmmsv_new_string (XMMS_COLLECTION_NS_PLAYLISTS));
+	CU_ASSERT_EQUAL (2, xmmsv_list_get_size (result));
+	xmmsv_unref (result);
+
+	/* removing the entry from the medialib removes every occurrence */
+	session = xmms_medialib_session_begin (medialib);
+	xmms_medialib_entry_remove (session, first);
+	xmms_medialib_session_commit (session);
+
+	result = XMMS_IPC_CALL (playlist, XMMS_IPC_CMD_ENTRY_POSITIONS,
+	                        xmmsv_new_int (first));
+	CU_ASSERT_EQUAL (0, xmmsv_dict_get_size (result));
+	xmmsv_unref (result);
+
+	result = XMMS_IPC_CALL (playlist, XMMS_IPC_CMD_ENTRY_POSITIONS,
+	                        xmmsv_new_int (second));
+	expected = xmmsv_from_xson ("{ 'Default': [0], '_active': [0] }");
+	CU_ASSERT (xmmsv_compare (expected, result));
+	xmmsv_unref (result);
+	xmmsv_unref (expected);
+
+	result = XMMS_IPC_CALL (playlist, XMMS_IPC_CMD_LIST,
+	                        xmmsv_new_string ("Other"));
+	CU_ASSERT_EQUAL (0, xmmsv_list_get_size (result));
+	xmmsv_unref (result);
+}
+
+CASE(test_client_list_range_and_changes)
+{
+	xmms_medialib_entry_t first, second, third;
+	xmmsv_t *result, *expected, *changes;
+	xmms_error_t err;
+	gint revision, latest;
+
+	first  = xmms_mock_entry (medialib, 1, "Red Fang", "Red Fang", "Prehistoric Dog");
+	second = xmms_mock_entry (medialib, 2, "Red Fang", "Red Fang", "Reverse Thunder");
+	third  = xmms_mock_entry (medialib, 3, "Red Fang", "Red Fang", "Night Destroyer");
+
+	xmms_error_reset (&err);
+
+	xmms_playlist_add_entry (playlist, "Default", first, &err);
+	xmms_playlist_add_entry (playlist, "Default", second, &err);
+	xmms_playlist_add_entry (playlist, "Default", third, &err);
+
+	result = XMMS_IPC_CALL (playlist, XMMS_IPC_CMD_LIST_RANGE,
+	                        xmmsv_new_string ("Default"),
+	                        xmmsv_new_int (1), xmmsv_new_int (5));
+	CU_ASSERT (xmmsv_dict_entry_get_int (result, "revision", &revision));
+	CU_ASSERT (xmmsv_dict_get (result, "ids", &changes));
+	expected = xmmsv_from_xson ("[2, 3]");
+	CU_ASSERT (xmmsv_compare (expected, changes));
+	xmmsv_unref (expected);
+	xmmsv_unref (result);
+
+	result = XMMS_IPC_CALL (playlist, XMMS_IPC_CMD_LIST_RANGE,
+	                        xmmsv_new_string ("Default"),
+	                        xmmsv_new_int (4), xmmsv_new_int (-1));
+	CU_ASSERT (xmmsv_is_type (result, XMMSV_TYPE_ERROR));
+	xmmsv_unref (result);
+
+	result = XMMS_IPC_CALL (playlist, XMMS_IPC_CMD_REMOVE_ENTRY,
+	                        xmmsv_new_string ("Default"),
+	                        xmmsv_new_int (0));
+	CU_ASSERT (xmmsv_is_type (result, XMMSV_TYPE_NONE));
+	xmmsv_unref (result);
+
+	xmms_playlist_insert_entry (playlist, "Default", 1, first, &err);
+	CU_ASSERT_FALSE (xmms_error_iserror (&err));
+
+	/* XMMS_PLAYLIST_CHANGED_INSERT = 1, XMMS_PLAYLIST_CHANGED_REMOVE = 3 */
+	result = XMMS_IPC_CALL (playlist, XMMS_IPC_CMD_LIST_CHANGES,
+	                        xmmsv_new_string ("Default"),
+	                        xmmsv_new_int (revision));
+	CU_ASSERT (xmmsv_dict_entry_get_int (result, "revision", &latest));
+	CU_ASSERT (latest > revision);
+	CU_ASSERT (xmmsv_dict_get (result, "changes", &changes));
+	CU_ASSERT_EQUAL (2, xmmsv_list_get_size (changes));
+	xmmsv_list_get (changes, 1, &changes);
+	CU_ASSERT (xmmsv_dict_entry_get_int (changes, "revision", &revision));
+	CU_ASSERT_EQUAL (latest, revision);
+	xmmsv_dict_remove (changes, "revision");
+	expected = xmmsv_from_xson ("{ 'position': 1, 'id': 1, 'type': 1, 'name': 'Default' }");
+	CU_ASSERT (xmmsv_compare (expected, changes));
+	xmmsv_unref (expected);
+	xmmsv_unref (result);
+
+	result = XMMS_IPC_CALL (playlist, XMMS_IPC_CMD_LIST_CHANGES,
+	                        xmmsv_new_string ("Default"),
+	                        xmmsv_new_int (latest));
+	CU_ASSERT (xmmsv_dict_get (result, "changes", &changes));
+	CU_ASSERT_EQUAL (0, xmmsv_list_get_size (changes));
+	xmmsv_unref (result);
+
+	/* a revision the playlist never had */
+	result = XMMS_IPC_CALL (playlist, XMMS_IPC_CMD_LIST_CHANGES,
+	                        xmmsv_new_string ("Default"),
+	                        xmmsv_new_int (latest + 100));
+	CU_ASSERT (xmmsv_is_type (result, XMMSV_TYPE_ERROR));
+	xmmsv_unref (result);
+}
+
 CASE(test_client_add_collection)
 {
 	xmmsv_t *universe, *ordered;
@@ -264,6 +397,60 @@ CASE(test_client_add_collection)
 	xmmsv_unref (result);
 }
 
+CASE(test_client_add_collection_single_message)
+{
+	xmms_future_t *future;
+	xmmsv_t *coll, *result, *expected;
+
+	xmms_mock_entry (medialib, 1, "Red Fang", "Red Fang", "Prehistoric Dog");
+	xmms_mock_entry (medialib, 2, "Red Fang", "Red Fang", "Reverse Thunder");
+	xmms_mock_entry (medialib, 3, "Red Fang", "Red Fang", "Night Destroyer");
+	xmms_mock_entry (medialib, 4, "Red Fang", "Red Fang", "Human Remain Human Remains");
+
+	future = XMMS_IPC_CHECK_SIGNAL (playlist, XMMS_IPC_SIGNAL_PLAYLIST_CHANGED);
+
+	coll = xmmsv_new_coll (XMMS_COLLECTION_TYPE_IDLIST);
+	xmmsv_coll_idlist_append (coll, 1);
+	xmmsv_coll_idlist_append (coll, 4);
+
+	result = XMMS_IPC_CALL (playlist, XMMS_IPC_CMD_ADD_COLL,
+	                        xmmsv_new_string ("Default"),
+	                        xmmsv_ref (coll));
+	CU_ASSERT (xmmsv_is_type (result, XMMSV_TYPE_NONE));
+	xmmsv_unref (result);
+
+	xmmsv_coll_idlist_clear (coll);
+	xmmsv_coll_idlist_append (coll, 2);
+	xmmsv_coll_idlist_append (coll, 3);
+
+	result = XMMS_IPC_CALL (playlist, XMMS_IPC_CMD_INSERT_COLL,
+	                        xmmsv_new_string ("Default"),
+	                        xmmsv_new_int (1),
+	                        xmmsv_ref (coll));
+	CU_ASSERT (xmmsv_is_type (result, XMMSV_TYPE_NONE));
+	xmmsv_unref (result);
+
+	/* XMMS_PLAYLIST_CHANGED_UPDATE = 7, XMMS_PLAYLIST_CHANGED_ADD_MANY = 9 */
+	result = xmms_future_await (future, 4);
+	expected = xmmsv_from_xson ("[{                                   'type': 7, 'name': 'Default' },"
+	                            " { 'position': 0, 'ids': [1, 4], 'type': 9, 'name': 'Default' },"
+	                            " {                                   'type': 7, 'name': 'Default' },"
+	                            " { 'position': 1, 'ids': [2, 3], 'type': 9, 'name': 'Default' }]");
+	CU_ASSERT (xmmsv_compare (expected, result));
+	xmmsv_unref (result);
+	xmmsv_unref (expected);
+	xmms_future_free (future);
+
+	result = XMMS_IPC_CALL (playlist, XMMS_IPC_CMD_LIST,
+	                        xmmsv_new_string ("Default"));
+	expected = xmmsv_from_xson ("[1, 2, 3, 4]");
+	CU_ASSERT (xmmsv_compare (expected, result));
+	xmmsv_unref (result);
+	xmmsv_unref (expected);
+
+	xmmsv_unref (coll);
+}
+
 CASE(test_client_add_url)
 {
 	xmmsv_t *result;
@@ -595,6 +782,59 @@ CASE(test_client_set_next)
 	xmms_config_property_set_data (property, "0");
 }
 
+CASE(test_queue_history)
+{
+	xmms_medialib_entry_t first;
+	xmmsv_t *result, *expected, *coll;
+	xmms_future_t *future;
+	xmms_error_t err;
+	gint i;
+
+	first = xmms_mock_entry (medialib, 1, "Red Fang", "Red Fang", "Prehistoric Dog");
+
+	coll = xmmsv_new_coll (XMMS_COLLECTION_TYPE_IDLIST);
+	xmmsv_coll_attribute_set_string (coll, "type", "queue");
+	xmmsv_coll_attribute_set_string (coll, "history", "1");
+	xmms_collection_update_pointer (colldag, "Default",
+	                                XMMS_COLLECTION_NSID_PLAYLISTS, coll);
+	xmms_collection_update_pointer (colldag, XMMS_ACTIVE_PLAYLIST,
+	                                XMMS_COLLECTION_NSID_PLAYLISTS, coll);
+	xmmsv_unref (coll);
+
+	for (i = 0; i < 5; i++) {
+		xmms_playlist_add_entry (playlist, "Default", first, &err);
+	}
+
+	result = XMMS_IPC_CALL (playlist, XMMS_IPC_CMD_SET_POS, xmmsv_new_int (3));
+	xmmsv_unref (result);
+
+	future = XMMS_IPC_CHECK_SIGNAL (playlist, XMMS_IPC_SIGNAL_PLAYLIST_CHANGED);
+
+	/* the two entries past the history go away with a single message */
+	xmms_playlist_update (playlist, "Default");
+
+	result = xmms_future_await (future, 2);
+	expected = xmmsv_from_xson ("[{ 'type': 7, 'name': 'Default' },"
+	                            " { 'type': 10, 'name': 'Default', 'position': 0, 'count': 2 }]");
+	CU_ASSERT (xmmsv_compare (expected, result));
+	xmmsv_unref (result);
+	xmmsv_unref (expected);
+
+	xmms_future_free (future);
+
+	result = XMMS_IPC_CALL (playlist, XMMS_IPC_CMD_CURRENT_POS,
+	                        xmmsv_new_string ("Default"));
+	expected = xmmsv_from_xson ("{ 'position': 1, 'name': 'Default' }");
+	CU_ASSERT (xmmsv_compare (expected, result));
+	xmmsv_unref (result);
+	xmmsv_unref (expected);
+
+	result = XMMS_IPC_CALL (playlist, XMMS_IPC_CMD_LIST,
+	                        xmmsv_new_string ("Default"));
+	CU_ASSERT_EQUAL (3, xmmsv_list_get_size (result));
+	xmmsv_unref (result);
+}
+
 /**
  * Party Shuffle should work like the following:
  *
@@ -606,7 +846,7 @@ CASE(test_client_set_next)
 CASE(test_party_shuffle)
 {
 	xmms_playlist_updater_t *updater;
-	xmmsv_t *result, *expected, *signal;
+	xmmsv_t *result, *expected, *signal, *ids;
 	xmmsv_t *coll, *universe;
 	xmms_future_t *future;
 	gint type, current, entry;
@@ -647,21 +887,16 @@ CASE(test_party_shuffle)
 	xmmsv_unref (result);
 	xmmsv_unref (expected);
 
-	/* adding the two 'upcoming' tracks to the playlist, 'id' is random thus the verbosity */
-	result = xmms_future_await (future, 4);
+	/* adding the two 'upcoming' tracks to the playlist at once, 'ids' are random thus the verbosity */
+	result = xmms_future_await (future, 2);
 	CU_ASSERT (xmmsv_list_get (result, 0, &signal));
 	CU_ASSERT (xmmsv_dict_entry_get_int (signal, "type", &type));
 	CU_ASSERT_EQUAL (XMMS_PLAYLIST_CHANGED_UPDATE, type);
 	CU_ASSERT (xmmsv_list_get (result, 1, &signal));
 	CU_ASSERT (xmmsv_dict_entry_get_int (signal, "type", &type));
-	CU_ASSERT_EQUAL (XMMS_PLAYLIST_CHANGED_ADD, type);
-
-	CU_ASSERT (xmmsv_list_get (result, 2, &signal));
-	CU_ASSERT (xmmsv_dict_entry_get_int (signal, "type", &type));
-	CU_ASSERT_EQUAL (XMMS_PLAYLIST_CHANGED_UPDATE, type);
-	CU_ASSERT (xmmsv_list_get (result, 3, &signal));
-	CU_ASSERT (xmmsv_dict_entry_get_int (signal, "type", &type));
-	CU_ASSERT_EQUAL (XMMS_PLAYLIST_CHANGED_ADD, type);
+	CU_ASSERT_EQUAL (XMMS_PLAYLIST_CHANGED_ADD_MANY, type);
+	CU_ASSERT (xmmsv_dict_get (signal, "ids", &ids));
+	CU_ASSERT_EQUAL (2, xmmsv_list_get_size (ids));
 	xmmsv_unref (result);
 
 	result = XMMS_IPC_CALL (playlist, XMMS_IPC_CMD_LIST,
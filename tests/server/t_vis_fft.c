@@ -0,0 +1,121 @@
+/*  XMMS2 - X Music Multiplexer System
+ *  Copyright (C) 2003-2013 XMMS2 Team
+ *
+ *  PLUGINS ARE NOT CONSIDERED TO BE DERIVED WORK !!!
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ */
+
+#include "xcu.h"
+
+#include <glib.h>
+#include <math.h>
+
+#include "../src/xmms/visualization/fft.h"
+
+#define SIZE 512
+
+SETUP (vis_fft) {
+	return 0;
+}
+
+CLEANUP () {
+	return 0;
+}
+
+/* The spectrum as computed before the real FFT: a hann windowed complex
+ * DFT, scaled by 2 / n. */
+static void
+reference_spectrum (const gfloat *in, gdouble *spec)
+{
+	gint i, k;
+
+	for (k = 0; k < SIZE / 2; k++) {
+		gdouble re = 0.0, im = 0.0;
+
+		for (i = 0; i < SIZE; i++) {
+			gdouble w = 0.5 - 0.5 * cos (2.0 * M_PI * i / SIZE);
+			re += in[i] * w * cos (2.0 * M_PI * i * k / SIZE);
+			im -= in[i] * w * sin (2.0 * M_PI * i * k / SIZE);
+		}
+
+		spec[k] = 2 * hypot (re, im) / SIZE;
+	}
+}
+
+static void
+sine (gfloat *in, gdouble amplitude, gdouble bin)
+{
+	gint i;
+
+	for (i = 0; i < SIZE; i++) {
+		in[i] = amplitude * sin (2.0 * M_PI * bin * i / SIZE + 0.3);
+	}
+}
+
+CASE (test_sine_matches_reference)
+{
+	gfloat in[SIZE], spec[SIZE / 2];
+	gdouble ref[SIZE / 2];
+	xmms_vis_fft_t *fft;
+	gint k;
+
+	fft = xmms_vis_fft_new (SIZE, XMMS_VIS_WINDOW_HANN);
+
+	/* on a bin and between two bins, plus an offset for the DC bin */
+	sine (in, 0.5, 32.0);
+	for (k = 0; k < SIZE; k++) {
+		in[k] += 0.1f;
+	}
+	xmms_vis_fft_spectrum (fft, in, spec);
+	reference_spectrum (in, ref);
+
+	for (k = 0; k < SIZE / 2; k++) {
+		CU_ASSERT_DOUBLE_EQUAL (ref[k], spec[k], 1e-4);
+	}
+	CU_ASSERT_DOUBLE_EQUAL (0.25, spec[32], 1e-4);
+
+	sine (in, 0.5, 70.5);
+	xmms_vis_fft_spectrum (fft, in, spec);
+	reference_spectrum (in, ref);
+
+	for (k = 0; k < SIZE / 2; k++) {
+		CU_ASSERT_DOUBLE_EQUAL (ref[k], spec[k], 1e-4);
+	}
+
+	xmms_vis_fft_free (fft);
+}
+
+CASE (test_sine_level_independent_of_window)
+{
+	xmms_vis_window_t windows[] = {
+		XMMS_VIS_WINDOW_RECTANGULAR, XMMS_VIS_WINDOW_HANN,
+		XMMS_VIS_WINDOW_HAMMING, XMMS_VIS_WINDOW_BLACKMAN
+	};
+	gfloat in[4 * SIZE], spec[2 * SIZE];
+	xmms_vis_fft_t *fft;
+	gint i, size;
+
+	for (size = SIZE; size <= 4 * SIZE; size *= 2) {
+		for (i = 0; i < G_N_ELEMENTS (windows); i++) {
+			gint k;
+
+			for (k = 0; k < size; k++) {
+				in[k] = 0.8 * sin (2.0 * M_PI * (size / 8) * k / size);
+			}
+
+			fft = xmms_vis_fft_new (size, windows[i]);
+			xmms_vis_fft_spectrum (fft, in, spec);
+			CU_ASSERT_DOUBLE_EQUAL (0.4, spec[size / 8], 1e-4);
+			xmms_vis_fft_free (fft);
+		}
+	}
+}
@@ -17,8 +17,10 @@
 #include "xcu.h"
 
 #include <glib.h>
+#include <glib/gstdio.h>
 
 #include <locale.h>
+#include <string.h>
 
 #include <xmmspriv/xmms_plugin.h>
 #include <xmmspriv/xmms_xform.h>
@@ -199,6 +201,419 @@ CASE(test_xform_metadata)
 	xmms_object_unref (format);
 }
 
+static xmms_sample_format_t probe_test_format;
+static gint probe_decoder_inits;
+
+static gboolean
+xmms_probe_test_xform_init (xmms_xform_t *xform)
+{
+	xmms_xform_outdata_type_add (xform,
+	                             XMMS_STREAM_TYPE_MIMETYPE, "audio/x-probetest",
+	                             XMMS_STREAM_TYPE_FMT_CHANNELS, 2,
+	                             XMMS_STREAM_TYPE_FMT_SAMPLERATE, 22050,
+	                             XMMS_STREAM_TYPE_END);
+
+	if (xmms_xform_probing (xform)) {
+		xmms_xform_probe_finish (xform, probe_test_format);
+	}
+
+	return TRUE;
+}
+
+static gboolean
+xmms_probe_test_xform_plugin_setup (xmms_xform_plugin_t *xform_plugin)
+{
+	xmms_xform_methods_t methods;
+
+	XMMS_XFORM_METHODS_INIT (methods);
+
+	methods.init = xmms_probe_test_xform_init;
+
+	xmms_xform_plugin_methods_set (xform_plugin, &methods);
+
+	xmms_xform_plugin_indata_add (xform_plugin,
+	                              XMMS_STREAM_TYPE_MIMETYPE, "application/x-url",
+	                              XMMS_STREAM_TYPE_URL, "probetest://*",
+	                              XMMS_STREAM_TYPE_END);
+
+	return TRUE;
+}
+
+XMMS_XFORM_BUILTIN (probe_test_xform,
+                    "probe test xform",
+                    XMMS_VERSION,
+                    "probe test xform",
+                    xmms_probe_test_xform_plugin_setup);
+
+/* Doubles the samplerate, like HE-AAC decoders do */
+static gboolean
+xmms_probe_decoder_test_xform_init (xmms_xform_t *xform)
+{
+	probe_decoder_inits++;
+
+	xmms_xform_outdata_type_add (xform,
+	                             XMMS_STREAM_TYPE_MIMETYPE, "audio/pcm",
+	                             XMMS_STREAM_TYPE_FMT_FORMAT, XMMS_SAMPLE_FORMAT_S16,
+	                             XMMS_STREAM_TYPE_FMT_CHANNELS, 2,
+	                             XMMS_STREAM_TYPE_FMT_SAMPLERATE, 44100,
+	                             XMMS_STREAM_TYPE_END);
+
+	return TRUE;
+}
+
+static gboolean
+xmms_probe_decoder_test_xform_plugin_setup (xmms_xform_plugin_t *xform_plugin)
+{
+	xmms_xform_methods_t methods;
+
+	XMMS_XFORM_METHODS_INIT (methods);
+
+	methods.init = xmms_probe_decoder_test_xform_init;
+
+	xmms_xform_plugin_methods_set (xform_plugin, &methods);
+
+	xmms_xform_plugin_indata_add (xform_plugin,
+	                              XMMS_STREAM_TYPE_MIMETYPE, "audio/x-probetest",
+	                              XMMS_STREAM_TYPE_END);
+
+	return TRUE;
+}
+
+XMMS_XFORM_BUILTIN (probe_decoder_test_xform,
+                    "probe decoder test xform",
+                    XMMS_VERSION,
+                    "probe decoder test xform",
+                    xmms_probe_decoder_test_xform_plugin_setup);
+
+static xmms_xform_t *
+probe_test_chain_setup (GList *goal_format)
+{
+	xmms_medialib_session_t *session;
+	xmms_xform_t *xform;
+
+	session = xmms_medialib_session_begin (medialib);
+	xform = xmms_xform_chain_setup_url_session (medialib, session, 1,
+	                                            "probetest://", goal_format,
+	                                            TRUE);
+	xmms_medialib_session_abort (session);
+
+	return xform;
+}
+
+CASE(test_xform_probe)
+{
+	xmms_stream_type_t *format, *probe;
+	xmms_xform_t *xform;
+	GList *goal_format;
+	const gchar *sample_fmt;
+	gint samplerate;
+
+	format = _xmms_stream_type_new (XMMS_STREAM_TYPE_BEGIN,
+	                                XMMS_STREAM_TYPE_MIMETYPE,
+	                                "audio/pcm",
+	                                XMMS_STREAM_TYPE_END);
+	probe = _xmms_stream_type_new (XMMS_STREAM_TYPE_BEGIN,
+	                               XMMS_STREAM_TYPE_MIMETYPE,
+	                               XMMS_XFORM_PROBE_MIMETYPE,
+	                               XMMS_STREAM_TYPE_END);
+	goal_format = g_list_prepend (NULL, format);
+	goal_format = g_list_prepend (goal_format, probe);
+
+	xmms_plugin_load (&xmms_builtin_probe_test_xform, NULL);
+
+	/* there is no decoder for the stream, so it isn't playable */
+	probe_test_format = XMMS_SAMPLE_FORMAT_S16;
+	xform = probe_test_chain_setup (goal_format);
+	CU_ASSERT_PTR_NULL (xform);
+
+	xmms_plugin_load (&xmms_builtin_probe_decoder_test_xform, NULL);
+
+	/* with one, probing ends the chain at the plugin */
+	xform = probe_test_chain_setup (goal_format);
+	CU_ASSERT_PTR_NOT_NULL_FATAL (xform);
+	CU_ASSERT_EQUAL (0, probe_decoder_inits);
+
+	CU_ASSERT_STRING_EQUAL (XMMS_XFORM_PROBE_MIMETYPE,
+	                        xmms_xform_outtype_get_str (xform, XMMS_STREAM_TYPE_MIMETYPE));
+	CU_ASSERT_TRUE (xmms_xform_metadata_get_str (xform, XMMS_MEDIALIB_ENTRY_PROPERTY_SAMPLE_FMT,
+	                                             &sample_fmt));
+	CU_ASSERT_STRING_EQUAL (xmms_sample_name_get (XMMS_SAMPLE_FORMAT_S16), sample_fmt);
+	CU_ASSERT_TRUE (xmms_xform_metadata_get_int (xform, XMMS_MEDIALIB_ENTRY_PROPERTY_SAMPLERATE,
+	                                             &samplerate));
+	CU_ASSERT_EQUAL (22050, samplerate);
+	xmms_object_unref (xform);
+
+	/* the format is up to the decoder, so it is set up */
+	probe_test_format = XMMS_SAMPLE_FORMAT_UNKNOWN;
+	xform = probe_test_chain_setup (goal_format);
+	CU_ASSERT_PTR_NOT_NULL_FATAL (xform);
+	CU_ASSERT_EQUAL (1, probe_decoder_inits);
+
+	CU_ASSERT_STRING_EQUAL ("audio/pcm",
+	                        xmms_xform_outtype_get_str (xform, XMMS_STREAM_TYPE_MIMETYPE));
+	CU_ASSERT_TRUE (xmms_xform_metadata_get_int (xform, XMMS_MEDIALIB_ENTRY_PROPERTY_SAMPLERATE,
+	                                             &samplerate));
+	CU_ASSERT_EQUAL (44100, samplerate);
+	xmms_object_unref (xform);
+
+	g_list_free (goal_format);
+	xmms_object_unref (probe);
+	xmms_object_unref (format);
+}
+
+static gint junk_probe_inits;
+static const gchar *junk_fingerprint = "1-1-1";
+
+static gboolean
+xmms_junk_test_xform_init (xmms_xform_t *xform)
+{
+	xmms_xform_metadata_set_str (xform, XMMS_MEDIALIB_ENTRY_PROPERTY_FINGERPRINT,
+	                             junk_fingerprint);
+	xmms_xform_outdata_type_add (xform,
+	                             XMMS_STREAM_TYPE_MIMETYPE, "application/x-junktest",
+	                             XMMS_STREAM_TYPE_END);
+
+	return TRUE;
+}
+
+static gboolean
+xmms_junk_test_xform_plugin_setup (xmms_xform_plugin_t *xform_plugin)
+{
+	xmms_xform_methods_t methods;
+
+	XMMS_XFORM_METHODS_INIT (methods);
+
+	methods.init = xmms_junk_test_xform_init;
+
+	xmms_xform_plugin_methods_set (xform_plugin, &methods);
+
+	xmms_xform_plugin_indata_add (xform_plugin,
+	                              XMMS_STREAM_TYPE_MIMETYPE, "application/x-url",
+	                              XMMS_STREAM_TYPE_URL, "junktest://*",
+	                              XMMS_STREAM_TYPE_END);
+
+	return TRUE;
+}
+
+XMMS_XFORM_BUILTIN (junk_test_xform,
+                    "junk test xform",
+                    XMMS_VERSION,
+                    "junk test xform",
+                    xmms_junk_test_xform_plugin_setup);
+
+/* Tries to make sense of the junk, and fails */
+static gboolean
+xmms_junk_probe_test_xform_init (xmms_xform_t *xform)
+{
+	junk_probe_inits++;
+
+	return FALSE;
+}
+
+static gboolean
+xmms_junk_probe_test_xform_plugin_setup (xmms_xform_plugin_t *xform_plugin)
+{
+	xmms_xform_methods_t methods;
+
+	XMMS_XFORM_METHODS_INIT (methods);
+
+	methods.init = xmms_junk_probe_test_xform_init;
+
+	xmms_xform_plugin_methods_set (xform_plugin, &methods);
+
+	xmms_xform_plugin_indata_add (xform_plugin,
+	                              XMMS_STREAM_TYPE_PRIORITY, 1,
+	                              XMMS_STREAM_TYPE_MIMETYPE, "application/x-junktest",
+	                              XMMS_STREAM_TYPE_END);
+
+	return TRUE;
+}
+
+XMMS_XFORM_BUILTIN (junk_probe_test_xform,
+                    "junk probe test xform",
+                    XMMS_VERSION,
+                    "junk probe test xform",
+                    xmms_junk_probe_test_xform_plugin_setup);
+
+static gboolean
+xmms_junk_decoder_test_xform_init (xmms_xform_t *xform)
+{
+	xmms_xform_outdata_type_add (xform,
+	                             XMMS_STREAM_TYPE_MIMETYPE, "audio/pcm",
+	                             XMMS_STREAM_TYPE_END);
+
+	return TRUE;
+}
+
+static gboolean
+xmms_junk_decoder_test_xform_plugin_setup (xmms_xform_plugin_t *xform_plugin)
+{
+	xmms_xform_methods_t methods;
+
+	XMMS_XFORM_METHODS_INIT (methods);
+
+	methods.init = xmms_junk_decoder_test_xform_init;
+
+	xmms_xform_plugin_methods_set (xform_plugin, &methods);
+
+	xmms_xform_plugin_indata_add (xform_plugin,
+	                              XMMS_STREAM_TYPE_MIMETYPE, "application/x-junktest",
+	                              XMMS_STREAM_TYPE_END);
+
+	return TRUE;
+}
+
+XMMS_XFORM_BUILTIN (junk_decoder_test_xform,
+                    "junk decoder test xform",
+                    XMMS_VERSION,
+                    "junk decoder test xform",
+                    xmms_junk_decoder_test_xform_plugin_setup);
+
+CASE(test_xform_chain_failed)
+{
+	xmms_medialib_unplayable_t *unplayable;
+	xmms_medialib_session_t *session;
+	xmms_medialib_entry_t entry;
+	xmms_stream_type_t *format;
+	xmms_xform_t *xform;
+	xmms_error_t err;
+	GList *goal_format;
+	gint status;
+
+	xmms_error_reset (&err);
+
+	format = _xmms_stream_type_new (XMMS_STREAM_TYPE_BEGIN,
+	                                XMMS_STREAM_TYPE_MIMETYPE,
+	                                "audio/pcm",
+	                                XMMS_STREAM_TYPE_END);
+	goal_format = g_list_prepend (NULL, format);
+
+	xmms_plugin_load (&xmms_builtin_junk_test_xform, NULL);
+	xmms_plugin_load (&xmms_builtin_junk_probe_test_xform, NULL);
+
+	unplayable = xmms_medialib_get_unplayable (medialib);
+
+	session = xmms_medialib_session_begin (medialib);
+	entry = xmms_medialib_entry_new (session, "junktest://junk", &err);
+	xmms_medialib_session_commit (session);
+
+	/* failing to play a file isn't remembered... */
+	xform = xmms_xform_chain_setup (medialib, entry, goal_format, FALSE);
+	CU_ASSERT_PTR_NULL (xform);
+	CU_ASSERT_EQUAL (1, junk_probe_inits);
+	CU_ASSERT_FALSE (xmms_medialib_unplayable_contains (unplayable, "junktest://junk"));
+
+	/* ...failing to read its metadata is, for that very file */
+	xform = xmms_xform_chain_setup (medialib, entry, goal_format, TRUE);
+	CU_ASSERT_PTR_NULL (xform);
+	CU_ASSERT_EQUAL (2, junk_probe_inits);
+	CU_ASSERT_TRUE (xmms_medialib_unplayable_lookup (unplayable, "junktest://junk", "1-1-1"));
+	CU_ASSERT_FALSE (xmms_medialib_unplayable_lookup (unplayable, "junktest://other", "1-1-1"));
+
+	/* and it isn't probed again, neither to read nor to play it */
+	xform = xmms_xform_chain_setup (medialib, entry, goal_format, TRUE);
+	CU_ASSERT_PTR_NULL (xform);
+	xform = xmms_xform_chain_setup (medialib, entry, goal_format, FALSE);
+	CU_ASSERT_PTR_NULL (xform);
+	CU_ASSERT_EQUAL (2, junk_probe_inits);
+
+	/* the entry is left to the mediainfo reader, which removes new ones */
+	session = xmms_medialib_session_begin (medialib);
+	status = xmms_medialib_entry_property_get_int (session, entry,
+	                                               XMMS_MEDIALIB_ENTRY_PROPERTY_STATUS);
+	xmms_medialib_session_commit (session);
+	CU_ASSERT_EQUAL (XMMS_MEDIALIB_ENTRY_STATUS_NEW, status);
+
+	/* until the file changes */
+	junk_fingerprint = "1-1-2";
+	xform = xmms_xform_chain_setup (medialib, entry, goal_format, TRUE);
+	CU_ASSERT_PTR_NULL (xform);
+	CU_ASSERT_EQUAL (3, junk_probe_inits);
+	CU_ASSERT_TRUE (xmms_medialib_unplayable_lookup (unplayable, "junktest://junk", "1-1-2"));
+
+	/* a record that doesn't match is dropped */
+	CU_ASSERT_FALSE (xmms_medialib_unplayable_lookup (unplayable, "junktest://junk", "1-1-1"));
+	CU_ASSERT_FALSE (xmms_medialib_unplayable_contains (unplayable, "junktest://junk"));
+
+	xform = xmms_xform_chain_setup (medialib, entry, goal_format, TRUE);
+	CU_ASSERT_PTR_NULL (xform);
+	CU_ASSERT_EQUAL (4, junk_probe_inits);
+	CU_ASSERT_TRUE (xmms_medialib_unplayable_contains (unplayable, "junktest://junk"));
+
+	/* a new plugin may well handle the file */
+	xmms_plugin_load (&xmms_builtin_junk_decoder_test_xform, NULL);
+
+	xform = xmms_xform_chain_setup (medialib, entry, goal_format, TRUE);
+	CU_ASSERT_PTR_NOT_NULL (xform);
+	CU_ASSERT_EQUAL (4, junk_probe_inits);
+	CU_ASSERT_FALSE (xmms_medialib_unplayable_contains (unplayable, "junktest://junk"));
+	if (xform != NULL) {
+		xmms_object_unref (xform);
+	}
+
+	junk_fingerprint = "1-1-1";
+
+	g_list_free (goal_format);
+	xmms_object_unref (format);
+}
+
+CASE(test_unplayable_save_load)
+{
+	xmms_medialib_unplayable_t *unplayable;
+	gchar *dir, *path, *present, *present_url, *missing_url, *contents;
+
+	dir = g_dir_make_tmp ("t_xform-XXXXXX", NULL);
+	CU_ASSERT_PTR_NOT_NULL_FATAL (dir);
+
+	path = g_build_filename (dir, "unplayable", NULL);
+	present = g_build_filename (dir, "present.mp3", NULL);
+	g_file_set_contents (present, "junk", -1, NULL);
+
+	present_url = g_strconcat ("file://", present, NULL);
+	missing_url = g_strconcat ("file://", dir, "/missing.mp3", NULL);
+
+	unplayable = xmms_medialib_unplayable_new (path);
+	xmms_medialib_unplayable_add (unplayable, present_url, "1-1-1", "file");
+	xmms_medialib_unplayable_add (unplayable, missing_url, "1-1-2", "file");
+	xmms_medialib_unplayable_add (unplayable, "junktest://junk", "1-1-3", "junk");
+	CU_ASSERT_TRUE (xmms_medialib_unplayable_save (unplayable));
+	xmms_medialib_unplayable_free (unplayable);
+
+	CU_ASSERT_TRUE (g_file_test (path, G_FILE_TEST_IS_REGULAR));
+
+	/* files that were deleted are dropped when loading */
+	unplayable = xmms_medialib_unplayable_new (path);
+	CU_ASSERT_TRUE (xmms_medialib_unplayable_lookup (unplayable, present_url, "1-1-1"));
+	CU_ASSERT_FALSE (xmms_medialib_unplayable_contains (unplayable, missing_url));
+	CU_ASSERT_TRUE (xmms_medialib_unplayable_contains (unplayable, "junktest://junk"));
+
+	/* and those that changed when looking them up */
+	CU_ASSERT_FALSE (xmms_medialib_unplayable_lookup (unplayable, "junktest://junk", "2-2-2"));
+	xmms_medialib_unplayable_free (unplayable);
+
+	CU_ASSERT_TRUE (g_file_get_contents (path, &contents, NULL, NULL));
+	CU_ASSERT_PTR_NOT_NULL (strstr (contents, present_url));
+	CU_ASSERT_PTR_NULL (strstr (contents, missing_url));
+	CU_ASSERT_PTR_NULL (strstr (contents, "junktest://junk"));
+	g_free (contents);
+
+	unplayable = xmms_medialib_unplayable_new (path);
+	CU_ASSERT_TRUE (xmms_medialib_unplayable_lookup (unplayable, present_url, "1-1-1"));
+	CU_ASSERT_FALSE (xmms_medialib_unplayable_contains (unplayable, missing_url));
+	CU_ASSERT_FALSE (xmms_medialib_unplayable_contains (unplayable, "junktest://junk"));
+	xmms_medialib_unplayable_free (unplayable);
+
+	g_unlink (path);
+	g_unlink (present);
+	g_rmdir (dir);
+
+	g_free (missing_url);
+	g_free (present_url);
+	g_free (present);
+	g_free (path);
+	g_free (dir);
+}
+
 static gboolean
 xmms_test_browse_init (xmms_xform_t *xform)
 {
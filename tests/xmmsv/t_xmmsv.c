@@ -690,6 +690,55 @@ CASE (test_xmmsv_dict_format) {
 
 }
 
+CASE (test_xmmsv_dict_grow) {
+	xmmsv_dict_iter_t *it;
+	xmmsv_t *val;
+	const char *key;
+	char buf[128];
+	int i, j, n;
+
+	val = xmmsv_new_dict ();
+
+	/* small dicts are stored inline, larger ones as hash tables */
+	for (n = 1; n <= 200; n *= 3) {
+		for (i = 0; i < n; i++) {
+			snprintf (buf, sizeof (buf), "key %d", i);
+			CU_ASSERT_TRUE (xmmsv_dict_set_int (val, buf, i));
+		}
+		/* a key too long to be interned */
+		memset (buf, 'x', 100);
+		buf[100] = '\0';
+		CU_ASSERT_TRUE (xmmsv_dict_set_int (val, buf, -1));
+		CU_ASSERT_EQUAL (n + 1, xmmsv_dict_get_size (val));
+
+		for (i = 0; i < n; i++) {
+			snprintf (buf, sizeof (buf), "key %d", i);
+			CU_ASSERT_TRUE (xmmsv_dict_entry_get_int (val, buf, &j));
+			CU_ASSERT_EQUAL (i, j);
+		}
+
+		/* remove every other entry while iterating */
+		CU_ASSERT_TRUE (xmmsv_get_dict_iter (val, &it));
+		while (xmmsv_dict_iter_pair_int (it, &key, &i)) {
+			if (i % 2) {
+				xmmsv_dict_iter_next (it);
+			} else {
+				CU_ASSERT_TRUE (xmmsv_dict_iter_remove (it));
+			}
+		}
+		xmmsv_dict_iter_explicit_destroy (it);
+
+		CU_ASSERT_EQUAL ((n + 1) / 2, xmmsv_dict_get_size (val));
+		CU_ASSERT_TRUE (xmmsv_dict_has_key (val, "key 1") == (n > 1));
+		CU_ASSERT_FALSE (xmmsv_dict_has_key (val, "key 0"));
+
+		CU_ASSERT_TRUE (xmmsv_dict_clear (val));
+		CU_ASSERT_EQUAL (0, xmmsv_dict_get_size (val));
+	}
+
+	xmmsv_unref (val);
+}
+
 CASE (test_xmmsv_list_move) {
 	xmmsv_t *l;
 	xmmsv_list_iter_t *its[5];
@@ -784,6 +833,126 @@ CASE (test_xmmsv_list_move) {
 	xmmsv_unref (l);
 }
 
+static int
+_int_compare (const void *a, const void *b)
+{
+	return *(const int *) a - *(const int *) b;
+}
+
+static int
+_list_matches (xmmsv_t *l, int *expected, int size)
+{
+	xmmsv_list_iter_t *it;
+	int i, entry;
+
+	if (xmmsv_list_get_size (l) != size) {
+		return 0;
+	}
+
+	for (i = 0; i < size; i++) {
+		if (!xmmsv_list_get_int (l, i, &entry) || entry != expected[i]) {
+			return 0;
+		}
+	}
+
+	xmmsv_get_list_iter (l, &it);
+	for (i = 0; xmmsv_list_iter_entry_int (it, &entry); i++) {
+		if (entry != expected[i]) {
+			break;
+		}
+		xmmsv_list_iter_next (it);
+	}
+	xmmsv_list_iter_explicit_destroy (it);
+
+	return i == size;
+}
+
+CASE (test_xmmsv_list_large) {
+	xmmsv_list_iter_t *it;
+	xmmsv_t *l;
+	int *expected;
+	int i, op, pos, to, v, size = 0, entry;
+
+	expected = malloc (10000 * sizeof (int));
+	l = xmmsv_new_list ();
+
+	srand (42);
+
+	/* grow well beyond one chunk, then shrink back below it */
+	for (i = 0; i < 20000; i++) {
+		op = rand () % 10;
+		if (i >= 12000) {
+			op = (op < 3) ? 0 : 1;
+		}
+
+		if (size == 0 || (op < 5 && size < 5000)) {
+			pos = rand () % (size + 1);
+			CU_ASSERT_TRUE (xmmsv_list_insert_int (l, pos, i));
+			memmove (expected + pos + 1, expected + pos, (size - pos) * sizeof (int));
+			expected[pos] = i;
+			size++;
+		} else if (op < 8) {
+			/* mostly from the head, like a played radio playlist */
+			pos = (op == 5) ? 0 : rand () % size;
+			CU_ASSERT_TRUE (xmmsv_list_remove (l, pos));
+			memmove (expected + pos, expected + pos + 1, (size - pos - 1) * sizeof (int));
+			size--;
+		} else {
+			pos = rand () % size;
+			to = rand () % size;
+			CU_ASSERT_TRUE (xmmsv_list_move (l, pos, to));
+			v = expected[pos];
+			memmove (expected + pos, expected + pos + 1, (size - pos - 1) * sizeof (int));
+			memmove (expected + to + 1, expected + to, (size - 1 - to) * sizeof (int));
+			expected[to] = v;
+		}
+
+		if (i % 500 == 0) {
+			CU_ASSERT_TRUE (_list_matches (l, expected, size));
+		}
+	}
+	CU_ASSERT_TRUE (_list_matches (l, expected, size));
+
+	/* refill, keep an iterator on the middle and edit around it */
+	for (i = 0; i < 3000; i++) {
+		CU_ASSERT_TRUE (xmmsv_list_append_int (l, -i));
+		expected[size++] = -i;
+	}
+
+	CU_ASSERT_TRUE (xmmsv_get_list_iter (l, &it));
+	CU_ASSERT_TRUE (xmmsv_list_iter_seek (it, size / 2));
+	v = expected[size / 2];
+
+	for (i = 0; i < 1000; i++) {
+		CU_ASSERT_TRUE (xmmsv_list_remove (l, 0));
+		CU_ASSERT_TRUE (xmmsv_list_insert_int (l, -1, i));
+	}
+	CU_ASSERT_TRUE (xmmsv_list_iter_entry_int (it, &entry));
+	CU_ASSERT_EQUAL (v, entry);
+	xmmsv_list_iter_explicit_destroy (it);
+
+	/* sort across chunks */
+	memmove (expected, expected + 1000, (size - 1000) * sizeof (int));
+	for (i = 0; i < 1000; i++) {
+		expected[size - 1000 + i] = i;
+	}
+	CU_ASSERT_TRUE (xmmsv_list_sort (l, list_compare_int));
+	qsort (expected, size, sizeof (int), _int_compare);
+	CU_ASSERT_TRUE (_list_matches (l, expected, size));
+
+	CU_ASSERT_TRUE (xmmsv_list_set_int (l, size - 1, 7));
+	CU_ASSERT_TRUE (xmmsv_list_get_int (l, -1, &entry));
+	CU_ASSERT_EQUAL (7, entry);
+
+	CU_ASSERT_TRUE (xmmsv_list_clear (l));
+	CU_ASSERT_EQUAL (0, xmmsv_list_get_size (l));
+	CU_ASSERT_TRUE (xmmsv_list_append_int (l, 1));
+	CU_ASSERT_EQUAL (1, xmmsv_list_get_size (l));
+
+	xmmsv_unref (l);
+	free (expected);
+}
+
 CASE (test_xmmsv_type_bitbuffer_one_bit)
 {
 	xmmsv_t *value;
@@ -0,0 +1,313 @@
+/*  XMMS2 - X Music Multiplexer System
+ *  Copyright (C) 2003-2013 XMMS2 Team
+ *
+ *  PLUGINS ARE NOT CONSIDERED TO BE DERIVED WORK !!!
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ */
+
+/*
+ * The threaded case is most useful with the tests built using
+ * -fsanitize=thread, so that races on the shared value are reported.
+ */
+
+#include "xcu.h"
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <xmmsc/xmmsv.h>
+#include <xmmsc/xmmsc_idnumbers.h>
+
+#define ITEMS 500
+#define THREADS 8
+#define ROUNDS 200
+
+SETUP (xmmsv_frozen) {
+	return 0;
+}
+
+CLEANUP () {
+	return 0;
+}
+
+static xmmsv_t *
+build_tree (void)
+{
+	xmmsv_t *tree, *items, *item, *coll;
+	int i;
+
+	items = xmmsv_new_list ();
+	for (i = 0; i < ITEMS; i++) {
+		item = xmmsv_build_dict (XMMSV_DICT_ENTRY_INT ("id", i),
+		                         XMMSV_DICT_ENTRY_STR ("title", "a title"),
+		                         XMMSV_DICT_END);
+		xmmsv_list_append (items, item);
+		xmmsv_unref (item);
+	}
+
+	coll = xmmsv_new_coll (XMMS_COLLECTION_TYPE_IDLIST);
+	for (i = 0; i < ITEMS; i++) {
+		xmmsv_coll_idlist_append (coll, i);
+	}
+
+	tree = xmmsv_new_dict ();
+	xmmsv_dict_set (tree, "items", items);
+	xmmsv_dict_set (tree, "coll", coll);
+
+	xmmsv_unref (items);
+	xmmsv_unref (coll);
+
+	return tree;
+}
+
+CASE (test_xmmsv_freeze_recursive)
+{
+	xmmsv_t *tree, *items, *item, *coll;
+
+	tree = build_tree ();
+	CU_ASSERT_FALSE (xmmsv_is_frozen (tree));
+
+	CU_ASSERT_PTR_EQUAL (tree, xmmsv_freeze (tree));
+	CU_ASSERT_TRUE (xmmsv_is_frozen (tree));
+
+	CU_ASSERT_TRUE (xmmsv_dict_get (tree, "items", &items));
+	CU_ASSERT_TRUE (xmmsv_is_frozen (items));
+	CU_ASSERT_TRUE (xmmsv_list_get (items, 3, &item));
+	CU_ASSERT_TRUE (xmmsv_is_frozen (item));
+
+	CU_ASSERT_TRUE (xmmsv_dict_get (tree, "coll", &coll));
+	CU_ASSERT_TRUE (xmmsv_is_frozen (coll));
+	CU_ASSERT_TRUE (xmmsv_is_frozen (xmmsv_coll_idlist_get (coll)));
+	CU_ASSERT_TRUE (xmmsv_is_frozen (xmmsv_coll_attributes_get (coll)));
+
+	/* freezing twice is fine */
+	xmmsv_freeze (tree);
+
+	xmmsv_unref (tree);
+}
+
+CASE (test_xmmsv_frozen_rejects_writes)
+{
+	xmmsv_t *tree, *items, *item, *coll, *value, *bb;
+	xmmsv_list_iter_t *lit;
+	xmmsv_dict_iter_t *dit;
+	const char *s;
+
+	tree = xmmsv_freeze (build_tree ());
+
+	value = xmmsv_new_int (42);
+
+	CU_ASSERT_FALSE (xmmsv_dict_set (tree, "answer", value));
+	CU_ASSERT_FALSE (xmmsv_dict_remove (tree, "items"));
+	CU_ASSERT_FALSE (xmmsv_dict_clear (tree));
+	CU_ASSERT_EQUAL (2, xmmsv_dict_get_size (tree));
+
+	CU_ASSERT_TRUE (xmmsv_get_dict_iter (tree, &dit));
+	CU_ASSERT_FALSE (xmmsv_dict_iter_set (dit, value));
+	CU_ASSERT_FALSE (xmmsv_dict_iter_remove (dit));
+	xmmsv_dict_iter_explicit_destroy (dit);
+
+	CU_ASSERT_TRUE (xmmsv_dict_get (tree, "items", &items));
+	CU_ASSERT_FALSE (xmmsv_list_append (items, value));
+	CU_ASSERT_FALSE (xmmsv_list_insert (items, 0, value));
+	CU_ASSERT_FALSE (xmmsv_list_set (items, 0, value));
+	CU_ASSERT_FALSE (xmmsv_list_remove (items, 0));
+	CU_ASSERT_FALSE (xmmsv_list_move (items, 0, 1));
+	CU_ASSERT_FALSE (xmmsv_list_clear (items));
+	CU_ASSERT_FALSE (xmmsv_list_restrict_type (items, XMMSV_TYPE_DICT));
+	CU_ASSERT_EQUAL (ITEMS, xmmsv_list_get_size (items));
+
+	CU_ASSERT_TRUE (xmmsv_get_list_iter (items, &lit));
+	CU_ASSERT_FALSE (xmmsv_list_iter_insert (lit, value));
+	CU_ASSERT_FALSE (xmmsv_list_iter_remove (lit));
+	xmmsv_list_iter_explicit_destroy (lit);
+
+	CU_ASSERT_TRUE (xmmsv_list_get (items, 0, &item));
+	CU_ASSERT_FALSE (xmmsv_dict_set_string (item, "title", "other"));
+	CU_ASSERT_TRUE (xmmsv_dict_entry_get_string (item, "title", &s));
+	CU_ASSERT_STRING_EQUAL ("a title", s);
+
+	CU_ASSERT_TRUE (xmmsv_dict_get (tree, "coll", &coll));
+	CU_ASSERT_FALSE (xmmsv_coll_idlist_append (coll, 1000));
+	CU_ASSERT_EQUAL (ITEMS, xmmsv_coll_idlist_get_size (coll));
+	xmmsv_coll_attribute_set_string (coll, "type", "queue");
+	CU_ASSERT_FALSE (xmmsv_coll_attribute_get_string (coll, "type", &s));
+
+	bb = xmmsv_freeze (xmmsv_new_bitbuffer ());
+	CU_ASSERT_FALSE (xmmsv_bitbuffer_put_bits (bb, 8, 1));
+	xmmsv_unref (bb);
+
+	xmmsv_unref (value);
+	xmmsv_unref (tree);
+}
+
+CASE (test_xmmsv_frozen_copy_is_mutable)
+{
+	xmmsv_t *tree, *copy, *items;
+
+	tree = xmmsv_freeze (build_tree ());
+	copy = xmmsv_copy (tree);
+
+	CU_ASSERT_FALSE (xmmsv_is_frozen (copy));
+	CU_ASSERT_TRUE (xmmsv_dict_get (copy, "items", &items));
+	CU_ASSERT_FALSE (xmmsv_is_frozen (items));
+	CU_ASSERT_TRUE (xmmsv_list_remove (items, 0));
+	CU_ASSERT_EQUAL (ITEMS - 1, xmmsv_list_get_size (items));
+
+	xmmsv_unref (tree);
+	xmmsv_unref (copy);
+}
+
+typedef struct {
+	xmmsv_t *tree;
+	int failures;
+} reader_t;
+
+static void *
+reader_thread (void *data)
+{
+	reader_t *reader = data;
+	xmmsv_t *items, *item, *coll, *bb;
+	xmmsv_list_iter_t *it;
+	int i, id, sum;
+
+	for (i = 0; i < ROUNDS; i++) {
+		xmmsv_ref (reader->tree);
+
+		if (!xmmsv_dict_get (reader->tree, "items", &items) ||
+		    !xmmsv_get_list_iter (items, &it)) {
+			reader->failures++;
+			xmmsv_unref (reader->tree);
+			continue;
+		}
+
+		for (sum = 0; xmmsv_list_iter_entry (it, &item); xmmsv_list_iter_next (it)) {
+			if (xmmsv_dict_entry_get_int (item, "id", &id)) {
+				sum += id;
+			}
+		}
+		xmmsv_list_iter_explicit_destroy (it);
+
+		if (sum != ITEMS * (ITEMS - 1) / 2) {
+			reader->failures++;
+		}
+
+		if (!xmmsv_dict_get (reader->tree, "coll", &coll) ||
+		    xmmsv_coll_idlist_get_size (coll) != ITEMS) {
+			reader->failures++;
+		}
+
+		bb = xmmsv_serialize (reader->tree);
+		if (!bb) {
+			reader->failures++;
+		} else {
+			xmmsv_unref (bb);
+		}
+
+		xmmsv_unref (reader->tree);
+	}
+
+	/* the last thread to get here frees the tree */
+	xmmsv_unref (reader->tree);
+
+	return NULL;
+}
+
+CASE (test_xmmsv_frozen_shared_between_threads)
+{
+	reader_t readers[THREADS];
+	pthread_t threads[THREADS];
+	xmmsv_t *tree;
+	int i, failures = 0;
+
+	tree = xmmsv_freeze (build_tree ());
+
+	for (i = 0; i < THREADS; i++) {
+		readers[i].tree = xmmsv_ref (tree);
+		readers[i].failures = 0;
+		CU_ASSERT_EQUAL (0, pthread_create (&threads[i], NULL,
+		                                    reader_thread, &readers[i]));
+	}
+
+	xmmsv_unref (tree);
+
+	for (i = 0; i < THREADS; i++) {
+		pthread_join (threads[i], NULL);
+		failures += readers[i].failures;
+	}
+
+	CU_ASSERT_EQUAL (0, failures);
+}
+
+static void *
+lookup_thread (void *data)
+{
+	reader_t *reader = data;
+	char key[16];
+	int i, j, value;
+
+	for (i = 0; i < ROUNDS; i++) {
+		for (j = 0; j < ITEMS; j++) {
+			snprintf (key, sizeof (key), "key%d", j);
+			if (xmmsv_dict_entry_get_int (reader->tree, key, &value)) {
+				if (j % 2 == 0 || value != j) {
+					reader->failures++;
+				}
+			} else if (j % 2 == 1) {
+				reader->failures++;
+			}
+		}
+	}
+
+	return NULL;
+}
+
+CASE (test_xmmsv_frozen_dict_lookups_between_threads)
+{
+	reader_t readers[THREADS];
+	pthread_t threads[THREADS];
+	xmmsv_t *dict;
+	char key[16];
+	int i, failures = 0;
+
+	/* leave deleted slots in front of the remaining keys, a lookup of a
+	 * mutable dict would move the keys into them */
+	dict = xmmsv_new_dict ();
+	for (i = 0; i < ITEMS; i++) {
+		snprintf (key, sizeof (key), "key%d", i);
+		xmmsv_dict_set_int (dict, key, i);
+	}
+	for (i = 0; i < ITEMS; i += 2) {
+		snprintf (key, sizeof (key), "key%d", i);
+		xmmsv_dict_remove (dict, key);
+	}
+
+	xmmsv_freeze (dict);
+
+	for (i = 0; i < THREADS; i++) {
+		readers[i].tree = dict;
+		readers[i].failures = 0;
+		CU_ASSERT_EQUAL (0, pthread_create (&threads[i], NULL,
+		                                    lookup_thread, &readers[i]));
+	}
+
+	for (i = 0; i < THREADS; i++) {
+		pthread_join (threads[i], NULL);
+		failures += readers[i].failures;
+	}
+
+	CU_ASSERT_EQUAL (0, failures);
+	CU_ASSERT_EQUAL (ITEMS / 2, xmmsv_dict_get_size (dict));
+
+	xmmsv_unref (dict);
+}
@@ -65,17 +65,20 @@ def build(object_name, c_type):
 			for method in object.methods:
 				emit_method_define_code(object, method, c_type)
 
+			if object.methods:
+				emit_method_table_code(object)
+
 			Indenter.printline()
 			Indenter.printline('static void')
 			Indenter.printline('xmms_%s_register_ipc_commands (xmms_object_t *%s_object)' % (object.name, object.name))
 			Indenter.enter('{')
 
-			Indenter.printline('xmms_ipc_object_register (%i, %s_object);' % (object.id, object.name))
-			Indenter.printline()
-
-			for method in object.methods:
-				emit_method_add_code(object, method)
+			# the commands must be set before clients can reach the object
+			if object.methods:
+				emit_method_add_code(object)
+				Indenter.printline()
 
+			Indenter.printline('xmms_ipc_object_register (%i, %s_object);' % (object.id, object.name))
 			Indenter.printline()
 
 			for broadcast in object.broadcasts:
@@ -182,5 +185,21 @@ def emit_method_define_code(object, method, c_type):
 	Indenter.printline()
 
 
-def emit_method_add_code(object, method):
-	Indenter.printline('xmms_object_cmd_add (%s_object, %i, %s);' % (object.name, method.id, method_name_to_cname (method.name)))
+def method_table_cname(object):
+	return "xmms_%s_cmds" % object.name
+
+def emit_method_table_code(object):
+	# dispatch table indexed by command id minus the first id
+	first = min(method.id for method in object.methods)
+
+	Indenter.enter('static const xmms_object_cmd_func_t %s[] = {' % method_table_cname(object))
+	for method in object.methods:
+		Indenter.printline('[%i] = %s,' % (method.id - first, method_name_to_cname (method.name)))
+	Indenter.leave('};')
+	Indenter.printline()
+
+def emit_method_add_code(object):
+	first = min(method.id for method in object.methods)
+	table = method_table_cname(object)
+
+	Indenter.printline('xmms_object_cmds_set (%s_object, %i, %s, G_N_ELEMENTS (%s));' % (object.name, first, table, table))